@@ -2,15 +2,15 @@
 #include "../logger/CarLogger.hpp"
 #include "../Sensors/Sensor.hpp"
 #include "../car/Car.hpp"
+#include "../metrics/CarMetrics.hpp"
 
 /**
  * @brief Constructs an Adaptive_Cruise_Control_ECU object.
  * 
- * Initializes the name and type of the ECU and sets the adaptive cruise control status to off.
+ * Sets the kind of the ECU and sets the adaptive cruise control status to off.
  */
 Adaptive_Cruise_Control_ECU::Adaptive_Cruise_Control_ECU() 
-    : type("Adaptive Cruise Control ECU"), ADAPTIVE_ON(false) {
-    name = type;  // initializing the name and type of the ECU  
+    : ECU(ECUTypes::ADAPTIVE_CRUISE_CONTROL_ECU), ADAPTIVE_ON(false) {
 }
 
 /**
@@ -19,7 +19,9 @@ Adaptive_Cruise_Control_ECU::Adaptive_Cruise_Control_ECU()
  * Logs a message indicating the destruction of the ECU.
  */
 Adaptive_Cruise_Control_ECU::~Adaptive_Cruise_Control_ECU() {
-    Logger::getInstance().log(name + " is destroyed");
+    if (Logger::getInstance().isEnabled()) {
+        Logger::getInstance().log(std::string(getName()) + " is destroyed");
+    }
 } 
 
 /**
@@ -33,31 +35,36 @@ Adaptive_Cruise_Control_ECU::~Adaptive_Cruise_Control_ECU() {
 void Adaptive_Cruise_Control_ECU::AttachSensor(std::shared_ptr<Sensor> s) {
     // Check if the sensor is already subscribed
     for (const auto& sensor : Subscribed_Sensors) {
-        if (sensor->getSensorID() == s->getSensorID() && sensor->getType() == s->getType()) {
-            Logger::getInstance().log(s->getType() + " of ID " + std::to_string(s->getSensorID()) + " is already subscribed.");
+        if (sensor == s) {
+            if (Logger::getInstance().isEnabled()) {
+                Logger::getInstance().log(std::string(s->getType()) + " of ID " + std::to_string(s->getSensorID()) + " is already subscribed.");
+            }
             return; // Exit if the sensor is already subscribed
         }
     }
 
     // Add the sensor if it is not already subscribed
     Subscribed_Sensors.push_back(s);
-    Logger::getInstance().log("A new " + s->getType() + " is subscribed.");
+    if (Logger::getInstance().isEnabled()) {
+        Logger::getInstance().log("A new " + std::string(s->getType()) + " is subscribed.");
+    }
 }
 
 /**
  * @brief Detaches a sensor from the adaptive cruise control ECU.
  * 
  * Searches for the sensor in the list of subscribed sensors and removes it
- * if found. Logs the action.
+ * if found, forgetting its samples. Logs the action.
  * 
  * @param s A shared pointer to the sensor to detach.
  */
 void Adaptive_Cruise_Control_ECU::DeattachSensor(std::shared_ptr<Sensor> s) {
     auto it = Subscribed_Sensors.begin();
     while (it != Subscribed_Sensors.end()) {
-        if ((*it)->getSensorID() == s->getSensorID() && (*it)->getType() == s->getType()) {
+        if ((*it)->getSensorID() == s->getSensorID() && (*it)->getKind() == s->getKind()) {
             it = Subscribed_Sensors.erase(it);  // Erase and update iterator
-            Logger::getInstance().log(s->getType() + " of ID " + std::to_string(s->getSensorID()) + " is erased successfully.");
+            ForgetSensor((int)s->getKind(), s->getSensorID()); 
+            Logger::getInstance().log(std::string(s->getType()) + " of ID " + std::to_string(s->getSensorID()) + " is erased successfully.");
             return; // Return after successful deletion
         } else {
             ++it; // Move to the next sensor
@@ -71,13 +78,28 @@ void Adaptive_Cruise_Control_ECU::DeattachSensor(std::shared_ptr<Sensor> s) {
  * @brief Activates the adaptive cruise control functionality.
  * 
  * Logs the activation of the adaptive cruise control mode and sets the
- * status to on.
+ * status to on. The safe gap comes from the car's vehicle profile.
  * 
  * @param c The car object that the ECU is controlling.
  */
-void Adaptive_Cruise_Control_ECU::PerformFunction(Car c) {
+void Adaptive_Cruise_Control_ECU::PerformFunction(Car& c) {
     Logger::getInstance().log("Adaptive Cruise Control MODE is ON"); 
     ADAPTIVE_ON = true; 
+    CarMetrics::get().adaptiveRuns->Increment(); 
+
+    // Use the pre-aggregated rollups instead of scanning raw samples
+    WindowStats radar = QueryWindow(int(SensorTypes::RADAR_SENSOR), RollupWindowId::ONE_SECOND); 
+    WindowStats speed = QueryWindow(int(SensorTypes::SPEED_SENSOR), RollupWindowId::ONE_SECOND); 
+    if (radar.count > 0 && speed.count > 0 && Logger::getInstance().isEnabled()) {
+        std::ostringstream oss; 
+        oss << "ACC last second: closest obstacle " << radar.min 
+            << ", mean speed " << speed.mean(); 
+        if (radar.min < c.getLimits().safeRadarDistance) {
+            oss << ", inside the " << c.getLimits().safeRadarDistance << " m gap of a " 
+                << c.getLimits().name << " vehicle"; 
+        }
+        Logger::getInstance().log(oss.str()); 
+    }
 }
 
 /**
@@ -90,19 +112,19 @@ bool Adaptive_Cruise_Control_ECU::IsON() {
 }
 
 /**
- * @brief Gets the ID of the adaptive cruise control ECU.
+ * @brief Turns adaptive cruise control on or off without running it.
  * 
- * @return The ID of the ECU as an integer.
+ * @param on true to mark it active.
  */
-int Adaptive_Cruise_Control_ECU::getID() const {
-    return ECU_ID; 
+void Adaptive_Cruise_Control_ECU::SetON(bool on) {
+    ADAPTIVE_ON = on; 
 }
 
 /**
- * @brief Gets the name of the adaptive cruise control ECU.
+ * @brief Gets the ID of the adaptive cruise control ECU.
  * 
- * @return The name of the ECU as a string.
+ * @return The ID of the ECU as an integer.
  */
-std::string Adaptive_Cruise_Control_ECU::getName() const {
-    return name; 
+int Adaptive_Cruise_Control_ECU::getID() const {
+    return ECU_ID; 
 }
@@ -32,12 +32,6 @@ public:
      */
     void DeattachSensor(std::shared_ptr<Sensor> s) override;
 
-    /**
-     * @brief Gets the name of the adaptive cruise control ECU.
-     * @return The name of the ECU as a string.
-     */
-    std::string getName() const override;
-
     /**
      * @brief Gets the ID of the adaptive cruise control ECU.
      * @return The ID of the ECU as an integer.
@@ -48,7 +42,7 @@ public:
      * @brief Performs the function of the adaptive cruise control ECU.
      * @param c The car object that the ECU is controlling.
      */
-    void PerformFunction(Car c) override;
+    void PerformFunction(Car& c) override;
 
     /**
      * @brief Destructor for Adaptive_Cruise_Control_ECU.
@@ -63,8 +57,13 @@ public:
      */
     bool IsON(); 
 
+    /**
+     * @brief Turns adaptive cruise control on or off without running it.
+     * @param on true to mark it active; PerformFunction turns it on.
+     */
+    void SetON(bool on); 
+
 private:
-    std::string type;  ///< The type of the adaptive cruise control ECU.
     bool ADAPTIVE_ON;  ///< The status indicating if adaptive cruise control is active.
 };
 
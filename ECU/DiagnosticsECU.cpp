@@ -2,25 +2,34 @@
 #include "../logger/CarLogger.hpp"
 #include "../Sensors/Sensor.hpp"
 #include <memory>
+#include <algorithm>
 #include "../car/Car.hpp"
+#include "../metrics/CarMetrics.hpp"
+#include "../config/RuntimeConfig.hpp"
 
 /**
  * @brief Constructor for the DiagnosticECU class.
  * 
- * Initializes the Diagnostic ECU with its type and state.
+ * Initializes the Diagnostic ECU with its type and state, and takes the
+ * anomaly thresholds of the current runtime settings.
  */
-DiagnosticECU::DiagnosticECU() : type("Diagnostic ECU"), Diagnostic_ON(false) {
-    // Initializing the name and type of the ECU  
-    name = type; 
+DiagnosticECU::DiagnosticECU() 
+    : ECU(ECUTypes::DIAGNOSTIC_ECU), Diagnostic_ON(false) {
+    RcuReadGuard guard; 
+    const RuntimeSettings* settings = RuntimeConfig::get().Current(); 
+    Anomaly_Limits = settings->anomaly; 
+    Settings_Version = settings->version; 
 }
 
 /**
  * @brief Destructor for the DiagnosticECU class.
  * 
- * Logs the destruction of the Diagnostic ECU.
+ * Logs the destruction of the Diagnostic ECU; the message is only built when logging is on.
  */
 DiagnosticECU::~DiagnosticECU() {
-    Logger::getInstance().log(name + " is destroyed");
+    if (Logger::getInstance().isEnabled()) {
+        Logger::getInstance().log(std::string(getName()) + " is destroyed");
+    }
 }
 
 /**
@@ -34,30 +43,36 @@ DiagnosticECU::~DiagnosticECU() {
 void DiagnosticECU::AttachSensor(std::shared_ptr<Sensor> s) {
     // Check if the sensor is already subscribed
     for (const auto& sensor : Subscribed_Sensors) {
-        if (sensor->getSensorID() == s->getSensorID() && sensor->getType() == s->getType()) {
-            Logger::getInstance().log(s->getType() + " of ID " + std::to_string(s->getSensorID()) + " is already subscribed.");
+        if (sensor == s) {
+            if (Logger::getInstance().isEnabled()) {
+                Logger::getInstance().log(std::string(s->getType()) + " of ID " + std::to_string(s->getSensorID()) + " is already subscribed.");
+            }
             return; // Exit if the sensor is already subscribed
         }
     }
 
     // Add the sensor if it is not already subscribed
     Subscribed_Sensors.push_back(s);
-    Logger::getInstance().log("A new " + s->getType() + " is subscribed to Diagnostics.");
+    if (Logger::getInstance().isEnabled()) {
+        Logger::getInstance().log("A new " + std::string(s->getType()) + " is subscribed to Diagnostics.");
+    }
 }
 
 /**
  * @brief Detaches a sensor from the Diagnostic ECU.
  * 
- * Removes the specified sensor from the list of subscribed sensors and logs the action.
+ * Removes the specified sensor from the list of subscribed sensors, forgets
+ * its samples and statistics, and logs the action.
  * 
  * @param s A shared pointer to the sensor to be detached.
  */
 void DiagnosticECU::DeattachSensor(std::shared_ptr<Sensor> s) {
     auto it = Subscribed_Sensors.begin();
     while (it != Subscribed_Sensors.end()) {
-        if ((*it)->getSensorID() == s->getSensorID() && (*it)->getType() == s->getType()) {
+        if ((*it)->getSensorID() == s->getSensorID() && (*it)->getKind() == s->getKind()) {
             it = Subscribed_Sensors.erase(it);  // Erase and update iterator
-            Logger::getInstance().log(s->getType() + " of ID " + std::to_string(s->getSensorID()) + " is erased successfully from Diagnostics.");
+            ForgetSensor((int)s->getKind(), s->getSensorID()); 
+            Logger::getInstance().log(std::string(s->getType()) + " of ID " + std::to_string(s->getSensorID()) + " is erased successfully from Diagnostics.");
             return; // Return after successful deletion
         } else {
             ++it; // Move to the next sensor
@@ -70,15 +85,155 @@ void DiagnosticECU::DeattachSensor(std::shared_ptr<Sensor> s) {
 /**
  * @brief Performs the primary function of the Diagnostic ECU.
  * 
- * Activates diagnostic mode, updates the sensors, and logs the current data.
+ * Activates diagnostic mode, reads the sensors, relays them to every
+ * subscribed ECU and logs the current data. The sensors are read first so
+ * no ECU starts from a sensor that has never been read; the fusion filter
+ * would otherwise lock onto a 0 m radar range.
  * 
  * @param c The car instance to perform the function on.
  */
-void DiagnosticECU::PerformFunction(Car c) {
+void DiagnosticECU::PerformFunction(Car& c) {
     Logger::getInstance().log("Diagnostics MODE is ON");
     Diagnostic_ON = true;
-    update(); 
     c.UpdateSensorsData(); // Update and log all the car sensory data 
+    update(); 
+    LogRecentWindow(RollupWindowId::TEN_SECONDS); 
+}
+
+/**
+ * @brief Drops the samples, history and statistics of a detached sensor.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param sensorID The ID of the sensor.
+ */
+void DiagnosticECU::ForgetSensor(int sensorType, int sensorID) {
+    ECU::ForgetSensor(sensorType, sensorID); 
+    Sensor_Diagnostics[sensorType].erase(sensorID); 
+}
+
+/**
+ * @brief Updates the sensor statistics and reports newly raised anomalies.
+ * 
+ * Runs in O(1) per sample; the statistics entry is only allocated the first
+ * time a sensor reports. An anomaly is logged when it appears, not on every
+ * sample that keeps it raised.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param sensorID The ID of the sensor that produced the sample.
+ * @param value The sample value.
+ * @param time The timestamp the sample was recorded with.
+ */
+void DiagnosticECU::OnSample(int sensorType, int sensorID, double value, TimestampNs /* time */) {
+    if (!Diagnostic_ON) {
+        return; // The samples are still relayed; only the checks are off
+    }
+    SensorDiagnostics& d = Sensor_Diagnostics[sensorType][sensorID]; 
+    const unsigned previous = d.lastFlags(); 
+    const unsigned raised = d.add(value, Anomaly_Limits[sensorType]); 
+    const unsigned fresh = raised & ~previous; 
+    if (fresh == ANOMALY_NONE) {
+        return; 
+    }
+    const CarMetrics& metrics = CarMetrics::get(); 
+    if (fresh & ANOMALY_RANGE) metrics.alerts[(int)CarAlert::OUT_OF_RANGE]->Increment(); 
+    if (fresh & ANOMALY_Z_SCORE) metrics.alerts[(int)CarAlert::SPIKE]->Increment(); 
+    if (fresh & ANOMALY_STUCK) metrics.alerts[(int)CarAlert::STUCK]->Increment(); 
+    if (!Logger::getInstance().isEnabled(LogLevel::WARNING)) {
+        return; // Counted; skip building the message
+    }
+
+    std::ostringstream oss; 
+    oss << "Anomaly on sensor type " << sensorType << " ID " << sensorID << " value " << value << ":"; 
+    if (fresh & ANOMALY_RANGE) oss << " out of range"; 
+    if (fresh & ANOMALY_Z_SCORE) oss << " spike (mean " << d.stats().mean() << ")"; 
+    if (fresh & ANOMALY_STUCK) oss << " stuck"; 
+    Logger::getInstance().log(LogLevel::WARNING, oss.str()); 
+}
+
+/**
+ * @brief Retrieves the running statistics and anomaly counters of one sensor.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param sensorID The ID of the sensor.
+ * @return const SensorDiagnostics* The summary, or nullptr if the sensor never reported.
+ */
+const SensorDiagnostics* DiagnosticECU::GetSensorSummary(int sensorType, int sensorID) const {
+    auto it = Sensor_Diagnostics[sensorType].find(sensorID); 
+    return it == Sensor_Diagnostics[sensorType].end() ? nullptr : &it->second; 
+}
+
+/**
+ * @brief Replaces the running statistics and anomaly counters of one sensor.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param sensorID The ID of the sensor.
+ * @param summary The statistics and counters.
+ */
+void DiagnosticECU::RestoreSensorSummary(int sensorType, int sensorID, const SensorDiagnostics& summary) {
+    Sensor_Diagnostics[sensorType].insert_or_assign(sensorID, summary); 
+}
+
+/**
+ * @brief Replaces the anomaly thresholds used for one sensor type, until new runtime settings are installed.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param limits The new thresholds.
+ */
+void DiagnosticECU::SetAnomalyLimits(int sensorType, const AnomalyLimits& limits) {
+    Anomaly_Limits[sensorType] = limits; 
+}
+
+/**
+ * @brief Logs the statistics summary of every sensor that reported.
+ */
+void DiagnosticECU::LogSummary() const {
+    for (int type = 0; type < Sensor_Types_Count; type++) {
+        for (const auto& entry : Sensor_Diagnostics[type]) {
+            const StreamingStats& st = entry.second.stats(); 
+            std::ostringstream oss; 
+            oss << "Sensor type " << type << " ID " << entry.first << " summary: n=" << st.count() 
+                << " mean=" << st.mean() << " stddev=" << st.stddev() << " ewma=" << st.ewma() 
+                << " min=" << st.min() << " max=" << st.max() 
+                << " spikes=" << entry.second.anomalyCount(ANOMALY_Z_SCORE) 
+                << " stuck=" << entry.second.anomalyCount(ANOMALY_STUCK) 
+                << " out_of_range=" << entry.second.anomalyCount(ANOMALY_RANGE); 
+            Logger::getInstance().log(oss.str()); 
+        }
+    }
+
+    for (const auto& s : Subscribed_Sensors) {
+        std::ostringstream oss; 
+        oss << s->getType() << " ID " << s->getSensorID() << " notifications: delivered=" 
+            << s->getDeliveredCount() << " suppressed=" << s->getSuppressedCount(); 
+        Logger::getInstance().log(oss.str()); 
+    }
+}
+
+/**
+ * @brief Logs the rollup of a recent window for every sensor that reported.
+ * 
+ * Reads the pre-aggregated rollups, so the cost does not depend on how many
+ * samples arrived during the window.
+ * 
+ * @param window Which rollup window to report.
+ */
+void DiagnosticECU::LogRecentWindow(RollupWindowId window) const {
+    if (!Logger::getInstance().isEnabled()) {
+        return; 
+    }
+    const TimestampNs now = SampleNowNs(); 
+    for (int type = 0; type < Sensor_Types_Count; type++) {
+        for (const auto& entry : Sensory_History[type]) {
+            WindowStats w = entry.second.window(window, now); 
+            if (w.count == 0) {
+                continue; // Nothing reported inside the window 
+            }
+            std::ostringstream oss; 
+            oss << "Sensor type " << type << " ID " << entry.first << " window: samples=" << w.count 
+                << " min=" << w.min << " max=" << w.max << " mean=" << w.mean(); 
+            Logger::getInstance().log(oss.str()); 
+        }
+    }
 }
 
 /**
@@ -91,28 +246,45 @@ bool DiagnosticECU::IsON() {
 }
 
 /**
- * @brief Retrieves the ID of the Diagnostic ECU.
+ * @brief Turns the anomaly checks on or off.
  * 
- * @return int The ID of the Diagnostic ECU.
+ * While off, the ECU keeps relaying samples to the other ECUs on every
+ * update but no longer checks them.
+ * 
+ * @param on true to check samples.
  */
-int DiagnosticECU::getID() const {
-    return ECU_ID; 
+void DiagnosticECU::SetON(bool on) {
+    Diagnostic_ON = on; 
 }
 
 /**
- * @brief Retrieves the name of the Diagnostic ECU.
+ * @brief Retrieves the ID of the Diagnostic ECU.
  * 
- * @return std::string The name of the Diagnostic ECU.
+ * @return int The ID of the Diagnostic ECU.
  */
-std::string DiagnosticECU::getName() const {
-    return name; 
+int DiagnosticECU::getID() const {
+    return ECU_ID; 
 }
 
 /**
  * @brief Updates the state of the Diagnostic ECU by notifying all subscribed sensors.
+ * 
+ * First takes the anomaly thresholds of the runtime settings if a new
+ * version was installed since the last cycle; otherwise this costs one
+ * pointer load and a compare, and the samples are checked against the
+ * ECU's own copy.
  */
 void DiagnosticECU::update() {
-    for (auto s : Subscribed_Sensors) {
+    {
+        RcuReadGuard guard; 
+        const RuntimeSettings* settings = RuntimeConfig::get().Current(); 
+        if (settings->version != Settings_Version) {
+            Anomaly_Limits = settings->anomaly; 
+            Settings_Version = settings->version; 
+        }
+    }
+    CarMetrics::get().diagnosticRuns->Increment(); 
+    for (const auto& s : Subscribed_Sensors) {
         s->NotifyAllECUs(); 
         // Notify all ECUs by updating their sensory data 
     }
@@ -2,6 +2,7 @@
 #define DIAGNOSTIC_ECU_h 
 
 #include "ECU.hpp"
+#include "../telemetry/StreamingStats.hpp"
 
 // Forward declaration
 class Car;
@@ -32,13 +33,6 @@ public:
      */
     void DeattachSensor(std::shared_ptr<Sensor> s) override;
 
-    /**
-     * @brief Retrieves the name of this Diagnostic ECU.
-     * 
-     * @return std::string The name of the Diagnostic ECU.
-     */
-    std::string getName() const override;
-
     /**
      * @brief Retrieves the ID of this Diagnostic ECU.
      * 
@@ -51,7 +45,7 @@ public:
      * 
      * @param c The car to perform the function on.
      */
-    void PerformFunction(Car c) override;
+    void PerformFunction(Car& c) override;
 
     /**
      * @brief Updates the state of the Diagnostic ECU.
@@ -72,9 +66,83 @@ public:
      */
     bool IsON();
 
+    /**
+     * @brief Turns the anomaly checks on or off.
+     * 
+     * @param on true to check samples; PerformFunction turns them on.
+     */
+    void SetON(bool on);
+
+    /**
+     * @brief Logs the rollup of a recent window for every sensor that reported.
+     * 
+     * @param window Which rollup window to report.
+     */
+    void LogRecentWindow(RollupWindowId window) const;
+
+    /**
+     * @brief Retrieves the running statistics and anomaly counters of one sensor.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param sensorID The ID of the sensor.
+     * @return const SensorDiagnostics* The summary, or nullptr if the sensor never reported.
+     */
+    const SensorDiagnostics* GetSensorSummary(int sensorType, int sensorID) const;
+
+    /**
+     * @brief Replaces the running statistics and anomaly counters of one sensor.
+     * 
+     * Used to restore a checkpoint, whose sensors come back with new IDs.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param sensorID The ID of the sensor.
+     * @param summary The statistics and counters.
+     */
+    void RestoreSensorSummary(int sensorType, int sensorID, const SensorDiagnostics& summary);
+
+    /**
+     * @brief Replaces the anomaly thresholds used for one sensor type.
+     * 
+     * The next update after new runtime settings are installed replaces
+     * them again.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param limits The new thresholds.
+     */
+    void SetAnomalyLimits(int sensorType, const AnomalyLimits& limits);
+
+    /**
+     * @brief Logs the statistics summary of every sensor that reported, 
+     * and the notification counters of every subscribed sensor.
+     */
+    void LogSummary() const;
+
+protected:
+    /**
+     * @brief Updates the sensor statistics and reports newly raised anomalies.
+     * 
+     * Does nothing while the checks are off.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param sensorID The ID of the sensor that produced the sample.
+     * @param value The sample value.
+     * @param time The timestamp the sample was recorded with.
+     */
+    void OnSample(int sensorType, int sensorID, double value, TimestampNs time) override;
+
+    /**
+     * @brief Drops the samples, history and statistics of a detached sensor.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param sensorID The ID of the sensor.
+     */
+    void ForgetSensor(int sensorType, int sensorID) override;
+
 private:
-    std::string type; ///< Type of the Diagnostic ECU
     bool Diagnostic_ON; ///< State indicating if the ECU is ON
+    std::array<std::unordered_map<int, SensorDiagnostics>, Sensor_Types_Count> Sensor_Diagnostics; ///< Per sensor type, keyed by sensor ID
+    std::array<AnomalyLimits, Sensor_Types_Count> Anomaly_Limits; ///< Thresholds indexed by sensor type
+    std::uint64_t Settings_Version; ///< Version of the runtime settings Anomaly_Limits was taken from
 };
 
 #endif
@@ -1,9 +1,15 @@
 #include "ECU.hpp"
+#include "../metrics/CarMetrics.hpp"
 #include <unordered_map>
 #include <vector>
+#include <algorithm>
 
 std::atomic<int> ECU::ECU_Count {0}; 
 
+static const std::string_view ECU_Type_Names[ECU_Types_Count] = {
+    "Adaptive Cruise Control ECU", "Diagnostic ECU", "Sensor Fusion ECU"
+}; ///< Name of each ECUTypes value
+
 /**
  * @brief Get the current count of ECUs created.
  * 
@@ -13,25 +19,219 @@ int ECU::getECUCount() {
     return ECU_Count; 
 }
 
+/**
+ * @brief Get the kind of the ECU.
+ * 
+ * @return ECUTypes The kind.
+ */
+ECUTypes ECU::getKind() const {
+    return ECU_Kind; 
+}
+
+/**
+ * @brief Get the name of the ECU.
+ * 
+ * @return std::string_view The name of its kind.
+ */
+std::string_view ECU::getName() const {
+    return ECU_Type_Names[(int)ECU_Kind]; 
+}
+
+/**
+ * @brief Get the name of a kind of ECU.
+ * 
+ * @param kind The kind.
+ * @return std::string_view The name.
+ */
+std::string_view ECU::TypeName(ECUTypes kind) {
+    return ECU_Type_Names[(int)kind]; 
+}
+
+/**
+ * @brief Get the ECU's ID together with its generation.
+ * 
+ * @return RegistryHandle The handle.
+ */
+RegistryHandle ECU::getHandle() const {
+    return ECU_Handle; 
+}
+
+/**
+ * @brief Get the registry every ECU takes its ID from.
+ * 
+ * @return ObjectRegistry<ECU>& The process-wide ECU registry.
+ */
+ObjectRegistry<ECU>& ECU::Registry() {
+    static ObjectRegistry<ECU> registry; 
+    return registry; 
+}
+
 /**
  * @brief Destructor for the ECU class.
  * 
- * Decreases the count of ECUs when an ECU object is destroyed
- * and logs the remaining count of ECUs.
+ * Decreases the count of ECUs when an ECU object is destroyed, releases
+ * its ID for reuse and logs the remaining count of ECUs.
  */
 ECU::~ECU() {
     ECU_Count--; 
-    std::cout << "ECU is destroyed; remaining ECU count is " << ECU_Count << std::endl; 
+    Registry().Unregister(ECU_Handle); 
+    CarMetrics::get().ecus->Add(-1); 
+    if (Logger::getInstance().isEnabled(LogLevel::DEBUG)) {
+        std::cout << "ECU is destroyed; remaining ECU count is " << ECU_Count << std::endl; 
+    }
 }
 
 /**
  * @brief Constructor for the ECU class.
  * 
  * Initializes the ECU object, increments the count of ECUs,
- * and assigns a unique ID to the ECU.
+ * and takes a unique ID from the ECU registry.
+ * 
+ * @param kind The kind of the ECU.
  */
-ECU::ECU() : Recent_Sensory_Data(Sensor_Types_Count) {
+ECU::ECU(ECUTypes kind) : ECU_Handle(Registry().Register(this)), ECU_ID((int)ECU_Handle.id), ECU_Kind(kind) {
     ECU_Count++;  
-    ECU_ID = ECU_Count; 
-    std::cout << "A new ECU is created; the ECU count is " << ECU_Count << std::endl; 
+    CarMetrics::get().ecus->Add(1); 
+    if (Logger::getInstance().isEnabled(LogLevel::DEBUG)) {
+        std::cout << "A new ECU is created; the ECU count is " << ECU_Count << std::endl; 
+    }
+}
+
+/**
+ * @brief Store a new sample from a subscribed sensor.
+ * 
+ * The history entry is created on the first sample of a sensor; every later
+ * sample is written into its fixed-size ring and rollups without allocating.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param sensorID The ID of the sensor that produced the sample.
+ * @param value The sample value.
+ */
+void ECU::RecordSample(int sensorType, int sensorID, double value) {
+    const TimestampNs now = SampleNowNs(); 
+    CarMetrics::get().ecuSamples->Increment(); 
+    Recent_Sensory_Data[sensorType][sensorID] = ToStoredSample(value, sensorType); 
+
+    auto it = Sensory_History[sensorType].find(sensorID); 
+    if (it == Sensory_History[sensorType].end()) {
+        it = Sensory_History[sensorType].emplace(sensorID, SensorHistory(sensorType)).first; 
+    }
+    it->second.record(now, value); 
+    OnSample(sensorType, sensorID, value, now); 
+}
+
+/**
+ * @brief Default sample hook; the base ECU has nothing more to do.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param sensorID The ID of the sensor that produced the sample.
+ * @param value The sample value.
+ * @param time The timestamp the sample was recorded with.
+ */
+void ECU::OnSample(int /* sensorType */, int /* sensorID */, double /* value */, TimestampNs /* time */) {
+}
+
+/**
+ * @brief Drops the latest value and the history of a sensor.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param sensorID The ID of the sensor.
+ */
+void ECU::ForgetSensor(int sensorType, int sensorID) {
+    Recent_Sensory_Data[sensorType].erase(sensorID); 
+    Sensory_History[sensorType].erase(sensorID); 
+}
+
+/**
+ * @brief Get the history kept for one sensor.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param sensorID The ID of the sensor.
+ * @return const SensorHistory* The history, or nullptr if the sensor never reported.
+ */
+const SensorHistory* ECU::GetSensorHistory(int sensorType, int sensorID) const {
+    auto it = Sensory_History[sensorType].find(sensorID); 
+    return it == Sensory_History[sensorType].end() ? nullptr : &it->second; 
+}
+
+/**
+ * @brief Takes up the last value a sensor delivered before a checkpoint.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param sensorID The ID of the sensor.
+ * @param value The value last delivered.
+ */
+void ECU::RestoreRecentSample(int sensorType, int sensorID, double value) {
+    Recent_Sensory_Data[sensorType][sensorID] = ToStoredSample(value, sensorType); 
+}
+
+/**
+ * @brief Creates the history of every sensor that has reported but has none yet.
+ */
+void ECU::CreateSampleHistories() {
+    for (int type = 0; type < Sensor_Types_Count; type++) {
+        for (const auto& entry : Recent_Sensory_Data[type]) {
+            Sensory_History[type].try_emplace(entry.first, type); 
+        }
+    }
+}
+
+/**
+ * @brief Get the latest value reported by one sensor.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param sensorID The ID of the sensor.
+ * @param value Receives the value if the sensor has reported.
+ * @return true if the sensor has reported.
+ */
+bool ECU::GetRecentSample(int sensorType, int sensorID, double& value) const {
+    auto it = Recent_Sensory_Data[sensorType].find(sensorID); 
+    if (it == Recent_Sensory_Data[sensorType].end()) {
+        return false; 
+    }
+    value = FromStoredSample(it->second, sensorType); 
+    return true; 
+}
+
+/**
+ * @brief Get the rollup of a recent time window for one sensor.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param sensorID The ID of the sensor.
+ * @param window Which rollup window to query.
+ * @return WindowStats The aggregate; count is 0 if the sensor never reported.
+ */
+WindowStats ECU::QueryWindow(int sensorType, int sensorID, RollupWindowId window) const {
+    const SensorHistory* h = GetSensorHistory(sensorType, sensorID); 
+    if (h == nullptr) {
+        return WindowStats{0, 0.0, 0.0, 0.0}; 
+    }
+    return h->window(window, SampleNowNs()); 
+}
+
+/**
+ * @brief Get the rollup of a recent time window across all sensors of one type.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param window Which rollup window to query.
+ * @return WindowStats The combined aggregate of every sensor of that type.
+ */
+WindowStats ECU::QueryWindow(int sensorType, RollupWindowId window) const {
+    const TimestampNs now = SampleNowNs(); 
+    WindowStats result{0, 0.0, 0.0, 0.0}; 
+    for (const auto& entry : Sensory_History[sensorType]) {
+        WindowStats w = entry.second.window(window, now); 
+        if (w.count == 0) {
+            continue; 
+        }
+        if (result.count == 0) {
+            result = w; 
+            continue; 
+        }
+        result.count += w.count; 
+        result.min = std::min(result.min, w.min); 
+        result.max = std::max(result.max, w.max); 
+        result.sum += w.sum; 
+    }
+    return result; 
 }
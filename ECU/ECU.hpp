@@ -3,10 +3,14 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <vector>
 #include <unordered_map> 
-#include "/home/abdalla/EmbeddedLINUX_Projects/CAR_ECU_CPP_PROJECT/logger/CarLogger.hpp"
+#include <array>
+#include "../logger/CarLogger.hpp"
+#include "../telemetry/SensorHistory.hpp"
+#include "../car/ObjectRegistry.hpp"
 #include <sstream>
 #include <atomic>
 
@@ -17,6 +21,18 @@ class Car;
 class Sensor; 
 class ECU; // Forward declaration
 
+/**
+ * @enum ECUTypes
+ * @brief The kinds of ECU; an ECU's type is compared by this tag, never by name.
+ */
+enum class ECUTypes {
+    ADAPTIVE_CRUISE_CONTROL_ECU = 0, /**< Adaptive_Cruise_Control_ECU */
+    DIAGNOSTIC_ECU = 1,              /**< DiagnosticECU */
+    SENSOR_FUSION_ECU = 2            /**< SensorFusionECU */
+};
+
+#define ECU_Types_Count 3 // Number of ECUTypes values
+
 /**
  * @brief Abstract observer class for ECU.
  */
@@ -47,8 +63,12 @@ public:
  */
 class ECU : public EObserver {
 public: 
-    // Constructor
-    ECU(); 
+    /**
+     * @brief Constructor for the ECU class.
+     * 
+     * @param kind The kind of the ECU, fixed for its lifetime.
+     */
+    explicit ECU(ECUTypes kind); 
 
     // Destructor
     virtual ~ECU();  
@@ -67,19 +87,51 @@ public:
      */
     static int getECUCount();
 
+    /**
+     * @brief Get the ECU's ID together with its generation.
+     * 
+     * @return RegistryHandle The handle; Registry().Find(handle) resolves it while the ECU lives.
+     */
+    RegistryHandle getHandle() const;
+
+    /**
+     * @brief Get the registry every ECU takes its ID from.
+     * 
+     * IDs are dense and reused after an ECU is destroyed, so a destroyed ECU
+     * never leaves two live ECUs sharing an ID. Lookups take no lock.
+     * 
+     * @return ObjectRegistry<ECU>& The process-wide ECU registry.
+     */
+    static ObjectRegistry<ECU>& Registry();
+
+    /**
+     * @brief Get the kind of the ECU.
+     * 
+     * @return ECUTypes The kind; use it, not the name, to tell ECUs apart.
+     */
+    ECUTypes getKind() const;
+
     /**
      * @brief Get the name of the ECU.
      * 
-     * @return std::string The name of the ECU.
+     * @return std::string_view The name of its kind, from a static table; nothing is copied.
      */
-    virtual std::string getName() const = 0;
+    std::string_view getName() const;
+
+    /**
+     * @brief Get the name of a kind of ECU.
+     * 
+     * @param kind The kind.
+     * @return std::string_view The name, valid for the whole program.
+     */
+    static std::string_view TypeName(ECUTypes kind);
 
     /**
      * @brief Perform the specific function of the ECU based on a given car state.
      * 
-     * @param c The current state of the car.
+     * @param c The car the ECU belongs to; passed by reference so no copy is made.
      */
-    virtual void PerformFunction(Car c) = 0;
+    virtual void PerformFunction(Car& c) = 0;
 
     // Deleted copy constructor
     ECU(const ECU&) = delete; 
@@ -107,13 +159,116 @@ public:
      */
     virtual void DeattachSensor(std::shared_ptr<Sensor> s) = 0;  
 
-    // The index of the vector is the sensor type
-    std::vector<std::unordered_map<int, double>> Recent_Sensory_Data; 
+    /**
+     * @brief Store a new sample from a subscribed sensor.
+     * 
+     * Updates the latest value in Recent_Sensory_Data and appends the sample
+     * to the sensor's history and rollups.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param sensorID The ID of the sensor that produced the sample.
+     * @param value The sample value.
+     */
+    void RecordSample(int sensorType, int sensorID, double value);
+
+    /**
+     * @brief Get the history kept for one sensor.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param sensorID The ID of the sensor.
+     * @return const SensorHistory* The history, or nullptr if the sensor never reported.
+     */
+    const SensorHistory* GetSensorHistory(int sensorType, int sensorID) const;
+
+    /**
+     * @brief Takes up the last value a sensor delivered before a checkpoint.
+     * 
+     * Histories are not saved; the sensor's is created by its next sample,
+     * as for a new subscription, so a restored fleet only pays for the
+     * histories it goes on to fill.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param sensorID The ID of the sensor.
+     * @param value The value last delivered.
+     */
+    void RestoreRecentSample(int sensorType, int sensorID, double value);
+
+    /**
+     * @brief Creates the history of every sensor that has reported but has none yet.
+     * 
+     * After a restore, a slow sensor may not report again for many ticks;
+     * this creates its history up front, so no later sample allocates.
+     */
+    void CreateSampleHistories();
+
+    /**
+     * @brief Get the latest value reported by one sensor.
+     * 
+     * Decodes the value when the tables are built with CARECU_COMPACT_SAMPLES.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param sensorID The ID of the sensor.
+     * @param value Receives the value if the sensor has reported.
+     * @return true if the sensor has reported.
+     */
+    bool GetRecentSample(int sensorType, int sensorID, double& value) const;
+
+    /**
+     * @brief Get the rollup of a recent time window for one sensor.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param sensorID The ID of the sensor.
+     * @param window Which rollup window to query.
+     * @return WindowStats The aggregate; count is 0 if the sensor never reported.
+     */
+    WindowStats QueryWindow(int sensorType, int sensorID, RollupWindowId window) const;
+
+    /**
+     * @brief Get the rollup of a recent time window across all sensors of one type.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param window Which rollup window to query.
+     * @return WindowStats The combined aggregate of every sensor of that type.
+     */
+    WindowStats QueryWindow(int sensorType, RollupWindowId window) const;
+
+    // The index of the array is the sensor type, the key is the sensor ID. An ECU
+    // hears from a handful of sensors whose IDs span the whole fleet, so a map
+    // stays small where a table indexed by the dense ID would be fleet-sized.
+    std::array<std::unordered_map<int, StoredSample>, Sensor_Types_Count> Recent_Sensory_Data; 
+
+    // The index of the array is the sensor type, the key is the sensor ID
+    std::array<std::unordered_map<int, SensorHistory>, Sensor_Types_Count> Sensory_History; 
 
 protected:   
-    int ECU_ID; /**< Unique identifier for the ECU. */
-    static std::atomic<int> ECU_Count; /**< Static variable to keep track of the number of ECUs created. */
-    std::string name; /**< Name of the ECU. */
+    /**
+     * @brief Hook called by RecordSample after a sample has been stored.
+     * 
+     * The default does nothing; derived ECUs override it to process samples as they arrive.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param sensorID The ID of the sensor that produced the sample.
+     * @param value The sample value.
+     * @param time The timestamp the sample was recorded with.
+     */
+    virtual void OnSample(int sensorType, int sensorID, double value, TimestampNs time); 
+
+    /**
+     * @brief Drops everything kept for a sensor; called when it is detached.
+     * 
+     * Sensor IDs are reused once a sensor is destroyed, and a subscribed
+     * sensor cannot be destroyed, so forgetting it on detach keeps a later
+     * sensor with the same ID from inheriting its samples and history.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param sensorID The ID of the sensor.
+     */
+    virtual void ForgetSensor(int sensorType, int sensorID); 
+
+    const RegistryHandle ECU_Handle; /**< ID and generation from the ECU registry. */
+    const int ECU_ID; /**< Unique identifier for the ECU, ECU_Handle.id. */
+    static std::atomic<int> ECU_Count; /**< Static variable to keep track of the number of live ECUs. */
+    const ECUTypes ECU_Kind; /**< Kind of the ECU. */
     std::vector<std::shared_ptr<Sensor>> Subscribed_Sensors; /**< List of subscribed sensors. */
 };
 
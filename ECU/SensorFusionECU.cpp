@@ -0,0 +1,172 @@
+#include "SensorFusionECU.hpp"
+#include "../logger/CarLogger.hpp"
+#include "../Sensors/Sensor.hpp"
+#include "../car/Car.hpp"
+
+/**
+ * @brief Constructor for the SensorFusionECU class.
+ * 
+ * @param config Noise settings of the filter.
+ */
+SensorFusionECU::SensorFusionECU(const RangeFilterConfig& config) 
+    : ECU(ECUTypes::SENSOR_FUSION_ECU), Filter(config), Fused_Range(0.0), Closing_Rate(0.0), Has_Estimate(false) {
+}
+
+/**
+ * @brief Destructor for the SensorFusionECU class.
+ * 
+ * Logs the destruction of the ECU.
+ */
+SensorFusionECU::~SensorFusionECU() {
+    if (Logger::getInstance().isEnabled()) {
+        Logger::getInstance().log(std::string(getName()) + " is destroyed");
+    }
+}
+
+/**
+ * @brief Attaches a sensor to the fusion ECU.
+ * 
+ * Only speed and radar sensors are used; other samples are stored but not fused.
+ * 
+ * @param s A shared pointer to the sensor to be attached.
+ */
+void SensorFusionECU::AttachSensor(std::shared_ptr<Sensor> s) {
+    // Check if the sensor is already subscribed
+    for (const auto& sensor : Subscribed_Sensors) {
+        if (sensor == s) {
+            if (Logger::getInstance().isEnabled()) {
+                Logger::getInstance().log(std::string(s->getType()) + " of ID " + std::to_string(s->getSensorID()) + " is already subscribed.");
+            }
+            return; // Exit if the sensor is already subscribed
+        }
+    }
+
+    Subscribed_Sensors.push_back(s);
+    if (Logger::getInstance().isEnabled()) {
+        Logger::getInstance().log("A new " + std::string(s->getType()) + " is subscribed to Sensor Fusion.");
+    }
+}
+
+/**
+ * @brief Detaches a sensor from the fusion ECU and forgets its samples.
+ * 
+ * @param s A shared pointer to the sensor to be detached.
+ */
+void SensorFusionECU::DeattachSensor(std::shared_ptr<Sensor> s) {
+    auto it = Subscribed_Sensors.begin();
+    while (it != Subscribed_Sensors.end()) {
+        if ((*it)->getSensorID() == s->getSensorID() && (*it)->getKind() == s->getKind()) {
+            it = Subscribed_Sensors.erase(it);  // Erase and update iterator
+            ForgetSensor((int)s->getKind(), s->getSensorID()); 
+            Logger::getInstance().log(std::string(s->getType()) + " of ID " + std::to_string(s->getSensorID()) + " is erased successfully from Sensor Fusion.");
+            return; // Return after successful deletion
+        } else {
+            ++it; // Move to the next sensor
+        }
+    }
+
+    Logger::getInstance().log("Couldn't detach the sensor from Sensor Fusion.");
+}
+
+/**
+ * @brief Feeds speed and radar samples to the filter.
+ * 
+ * Each car has one speed and one radar sensor, so the sensor ID is not used.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param value The sample value.
+ * @param time The timestamp the sample was recorded with.
+ */
+void SensorFusionECU::OnSample(int sensorType, int /* sensorID */, double value, TimestampNs time) {
+    if (sensorType == (int)SensorTypes::SPEED_SENSOR) {
+        Filter.OnSpeed(value); 
+        return; 
+    }
+    if (sensorType != (int)SensorTypes::RADAR_SENSOR) {
+        return; 
+    }
+    Filter.OnRadar(value, time); 
+    Fused_Range.store(Filter.getRange(), std::memory_order_relaxed); 
+    Closing_Rate.store(Filter.getClosingRate(), std::memory_order_relaxed); 
+    Has_Estimate.store(true, std::memory_order_release); 
+}
+
+/**
+ * @brief Logs the fused range, closing rate and time to collision.
+ * 
+ * @param c The car the ECU belongs to.
+ */
+void SensorFusionECU::PerformFunction(Car& c) {
+    if (!hasEstimate() || !Logger::getInstance().isEnabled()) {
+        return; 
+    }
+    std::ostringstream oss; 
+    oss << "Sensor fusion: obstacle at " << getRange() << " m, closing at " << getClosingRate() << " m/s"; 
+    if (getClosingRate() > 0.0) {
+        oss << ", " << getRange() / getClosingRate() << " s to collision"; 
+    }
+    oss << " (" << Filter.getRejected() << " of " << Filter.getReadings() << " radar samples rejected)"; 
+    if (getRange() < c.getLimits().safeRadarDistance) {
+        oss << ", inside the " << c.getLimits().safeRadarDistance << " m gap"; 
+    }
+    Logger::getInstance().log(oss.str()); 
+}
+
+/**
+ * @brief Checks whether a radar sample has been fused yet.
+ * 
+ * @return true once the estimate exists.
+ */
+bool SensorFusionECU::hasEstimate() const {
+    return Has_Estimate.load(std::memory_order_acquire); 
+}
+
+/**
+ * @brief Gets the fused range to the obstacle ahead.
+ * 
+ * @return double Metres.
+ */
+double SensorFusionECU::getRange() const {
+    return Fused_Range.load(std::memory_order_relaxed); 
+}
+
+/**
+ * @brief Gets the fused closing rate.
+ * 
+ * @return double Metres per second; positive while the gap shrinks.
+ */
+double SensorFusionECU::getClosingRate() const {
+    return Closing_Rate.load(std::memory_order_relaxed); 
+}
+
+/**
+ * @brief Gets the state of the range filter.
+ * 
+ * @param now The current time, which the last radar step's age is taken from.
+ * @return RangeFilterState The state.
+ */
+RangeFilterState SensorFusionECU::getFilterState(TimestampNs now) const {
+    return Filter.getState(now); 
+}
+
+/**
+ * @brief Takes up a saved filter state and publishes its estimate.
+ * 
+ * @param state The state.
+ * @param now The current time, which the last radar step is placed before.
+ */
+void SensorFusionECU::RestoreFilterState(const RangeFilterState& state, TimestampNs now) {
+    Filter.setState(state, now); 
+    Fused_Range.store(Filter.getRange(), std::memory_order_relaxed); 
+    Closing_Rate.store(Filter.getClosingRate(), std::memory_order_relaxed); 
+    Has_Estimate.store(Filter.hasEstimate(), std::memory_order_release); 
+}
+
+/**
+ * @brief Retrieves the ID of this ECU.
+ * 
+ * @return int The ID of the ECU.
+ */
+int SensorFusionECU::getID() const {
+    return ECU_ID; 
+}
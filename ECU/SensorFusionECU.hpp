@@ -0,0 +1,116 @@
+#ifndef SENSOR_FUSION_ECU_h 
+#define SENSOR_FUSION_ECU_h 
+
+#include "ECU.hpp"
+#include "../fusion/RangeFilter.hpp"
+
+// Forward declaration
+class Car;
+
+/**
+ * @brief ECU that fuses the radar and speed samples into a filtered range and closing rate.
+ * 
+ * @details Radar samples go through a constant-velocity RangeFilter, with
+ * the car's own speed changes as a known input, so one noisy radar sample
+ * is gated out instead of reaching the collision check. The estimate is
+ * published through atomics and may be read from any thread.
+ */
+class SensorFusionECU : public ECU {
+public:
+    /**
+     * @brief Constructor for the SensorFusionECU class.
+     * 
+     * @param config Noise settings of the filter.
+     */
+    explicit SensorFusionECU(const RangeFilterConfig& config = RangeFilterConfig::Defaults());
+
+    /**
+     * @brief Attaches a sensor to this ECU.
+     * 
+     * @param s A shared pointer to the sensor to be attached.
+     */
+    void AttachSensor(std::shared_ptr<Sensor> s) override;
+
+    /**
+     * @brief Detaches a sensor from this ECU.
+     * 
+     * @param s A shared pointer to the sensor to be detached.
+     */
+    void DeattachSensor(std::shared_ptr<Sensor> s) override;
+
+    /**
+     * @brief Retrieves the ID of this ECU.
+     * 
+     * @return int The ID of the ECU.
+     */
+    int getID() const override;
+
+    /**
+     * @brief Logs the fused range, closing rate and time to collision.
+     * 
+     * @param c The car the ECU belongs to.
+     */
+    void PerformFunction(Car& c) override;
+
+    /**
+     * @brief Destructor for the SensorFusionECU class.
+     */
+    ~SensorFusionECU();
+
+    /**
+     * @brief Checks whether a radar sample has been fused yet.
+     * 
+     * @return true once the estimate exists.
+     */
+    bool hasEstimate() const;
+
+    /**
+     * @brief Gets the fused range to the obstacle ahead.
+     * 
+     * @return double Metres.
+     */
+    double getRange() const;
+
+    /**
+     * @brief Gets the fused closing rate.
+     * 
+     * @return double Metres per second; positive while the gap shrinks.
+     */
+    double getClosingRate() const;
+
+    /**
+     * @brief Gets the state of the range filter.
+     * 
+     * Only the thread delivering samples may call it while samples flow.
+     * 
+     * @param now The current time, which the last radar step's age is taken from.
+     * @return RangeFilterState The state.
+     */
+    RangeFilterState getFilterState(TimestampNs now) const;
+
+    /**
+     * @brief Takes up a saved filter state and publishes its estimate.
+     * 
+     * @param state The state.
+     * @param now The current time, which the last radar step is placed before.
+     */
+    void RestoreFilterState(const RangeFilterState& state, TimestampNs now);
+
+protected:
+    /**
+     * @brief Feeds speed and radar samples to the filter.
+     * 
+     * @param sensorType The sensor type (index of SensorTypes).
+     * @param value The sample value.
+     * @param time The timestamp the sample was recorded with.
+     */
+    void OnSample(int sensorType, int /* sensorID */, double value, TimestampNs time) override;
+
+private:
+    RangeFilter Filter; ///< The range filter; written by the thread delivering samples
+    std::atomic<double> Fused_Range; ///< Filter range as of the last radar sample
+    std::atomic<double> Closing_Rate; ///< Filter closing rate as of the last radar sample
+    std::atomic<bool> Has_Estimate; ///< Whether a radar sample has been fused
+};
+
+#endif // !SENSOR_FUSION_ECU_h 
@@ -1,29 +1,24 @@
 #include "BatteryLevelSensor.hpp" 
+#include "../metrics/CarMetrics.hpp"
 #include "Sensor.hpp"
 #include <random>
 
-int BatteryLevelSensor::BL_Sensor_Count = 0;
-std::default_random_engine eb(std::chrono::system_clock::now().time_since_epoch().count());
+std::atomic<int> BatteryLevelSensor::BL_Sensor_Count{0};
 std::uniform_real_distribution<double> unifb(0, 100);
 
 BatteryLevelSensor::~BatteryLevelSensor() {
     BL_Sensor_Count--;
-    Sensor::total_sensor_count--; // Shared variable may add a mutex or do an atomic operation
+    CarMetrics::get().sensors->Add(-1);
 
+    if (!Logger::getInstance().isEnabled()) {
+        return; // Skip building the message when logging is suppressed
+    }
     std::ostringstream oss;
-    oss << "Sensor of type " << type << " & ID = " << Sensor_ID 
+    oss << "Sensor of type " << getType() << " & ID = " << Sensor_ID 
         << " is destroyed. Remaining count is " << BL_Sensor_Count;
     Logger::getInstance().log(oss.str());
 }
 
-/**
- * @brief Gets the type of the battery level sensor.
- * @return A string representing the sensor type.
- */
-std::string BatteryLevelSensor::getType() {
-    return type;  
-}
-
 /**
  * @brief Gets the unique sensor ID.
  * @return The sensor ID.
@@ -44,6 +39,7 @@ int BatteryLevelSensor::getSensorCount() const {
  * @brief Reads the sensor data and updates the battery level.
  */
 void BatteryLevelSensor::sensorRead() {
+    CarMetrics::get().sensorReads[(int)SensorTypes::BATTERY_LEVEL_SENSOR]->Increment();
     getRandomData(); // Call the random generator to randomize a BatteryLevel and update it 
 }
 
@@ -52,8 +48,8 @@ void BatteryLevelSensor::sensorRead() {
  * @return A random battery level value between 0 and 100.
  */
 double BatteryLevelSensor::getRandomData() {
-    double randomBatteryLevel = unifb(eb); 
-    this->BatteryLevel = randomBatteryLevel; // Update the current BatteryLevel 
+    double randomBatteryLevel = unifb(Random_Engine); 
+    this->BatteryLevel.store(randomBatteryLevel, std::memory_order_relaxed); // Update the current BatteryLevel 
     return randomBatteryLevel; 
 }
 
@@ -63,7 +59,7 @@ double BatteryLevelSensor::getRandomData() {
  */
 double BatteryLevelSensor::GetSensorData() {
     sensorRead();                               
-    return BatteryLevel; 
+    return BatteryLevel.load(std::memory_order_relaxed);
 }
 
 /**
@@ -80,9 +76,14 @@ void BatteryLevelSensor::PrintInfo() {
 /**
  * @brief Constructs a BatteryLevelSensor object.
  */
-BatteryLevelSensor::BatteryLevelSensor() : Sensor_ID(++BL_Sensor_Count), BatteryLevel(0.0) {
-    PrintInfo(); 
-    Sensor::total_sensor_count++; 
+BatteryLevelSensor::BatteryLevelSensor() : Sensor(SensorTypes::BATTERY_LEVEL_SENSOR), BatteryLevel(0.0) {
+    BL_Sensor_Count++;
+    // Battery level drifts slowly: one percent deadband, refresh at least every 30 s
+    Default_Policy = NotificationPolicy{1.0, 0.0, 0, 30000000000LL};
+    if (Logger::getInstance().isEnabled()) {
+        PrintInfo();
+    }
+    CarMetrics::get().sensors->Add(1); 
 }
 
 /**
@@ -94,15 +95,21 @@ void BatteryLevelSensor::AttachECU(std::weak_ptr<ECU> Ecu) {
         for (const auto& subscribedEcu : Subscribed_ECUs) {
             if (std::shared_ptr<ECU> existingEcu = subscribedEcu.lock()) {
                 if (existingEcu->getID() == sharedEcu->getID()) {
-                    std::ostringstream oss;
-                    oss << "ECU " << existingEcu->getName() << " is already subscribed.";
-                    Logger::getInstance().log(oss.str());
+                    if (Logger::getInstance().isEnabled()) {
+                        std::ostringstream oss;
+                        oss << "ECU " << existingEcu->getName() << " is already subscribed.";
+                        Logger::getInstance().log(oss.str());
+                    }
                     return;  // Exit if ECU is already subscribed
                 }
             }
         }
 
         Subscribed_ECUs.push_back(Ecu);
+        Subscription_Filters.push_back(DeadbandFilter(Default_Policy));
+        if (!Logger::getInstance().isEnabled()) {
+            return;
+        }
         std::ostringstream oss;
         oss << "A new ECU: " << sharedEcu->getName() 
             << " subscribes to this " << this->getType() << " sensor.";
@@ -121,7 +128,8 @@ void BatteryLevelSensor::DeAttachECU(std::weak_ptr<ECU> Ecu) {
         auto it = Subscribed_ECUs.begin();
         while (it != Subscribed_ECUs.end()) {
             if (std::shared_ptr<ECU> e = it->lock()) {
-                if (e->getID() == sharedECU->getID() && e->getName() == sharedECU->getName()) {
+                if (e->getID() == sharedECU->getID() && e->getKind() == sharedECU->getKind()) {
+                    Subscription_Filters.erase(Subscription_Filters.begin() + (it - Subscribed_ECUs.begin()));
                     it = Subscribed_ECUs.erase(it);  // Reassign the iterator after erasing
                     std::ostringstream oss;
                     oss << sharedECU->getName() << " was successfully detached.";
@@ -150,12 +158,14 @@ void BatteryLevelSensor::DeAttachECU(std::weak_ptr<ECU> Ecu) {
  */
 void BatteryLevelSensor::updateECU(std::weak_ptr<ECU> E) {
     if (std::shared_ptr<ECU> e = E.lock()) {
-        e->Recent_Sensory_Data[int(SensorTypes::BATTERY_LEVEL_SENSOR)][Sensor_ID] = BatteryLevel;
+        e->RecordSample(int(SensorTypes::BATTERY_LEVEL_SENSOR), Sensor_ID, BatteryLevel.load(std::memory_order_relaxed));
 
-        std::ostringstream oss;
-        oss << "Updated ECU: " << e->getName() << " with Sensor type " 
-            << type << " ID: " << Sensor_ID;
-        Logger::getInstance().log(oss.str());
+        if (Logger::getInstance().isEnabled()) {
+            std::ostringstream oss;
+            oss << "Updated ECU: " << e->getName() << " with Sensor type " 
+                << getType() << " ID: " << Sensor_ID;
+            Logger::getInstance().log(oss.str());
+        }
     } else {
         Logger::getInstance().log("ECU object no longer exists.");
     }
@@ -163,10 +173,16 @@ void BatteryLevelSensor::updateECU(std::weak_ptr<ECU> E) {
 
 /**
  * @brief Notifies all attached ECUs of the latest sensor data.
+ * 
+ * Subscribers whose notification policy holds the value back are skipped.
  */
 void BatteryLevelSensor::NotifyAllECUs() {
-    for (const auto& s : Subscribed_ECUs) {
-        updateECU(s); // Update all the list of the subscribed ECUs 
+    const TimestampNs now = SampleNowNs();
+    const double value = BatteryLevel.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < Subscribed_ECUs.size(); i++) {
+        if (ShouldNotify(i, value, now)) {
+            updateECU(Subscribed_ECUs[i]); // Update all the list of the subscribed ECUs 
+        }
     }
 }
 
@@ -175,5 +191,23 @@ void BatteryLevelSensor::NotifyAllECUs() {
  * @return The total count of sensors.
  */
 int BatteryLevelSensor::getTotalSensorsCount() {
-    return Sensor::total_sensor_count; 
+    return (int)CarMetrics::get().sensors->value(); 
+}
+
+/**
+ * @brief Gets the last battery level without taking a new reading.
+ * 
+ * @return The battery level.
+ */
+double BatteryLevelSensor::getCurrentValue() const {
+    return BatteryLevel.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Replaces the last battery level without notifying anyone.
+ * 
+ * @param value The battery level.
+ */
+void BatteryLevelSensor::setCurrentValue(double value) {
+    BatteryLevel.store(value, std::memory_order_relaxed);
 }
@@ -50,11 +50,6 @@ public:
      */
     void PrintInfo() override;
 
-    /**
-     * @brief Gets the type of the sensor.
-     * @return A string representing the sensor type.
-     */
-    std::string getType() override;
 
     // Deleted copy constructor
     BatteryLevelSensor(const BatteryLevelSensor&) = delete;
@@ -97,10 +92,24 @@ public:
      */
     virtual int getTotalSensorsCount() override;
 
+protected:
+    /** 
+     * @brief Gets the last battery level without taking a new reading.
+     * 
+     * @return The battery level.
+     */
+    double getCurrentValue() const override;
+
+    /** 
+     * @brief Replaces the last battery level without notifying anyone.
+     * 
+     * @param value The battery level.
+     */
+    void setCurrentValue(double value) override;
+
 private:
-    double BatteryLevel; ///< The current battery level.
-    static int BL_Sensor_Count; ///< The total number of battery level sensors created.
-    const int Sensor_ID; ///< The unique ID for this battery level sensor.
+    std::atomic<double> BatteryLevel; ///< The current battery level.
+    static std::atomic<int> BL_Sensor_Count; ///< The total number of battery level sensors created.
 
     /**
      * @brief Generates a random battery level value.
@@ -113,8 +122,6 @@ private:
      * @return A random double value for the sensor.
      */
     double getRandomData() override; // generate random data
-
-    std::string type = "BatteryLevel Sensor"; ///< The type of the sensor.
 };
 
 #endif // !BatteryLevel_SENSOR_H
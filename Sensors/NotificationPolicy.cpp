@@ -0,0 +1,77 @@
+#include "NotificationPolicy.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructs a filter that will deliver the first value it sees.
+ * 
+ * @param policy The rules to apply.
+ */
+DeadbandFilter::DeadbandFilter(const NotificationPolicy& policy)
+    : policy(policy), hasDelivered(false), lastValue(0.0), lastTime(0), 
+      deliveredCount(0), suppressedCount(0) {
+}
+
+/**
+ * @brief Decides whether a value should be delivered and updates the counters.
+ * 
+ * @param value The current sensor value.
+ * @param now The current time.
+ * @return true if the subscriber should be updated.
+ */
+bool DeadbandFilter::shouldDeliver(double value, TimestampNs now) {
+    bool deliver = !hasDelivered; 
+
+    if (!deliver) {
+        const TimestampNs elapsed = now - lastTime; 
+        const double band = std::max(policy.absoluteThreshold, 
+                                     policy.relativeThreshold * std::fabs(lastValue)); 
+        const bool changed = std::fabs(value - lastValue) > band; 
+        const bool stale = policy.maxStaleness > 0 && elapsed >= policy.maxStaleness; 
+        const bool tooSoon = policy.minInterval > 0 && elapsed < policy.minInterval; 
+        deliver = stale || (changed && !tooSoon); 
+    }
+
+    if (!deliver) {
+        suppressedCount++; 
+        return false; 
+    }
+    hasDelivered = true; 
+    lastValue = value; 
+    lastTime = now; 
+    deliveredCount++; 
+    return true; 
+}
+
+/**
+ * @brief Replaces the rules; the delivery history is kept.
+ * 
+ * @param newPolicy The rules to apply from now on.
+ */
+void DeadbandFilter::setPolicy(const NotificationPolicy& newPolicy) {
+    policy = newPolicy; 
+}
+
+/**
+ * @brief Gets what the filter remembers.
+ * 
+ * @param now The current time, which the last delivery's age is taken from.
+ * @return DeadbandState The state.
+ */
+DeadbandState DeadbandFilter::getState(TimestampNs now) const {
+    return DeadbandState{hasDelivered, lastValue, now - lastTime, deliveredCount, suppressedCount}; 
+}
+
+/**
+ * @brief Takes up a saved state; the policy is kept.
+ * 
+ * @param state The state.
+ * @param now The current time, which the last delivery is placed before.
+ */
+void DeadbandFilter::setState(const DeadbandState& state, TimestampNs now) {
+    hasDelivered = state.hasDelivered; 
+    lastValue = state.lastValue; 
+    lastTime = now - state.lastAge; 
+    deliveredCount = state.delivered; 
+    suppressedCount = state.suppressed; 
+}
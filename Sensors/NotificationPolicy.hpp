@@ -0,0 +1,112 @@
+#ifndef NOTIFICATION_POLICY_H
+#define NOTIFICATION_POLICY_H
+
+#include <cstdint>
+#include "../telemetry/SensorHistory.hpp"
+
+/**
+ * @brief Rules deciding when a sensor value is worth sending to a subscriber.
+ * 
+ * @details A value is delivered when it moved by more than the deadband since
+ * the last delivered value. The deadband is the larger of absoluteThreshold and
+ * relativeThreshold * |last delivered value|. Deliveries closer together than
+ * minInterval are held back, and a value is always delivered once the last
+ * delivery is older than maxStaleness. Zero disables a time limit.
+ */
+struct NotificationPolicy {
+    double absoluteThreshold; ///< Minimum absolute change to deliver
+    double relativeThreshold; ///< Minimum change relative to the last delivered value
+    TimestampNs minInterval; ///< Minimum time between deliveries (0 = none)
+    TimestampNs maxStaleness; ///< Force a delivery after this long without one (0 = never)
+};
+
+/**
+ * @brief What a DeadbandFilter remembers, as kept in a checkpoint.
+ * 
+ * @details The time of the last delivery is kept as its age, since
+ * timestamps are only meaningful within one process. The policy is
+ * configuration and not part of it.
+ */
+struct DeadbandState {
+    bool hasDelivered; ///< Whether anything was delivered yet
+    double lastValue; ///< Last delivered value
+    TimestampNs lastAge; ///< Time between the last delivery and the save
+    std::uint64_t delivered; ///< Updates delivered
+    std::uint64_t suppressed; ///< Updates suppressed
+};
+
+/**
+ * @brief Per-subscriber deadband and rate-limit state.
+ */
+class DeadbandFilter {
+public:
+    /**
+     * @brief Constructs a filter that will deliver the first value it sees.
+     * 
+     * @param policy The rules to apply.
+     */
+    explicit DeadbandFilter(const NotificationPolicy& policy);
+
+    /**
+     * @brief Decides whether a value should be delivered and updates the counters.
+     * 
+     * @param value The current sensor value.
+     * @param now The current time.
+     * @return true if the subscriber should be updated.
+     */
+    bool shouldDeliver(double value, TimestampNs now);
+
+    /**
+     * @brief Replaces the rules; the delivery history is kept.
+     * 
+     * @param newPolicy The rules to apply from now on.
+     */
+    void setPolicy(const NotificationPolicy& newPolicy);
+
+    /**
+     * @brief Gets the rules in use.
+     * 
+     * @return const NotificationPolicy& The policy.
+     */
+    const NotificationPolicy& getPolicy() const { return policy; }
+
+    /**
+     * @brief Gets the number of delivered updates.
+     * 
+     * @return std::uint64_t Delivered count.
+     */
+    std::uint64_t delivered() const { return deliveredCount; }
+
+    /**
+     * @brief Gets the number of suppressed updates.
+     * 
+     * @return std::uint64_t Suppressed count.
+     */
+    std::uint64_t suppressed() const { return suppressedCount; }
+
+    /**
+     * @brief Gets what the filter remembers.
+     * 
+     * @param now The current time, which the last delivery's age is taken from.
+     * @return DeadbandState The state.
+     */
+    DeadbandState getState(TimestampNs now) const;
+
+    /**
+     * @brief Takes up a saved state; the policy is kept.
+     * 
+     * @param state The state.
+     * @param now The current time, which the last delivery is placed before.
+     */
+    void setState(const DeadbandState& state, TimestampNs now);
+
+private:
+    NotificationPolicy policy; ///< Rules to apply
+    bool hasDelivered; ///< Whether anything was delivered yet
+    double lastValue; ///< Last delivered value
+    TimestampNs lastTime; ///< When the last value was delivered
+    std::uint64_t deliveredCount; ///< Updates delivered
+    std::uint64_t suppressedCount; ///< Updates suppressed
+};
+
+#endif // !NOTIFICATION_POLICY_H
@@ -1,11 +1,10 @@
 #include "RadarSensor.hpp"
+#include "../metrics/CarMetrics.hpp"
 #include <random>
 
 /// Static member to keep track of the number of RadarSensor instances.
-int RadarSensor::R_sensor_count = 0;
+std::atomic<int> RadarSensor::R_sensor_count{0};
 
-/// Random engine for generating random radar data.
-std::default_random_engine er(std::chrono::system_clock::now().time_since_epoch().count());
 /// Distribution range for radar data.
 std::uniform_real_distribution<double> unifr(0, 50);
 
@@ -15,22 +14,17 @@ std::uniform_real_distribution<double> unifr(0, 50);
  */
 RadarSensor::~RadarSensor() {
     R_sensor_count--;
-    Sensor::total_sensor_count--; // shared variable may add a mutex or do an atomic operation
+    CarMetrics::get().sensors->Add(-1);
 
+    if (!Logger::getInstance().isEnabled()) {
+        return; // Skip building the message when logging is suppressed
+    }
     std::ostringstream oss;
-    oss << "Sensor of type " << type << " & ID = " << Sensor_ID 
+    oss << "Sensor of type " << getType() << " & ID = " << Sensor_ID 
         << " is destroyed. Remaining count is " << R_sensor_count;
     Logger::getInstance().log(oss.str());
 }
 
-/**
- * @brief Gets the type of the radar sensor.
- * @return The type of the sensor as a string.
- */
-std::string RadarSensor::getType() {
-    return type;
-}
-
 /**
  * @brief Gets the sensor ID.
  * @return The ID of the sensor.
@@ -51,6 +45,7 @@ int RadarSensor::getSensorCount() const {
  * @brief Reads data from the sensor by generating random values.
  */
 void RadarSensor::sensorRead() {
+    CarMetrics::get().sensorReads[(int)SensorTypes::RADAR_SENSOR]->Increment();
     getRandomData(); // call the random generator to randomize a Radar and update it
 }
 
@@ -59,8 +54,8 @@ void RadarSensor::sensorRead() {
  * @return The generated random radar data.
  */
 double RadarSensor::getRandomData() {
-    double randomRadar = unifr(er);
-    this->Radar = randomRadar; // update the current Radar
+    double randomRadar = unifr(Random_Engine);
+    this->Radar.store(randomRadar, std::memory_order_relaxed); // update the current Radar
     return randomRadar;
 }
 
@@ -70,7 +65,7 @@ double RadarSensor::getRandomData() {
  */
 double RadarSensor::GetSensorData() {
     sensorRead();
-    return Radar;
+    return Radar.load(std::memory_order_relaxed);
 }
 
 /**
@@ -87,9 +82,14 @@ void RadarSensor::PrintInfo() {
 /**
  * @brief Constructs a new RadarSensor and increments the sensor count.
  */
-RadarSensor::RadarSensor() : Sensor_ID(++R_sensor_count), Radar(0.0) {
-    PrintInfo();
-    Sensor::total_sensor_count++;
+RadarSensor::RadarSensor() : Sensor(SensorTypes::RADAR_SENSOR), Radar(0.0) {
+    R_sensor_count++;
+    // Obstacle distance is safety relevant; deliver any change
+    Default_Policy = NotificationPolicy{0.0, 0.0, 0, 0};
+    if (Logger::getInstance().isEnabled()) {
+        PrintInfo();
+    }
+    CarMetrics::get().sensors->Add(1);
 }
 
 /**
@@ -101,15 +101,21 @@ void RadarSensor::AttachECU(std::weak_ptr<ECU> Ecu) {
         for (const auto& subscribedEcu : Subscribed_ECUs) {
             if (std::shared_ptr<ECU> existingEcu = subscribedEcu.lock()) {
                 if (existingEcu->getID() == sharedEcu->getID()) {
-                    std::ostringstream oss;
-                    oss << "ECU " << existingEcu->getName() << " is already subscribed.";
-                    Logger::getInstance().log(oss.str());
+                    if (Logger::getInstance().isEnabled()) {
+                        std::ostringstream oss;
+                        oss << "ECU " << existingEcu->getName() << " is already subscribed.";
+                        Logger::getInstance().log(oss.str());
+                    }
                     return;  // Exit if ECU is already subscribed
                 }
             }
         }
 
         Subscribed_ECUs.push_back(Ecu);
+        Subscription_Filters.push_back(DeadbandFilter(Default_Policy));
+        if (!Logger::getInstance().isEnabled()) {
+            return;
+        }
         std::ostringstream oss;
         oss << "A new ECU: " << sharedEcu->getName() 
             << " subscribes to this " << this->getType() << " sensor.";
@@ -128,7 +134,8 @@ void RadarSensor::DeAttachECU(std::weak_ptr<ECU> Ecu) {
         auto it = Subscribed_ECUs.begin();
         while (it != Subscribed_ECUs.end()) {
             if (std::shared_ptr<ECU> e = it->lock()) {
-                if (e->getID() == sharedECU->getID() && e->getName() == sharedECU->getName()) {
+                if (e->getID() == sharedECU->getID() && e->getKind() == sharedECU->getKind()) {
+                    Subscription_Filters.erase(Subscription_Filters.begin() + (it - Subscribed_ECUs.begin()));
                     it = Subscribed_ECUs.erase(it);  // Reassign the iterator after erasing
                     std::ostringstream oss;
                     oss << sharedECU->getName() << " was successfully detached.";
@@ -157,11 +164,13 @@ void RadarSensor::DeAttachECU(std::weak_ptr<ECU> Ecu) {
  */
 void RadarSensor::updateECU(std::weak_ptr<ECU> E) {
     if (std::shared_ptr<ECU> e = E.lock()) {
-        e->Recent_Sensory_Data[int(SensorTypes::RADAR_SENSOR)][Sensor_ID] = Radar;
+        e->RecordSample(int(SensorTypes::RADAR_SENSOR), Sensor_ID, Radar.load(std::memory_order_relaxed));
 
-        std::ostringstream oss;
-        oss << "Updated  ECU : "<<e->getName()<<"  with Sensor type " << type<< " ID : " << Sensor_ID ;
-        Logger::getInstance().log(oss.str());
+        if (Logger::getInstance().isEnabled()) {
+            std::ostringstream oss;
+            oss << "Updated  ECU : "<<e->getName()<<"  with Sensor type " << getType() << " ID : " << Sensor_ID ;
+            Logger::getInstance().log(oss.str());
+        }
     } else {
         Logger::getInstance().log("ECU object no longer exists.");
     }
@@ -169,10 +178,16 @@ void RadarSensor::updateECU(std::weak_ptr<ECU> E) {
 
 /**
  * @brief Notifies all subscribed ECUs with the latest sensor data.
+ * 
+ * Subscribers whose notification policy holds the value back are skipped.
  */
 void RadarSensor::NotifyAllECUs() {
-    for (const auto& s : Subscribed_ECUs) {
-        updateECU(s);  // update all the list of the subscribed ECUs
+    const TimestampNs now = SampleNowNs();
+    const double value = Radar.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < Subscribed_ECUs.size(); i++) {
+        if (ShouldNotify(i, value, now)) {
+            updateECU(Subscribed_ECUs[i]);  // update all the list of the subscribed ECUs
+        }
     }
 }
 
@@ -181,5 +196,23 @@ void RadarSensor::NotifyAllECUs() {
  * @return The total number of sensors.
  */
 int RadarSensor::getTotalSensorsCount(){
-    return Sensor::total_sensor_count; 
+    return (int)CarMetrics::get().sensors->value(); 
+}
+
+/**
+ * @brief Gets the last radar reading without taking a new reading.
+ * 
+ * @return The radar reading.
+ */
+double RadarSensor::getCurrentValue() const {
+    return Radar.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Replaces the last radar reading without notifying anyone.
+ * 
+ * @param value The radar reading.
+ */
+void RadarSensor::setCurrentValue(double value) {
+    Radar.store(value, std::memory_order_relaxed);
 }
@@ -50,11 +50,6 @@ public:
      */
     void PrintInfo() override;
 
-    /**
-     * @brief Gets the type of the sensor.
-     * @return The sensor type as a string.
-     */
-    std::string getType() override;
 
     // Delete copy and move constructors and assignment operators
     RadarSensor(const RadarSensor&) = delete; //delete copy constructor 
@@ -91,18 +86,30 @@ public:
      */
     virtual int getTotalSensorsCount() override;
 
+protected:
+    /** 
+     * @brief Gets the last radar reading without taking a new reading.
+     * 
+     * @return The radar reading.
+     */
+    double getCurrentValue() const override;
+
+    /** 
+     * @brief Replaces the last radar reading without notifying anyone.
+     * 
+     * @param value The radar reading.
+     */
+    void setCurrentValue(double value) override;
+
 private:
-    double Radar;                  ///< Current radar value.
-    static int R_sensor_count;     ///< Static count of radar sensors.
-    const int Sensor_ID;           ///< Unique identifier for the sensor.
+    std::atomic<double> Radar;     ///< Current radar value.
+    static std::atomic<int> R_sensor_count; ///< Static count of radar sensors.
     
     /**
      * @brief Generates random radar data.
      * @return The generated random radar data.
      */
     double getRandomData() override; // generate random data
-
-    std::string type = "Radar Sensor"; ///< Type of the sensor.
 };
 
 #endif // !RADAR_SENSOR_H
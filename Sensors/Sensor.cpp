@@ -0,0 +1,278 @@
+#include "Sensor.hpp"
+#include "../metrics/CarMetrics.hpp"
+#include <chrono>
+
+std::atomic<std::uint64_t> Sensor::seed_base{
+    static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())};
+std::atomic<std::uint64_t> Sensor::seed_sequence{0};
+
+static const std::string_view Sensor_Type_Names[Sensor_Types_Count] = {
+    "Speed Sensor", "Temperature Sensor", "Radar Sensor", "BatteryLevel Sensor"
+}; ///< Name of each SensorTypes value
+
+/**
+ * @brief Constructs a sensor with its own random engine.
+ * 
+ * The sequence number is spread with a 64-bit multiplicative hash so that
+ * consecutive sensors get unrelated streams.
+ * 
+ * @param kind The kind of the sensor.
+ */
+Sensor::Sensor(SensorTypes kind) : Sensor_Handle(Registry().Register(this)), Sensor_ID((int)Sensor_Handle.id), Sensor_Kind(kind) {
+    SeedEngine();
+}
+
+/**
+ * @brief Seeds the engine from the base seed and the next sequence number.
+ */
+void Sensor::SeedEngine() {
+    const std::uint64_t n = seed_sequence.fetch_add(1, std::memory_order_relaxed);
+    const std::uint64_t mixed = seed_base.load(std::memory_order_relaxed) ^ ((n + 1) * 0x9E3779B97F4A7C15ULL);
+    Random_Engine.seed(static_cast<std::minstd_rand0::result_type>(mixed ^ (mixed >> 32)));
+}
+
+/**
+ * @brief Releases the sensor's ID for reuse.
+ */
+Sensor::~Sensor() {
+    Registry().Unregister(Sensor_Handle);
+}
+
+/**
+ * @brief Gets the kind of the sensor.
+ * 
+ * @return SensorTypes The kind.
+ */
+SensorTypes Sensor::getKind() const {
+    return Sensor_Kind;
+}
+
+/**
+ * @brief Gets the type of the sensor.
+ * 
+ * @return std::string_view The name of its kind.
+ */
+std::string_view Sensor::getType() const {
+    return Sensor_Type_Names[(int)Sensor_Kind];
+}
+
+/**
+ * @brief Gets the name of a kind of sensor.
+ * 
+ * @param kind The kind.
+ * @return std::string_view The name.
+ */
+std::string_view Sensor::TypeName(SensorTypes kind) {
+    return Sensor_Type_Names[(int)kind];
+}
+
+/**
+ * @brief Gets the sensor's ID together with its generation.
+ * 
+ * @return RegistryHandle The handle.
+ */
+RegistryHandle Sensor::getHandle() const {
+    return Sensor_Handle;
+}
+
+/**
+ * @brief Gets the registry every sensor takes its ID from.
+ * 
+ * Built on first use, so sensors created during static initialization still find it.
+ * 
+ * @return ObjectRegistry<Sensor>& The process-wide sensor registry.
+ */
+ObjectRegistry<Sensor>& Sensor::Registry() {
+    static ObjectRegistry<Sensor> registry;
+    return registry;
+}
+
+/**
+ * @brief Sets the base seed used for the engines of sensors created afterwards.
+ * 
+ * @param seed The base seed.
+ * @param sequence The sequence number of the next sensor; a restored fleet passes the saved one.
+ */
+void Sensor::SetSeedBase(std::uint64_t seed, std::uint64_t sequence) {
+    seed_base.store(seed, std::memory_order_relaxed);
+    seed_sequence.store(sequence, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the base seed of the sensor engines.
+ * 
+ * @return The base seed.
+ */
+std::uint64_t Sensor::getSeedBase() {
+    return seed_base.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the sequence number the next sensor's engine will be seeded with.
+ * 
+ * @return The sequence number.
+ */
+std::uint64_t Sensor::getSeedSequence() {
+    return seed_sequence.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gives the sensor a fresh engine, seeded like a new sensor's.
+ */
+void Sensor::Reseed() {
+    SeedEngine();
+}
+
+// minstd_rand0 steps x to multiplier * x mod modulus, and the standard only
+// reads x out through the text stream operators. Stepping a copy and
+// multiplying by the inverse of the multiplier gives it back directly.
+static const std::uint64_t Engine_Multiplier_Inverse = 1407677000;
+static_assert(std::minstd_rand0::multiplier * Engine_Multiplier_Inverse % std::minstd_rand0::modulus == 1,
+              "Engine_Multiplier_Inverse must invert the minstd_rand0 multiplier");
+
+/**
+ * @brief Gets what the sensor carries from one sample to the next.
+ * 
+ * Only the first subscriber of each ECU kind is kept.
+ * 
+ * @param now The current time, which delivery ages are taken from.
+ * @return SensorState The state.
+ */
+SensorState Sensor::SaveState(TimestampNs now) const {
+    SensorState state{};
+    state.value = getCurrentValue();
+    std::minstd_rand0 probe = Random_Engine;
+    state.engine = (std::uint64_t)probe() * Engine_Multiplier_Inverse % std::minstd_rand0::modulus;
+    for (std::size_t i = 0; i < Subscribed_ECUs.size(); i++) {
+        const std::shared_ptr<ECU> e = Subscribed_ECUs[i].lock();
+        if (!e || ((state.subscribers >> (int)e->getKind()) & 1)) {
+            continue;
+        }
+        state.subscribers |= 1u << (int)e->getKind();
+        state.filters[(int)e->getKind()] = Subscription_Filters[i].getState(now);
+    }
+    return state;
+}
+
+/**
+ * @brief Takes up a saved state without sampling or notifying.
+ * 
+ * Seeding a linear congruential engine with a number below its modulus
+ * sets its state to that number. Like SaveState, only the first
+ * subscriber of each ECU kind is restored; it gets back the last value
+ * delivered to it, which its notification filter remembers.
+ * 
+ * @param state The state.
+ * @param now The current time, which delivery ages are counted back from.
+ */
+void Sensor::RestoreState(const SensorState& state, TimestampNs now) {
+    setCurrentValue(state.value);
+    Random_Engine.seed(static_cast<std::minstd_rand0::result_type>(state.engine));
+    std::uint32_t pending = state.subscribers;
+    for (std::size_t i = 0; i < Subscribed_ECUs.size(); i++) {
+        const std::shared_ptr<ECU> e = Subscribed_ECUs[i].lock();
+        if (e && ((pending >> (int)e->getKind()) & 1)) {
+            pending &= ~(1u << (int)e->getKind());
+            const DeadbandState& filter = state.filters[(int)e->getKind()];
+            Subscription_Filters[i].setState(filter, now);
+            if (filter.hasDelivered) {
+                e->RestoreRecentSample((int)getKind(), getSensorID(), filter.lastValue);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Sets the notification policy of every current and future subscriber.
+ * 
+ * @param policy The deadband and rate-limit rules to apply.
+ */
+void Sensor::SetNotificationPolicy(const NotificationPolicy& policy) {
+    Default_Policy = policy;
+    for (auto& f : Subscription_Filters) {
+        f.setPolicy(policy);
+    }
+}
+
+/**
+ * @brief Sets the notification policy of one subscriber.
+ * 
+ * @param E A weak pointer to a subscribed ECU.
+ * @param policy The deadband and rate-limit rules to apply.
+ * @return true if the ECU is subscribed to this sensor.
+ */
+bool Sensor::SetNotificationPolicy(std::weak_ptr<ECU> E, const NotificationPolicy& policy) {
+    std::shared_ptr<ECU> target = E.lock();
+    if (!target) {
+        return false;
+    }
+    for (std::size_t i = 0; i < Subscribed_ECUs.size(); i++) {
+        std::shared_ptr<ECU> e = Subscribed_ECUs[i].lock();
+        if (e && e->getID() == target->getID()) {
+            Subscription_Filters[i].setPolicy(policy);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Gets the number of updates this sensor delivered to its subscribers.
+ * 
+ * @return The delivered count summed over the current subscribers.
+ */
+std::uint64_t Sensor::getDeliveredCount() const {
+    std::uint64_t total = 0;
+    for (const auto& f : Subscription_Filters) {
+        total += f.delivered();
+    }
+    return total;
+}
+
+/**
+ * @brief Gets the number of updates this sensor held back from its subscribers.
+ * 
+ * @return The suppressed count summed over the current subscribers.
+ */
+std::uint64_t Sensor::getSuppressedCount() const {
+    std::uint64_t total = 0;
+    for (const auto& f : Subscription_Filters) {
+        total += f.suppressed();
+    }
+    return total;
+}
+
+/**
+ * @brief Gets the number of updates delivered by all sensors.
+ * 
+ * @return The process-wide delivered count.
+ */
+std::uint64_t Sensor::getTotalDeliveredCount() {
+    return CarMetrics::get().notificationsDelivered->value();
+}
+
+/**
+ * @brief Gets the number of updates suppressed by all sensors.
+ * 
+ * @return The process-wide suppressed count.
+ */
+std::uint64_t Sensor::getTotalSuppressedCount() {
+    return CarMetrics::get().notificationsSuppressed->value();
+}
+
+/**
+ * @brief Decides whether the subscriber at an index should receive a value.
+ * 
+ * @param index Index of the subscriber in Subscribed_ECUs.
+ * @param value The current sensor value.
+ * @param now The current time.
+ * @return true if the subscriber should be updated.
+ */
+bool Sensor::ShouldNotify(std::size_t index, double value, TimestampNs now) {
+    if (Subscription_Filters[index].shouldDeliver(value, now)) {
+        CarMetrics::get().notificationsDelivered->Increment();
+        return true;
+    }
+    CarMetrics::get().notificationsSuppressed->Increment();
+    return false;
+}
@@ -12,11 +12,14 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <random>
 #include <atomic>
 #include "../logger/CarLogger.hpp"
 #include "../ECU/ECU.hpp"  // Forward declaration of ECU class
+#include "NotificationPolicy.hpp"
+#include "../car/ObjectRegistry.hpp"
 
 /** 
  * @brief Observer interface for the Observer design pattern.
@@ -63,6 +66,19 @@ enum class SensorTypes {
     BATTERY_LEVEL_SENSOR = 3  /**< Battery level sensor type */
 };
 
+/**
+ * @brief What a sensor carries from one sample to the next, as kept in a checkpoint.
+ * 
+ * @details Subscriber filters are kept by the kind of the subscribed ECU,
+ * so they find their ECU again however the subscriptions were ordered.
+ */
+struct SensorState {
+    double value; ///< Last reading
+    std::uint64_t engine; ///< State of the random engine
+    std::uint32_t subscribers; ///< Bit k set if an ECU of ECUTypes value k is subscribed
+    DeadbandState filters[ECU_Types_Count]; ///< Notification state of each subscriber, indexed by ECUTypes
+};
+
 /**
  * @brief Abstract base class for all sensors.
  * 
@@ -72,7 +88,59 @@ enum class SensorTypes {
  */
 class Sensor : public SObserver {
 public:
-    Sensor() = default;
+    /** 
+     * @brief Construct a sensor with its own random engine.
+     * 
+     * @details Each sensor draws from a private engine so sensors can be
+     * sampled from different threads. Engines are seeded from a base seed and
+     * a per-sensor sequence number. The sensor also takes a dense ID from
+     * the sensor registry.
+     * 
+     * @param kind The kind of the sensor, fixed for its lifetime.
+     */
+    explicit Sensor(SensorTypes kind);
+
+    /** 
+     * @brief Set the base seed used for the engines of sensors created afterwards.
+     * 
+     * @param seed The base seed; the same seed reproduces the same readings.
+     */
+    static void SetSeedBase(std::uint64_t seed, std::uint64_t sequence = 0); 
+
+    /** 
+     * @brief Get the base seed of the sensor engines.
+     * @return The base seed.
+     */
+    static std::uint64_t getSeedBase(); 
+
+    /** 
+     * @brief Get the sequence number the next sensor's engine will be seeded with.
+     * @return The sequence number.
+     */
+    static std::uint64_t getSeedSequence(); 
+
+    /** 
+     * @brief Give the sensor a fresh engine, seeded like a new sensor's.
+     * @details After SetSeedBase, this forks the sensor's readings from
+     * whatever state it was restored to.
+     */
+    void Reseed(); 
+
+    /** 
+     * @brief Get what the sensor carries from one sample to the next.
+     * @param now The current time, which delivery ages are taken from.
+     * @return SensorState The reading, the engine and the notification state of each subscriber.
+     */
+    SensorState SaveState(TimestampNs now) const; 
+
+    /** 
+     * @brief Take up a saved state without sampling or notifying.
+     * @details Filters are restored for the subscribers the sensor has now;
+     * saved ones without a matching subscriber are dropped.
+     * @param state The state.
+     * @param now The current time, which delivery ages are counted back from.
+     */
+    void RestoreState(const SensorState& state, TimestampNs now); 
 
     /** 
      * @brief Generate random sensor data.
@@ -93,7 +161,10 @@ public:
      */
     virtual double GetSensorData() = 0; 
 
-    virtual ~Sensor() = default; // Rule of zero applied
+    /** 
+     * @brief Release the sensor's ID for reuse.
+     */
+    virtual ~Sensor(); 
 
     /** 
      * @brief Print information about the sensor.
@@ -126,12 +197,27 @@ public:
      */
     virtual void NotifyAllECUs() = 0; 
 
+    /** 
+     * @brief Get the kind of the sensor.
+     * 
+     * @return SensorTypes The kind; use it, not the type name, to tell sensors apart.
+     */
+    SensorTypes getKind() const; 
+
     /** 
      * @brief Get the type of the sensor.
      * 
-     * @return A string representing the sensor type.
+     * @return std::string_view The name of its kind, from a static table; nothing is copied.
+     */
+    std::string_view getType() const; 
+
+    /** 
+     * @brief Get the name of a kind of sensor.
+     * 
+     * @param kind The kind.
+     * @return std::string_view The name, valid for the whole program.
      */
-    virtual std::string getType() = 0;   
+    static std::string_view TypeName(SensorTypes kind); 
 
     /** 
      * @brief Get the unique identifier for the sensor.
@@ -140,16 +226,113 @@ public:
      */
     virtual int getSensorID() const = 0;    
 
+    /** 
+     * @brief Get the sensor's ID together with its generation.
+     * 
+     * @return RegistryHandle The handle; Registry().Find(handle) resolves it while the sensor lives.
+     */
+    RegistryHandle getHandle() const; 
+
+    /** 
+     * @brief Get the registry every sensor takes its ID from.
+     * 
+     * @details IDs are shared by all sensor types, dense and reused after a
+     * sensor is destroyed, so tables indexed by sensor ID need only
+     * Registry().getIdLimit() entries. Lookups take no lock.
+     * 
+     * @return ObjectRegistry<Sensor>& The process-wide sensor registry.
+     */
+    static ObjectRegistry<Sensor>& Registry(); 
+
     /** 
      * @brief Get the total count of sensor instances.
      * 
-     * @return An integer representing the total number of sensors.
+     * @return An integer representing the total number of sensors, from the carecu_sensors gauge.
      */
     virtual int getTotalSensorsCount() = 0; 
 
+    /** 
+     * @brief Set the notification policy of every current and future subscriber.
+     * 
+     * @param policy The deadband and rate-limit rules to apply.
+     */
+    void SetNotificationPolicy(const NotificationPolicy& policy); 
+
+    /** 
+     * @brief Set the notification policy of one subscriber.
+     * 
+     * @param E A weak pointer to a subscribed ECU.
+     * @param policy The deadband and rate-limit rules to apply.
+     * @return true if the ECU is subscribed to this sensor.
+     */
+    bool SetNotificationPolicy(std::weak_ptr<ECU> E, const NotificationPolicy& policy); 
+
+    /** 
+     * @brief Get the number of updates this sensor delivered to its subscribers.
+     * 
+     * @return The delivered count summed over the current subscribers.
+     */
+    std::uint64_t getDeliveredCount() const; 
+
+    /** 
+     * @brief Get the number of updates this sensor held back from its subscribers.
+     * 
+     * @return The suppressed count summed over the current subscribers.
+     */
+    std::uint64_t getSuppressedCount() const; 
+
+    /** 
+     * @brief Get the number of updates delivered by all sensors.
+     * 
+     * @return The process-wide delivered count, from carecu_notifications_total.
+     */
+    static std::uint64_t getTotalDeliveredCount(); 
+
+    /** 
+     * @brief Get the number of updates suppressed by all sensors.
+     * 
+     * @return The process-wide suppressed count, from carecu_notifications_total.
+     */
+    static std::uint64_t getTotalSuppressedCount(); 
+
 protected: 
+    /** 
+     * @brief Get the last reading without taking a new one.
+     * @return The reading.
+     */
+    virtual double getCurrentValue() const = 0; 
+
+    /** 
+     * @brief Replace the last reading without notifying anyone.
+     * @param value The reading.
+     */
+    virtual void setCurrentValue(double value) = 0; 
+
+    /** 
+     * @brief Decide whether the subscriber at an index should receive a value.
+     * 
+     * @param index Index of the subscriber in Subscribed_ECUs.
+     * @param value The current sensor value.
+     * @param now The current time.
+     * @return true if the subscriber should be updated.
+     */
+    bool ShouldNotify(std::size_t index, double value, TimestampNs now); 
+
     std::vector<std::weak_ptr<ECU>> Subscribed_ECUs; /**< List of subscribed ECUs */
-    static std::atomic<int> total_sensor_count; /**< Atomic count of total sensor instances */
+    std::vector<DeadbandFilter> Subscription_Filters; /**< Notification state, parallel to Subscribed_ECUs */
+    NotificationPolicy Default_Policy = NotificationPolicy{0.0, 0.0, 0, 0}; /**< Policy given to new subscribers */
+    const RegistryHandle Sensor_Handle; /**< ID and generation from the sensor registry */
+    const int Sensor_ID; /**< Unique identifier for the sensor, Sensor_Handle.id */
+    const SensorTypes Sensor_Kind; /**< Kind of the sensor */
+    std::minstd_rand0 Random_Engine; /**< Private engine for this sensor's readings; minstd_rand0, whose whole state is one number */
+    static std::atomic<std::uint64_t> seed_base; /**< Base seed of the sensor engines */
+    static std::atomic<std::uint64_t> seed_sequence; /**< Sequence number mixed into each seed */
+
+private: 
+    /** 
+     * @brief Seed the engine from the base seed and the next sequence number.
+     */
+    void SeedEngine(); 
 };
 
 #endif  
@@ -1,35 +1,28 @@
 #include "SpeedSensor.hpp"
+#include "../metrics/CarMetrics.hpp"
 #include <memory>
 #include <random>
 #include <utility>
 #include "../ECU/ECU.hpp"
 #include "Sensor.hpp"
 
-int SpeedSensor::S_Sensor_Count = 0;
-std::atomic<int> Sensor::total_sensor_count{0};
+std::atomic<int> SpeedSensor::S_Sensor_Count{0};
 
-std::default_random_engine es(std::chrono::system_clock::now().time_since_epoch().count());
 std::uniform_real_distribution<double> unifs(0, 320);
 
 SpeedSensor::~SpeedSensor() {
     S_Sensor_Count--;
-    Sensor::total_sensor_count--;
+    CarMetrics::get().sensors->Add(-1);
 
+    if (!Logger::getInstance().isEnabled()) {
+        return; // Skip building the message when logging is suppressed
+    }
     std::ostringstream oss;
-    oss << "Sensor of type " << type << " & ID = " << Sensor_ID 
+    oss << "Sensor of type " << getType() << " & ID = " << Sensor_ID 
         << " is destroyed. Remaining count is " << S_Sensor_Count;
     Logger::getInstance().log(oss.str());
 }
 
-/**
- * @brief Gets the type of the sensor.
- * 
- * @return A string representing the type of the speed sensor.
- */
-std::string SpeedSensor::getType() {
-    return type;
-}
-
 /**
  * @brief Gets the ID of the sensor.
  * 
@@ -52,6 +45,7 @@ int SpeedSensor::getSensorCount() const {
  * @brief Reads the sensor data by generating a random speed value.
  */
 void SpeedSensor::sensorRead() {
+    CarMetrics::get().sensorReads[(int)SensorTypes::SPEED_SENSOR]->Increment();
     getRandomData();  // Call the random generator to randomize speed and update it
 }
 
@@ -61,8 +55,8 @@ void SpeedSensor::sensorRead() {
  * @return A double representing the randomly generated speed.
  */
 double SpeedSensor::getRandomData() {
-    double randomSpeed = unifs(es);
-    this->speed = randomSpeed;  // Update the current speed
+    double randomSpeed = unifs(Random_Engine);
+    this->speed.store(randomSpeed, std::memory_order_relaxed);  // Update the current speed
     return randomSpeed;
 }
 
@@ -73,7 +67,7 @@ double SpeedSensor::getRandomData() {
  */
 double SpeedSensor::GetSensorData() {
     sensorRead();
-    return speed; 
+    return speed.load(std::memory_order_relaxed);
 }
 
 /**
@@ -92,9 +86,14 @@ void SpeedSensor::PrintInfo() {
  * 
  * @details Increments the sensor count and logs the sensor information.
  */
-SpeedSensor::SpeedSensor() : Sensor_ID(++S_Sensor_Count), speed(0.0) {
-    PrintInfo();
-    Sensor::total_sensor_count++;  // Make it atomic
+SpeedSensor::SpeedSensor() : Sensor(SensorTypes::SPEED_SENSOR), speed(0.0) {
+    S_Sensor_Count++;
+    // Speed changes every read; deliver any change
+    Default_Policy = NotificationPolicy{0.0, 0.0, 0, 0};
+    if (Logger::getInstance().isEnabled()) {
+        PrintInfo();
+    }
+    CarMetrics::get().sensors->Add(1);
 }
 
 /**
@@ -107,15 +106,21 @@ void SpeedSensor::AttachECU(std::weak_ptr<ECU> Ecu) {
         for (const auto& subscribedEcu : Subscribed_ECUs) {
             if (std::shared_ptr<ECU> existingEcu = subscribedEcu.lock()) {
                 if (existingEcu->getID() == sharedEcu->getID()) {
-                    std::ostringstream oss;
-                    oss << "ECU " << existingEcu->getName() << " is already subscribed.";
-                    Logger::getInstance().log(oss.str());
+                    if (Logger::getInstance().isEnabled()) {
+                        std::ostringstream oss;
+                        oss << "ECU " << existingEcu->getName() << " is already subscribed.";
+                        Logger::getInstance().log(oss.str());
+                    }
                     return;  // Exit if ECU is already subscribed
                 }
             }
         }
 
         Subscribed_ECUs.push_back(Ecu);
+        Subscription_Filters.push_back(DeadbandFilter(Default_Policy));
+        if (!Logger::getInstance().isEnabled()) {
+            return;
+        }
         std::ostringstream oss;
         oss << "A new ECU: " << sharedEcu->getName() << " subscribes to this " << this->getType() << " sensor.";
         Logger::getInstance().log(oss.str());
@@ -134,7 +139,8 @@ void SpeedSensor::DeAttachECU(std::weak_ptr<ECU> Ecu) {
         auto it = Subscribed_ECUs.begin();
         while (it != Subscribed_ECUs.end()) {
             if (std::shared_ptr<ECU> e = it->lock()) {
-                if (e->getID() == sharedECU->getID() && e->getName() == sharedECU->getName()) {
+                if (e->getID() == sharedECU->getID() && e->getKind() == sharedECU->getKind()) {
+                    Subscription_Filters.erase(Subscription_Filters.begin() + (it - Subscribed_ECUs.begin()));
                     it = Subscribed_ECUs.erase(it);  // Reassign the iterator after erasing
                     std::ostringstream oss;
                     oss << sharedECU->getName() << " was successfully detached.";
@@ -164,11 +170,13 @@ void SpeedSensor::DeAttachECU(std::weak_ptr<ECU> Ecu) {
  */
 void SpeedSensor::updateECU(std::weak_ptr<ECU> E) {
     if (std::shared_ptr<ECU> e = E.lock()) {
-        e->Recent_Sensory_Data[int(SensorTypes::SPEED_SENSOR)][Sensor_ID] = speed;
+        e->RecordSample(int(SensorTypes::SPEED_SENSOR), Sensor_ID, speed.load(std::memory_order_relaxed));
 
-        std::ostringstream oss;
-        oss << "Updated ECU: " << e->getName() << " with Sensor type " << type << " ID: " << Sensor_ID;
-        Logger::getInstance().log(oss.str());
+        if (Logger::getInstance().isEnabled()) {
+            std::ostringstream oss;
+            oss << "Updated ECU: " << e->getName() << " with Sensor type " << getType() << " ID: " << Sensor_ID;
+            Logger::getInstance().log(oss.str());
+        }
     } else {
         Logger::getInstance().log("ECU object no longer exists.");
     }
@@ -176,10 +184,16 @@ void SpeedSensor::updateECU(std::weak_ptr<ECU> E) {
 
 /**
  * @brief Notifies all subscribed ECUs with the latest speed data.
+ * 
+ * Subscribers whose notification policy holds the value back are skipped.
  */
 void SpeedSensor::NotifyAllECUs() {
-    for (const auto& s : Subscribed_ECUs) {
-        updateECU(s);  // Update all the list of the subscribed ECUs
+    const TimestampNs now = SampleNowNs();
+    const double value = speed.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < Subscribed_ECUs.size(); i++) {
+        if (ShouldNotify(i, value, now)) {
+            updateECU(Subscribed_ECUs[i]);  // Update all the list of the subscribed ECUs
+        }
     }
 }
 
@@ -189,5 +203,23 @@ void SpeedSensor::NotifyAllECUs() {
  * @return An integer representing the total number of sensors.
  */
 int SpeedSensor::getTotalSensorsCount() {
-    return Sensor::total_sensor_count; 
+    return (int)CarMetrics::get().sensors->value(); 
+}
+
+/**
+ * @brief Gets the last speed without taking a new reading.
+ * 
+ * @return The speed.
+ */
+double SpeedSensor::getCurrentValue() const {
+    return speed.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Replaces the last speed without notifying anyone.
+ * 
+ * @param value The speed.
+ */
+void SpeedSensor::setCurrentValue(double value) {
+    speed.store(value, std::memory_order_relaxed);
 }
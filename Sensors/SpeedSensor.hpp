@@ -53,12 +53,6 @@ public:
      */
     void PrintInfo() override;
 
-    /** 
-     * @brief Gets the type of the sensor.
-     * 
-     * @return A string representing the sensor type.
-     */
-    std::string getType() override;
 
     // Deleted copy constructor and assignment operator
     SpeedSensor(const SpeedSensor&) = delete; 
@@ -101,10 +95,24 @@ public:
      */
     virtual int getTotalSensorsCount() override;
 
+protected:
+    /** 
+     * @brief Gets the last speed without taking a new reading.
+     * 
+     * @return The speed.
+     */
+    double getCurrentValue() const override;
+
+    /** 
+     * @brief Replaces the last speed without notifying anyone.
+     * 
+     * @param value The speed.
+     */
+    void setCurrentValue(double value) override;
+
 private:
-    double speed;                     /**< Current speed value */
-    static int S_Sensor_Count;       /**< Static count of speed sensors */
-    const int Sensor_ID;             /**< Unique identifier for the sensor */
+    std::atomic<double> speed;       /**< Current speed value */
+    static std::atomic<int> S_Sensor_Count;       /**< Static count of speed sensors */
     
     /** 
      * @brief Generates a random speed value.
@@ -119,8 +127,6 @@ private:
      * @return A double representing the random speed data.
      */
     double getRandomData() override; 
-
-    std::string type = "Speed Sensor"; /**< Type of the sensor */
 };
 
 #endif // !SPEED_SENSOR_H
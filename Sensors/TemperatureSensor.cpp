@@ -1,11 +1,11 @@
 #include "TemperatureSensor.hpp"
+#include "../metrics/CarMetrics.hpp"
 #include <random>
 
 // Initialize static member variable
-int TemperatureSensor::T_Sensor_Count = 0;
+std::atomic<int> TemperatureSensor::T_Sensor_Count{0};
 
-// Random number generator setup
-std::default_random_engine et(std::chrono::system_clock::now().time_since_epoch().count());
+// Range of the generated readings; the engine is per sensor
 std::uniform_real_distribution<double> unift(0, 320);
 
 /**
@@ -14,22 +14,17 @@ std::uniform_real_distribution<double> unift(0, 320);
  */
 TemperatureSensor::~TemperatureSensor() {
     T_Sensor_Count--;
-    Sensor::total_sensor_count--; // Shared variable may require a mutex or atomic operation
+    CarMetrics::get().sensors->Add(-1);
 
+    if (!Logger::getInstance().isEnabled()) {
+        return; // Skip building the message when logging is suppressed
+    }
     std::ostringstream oss;
-    oss << "Sensor of type " << type << " & ID = " << Sensor_ID 
+    oss << "Sensor of type " << getType() << " & ID = " << Sensor_ID 
         << " is destroyed. Remaining count is " << T_Sensor_Count;
     Logger::getInstance().log(oss.str());
 }
 
-/**
- * @brief Gets the type of the sensor.
- * @return A string representing the type of the sensor.
- */
-std::string TemperatureSensor::getType() {
-    return type;
-}
-
 /**
  * @brief Retrieves the unique sensor ID.
  * @return The ID of the sensor.
@@ -50,6 +45,7 @@ int TemperatureSensor::getSensorCount() const {
  * @brief Reads the temperature sensor data by generating a random value.
  */
 void TemperatureSensor::sensorRead() {
+    CarMetrics::get().sensorReads[(int)SensorTypes::TEMPERATURE_SENSOR]->Increment();
     getRandomData(); // Call the random generator to randomize a Temperature and update it
 }
 
@@ -58,8 +54,8 @@ void TemperatureSensor::sensorRead() {
  * @return A randomly generated temperature value.
  */
 double TemperatureSensor::getRandomData() {
-    double randomTemperature = unift(et);
-    this->Temperature = randomTemperature; // Update the current Temperature
+    double randomTemperature = unift(Random_Engine);
+    this->Temperature.store(randomTemperature, std::memory_order_relaxed); // Update the current Temperature
     return randomTemperature;
 }
 
@@ -69,7 +65,7 @@ double TemperatureSensor::getRandomData() {
  */
 double TemperatureSensor::GetSensorData() {
     sensorRead();
-    return Temperature;
+    return Temperature.load(std::memory_order_relaxed);
 }
 
 /**
@@ -86,12 +82,17 @@ void TemperatureSensor::PrintInfo() {
 
 /**
  * @brief Default constructor for the TemperatureSensor class.
- * Initializes sensor ID and temperature, logs sensor creation, and updates the total sensor count.
+ * Initializes the temperature, logs sensor creation, and updates the total sensor count.
  */
 TemperatureSensor::TemperatureSensor() 
-    : Sensor_ID(++T_Sensor_Count), Temperature(0.0) {
-    PrintInfo();
-    Sensor::total_sensor_count++;
+    : Sensor(SensorTypes::TEMPERATURE_SENSOR), Temperature(0.0) {
+    T_Sensor_Count++;
+    // Temperature drifts slowly: half a degree deadband, refresh at least every 10 s
+    Default_Policy = NotificationPolicy{0.5, 0.0, 0, 10000000000LL};
+    if (Logger::getInstance().isEnabled()) {
+        PrintInfo();
+    }
+    CarMetrics::get().sensors->Add(1);
 }
 
 /**
@@ -103,15 +104,21 @@ void TemperatureSensor::AttachECU(std::weak_ptr<ECU> Ecu) {
         for (const auto& subscribedEcu : Subscribed_ECUs) {
             if (std::shared_ptr<ECU> existingEcu = subscribedEcu.lock()) {
                 if (existingEcu->getID() == sharedEcu->getID()) {
-                    std::ostringstream oss;
-                    oss << "ECU " << existingEcu->getName() << " is already subscribed.";
-                    Logger::getInstance().log(oss.str());
+                    if (Logger::getInstance().isEnabled()) {
+                        std::ostringstream oss;
+                        oss << "ECU " << existingEcu->getName() << " is already subscribed.";
+                        Logger::getInstance().log(oss.str());
+                    }
                     return;  // Exit if ECU is already subscribed
                 }
             }
         }
 
         Subscribed_ECUs.push_back(Ecu);
+        Subscription_Filters.push_back(DeadbandFilter(Default_Policy));
+        if (!Logger::getInstance().isEnabled()) {
+            return;
+        }
         std::ostringstream oss;
         oss << "A new ECU: " << sharedEcu->getName() 
             << " subscribes to this " << this->getType() << " sensor.";
@@ -130,7 +137,8 @@ void TemperatureSensor::DeAttachECU(std::weak_ptr<ECU> Ecu) {
         auto it = Subscribed_ECUs.begin();
         while (it != Subscribed_ECUs.end()) {
             if (std::shared_ptr<ECU> e = it->lock()) {
-                if (e->getID() == sharedECU->getID() && e->getName() == sharedECU->getName()) {
+                if (e->getID() == sharedECU->getID() && e->getKind() == sharedECU->getKind()) {
+                    Subscription_Filters.erase(Subscription_Filters.begin() + (it - Subscribed_ECUs.begin()));
                     it = Subscribed_ECUs.erase(it);  // Reassign the iterator after erasing
                     std::ostringstream oss;
                     oss << sharedECU->getName() << " was successfully detached.";
@@ -159,12 +167,14 @@ void TemperatureSensor::DeAttachECU(std::weak_ptr<ECU> Ecu) {
  */
 void TemperatureSensor::updateECU(std::weak_ptr<ECU> E) {
     if (std::shared_ptr<ECU> e = E.lock()) {
-        e->Recent_Sensory_Data[int(SensorTypes::TEMPERATURE_SENSOR)][Sensor_ID] = Temperature;
+        e->RecordSample(int(SensorTypes::TEMPERATURE_SENSOR), Sensor_ID, Temperature.load(std::memory_order_relaxed));
 
-        std::ostringstream oss;
-        oss << "Updated ECU: " << e->getName() << " with Sensor type " << type 
-            << " ID: " << Sensor_ID;
-        Logger::getInstance().log(oss.str());
+        if (Logger::getInstance().isEnabled()) {
+            std::ostringstream oss;
+            oss << "Updated ECU: " << e->getName() << " with Sensor type " << getType() 
+                << " ID: " << Sensor_ID;
+            Logger::getInstance().log(oss.str());
+        }
     } else {
         Logger::getInstance().log("ECU object no longer exists.");
     }
@@ -172,10 +182,16 @@ void TemperatureSensor::updateECU(std::weak_ptr<ECU> E) {
 
 /**
  * @brief Notifies all attached ECUs with the latest sensor data.
+ * 
+ * Subscribers whose notification policy holds the value back are skipped.
  */
 void TemperatureSensor::NotifyAllECUs() {
-    for (const auto& s : Subscribed_ECUs) {
-        updateECU(s);  // Update all the list of the subscribed ECUs
+    const TimestampNs now = SampleNowNs();
+    const double value = Temperature.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < Subscribed_ECUs.size(); i++) {
+        if (ShouldNotify(i, value, now)) {
+            updateECU(Subscribed_ECUs[i]);  // Update all the list of the subscribed ECUs
+        }
     }
 }
 
@@ -184,5 +200,23 @@ void TemperatureSensor::NotifyAllECUs() {
  * @return The total sensor count from the base Sensor class.
  */
 int TemperatureSensor::getTotalSensorsCount() {
-    return Sensor::total_sensor_count; 
+    return (int)CarMetrics::get().sensors->value(); 
+}
+
+/**
+ * @brief Gets the last temperature without taking a new reading.
+ * 
+ * @return The temperature.
+ */
+double TemperatureSensor::getCurrentValue() const {
+    return Temperature.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Replaces the last temperature without notifying anyone.
+ * 
+ * @param value The temperature.
+ */
+void TemperatureSensor::setCurrentValue(double value) {
+    Temperature.store(value, std::memory_order_relaxed);
 }
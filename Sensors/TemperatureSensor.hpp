@@ -51,11 +51,6 @@ public:
      */
     void PrintInfo() override;
 
-    /**
-     * @brief Retrieves the type of the sensor.
-     * @return The type of the sensor as a string.
-     */
-    std::string getType() override; 
 
     /**
      * @brief Deleted copy constructor.
@@ -108,10 +103,24 @@ public:
      */
     virtual int getTotalSensorsCount() override; 
 
+protected:
+    /** 
+     * @brief Gets the last temperature without taking a new reading.
+     * 
+     * @return The temperature.
+     */
+    double getCurrentValue() const override;
+
+    /** 
+     * @brief Replaces the last temperature without notifying anyone.
+     * 
+     * @param value The temperature.
+     */
+    void setCurrentValue(double value) override;
+
 private:
-    double Temperature; ///< Current temperature value.
-    static int T_Sensor_Count; ///< Static variable to track the number of TemperatureSensors created.
-    const int Sensor_ID; ///< Unique sensor ID.
+    std::atomic<double> Temperature; ///< Current temperature value.
+    static std::atomic<int> T_Sensor_Count; ///< Static variable to track the number of TemperatureSensors created.
     
     /**
      * @brief Generates a random temperature reading.
@@ -124,8 +133,6 @@ private:
      * @return A randomly generated double representing temperature.
      */
     double getRandomData() override; // Generates random data
-
-    std::string type = "Temperature Sensor"; ///< Type of the sensor.
 };
 
 #endif // !TEMPERATURE_SENSOR_H
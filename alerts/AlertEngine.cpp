@@ -0,0 +1,156 @@
+#include "AlertEngine.hpp"
+#include <algorithm>
+#include <bit>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Compiles the rules and clears every car's state.
+ *
+ * @param rules The rules.
+ * @param carCount Cars evaluated per tick.
+ */
+AlertEngine::AlertEngine(const std::vector<AlertRule>& rules, std::size_t carCount)
+    : carCount(carCount), wordsPerRule((carCount + 15) / 16), state(rules.size() * wordsPerRule, 0), stats{0, 0, 0, 0} {
+    for (const AlertRule& r : rules) {
+        const double s = r.comparator == AlertComparator::ABOVE ? 1.0 : -1.0;
+        signal.push_back((std::uint8_t)r.signal);
+        sign.push_back(s);
+        raiseAt.push_back(s * r.threshold);
+        clearAt.push_back(s * r.threshold - r.hysteresis);
+    }
+}
+
+/**
+ * @brief Computes the raise and hold masks of up to 16 cars for one rule.
+ *
+ * Bit i of up is set if values[i] breaks the threshold, bit i of hold
+ * if it has not moved back past the hysteresis band. Full groups use SSE2,
+ * two cars per compare; the movemask results are packed into the masks.
+ *
+ * @param values Signal values of the cars.
+ * @param n Cars in the group, at most 16.
+ * @param s Rule sign.
+ * @param raise Signed raise threshold.
+ * @param clear Signed clear threshold.
+ * @param up Receives the raise mask.
+ * @param hold Receives the hold mask.
+ */
+static inline void RuleMasks(const double* values, std::size_t n, double s, double raise, double clear,
+                             unsigned& up, unsigned& hold) {
+    up = 0;
+    hold = 0;
+#ifdef __SSE2__
+    if (n == 16) {
+        const __m128d sv = _mm_set1_pd(s);
+        const __m128d raisev = _mm_set1_pd(raise);
+        const __m128d clearv = _mm_set1_pd(clear);
+        for (unsigned k = 0; k < 16; k += 2) {
+            const __m128d x = _mm_mul_pd(_mm_loadu_pd(values + k), sv);
+            up |= (unsigned)_mm_movemask_pd(_mm_cmpgt_pd(x, raisev)) << k;
+            hold |= (unsigned)_mm_movemask_pd(_mm_cmpgt_pd(x, clearv)) << k;
+        }
+        return;
+    }
+#endif
+    for (std::size_t k = 0; k < n; k++) {
+        const double x = s * values[k];
+        up |= (unsigned)(x > raise) << k;
+        hold |= (unsigned)(x > clear) << k;
+    }
+}
+
+/**
+ * @brief Evaluates every rule for every car, block by block.
+ *
+ * @param columns Signal values indexed by SensorTypes.
+ * @param out Receives the transitions.
+ * @return std::size_t Transitions appended.
+ */
+std::size_t AlertEngine::Evaluate(const double* const columns[Sensor_Types_Count], std::vector<AlertTransition>& out) {
+    const std::size_t before = out.size();
+    const std::size_t rules = signal.size();
+    for (std::size_t first = 0; first < carCount; first += ALERT_BLOCK_CARS) {
+        const std::size_t last = std::min<std::size_t>(first + ALERT_BLOCK_CARS, carCount);
+        for (std::size_t r = 0; r < rules; r++) {
+            const double* values = columns[signal[r]];
+            std::uint16_t* row = state.data() + r * wordsPerRule;
+            for (std::size_t car = first; car < last; car += 16) {
+                unsigned up, hold;
+                RuleMasks(values + car, std::min<std::size_t>(16, last - car), sign[r], raiseAt[r], clearAt[r], up, hold);
+                const unsigned old = row[car / 16];
+                const unsigned now = up | (old & hold);
+                if (now == old) {
+                    continue; // The common case: nothing flipped in these 16 cars
+                }
+                row[car / 16] = (std::uint16_t)now;
+                for (unsigned flipped = old ^ now; flipped != 0; flipped &= flipped - 1) {
+                    const unsigned bit = std::countr_zero(flipped);
+                    const bool raised = (now >> bit) & 1;
+                    out.push_back(AlertTransition{(std::uint32_t)(car + bit), (std::uint32_t)r, raised});
+                    if (raised) {
+                        stats.raised++;
+                    } else {
+                        stats.cleared++;
+                    }
+                }
+            }
+        }
+    }
+    stats.ticks++;
+    stats.evaluations += rules * carCount;
+    return out.size() - before;
+}
+
+/**
+ * @brief Checks whether a rule is raised for a car.
+ *
+ * @param car Car index.
+ * @param rule Rule index.
+ * @return true if raised.
+ */
+bool AlertEngine::isRaised(std::size_t car, std::size_t rule) const {
+    return (state[rule * wordsPerRule + car / 16] >> (car % 16)) & 1;
+}
+
+/**
+ * @brief Counts the raised rule-car pairs.
+ *
+ * @return std::size_t Pairs currently raised.
+ */
+std::size_t AlertEngine::getRaisedCount() const {
+    std::size_t raised = 0;
+    for (std::uint16_t word : state) {
+        raised += std::popcount(word);
+    }
+    return raised;
+}
+
+/**
+ * @brief Gets the number of rules.
+ *
+ * @return std::size_t The rule count.
+ */
+std::size_t AlertEngine::getRuleCount() const {
+    return signal.size();
+}
+
+/**
+ * @brief Gets the number of cars.
+ *
+ * @return std::size_t The car count.
+ */
+std::size_t AlertEngine::getCarCount() const {
+    return carCount;
+}
+
+/**
+ * @brief Gets the counters.
+ *
+ * @return const AlertEngineStats& The counters.
+ */
+const AlertEngineStats& AlertEngine::getStats() const {
+    return stats;
+}
@@ -0,0 +1,116 @@
+#ifndef ALERT_ENGINE_H
+#define ALERT_ENGINE_H
+
+#include "AlertRule.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define ALERT_BLOCK_CARS 512 ///< Cars evaluated against every rule before moving on; their signals stay in L1. A multiple of 16
+
+/**
+ * @brief A rule that changed state for one car.
+ */
+struct AlertTransition {
+    std::uint32_t car; ///< Car index
+    std::uint32_t rule; ///< Rule index in the rule set
+    bool raised; ///< true if the rule was raised, false if it cleared
+};
+
+/**
+ * @brief Counters of an alert engine.
+ */
+struct AlertEngineStats {
+    std::uint64_t ticks; ///< Evaluate calls
+    std::uint64_t evaluations; ///< Rule-car pairs evaluated
+    std::uint64_t raised; ///< Transitions to raised
+    std::uint64_t cleared; ///< Transitions to cleared
+};
+
+/**
+ * @brief Evaluates a rule set over a whole fleet each tick and reports only state changes.
+ *
+ * @details The rules are compiled into flat arrays. Each rule gets a sign,
+ * +1 for ABOVE and -1 for BELOW, so that both directions become one test
+ * on s * value:
+ *
+ *     raised' = (s * value > raiseAt) | (raised & (s * value > clearAt))
+ *
+ * with raiseAt = s * threshold and clearAt = raiseAt - hysteresis. State is
+ * one bit per rule and car. Sixteen cars are evaluated at once: SSE2
+ * compares give two masks, and the update above becomes word-wide bit
+ * operations with no per-car branch. The cost of a tick is therefore
+ * rules x cars no matter how many alerts are active. Only a group whose
+ * word changed is written back and scanned for transitions, which is rare.
+ *
+ * Not thread-safe; one thread drives an engine. Split a fleet into ranges
+ * with one engine each to evaluate in parallel.
+ */
+class AlertEngine {
+public:
+    /**
+     * @brief Compiles the rules and clears every car's state.
+     *
+     * @param rules The rules.
+     * @param carCount Cars evaluated per tick.
+     */
+    AlertEngine(const std::vector<AlertRule>& rules, std::size_t carCount);
+
+    /**
+     * @brief Evaluates every rule for every car.
+     *
+     * @param columns Signal values indexed by SensorTypes, each an array of carCount values.
+     * @param out Receives the transitions; appended to.
+     * @return std::size_t Transitions appended.
+     */
+    std::size_t Evaluate(const double* const columns[Sensor_Types_Count], std::vector<AlertTransition>& out);
+
+    /**
+     * @brief Checks whether a rule is raised for a car.
+     *
+     * @param car Car index.
+     * @param rule Rule index.
+     * @return true if raised.
+     */
+    bool isRaised(std::size_t car, std::size_t rule) const;
+
+    /**
+     * @brief Counts the raised rule-car pairs.
+     *
+     * @return std::size_t Pairs currently raised.
+     */
+    std::size_t getRaisedCount() const;
+
+    /**
+     * @brief Gets the number of rules.
+     *
+     * @return std::size_t The rule count.
+     */
+    std::size_t getRuleCount() const;
+
+    /**
+     * @brief Gets the number of cars.
+     *
+     * @return std::size_t The car count.
+     */
+    std::size_t getCarCount() const;
+
+    /**
+     * @brief Gets the counters.
+     *
+     * @return const AlertEngineStats& The counters.
+     */
+    const AlertEngineStats& getStats() const;
+
+private:
+    std::size_t carCount; ///< Cars per tick
+    std::vector<std::uint8_t> signal; ///< Signal index of each rule
+    std::vector<double> sign; ///< +1 for ABOVE, -1 for BELOW
+    std::vector<double> raiseAt; ///< sign * threshold
+    std::vector<double> clearAt; ///< raiseAt - hysteresis
+    std::size_t wordsPerRule; ///< State words per rule, 16 cars each
+    std::vector<std::uint16_t> state; ///< Raised bits; rule-major, bit i of word w is car 16 * w + i
+    AlertEngineStats stats; ///< Counters
+};
+
+#endif // !ALERT_ENGINE_H
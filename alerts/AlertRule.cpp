@@ -0,0 +1,140 @@
+#include "AlertRule.hpp"
+#include "../car/VehicleProfile.hpp"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+static const char* const Signal_Names[Sensor_Types_Count] = {"speed", "temperature", "radar", "battery"}; ///< Indexed by SensorTypes
+static const char* const Severity_Names[] = {"info", "warning", "critical"}; ///< Indexed by AlertSeverity
+
+/**
+ * @brief Gets the text of a message.
+ *
+ * @param messageId The message ID.
+ * @return std::string The text, or "message <id>" if it has none.
+ */
+std::string AlertRuleSet::messageText(std::uint32_t messageId) const {
+    auto it = messages.find(messageId);
+    return it == messages.end() ? "message " + std::to_string(messageId) : it->second;
+}
+
+/**
+ * @brief Throws a parse error for a line.
+ *
+ * @param line Line number, from 1.
+ * @param what What is wrong.
+ */
+[[noreturn]] static void ParseError(std::size_t line, const std::string& what) {
+    throw std::runtime_error("alert rules line " + std::to_string(line) + ": " + what);
+}
+
+/**
+ * @brief Looks a word up in a name table.
+ *
+ * @param names The table.
+ * @param count Entries in the table.
+ * @param word The word.
+ * @return int Index of the word, or -1.
+ */
+static int FindName(const char* const* names, int count, const std::string& word) {
+    for (int i = 0; i < count; i++) {
+        if (word == names[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Parses a rule file.
+ *
+ * @param in The rule text.
+ * @return AlertRuleSet The rules.
+ */
+AlertRuleSet LoadAlertRules(std::istream& in) {
+    AlertRuleSet set;
+    std::string text;
+    for (std::size_t line = 1; std::getline(in, text); line++) {
+        std::istringstream words(text);
+        std::string keyword;
+        if (!(words >> keyword) || keyword[0] == '#') {
+            continue;
+        }
+        if (keyword == "message") {
+            std::uint32_t id;
+            if (!(words >> id)) {
+                ParseError(line, "expected a message ID");
+            }
+            std::string message;
+            std::getline(words >> std::ws, message);
+            set.messages[id] = message;
+            continue;
+        }
+        if (keyword != "rule") {
+            ParseError(line, "unknown statement '" + keyword + "'");
+        }
+
+        std::string signal, comparator, severity;
+        AlertRule rule;
+        if (!(words >> signal >> comparator >> rule.threshold >> rule.hysteresis >> severity >> rule.messageId)) {
+            ParseError(line, "expected: rule <signal> <above|below> <threshold> <hysteresis> <severity> <message id>");
+        }
+        const int s = FindName(Signal_Names, Sensor_Types_Count, signal);
+        if (s < 0) {
+            ParseError(line, "unknown signal '" + signal + "'");
+        }
+        if (comparator != "above" && comparator != "below") {
+            ParseError(line, "comparator must be above or below");
+        }
+        const int v = FindName(Severity_Names, 3, severity);
+        if (v < 0) {
+            ParseError(line, "unknown severity '" + severity + "'");
+        }
+        if (!(rule.hysteresis >= 0.0)) {
+            ParseError(line, "hysteresis must not be negative");
+        }
+        rule.signal = (SensorTypes)s;
+        rule.comparator = comparator == "above" ? AlertComparator::ABOVE : AlertComparator::BELOW;
+        rule.severity = (AlertSeverity)v;
+        set.rules.push_back(rule);
+    }
+    return set;
+}
+
+/**
+ * @brief Parses a rule file from disk.
+ *
+ * @param path The file.
+ * @return AlertRuleSet The rules.
+ */
+AlertRuleSet LoadAlertRuleFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot read alert rules from " + path);
+    }
+    return LoadAlertRules(file);
+}
+
+/**
+ * @brief Builds the rules equivalent to the status checks of a vehicle profile.
+ *
+ * @param maxSpeed Speed limit.
+ * @param maxTemperature Temperature limit.
+ * @param lowBattery Battery level warning threshold.
+ * @param safeRadarDistance Minimum radar distance.
+ * @return AlertRuleSet Four rules with the DisplayStatus messages.
+ */
+AlertRuleSet StatusAlertRules(double maxSpeed, double maxTemperature, double lowBattery, double safeRadarDistance) {
+    AlertRuleSet set;
+    set.rules = {
+        {SensorTypes::SPEED_SENSOR, AlertComparator::ABOVE, maxSpeed, VEHICLE_BAND_SPEED, AlertSeverity::WARNING, 1},
+        {SensorTypes::TEMPERATURE_SENSOR, AlertComparator::ABOVE, maxTemperature, VEHICLE_BAND_TEMPERATURE, AlertSeverity::CRITICAL, 2},
+        {SensorTypes::BATTERY_LEVEL_SENSOR, AlertComparator::BELOW, lowBattery, VEHICLE_BAND_BATTERY, AlertSeverity::WARNING, 3},
+        {SensorTypes::RADAR_SENSOR, AlertComparator::BELOW, safeRadarDistance, VEHICLE_BAND_RADAR, AlertSeverity::CRITICAL, 4},
+    };
+    set.messages[1] = "Speed Exceeded please SLOW DOWN";
+    set.messages[2] = "Car is overheating please stop";
+    set.messages[3] = "LOW BATTERY PLEASE GO TO THE NEAREST CHARGING STATION";
+    set.messages[4] = "Collision is predicted please Slow down";
+    return set;
+}
@@ -0,0 +1,96 @@
+#ifndef ALERT_RULE_H
+#define ALERT_RULE_H
+
+#include "../Sensors/Sensor.hpp"
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Direction in which a signal breaks a rule.
+ */
+enum class AlertComparator {
+    ABOVE = 0, /**< Raised while the signal is above the threshold */
+    BELOW = 1  /**< Raised while the signal is below the threshold */
+};
+
+/**
+ * @brief How urgent an alert is.
+ */
+enum class AlertSeverity {
+    INFO = 0,     /**< Worth knowing */
+    WARNING = 1,  /**< Needs attention */
+    CRITICAL = 2  /**< Needs action now */
+};
+
+/**
+ * @brief One alert condition on one signal.
+ *
+ * @details A rule is raised when the signal crosses the threshold in the
+ * comparator's direction, and cleared only once the signal is back by more
+ * than the hysteresis, so a signal hovering at the threshold does not flap.
+ */
+struct AlertRule {
+    SensorTypes signal; ///< Signal the rule watches
+    AlertComparator comparator; ///< Direction that raises the rule
+    double threshold; ///< Value that raises the rule
+    double hysteresis; ///< Distance back past the threshold that clears it; >= 0
+    AlertSeverity severity; ///< Urgency
+    std::uint32_t messageId; ///< Key into AlertRuleSet::messages
+};
+
+/**
+ * @brief Rules and the texts of their messages, as loaded at startup.
+ */
+struct AlertRuleSet {
+    std::vector<AlertRule> rules; ///< Rules in file order; a rule's index is its ID
+    std::map<std::uint32_t, std::string> messages; ///< Message texts by ID
+
+    /**
+     * @brief Gets the text of a message.
+     *
+     * @param messageId The message ID.
+     * @return std::string The text, or "message <id>" if it has none.
+     */
+    std::string messageText(std::uint32_t messageId) const;
+};
+
+/**
+ * @brief Parses a rule file.
+ *
+ * One statement per line; blank lines and lines starting with # are ignored:
+ *
+ *     rule <signal> <above|below> <threshold> <hysteresis> <info|warning|critical> <message id>
+ *     message <message id> <text to the end of the line>
+ *
+ * Signals are speed, temperature, radar and battery.
+ *
+ * @param in The rule text.
+ * @return AlertRuleSet The rules.
+ * @throws std::runtime_error On a malformed line, naming the line number.
+ */
+AlertRuleSet LoadAlertRules(std::istream& in);
+
+/**
+ * @brief Parses a rule file from disk.
+ *
+ * @param path The file.
+ * @return AlertRuleSet The rules.
+ * @throws std::runtime_error If the file cannot be read or is malformed.
+ */
+AlertRuleSet LoadAlertRuleFile(const std::string& path);
+
+/**
+ * @brief Builds the rules equivalent to the status checks of a vehicle profile.
+ *
+ * @param maxSpeed Speed limit.
+ * @param maxTemperature Temperature limit.
+ * @param lowBattery Battery level warning threshold.
+ * @param safeRadarDistance Minimum radar distance.
+ * @return AlertRuleSet Four rules with the DisplayStatus messages.
+ */
+AlertRuleSet StatusAlertRules(double maxSpeed, double maxTemperature, double lowBattery, double safeRadarDistance);
+
+#endif // !ALERT_RULE_H
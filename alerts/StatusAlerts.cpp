@@ -0,0 +1,201 @@
+#include "StatusAlerts.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+
+static const char* const Cleared_Texts[STATUS_RULE_COUNT] = {
+    "Speed is within the allowed Range", "Temperature is within the allowed Range", "Battery is Good", "NO collision Threats"
+}; ///< Line texts while each check is clear
+static const char* const Alert_Names[STATUS_RULE_COUNT] = {"OVERSPEED", "OVERHEAT", "BATTERY_LOW", "COLLISION"}; ///< Summary names of the checks
+
+/**
+ * @brief Gets the messages of the status rules, shared by every car.
+ *
+ * @return const AlertRuleSet& The rules with their messages; only the messages and severities are used.
+ */
+static const AlertRuleSet& StatusMessages() {
+    static const AlertRuleSet set = StatusAlertRules(0.0, 0.0, 0.0, 0.0);
+    return set;
+}
+
+/**
+ * @brief Gets the status checks whose raising is never debounced.
+ *
+ * @return std::uint32_t VEHICLE_ALERT_* bits of the CRITICAL rules.
+ */
+static std::uint32_t CriticalAlerts() {
+    static const std::uint32_t critical = [] {
+        std::uint32_t bits = 0;
+        for (int i = 0; i < STATUS_RULE_COUNT; i++) {
+            bits |= (std::uint32_t)(StatusMessages().rules[i].severity == AlertSeverity::CRITICAL) << i;
+        }
+        return bits;
+    }();
+    return critical;
+}
+
+/**
+ * @brief Starts with every line unknown.
+ *
+ * @param debounce Consecutive updates needed to change a line; 1 changes at once.
+ * @param summaryInterval Updates between summaries; 0 for none.
+ */
+StatusAlerts::StatusAlerts(unsigned debounce, unsigned summaryInterval)
+    : debounce(debounce < 1 ? 1 : debounce), summaryInterval(summaryInterval),
+      updates(0), emitted(0), suppressed(0), suppressedAtSummary(0) {
+    Reset();
+}
+
+/**
+ * @brief Forgets every line.
+ */
+void StatusAlerts::Reset() {
+    shown = 0;
+    pending.fill(0);
+    known = false;
+}
+
+/**
+ * @brief Applies one status check and reports the lines that changed.
+ *
+ * @param raised VEHICLE_ALERT_* bits the car's check raised.
+ * @param adaptive Whether cruise control is on.
+ * @return std::uint32_t Bit i set if line i changed and should be logged.
+ */
+std::uint32_t StatusAlerts::Update(std::uint32_t raised, bool adaptive) {
+    // The state each line would take on this check alone
+    const std::uint32_t checks = raised & ((1u << STATUS_RULE_COUNT) - 1);
+    const std::uint32_t wanted = checks | (std::uint32_t)adaptive << STATUS_LINE_CRUISE;
+    const std::uint32_t urgent = checks & CriticalAlerts();
+
+    std::uint32_t changed = 0;
+    if (!known) {
+        changed = (1u << STATUS_LINE_COUNT) - 1;
+        shown = wanted;
+        known = true;
+    } else {
+        const std::uint32_t differs = wanted ^ shown;
+        for (int i = 0; i < STATUS_LINE_COUNT; i++) {
+            if (!((differs >> i) & 1)) {
+                pending[i] = 0;
+            } else if (++pending[i] >= debounce || ((urgent >> i) & 1)) {
+                pending[i] = 0;
+                changed |= 1u << i;
+            }
+        }
+        shown ^= changed;
+    }
+
+    const unsigned lines = std::popcount(changed);
+    updates++;
+    emitted += lines;
+    suppressed += STATUS_LINE_COUNT - lines;
+    return changed;
+}
+
+/**
+ * @brief Gets the text a line currently shows.
+ *
+ * @param line Line index, below STATUS_LINE_COUNT.
+ * @return const char* The text.
+ */
+const char* StatusAlerts::LineText(int line) const {
+    const bool on = (shown >> line) & 1;
+    if (line == STATUS_LINE_CRUISE) {
+        return on ? "CRUISE CONTROL IS ON" : "CRUISE CONTROL IS OFF";
+    }
+    return on ? StatusMessages().messages.at(StatusMessages().rules[line].messageId).c_str() : Cleared_Texts[line];
+}
+
+/**
+ * @brief Gets the raised status checks.
+ *
+ * @return std::uint32_t VEHICLE_ALERT_* bits.
+ */
+std::uint32_t StatusAlerts::getAlerts() const {
+    return shown & ((1u << STATUS_RULE_COUNT) - 1);
+}
+
+/**
+ * @brief Checks whether a summary is due after the last update.
+ *
+ * @return true once every summaryInterval updates.
+ */
+bool StatusAlerts::isSummaryDue() const {
+    return summaryInterval != 0 && updates % summaryInterval == 0;
+}
+
+/**
+ * @brief Writes the compact summary and restarts the suppressed count.
+ *
+ * @param car Name of the car.
+ * @param values Signal values indexed by SensorTypes.
+ * @param out Receives the line.
+ * @param size Size of out.
+ */
+void StatusAlerts::Summary(const char* car, const double* values, char* out, std::size_t size) {
+    char alerts[64] = "";
+    std::size_t length = 0;
+    for (int i = 0; i < STATUS_RULE_COUNT; i++) {
+        if ((shown >> i) & 1) {
+            length += std::snprintf(alerts + length, sizeof(alerts) - length, "%s%s", length == 0 ? "" : ",", Alert_Names[i]);
+        }
+    }
+    std::snprintf(out, size,
+                  "Status of %s: speed %.1f, temperature %.1f, radar %.1f, battery %.1f%%, alerts %s, cruise control %s; %llu lines suppressed",
+                  car, values[(int)SensorTypes::SPEED_SENSOR], values[(int)SensorTypes::TEMPERATURE_SENSOR],
+                  values[(int)SensorTypes::RADAR_SENSOR], values[(int)SensorTypes::BATTERY_LEVEL_SENSOR],
+                  length == 0 ? "none" : alerts, ((shown >> STATUS_LINE_CRUISE) & 1) ? "ON" : "OFF",
+                  (unsigned long long)(suppressed - suppressedAtSummary));
+    suppressedAtSummary = suppressed;
+}
+
+/**
+ * @brief Gets the lines logged so far.
+ *
+ * @return std::uint64_t Lines reported by Update.
+ */
+std::uint64_t StatusAlerts::getEmitted() const {
+    return emitted;
+}
+
+/**
+ * @brief Gets the lines left out so far because they did not change.
+ *
+ * @return std::uint64_t Lines suppressed by Update.
+ */
+std::uint64_t StatusAlerts::getSuppressed() const {
+    return suppressed;
+}
+
+/**
+ * @brief Gets the lines and counters.
+ *
+ * @return StatusAlertsState The state.
+ */
+StatusAlertsState StatusAlerts::getState() const {
+    StatusAlertsState state;
+    state.shown = shown;
+    std::copy(pending.begin(), pending.end(), state.pending);
+    state.known = known;
+    state.updates = updates;
+    state.emitted = emitted;
+    state.suppressed = suppressed;
+    state.suppressedAtSummary = suppressedAtSummary;
+    return state;
+}
+
+/**
+ * @brief Takes up saved lines and counters.
+ *
+ * @param state The state.
+ */
+void StatusAlerts::setState(const StatusAlertsState& state) {
+    shown = state.shown;
+    std::copy(state.pending, state.pending + STATUS_LINE_COUNT, pending.begin());
+    known = state.known;
+    updates = state.updates;
+    emitted = state.emitted;
+    suppressed = state.suppressed;
+    suppressedAtSummary = state.suppressedAtSummary;
+}
@@ -0,0 +1,145 @@
+#ifndef STATUS_ALERTS_H
+#define STATUS_ALERTS_H
+
+#include "AlertRule.hpp"
+#include "../car/VehicleProfile.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#define STATUS_RULE_COUNT 4 ///< Status checks; check i is the VEHICLE_ALERT_* bit 1 << i
+#define STATUS_LINE_CRUISE 4 ///< Line index of the cruise control on/off line
+#define STATUS_LINE_COUNT 5 ///< Lines of a full status report: the checks, then cruise control
+#define STATUS_ALERT_DEBOUNCE 2 ///< Consecutive checks that must agree before a line changes
+#define STATUS_SUMMARY_INTERVAL 12 ///< Status updates between compact summaries; one minute at the 5 s display period
+
+/**
+ * @brief What StatusAlerts remembers between updates, as kept in a checkpoint.
+ *
+ * The checks belong to the car, so only the lines and counters are kept.
+ */
+struct StatusAlertsState {
+    std::uint32_t shown; ///< Bit i set if line i shows its raised (or ON) text
+    std::uint8_t pending[STATUS_LINE_COUNT]; ///< Consecutive updates disagreeing with each line
+    bool known; ///< false until the first update reports every line
+    std::uint64_t updates; ///< Update calls
+    std::uint64_t emitted; ///< Lines reported
+    std::uint64_t suppressed; ///< Lines left out
+    std::uint64_t suppressedAtSummary; ///< suppressed when the last summary was written
+};
+
+/**
+ * @brief Per-car state of the DisplayStatus lines, so a line is only logged when it changes.
+ *
+ * @details The car runs its status check, compiled for its profile when it
+ * has one, and passes the raised bits in; the check already holds a raised
+ * alert over its hysteresis band, given getAlerts(). StatusAlerts only
+ * debounces: a line changes after `debounce` consecutive updates agree on
+ * its new state, which absorbs single-sample glitches. Raising a CRITICAL
+ * check is never delayed.
+ *
+ * The first update after construction or Reset() reports every line.
+ *
+ * Not thread-safe; the thread displaying a car's status owns its state.
+ */
+class StatusAlerts {
+public:
+    /**
+     * @brief Starts with every line unknown.
+     *
+     * @param debounce Consecutive updates needed to change a line; 1 changes at once.
+     * @param summaryInterval Updates between summaries; 0 for none.
+     */
+    explicit StatusAlerts(unsigned debounce = STATUS_ALERT_DEBOUNCE, unsigned summaryInterval = STATUS_SUMMARY_INTERVAL);
+
+    /**
+     * @brief Forgets every line, for when the car's limits change.
+     */
+    void Reset();
+
+    /**
+     * @brief Applies one status check and reports the lines that changed.
+     *
+     * @param raised VEHICLE_ALERT_* bits the car's check raised, given getAlerts().
+     * @param adaptive Whether cruise control is on.
+     * @return std::uint32_t Bit i set if line i changed and should be logged.
+     */
+    std::uint32_t Update(std::uint32_t raised, bool adaptive);
+
+    /**
+     * @brief Gets the text a line currently shows.
+     *
+     * @param line Line index, below STATUS_LINE_COUNT.
+     * @return const char* The text.
+     */
+    const char* LineText(int line) const;
+
+    /**
+     * @brief Gets the raised status checks.
+     *
+     * @return std::uint32_t VEHICLE_ALERT_* bits.
+     */
+    std::uint32_t getAlerts() const;
+
+    /**
+     * @brief Checks whether a summary is due after the last update.
+     *
+     * @return true once every summaryInterval updates.
+     */
+    bool isSummaryDue() const;
+
+    /**
+     * @brief Writes the compact summary and restarts the suppressed count.
+     *
+     * One line with the signals, the raised alerts and the lines suppressed
+     * since the last summary, written without allocating.
+     *
+     * @param car Name of the car.
+     * @param values Signal values indexed by SensorTypes.
+     * @param out Receives the line, cut to size - 1 characters.
+     * @param size Size of out.
+     */
+    void Summary(const char* car, const double* values, char* out, std::size_t size);
+
+    /**
+     * @brief Gets the lines logged so far.
+     *
+     * @return std::uint64_t Lines reported by Update.
+     */
+    std::uint64_t getEmitted() const;
+
+    /**
+     * @brief Gets the lines left out so far because they did not change.
+     *
+     * @return std::uint64_t Lines suppressed by Update.
+     */
+    std::uint64_t getSuppressed() const;
+
+    /**
+     * @brief Gets the lines and counters.
+     *
+     * @return StatusAlertsState The state.
+     */
+    StatusAlertsState getState() const;
+
+    /**
+     * @brief Takes up saved lines and counters.
+     *
+     * @param state The state.
+     */
+    void setState(const StatusAlertsState& state);
+
+private:
+    std::uint32_t shown; ///< Bit i set if line i shows its raised (or ON) text
+    std::array<std::uint8_t, STATUS_LINE_COUNT> pending; ///< Consecutive updates disagreeing with each line
+    bool known; ///< false until the first update reports every line
+    unsigned debounce; ///< Updates needed to change a line
+    unsigned summaryInterval; ///< Updates between summaries
+    std::uint64_t updates; ///< Update calls
+    std::uint64_t emitted; ///< Lines reported
+    std::uint64_t suppressed; ///< Lines left out
+    std::uint64_t suppressedAtSummary; ///< suppressed when the last summary was written
+};
+
+#endif // !STATUS_ALERTS_H
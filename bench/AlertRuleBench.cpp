@@ -0,0 +1,123 @@
+// Evaluates many alert rules over a large fleet every tick with the compiled
+// table and with a per-car, per-rule if/else reference, checks that both
+// report the same transitions, and reports the cost per rule-car pair.
+// Usage: alert_rule_bench [cars] [rules] [ticks] [rule file]
+// Without a rule file, rules are generated at random over the sensor ranges.
+#include "../alerts/AlertEngine.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <random>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// The straightforward evaluator the table replaces: one branch per comparator and state
+static std::size_t EvaluateReference(const std::vector<AlertRule>& rules, const double* const columns[Sensor_Types_Count],
+                                     std::size_t cars, std::vector<std::uint8_t>& state) {
+    std::size_t transitions = 0;
+    for (std::size_t c = 0; c < cars; c++) {
+        for (std::size_t r = 0; r < rules.size(); r++) {
+            const AlertRule& rule = rules[r];
+            const double v = columns[(int)rule.signal][c];
+            std::uint8_t& raised = state[c * rules.size() + r];
+            bool now = raised;
+            if (rule.comparator == AlertComparator::ABOVE) {
+                if (!raised && v > rule.threshold) now = true;
+                else if (raised && v <= rule.threshold - rule.hysteresis) now = false;
+            } else {
+                if (!raised && v < rule.threshold) now = true;
+                else if (raised && v >= rule.threshold + rule.hysteresis) now = false;
+            }
+            if (now != (bool)raised) {
+                raised = now;
+                transitions++;
+            }
+        }
+    }
+    return transitions;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t cars = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const std::size_t ruleCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+    const std::size_t ticks = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 20;
+    const double ranges[Sensor_Types_Count] = {320.0, 320.0, 50.0, 100.0};
+
+    std::default_random_engine engine(11);
+    AlertRuleSet set;
+    if (argc > 4) {
+        try {
+            set = LoadAlertRuleFile(argv[4]);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s\n", e.what());
+            return 1;
+        }
+    } else {
+        std::uniform_int_distribution<int> signal(0, Sensor_Types_Count - 1), coin(0, 1), severity(0, 2);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        for (std::size_t i = 0; i < ruleCount; i++) {
+            const int s = signal(engine);
+            set.rules.push_back(AlertRule{(SensorTypes)s, coin(engine) ? AlertComparator::ABOVE : AlertComparator::BELOW,
+                                          unit(engine) * ranges[s], 0.02 * ranges[s], (AlertSeverity)severity(engine), (std::uint32_t)i});
+        }
+    }
+
+    // Signals drift by a random walk of 0.2% of their range per tick, so some rules keep crossing their thresholds
+    std::vector<double> columns[Sensor_Types_Count];
+    const double* pointers[Sensor_Types_Count];
+    for (int s = 0; s < Sensor_Types_Count; s++) {
+        std::uniform_real_distribution<double> start(0.0, ranges[s]);
+        columns[s].resize(cars);
+        for (double& v : columns[s]) {
+            v = start(engine);
+        }
+        pointers[s] = columns[s].data();
+    }
+
+    AlertEngine alerts(set.rules, cars);
+    std::vector<std::uint8_t> referenceState(cars * set.rules.size(), 0);
+    std::vector<AlertTransition> transitions;
+    std::normal_distribution<double> step(0.0, 1.0);
+    double tableSeconds = 0.0, referenceSeconds = 0.0, worstTick = 0.0;
+    std::size_t tableTransitions = 0, referenceTransitions = 0;
+    // The first tick raises every rule already broken; it settles the state and is not timed
+    alerts.Evaluate(pointers, transitions);
+    EvaluateReference(set.rules, pointers, cars, referenceState);
+    for (std::size_t t = 0; t < ticks; t++) {
+        for (int s = 0; s < Sensor_Types_Count; s++) {
+            for (double& v : columns[s]) {
+                v = std::min(ranges[s], std::max(0.0, v + step(engine) * 0.002 * ranges[s]));
+            }
+        }
+        transitions.clear();
+        Clock::time_point start = Clock::now();
+        tableTransitions += alerts.Evaluate(pointers, transitions);
+        const double tick = SecondsSince(start);
+        tableSeconds += tick;
+        worstTick = std::max(worstTick, tick);
+
+        start = Clock::now();
+        referenceTransitions += EvaluateReference(set.rules, pointers, cars, referenceState);
+        referenceSeconds += SecondsSince(start);
+    }
+
+    const double pairs = (double)cars * set.rules.size() * ticks;
+    std::printf("%zu cars x %zu rules, %zu ticks\n", cars, set.rules.size(), ticks);
+    std::printf("table:     %.3f ns/pair, %.1f ms/tick (worst %.1f ms), %zu transitions\n",
+                tableSeconds * 1e9 / pairs, tableSeconds * 1e3 / ticks, worstTick * 1e3, tableTransitions);
+    std::printf("reference: %.3f ns/pair, %.1f ms/tick, %zu transitions\n",
+                referenceSeconds * 1e9 / pairs, referenceSeconds * 1e3 / ticks, referenceTransitions);
+    std::printf("raised at the end: %zu of %.0f pairs; %.2f%% of evaluations changed state\n",
+                alerts.getRaisedCount(), (double)cars * set.rules.size(), 100.0 * tableTransitions / pairs);
+    if (tableTransitions != referenceTransitions) {
+        std::printf("MISMATCH between table and reference\n");
+        return 1;
+    }
+    return 0;
+}
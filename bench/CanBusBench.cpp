@@ -0,0 +1,136 @@
+// Measures the CAN signal codec and runs the car's sensors over a virtual
+// 500 kbit/s bus while background traffic raises the bus load, reporting
+// how latency and frame loss at the diagnostic ECU change.
+// Usage: can_bus_bench [codec frames] [simulated seconds]
+#include "../can/CanSensorBridge.hpp"
+#include "../can/VirtualCanBus.hpp"
+#include "../ECU/DiagnosticsECU.hpp"
+#include "../logger/CarLogger.hpp"
+#include "../Sensors/BatteryLevelSensor.hpp"
+#include "../Sensors/RadarSensor.hpp"
+#include "../Sensors/SpeedSensor.hpp"
+#include "../Sensors/TemperatureSensor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+static const char* Type_Names[Sensor_Types_Count] = {"speed", "temperature", "radar", "battery"}; 
+
+// Encodes and decodes frames of every sensor type and reports the rate and
+// the worst round-trip error per type.
+static void CodecBench(std::size_t frames) {
+    double maxError[Sensor_Types_Count] = {0, 0, 0, 0}; 
+    const double range[Sensor_Types_Count] = {320.0, 320.0, 50.0, 100.0}; 
+    double checksum = 0; 
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now(); 
+    for (std::size_t i = 0; i < frames; i++) {
+        const int t = (int)(i & 3); 
+        const double value = range[t] * (double)((i * 2654435761u) & 0xFFFF) / 65535.0; 
+        const CanFrame frame = EncodeSensorFrame(SensorTypes(t), value, (std::uint8_t)i); 
+        SensorTypes type; 
+        double decoded; 
+        std::uint8_t counter; 
+        DecodeSensorFrame(frame, type, decoded, counter); 
+        checksum += decoded + counter; 
+        maxError[t] = std::max(maxError[t], std::fabs(decoded - value)); 
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); 
+    std::printf("codec: %zu encode+decode round trips in %.3f s (%.1f M/s), checksum %.0f\n", 
+                frames, seconds, frames / seconds / 1e6, checksum); 
+    for (int t = 0; t < Sensor_Types_Count; t++) {
+        std::printf("  %-11s max round-trip error %.4f\n", Type_Names[t], maxError[t]); 
+    }
+}
+
+// A message sent periodically on the bus.
+struct PeriodicSource {
+    TimestampNs period; 
+    TimestampNs next; 
+    CanSensorNode* sensor; // Sensor message, or null for background traffic
+    VirtualCanBus::NodeId node; 
+    CanFrame frame; 
+}; 
+
+// Runs one car's sensors plus background messages on a bus and prints one row.
+static void BusScenario(int background, bool fd, double seconds) {
+    CanBusConfig config; 
+    VirtualCanBus bus(config); 
+    std::shared_ptr<Sensor> sensors[Sensor_Types_Count] = {
+        std::make_shared<SpeedSensor>(), std::make_shared<TemperatureSensor>(), 
+        std::make_shared<RadarSensor>(), std::make_shared<BatteryLevelSensor>()}; 
+    const TimestampNs periods[Sensor_Types_Count] = {10000000, 1000000000, 50000000, 1000000000}; 
+
+    std::shared_ptr<DiagnosticECU> ecu = std::make_shared<DiagnosticECU>(); 
+    CanEcuNode ecuNode(bus, ecu); 
+    std::vector<std::unique_ptr<CanSensorNode>> sensorNodes; 
+    std::vector<PeriodicSource> sources; 
+    for (int t = 0; t < Sensor_Types_Count; t++) {
+        sensorNodes.push_back(std::make_unique<CanSensorNode>(bus, sensors[t], SensorTypes(t), fd)); 
+        ecuNode.Listen(SensorTypes(t), sensors[t]->getSensorID()); 
+        sources.push_back(PeriodicSource{periods[t], 0, sensorNodes.back().get(), 0, CanFrame()}); 
+    }
+    // Background traffic: 8-byte messages every 10 ms with identifiers between speed and battery
+    for (int i = 0; i < background; i++) {
+        CanFrame frame; 
+        frame.id = 0x100 + i; 
+        frame.length = 8; 
+        frame.fd = fd; 
+        frame.bitRateSwitch = fd; 
+        sources.push_back(PeriodicSource{10000000, (TimestampNs)i * 250000, nullptr, bus.AddNode("filler"), frame}); 
+    }
+
+    const TimestampNs step = 50000; 
+    const TimestampNs end = (TimestampNs)(seconds * 1e9); 
+    for (TimestampNs now = 0; now <= end; now += step) {
+        for (PeriodicSource& s : sources) {
+            if (s.next > now) {
+                continue; 
+            }
+            if (s.sensor) {
+                s.sensor->Publish(now); 
+            } else {
+                bus.Transmit(s.node, s.frame, now); 
+            }
+            s.next += s.period; 
+        }
+        bus.RunUntil(now); 
+    }
+
+    const CanBusStats& stats = bus.getStats(); 
+    const CanIdStats& speed = stats.perId.at(SensorMessageId(SensorTypes::SPEED_SENSOR)); 
+    const CanIdStats& radar = stats.perId.at(SensorMessageId(SensorTypes::RADAR_SENSOR)); 
+    // The lowest-priority message never wins arbitration on a saturated bus
+    auto battery = stats.perId.find(SensorMessageId(SensorTypes::BATTERY_LEVEL_SENSOR)); 
+    char batteryMax[16] = "starved"; 
+    if (battery != stats.perId.end()) {
+        std::snprintf(batteryMax, sizeof(batteryMax), "%.0f", battery->second.maxLatency / 1e3); 
+    }
+    std::printf("%-9s %10d %6.1f%% %9.0f %9.0f %9.0f %9s %8llu %8llu %8llu\n", 
+                fd ? "FD+BRS" : "classic", background, stats.load() * 100.0, 
+                radar.maxLatency / 1e3, speed.totalLatency / 1e3 / std::max<std::uint64_t>(1, speed.frames), 
+                speed.maxLatency / 1e3, batteryMax, 
+                (unsigned long long)stats.dropped, (unsigned long long)ecuNode.getReceivedCount(), 
+                (unsigned long long)ecuNode.getLostCount()); 
+}
+
+int main(int argc, char** argv) {
+    const std::size_t frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000; 
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 2.0; 
+    Logger::getInstance().setEnabled(false); 
+
+    CodecBench(frames); 
+    std::printf("\nbus at 500 kbit/s (FD data phase 2 Mbit/s), latencies in us\n"); 
+    std::printf("%-9s %10s %7s %9s %9s %9s %9s %8s %8s %8s\n", 
+                "format", "background", "load", "radarMax", "speedAvg", "speedMax", "battMax", "dropped", "ecuRx", "ecuLost"); 
+    const int backgrounds[] = {0, 10, 20, 30, 34, 36, 40}; 
+    for (bool fd : {false, true}) {
+        for (int b : backgrounds) {
+            BusScenario(b, fd, seconds); 
+        }
+    }
+    return 0; 
+}
@@ -0,0 +1,151 @@
+// Measures saving and restoring a fleet, and checks that a restored run
+// carries on exactly where the saved one stopped. A seeded fleet is built,
+// warmed up and checkpointed, then run on as the reference. The checkpoint
+// is then restored and run for the same stretch, which must end with the
+// same sensor values and alerts; finally it is restored twice more with
+// reseeded sensors, and those forks must differ from the reference and from
+// each other. One fleet is alive at a time.
+// Usage: checkpoint_bench [cars] [simulated seconds per run] [checkpoint path]
+#include "../car/CarPool.hpp"
+#include "../logger/CarLogger.hpp"
+#include "../metrics/CarMetrics.hpp"
+#include "../sim/Checkpoint.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// FNV-1a over every sensor value of every car and the alert counters raised during the run
+static std::uint64_t Fingerprint(CarPool& pool, const std::uint64_t* alertsBefore) {
+    std::uint64_t hash = 14695981039346656037ull;
+    const auto mix = [&hash](std::uint64_t word) {
+        for (int i = 0; i < 8; i++) {
+            hash = (hash ^ ((word >> (8 * i)) & 0xff)) * 1099511628211ull;
+        }
+    };
+    for (std::size_t i = 0; i < pool.size(); i++) {
+        for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+            const double value = pool[i].getSensorValue(SensorTypes(type));
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            mix(bits);
+        }
+    }
+    for (int i = 0; i < CAR_ALERT_COUNT; i++) {
+        mix(CarMetrics::get().alerts[i]->value() - alertsBefore[i]);
+    }
+    return hash;
+}
+
+// Runs the engines for a stretch and fingerprints the fleet
+static std::uint64_t RunAndFingerprint(CarPool& pool, std::vector<std::unique_ptr<EventEngine>>& engines, std::chrono::nanoseconds duration) {
+    std::uint64_t alertsBefore[CAR_ALERT_COUNT];
+    for (int i = 0; i < CAR_ALERT_COUNT; i++) {
+        alertsBefore[i] = CarMetrics::get().alerts[i]->value();
+    }
+    for (std::unique_ptr<EventEngine>& engine : engines) {
+        engine->RunFor(duration);
+    }
+    return Fingerprint(pool, alertsBefore);
+}
+
+// Restores the checkpoint into a fresh pool, reseeding every sensor when fork is not zero, and runs it
+static bool RestoreAndRun(const Checkpoint& checkpoint, std::uint64_t fork, std::chrono::nanoseconds duration, double& restoreMs, std::uint64_t& fingerprint) {
+    CarPool pool(checkpoint.getCarCount());
+    std::vector<std::unique_ptr<EventEngine>> engines;
+    std::string error;
+    const Clock::time_point start = Clock::now();
+    if (!checkpoint.Restore(pool, engines, error)) {
+        std::printf("restore failed: %s\n", error.c_str());
+        return false;
+    }
+    restoreMs = MillisecondsSince(start);
+    if (fork != 0) {
+        Sensor::SetSeedBase(fork);
+        for (std::size_t i = 0; i < pool.size(); i++) {
+            for (const std::shared_ptr<Sensor>& sensor : pool[i].getSensors()) {
+                sensor->Reseed();
+            }
+        }
+    }
+    fingerprint = RunAndFingerprint(pool, engines, duration);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t cars = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const std::chrono::nanoseconds duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(argc > 2 ? std::atof(argv[2]) : 0.05));
+    const std::string path = argc > 3 ? argv[3] : "checkpoint_bench.ckpt";
+
+    Logger::getInstance().setEnabled(false);
+    Sensor::SetSeedBase(42);
+    const ConcurrentRunnerConfig config = ConcurrentRunnerConfig::Defaults();
+    double buildMs = 0.0;
+    double saveMs = 0.0;
+    std::uint64_t reference = 0;
+    {
+        Clock::time_point start = Clock::now();
+        CarPool pool(cars);
+        pool.emplaceMany(cars, "rio", "kia");
+        std::vector<Car*> fleet;
+        for (std::size_t i = 0; i < pool.size(); i++) {
+            fleet.push_back(&pool[i]);
+        }
+        std::vector<std::unique_ptr<EventEngine>> engines;
+        engines.push_back(std::make_unique<EventEngine>(fleet, config));
+        buildMs = MillisecondsSince(start);
+        engines[0]->RunFor(duration);
+
+        std::string error;
+        start = Clock::now();
+        if (!Checkpoint::Save(path, pool, {engines[0].get()}, error)) {
+            std::printf("save failed: %s\n", error.c_str());
+            return 1;
+        }
+        saveMs = MillisecondsSince(start);
+        reference = RunAndFingerprint(pool, engines, duration);
+    }
+
+    Checkpoint checkpoint;
+    std::string error;
+    Clock::time_point start = Clock::now();
+    if (!checkpoint.Open(path, error)) {
+        std::printf("open failed: %s\n", error.c_str());
+        return 1;
+    }
+    const double openMs = MillisecondsSince(start);
+    double restoreMs = 0.0;
+    std::uint64_t resumed = 0;
+    double forkMs[2] = {};
+    std::uint64_t forks[2] = {};
+    if (!RestoreAndRun(checkpoint, 0, duration, restoreMs, resumed) ||
+        !RestoreAndRun(checkpoint, 1001, duration, forkMs[0], forks[0]) ||
+        !RestoreAndRun(checkpoint, 1002, duration, forkMs[1], forks[1])) {
+        return 1;
+    }
+    std::remove(path.c_str());
+
+    std::printf("cars=%zu, checkpoint %.1f MB\n", cars, checkpoint.getFileBytes() / 1e6);
+    std::printf("build + start:  %8.2f ms\n", buildMs);
+    std::printf("save:           %8.2f ms\n", saveMs);
+    std::printf("open (mmap):    %8.2f ms\n", openMs);
+    std::printf("restore:        %8.2f ms (forks: %.2f ms, %.2f ms)\n", restoreMs, forkMs[0], forkMs[1]);
+    std::printf("fingerprints: reference %016llx, resumed %016llx, forks %016llx %016llx\n",
+                (unsigned long long)reference, (unsigned long long)resumed, (unsigned long long)forks[0], (unsigned long long)forks[1]);
+    if (resumed != reference || forks[0] == reference || forks[1] == reference || forks[0] == forks[1]) {
+        std::printf("MISMATCH: the resumed run must match the reference and the forks must differ from it and from each other\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+// Measures the fixed-point sample kernels: batch encode/decode throughput
+// against the scalar path, worst-case quantisation error per sensor type,
+// and the fleet store footprint compared to plain doubles.
+#include "../telemetry/CompactSample.hpp"
+#include "../telemetry/FleetSampleStore.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock; 
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count(); 
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000; 
+    const double ranges[Sensor_Types_Count] = {320.0, 320.0, 50.0, 100.0}; 
+    const char* names[Sensor_Types_Count] = {"speed", "temperature", "radar", "battery"}; 
+
+    std::default_random_engine engine(42); 
+    std::vector<double> values(n); 
+    std::vector<double> decoded(n); 
+    std::vector<CompactSample> codes(n); 
+
+    for (int type = 0; type < Sensor_Types_Count; type++) {
+        std::uniform_real_distribution<double> dist(0, ranges[type]); 
+        for (auto& v : values) {
+            v = dist(engine); 
+        }
+        const SampleEncoding& enc = EncodingFor(type); 
+
+        Clock::time_point start = Clock::now(); 
+        for (std::size_t i = 0; i < n; i++) {
+            codes[i] = EncodeSample(values[i], enc); 
+        }
+        const double scalarEncode = SecondsSince(start); 
+
+        start = Clock::now(); 
+        EncodeSamples(values.data(), codes.data(), n, enc); 
+        const double batchEncode = SecondsSince(start); 
+
+        start = Clock::now(); 
+        DecodeSamples(codes.data(), decoded.data(), n, enc); 
+        const double batchDecode = SecondsSince(start); 
+
+        double worst = 0.0; 
+        for (std::size_t i = 0; i < n; i++) {
+            worst = std::max(worst, std::fabs(decoded[i] - values[i])); 
+        }
+        std::printf("%-12s encode scalar %7.1f M/s, batch %7.1f M/s, decode batch %7.1f M/s, max error %.6f\n", 
+                    names[type], n / scalarEncode / 1e6, n / batchEncode / 1e6, n / batchDecode / 1e6, worst); 
+    }
+
+    const std::size_t cars = 100000; 
+    FleetSampleStore store(cars); 
+    std::printf("fleet store for %zu cars: %zu bytes compact vs %zu bytes as double\n", 
+                cars, store.bytes(), cars * Sensor_Types_Count * sizeof(double)); 
+    return 0; 
+}
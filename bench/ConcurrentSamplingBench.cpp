@@ -0,0 +1,111 @@
+// Runs the free-running producer/consumer mode on a fleet and reports
+// producer, consumer and snapshot reader throughput.
+// Usage: concurrent_sampling_bench [cars] [seconds] [producers/type]
+//        [consumers] [readers] [read period us] [telemetry endpoint or -]
+//        [shared-memory window name or -] [metrics: http:<port> or a file].
+// Build with -DCARECU_ENABLE_TSAN=ON to check the mode under ThreadSanitizer.
+#include "../car/CarPool.hpp"
+#include "../logger/CarLogger.hpp"
+#include "../metrics/Metrics.hpp"
+#include "../metrics/MetricsServer.hpp"
+#include "../sim/ConcurrentRunner.hpp"
+#include "../telemetry/SharedTelemetryWindow.hpp"
+#include "../telemetry/TelemetryExporter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv) {
+    const std::size_t carCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000; 
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 2.0; 
+    ConcurrentRunnerConfig config = ConcurrentRunnerConfig::Defaults(); 
+    config.producersPerType = argc > 3 ? std::atoi(argv[3]) : 1; 
+    config.consumers = argc > 4 ? std::atoi(argv[4]) : 2; 
+    config.readers = argc > 5 ? std::atoi(argv[5]) : 1; 
+    config.readPeriod = std::chrono::microseconds(argc > 6 ? std::atoi(argv[6]) : 0); 
+
+    CarPool pool(carCount); 
+    pool.emplaceMany(carCount, "rio", "kia"); 
+    std::vector<Car*> cars; 
+    for (std::size_t i = 0; i < pool.size(); i++) {
+        cars.push_back(&pool[i]); 
+    }
+
+    Logger::getInstance().setEnabled(false); 
+    ConcurrentRunner runner(cars, config); 
+    std::unique_ptr<TelemetryExporter> exporter; 
+    if (argc > 7 && std::string(argv[7]) != "-") {
+        TelemetryExporterConfig exportConfig; 
+        exportConfig.endpoint = argv[7]; 
+        exporter.reset(new TelemetryExporter(exportConfig)); 
+        runner.SetExporter(exporter.get()); 
+    }
+    std::unique_ptr<SharedTelemetryWindow> window; 
+    if (argc > 8 && std::string(argv[8]) != "-") {
+        try {
+            window.reset(new SharedTelemetryWindow(SharedTelemetryWindow::Create(argv[8], carCount))); 
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s\n", e.what()); 
+            return 1; 
+        }
+        runner.SetTelemetryWindow(window.get()); 
+        std::printf("publishing %zu cars to shared memory %s (%zu bytes)\n", carCount, argv[8], window->getMappedBytes()); 
+        std::fflush(stdout); 
+    }
+    // Metrics are served while the run lasts, or written to a file every second
+    const std::string metricsTarget = argc > 9 ? argv[9] : ""; 
+    std::unique_ptr<MetricsServer> metricsServer; 
+    if (metricsTarget.compare(0, 5, "http:") == 0) {
+        metricsServer.reset(new MetricsServer((unsigned short)std::atoi(metricsTarget.c_str() + 5))); 
+        std::printf("serving metrics at http://127.0.0.1:%u/metrics\n", metricsServer->getPort()); 
+        std::fflush(stdout); 
+    }
+    const bool metricsFile = !metricsTarget.empty() && !metricsServer; 
+
+    runner.Start(); 
+    const auto end = std::chrono::steady_clock::now() + 
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds)); 
+    while (std::chrono::steady_clock::now() < end) {
+        std::this_thread::sleep_until(std::min(end, std::chrono::steady_clock::now() + std::chrono::seconds(1))); 
+        if (metricsFile) {
+            MetricsRegistry::getInstance().WriteFile(metricsTarget); 
+        }
+    }
+    runner.Stop(); 
+
+    ThroughputReport r = runner.Report(); 
+    std::printf("cars=%zu producers/type=%u consumers=%u seconds=%.2f\n", 
+                carCount, config.producersPerType, config.consumers, r.seconds); 
+    std::printf("samples: speed=%llu temperature=%llu radar=%llu battery=%llu\n", 
+                (unsigned long long)r.samples[0], (unsigned long long)r.samples[1], 
+                (unsigned long long)r.samples[2], (unsigned long long)r.samples[3]); 
+    std::printf("producer throughput: %.0f samples/s\n", r.samplesPerSecond); 
+    std::printf("consumer throughput: %.0f car ECU cycles/s\n", r.cyclesPerSecond); 
+    std::printf("snapshots: read=%llu retried=%llu (%.0f reads/s over %u readers)\n", 
+                (unsigned long long)r.snapshotReads, (unsigned long long)r.snapshotRetries, 
+                r.seconds > 0 ? r.snapshotReads / r.seconds : 0.0, config.readers); 
+    std::printf("notifications: delivered=%llu suppressed=%llu\n", 
+                (unsigned long long)Sensor::getTotalDeliveredCount(), 
+                (unsigned long long)Sensor::getTotalSuppressedCount()); 
+    if (metricsServer) {
+        std::printf("metrics: %llu scrapes served\n", (unsigned long long)metricsServer->getScrapeCount()); 
+    } else if (metricsFile) {
+        MetricsRegistry::getInstance().WriteFile(metricsTarget); 
+        std::printf("metrics: written to %s\n", metricsTarget.c_str()); 
+    }
+    if (exporter) {
+        exporter->Stop(); // Flushes the last batch
+        const TelemetryExporterStats e = exporter->getStats(); 
+        std::printf("telemetry: queued=%llu dropped=%llu sent=%llu datagrams=%llu failed=%llu sendmmsg calls=%llu\n", 
+                    (unsigned long long)e.samplesQueued, (unsigned long long)e.samplesDropped, 
+                    (unsigned long long)e.samplesSent, (unsigned long long)e.datagramsSent, 
+                    (unsigned long long)e.datagramsFailed, (unsigned long long)e.sendCalls); 
+    }
+    return 0; 
+}
@@ -0,0 +1,150 @@
+// Measures what a settings reload costs the threads reading the settings.
+// Reader threads look up the runtime settings in a loop while a writer
+// installs a new version every few microseconds: first with no writer,
+// then through RCU, then with the same settings behind a std::shared_mutex.
+// Every version is installed with maxSpeed equal to its version number,
+// so a reader that saw a freed or half-written version would notice.
+// Usage: config_reload_bench [reader threads] [seconds per phase] [microseconds between installs]
+#include "../config/RuntimeConfig.hpp"
+#include "../logger/CarLogger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+struct PhaseResult {
+    double readNs; ///< Wall time per read, per reader thread
+    std::uint64_t installs; ///< Versions installed during the phase
+    std::size_t maxRetired; ///< Most versions waiting for a grace period at once
+    bool consistent; ///< Every version read matched its fields
+};
+
+// Readers look the settings up through RCU; the writer installs and reclaims when installEvery > 0
+static PhaseResult RunRcu(int readers, double seconds, std::chrono::microseconds installEvery) {
+    std::atomic<bool> stop(false);
+    std::atomic<bool> consistent(true);
+    std::vector<std::uint64_t> reads(readers, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < readers; t++) {
+        threads.emplace_back([&, t] {
+            std::uint64_t n = 0;
+            std::uint64_t last = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                RcuReadGuard guard;
+                const RuntimeSettings* s = RuntimeConfig::get().Current();
+                if (s->version < last || (s->version > 1 && s->limits.maxSpeed != (double)s->version)) {
+                    consistent.store(false, std::memory_order_relaxed);
+                }
+                last = s->version;
+                n++;
+            }
+            reads[t] = n;
+        });
+    }
+    PhaseResult r{0, 0, 0, true};
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    RuntimeSettings next = RuntimeSettings::Defaults();
+    while (Clock::now() < end) {
+        if (installEvery.count() == 0) {
+            std::this_thread::sleep_until(end);
+            break;
+        }
+        {
+            RcuReadGuard guard;
+            next.limits.maxSpeed = (double)(RuntimeConfig::get().Current()->version + 1);
+        }
+        RuntimeConfig::get().Install(next);
+        r.installs++;
+        r.maxRetired = std::max(r.maxRetired, Rcu::getRetiredCount());
+        Rcu::Reclaim();
+        std::this_thread::sleep_for(installEvery);
+    }
+    stop.store(true);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    const double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    std::uint64_t total = 0;
+    for (std::uint64_t n : reads) {
+        total += n;
+    }
+    r.readNs = total > 0 ? wall * 1e9 * readers / total : 0.0;
+    r.consistent = consistent.load();
+    Rcu::Synchronize();
+    return r;
+}
+
+// The same pattern with the settings copied under a reader-writer lock
+static PhaseResult RunSharedMutex(int readers, double seconds, std::chrono::microseconds installEvery) {
+    std::shared_mutex lock;
+    RuntimeSettings shared = RuntimeSettings::Defaults();
+    std::atomic<bool> stop(false);
+    std::atomic<bool> consistent(true);
+    std::vector<std::uint64_t> reads(readers, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < readers; t++) {
+        threads.emplace_back([&, t] {
+            std::uint64_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                std::shared_lock<std::shared_mutex> guard(lock);
+                if (shared.version > 1 && shared.limits.maxSpeed != (double)shared.version) {
+                    consistent.store(false, std::memory_order_relaxed);
+                }
+                n++;
+            }
+            reads[t] = n;
+        });
+    }
+    PhaseResult r{0, 0, 0, true};
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    while (Clock::now() < end) {
+        {
+            std::unique_lock<std::shared_mutex> guard(lock);
+            shared.version++;
+            shared.limits.maxSpeed = (double)shared.version;
+        }
+        r.installs++;
+        std::this_thread::sleep_for(installEvery);
+    }
+    stop.store(true);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    const double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    std::uint64_t total = 0;
+    for (std::uint64_t n : reads) {
+        total += n;
+    }
+    r.readNs = total > 0 ? wall * 1e9 * readers / total : 0.0;
+    r.consistent = consistent.load();
+    return r;
+}
+
+int main(int argc, char** argv) {
+    const int readers = argc > 1 ? std::atoi(argv[1]) : 2;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+    const std::chrono::microseconds installEvery(argc > 3 ? std::atoi(argv[3]) : 10);
+
+    Logger::getInstance().setEnabled(false);
+    const PhaseResult idle = RunRcu(readers, seconds, std::chrono::microseconds(0));
+    const PhaseResult rcu = RunRcu(readers, seconds, installEvery);
+    const PhaseResult locked = RunSharedMutex(readers, seconds, installEvery);
+    std::printf("readers=%d, one install every %lld us\n", readers, (long long)installEvery.count());
+    std::printf("rcu, no writer:   %6.1f ns/read\n", idle.readNs);
+    std::printf("rcu, reloading:   %6.1f ns/read, %llu installs, at most %zu versions awaiting reclamation, %llu reclaimed in total\n",
+                rcu.readNs, (unsigned long long)rcu.installs, rcu.maxRetired, (unsigned long long)Rcu::getReclaimedCount());
+    std::printf("shared_mutex:     %6.1f ns/read, %llu installs\n", locked.readNs, (unsigned long long)locked.installs);
+    if (!idle.consistent || !rcu.consistent || !locked.consistent || Rcu::getRetiredCount() != 0) {
+        std::printf("MISMATCH: a reader saw a settings version that did not match its fields, or versions were left unreclaimed\n");
+        return 1;
+    }
+    return 0;
+}
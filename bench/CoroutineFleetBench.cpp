@@ -0,0 +1,64 @@
+// Runs every sensor and ECU of a fleet as a coroutine on a thread-per-core
+// executor in virtual time, and reports task count, frame memory and
+// resume throughput.
+// Usage: coroutine_fleet_bench [cars] [simulated seconds] [workers]
+#include "../car/CarPool.hpp"
+#include "../logger/CarLogger.hpp"
+#include "../sim/Executor.hpp"
+#include "../sim/FleetTasks.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Resident set size of the process in kB, or 0 where /proc is unavailable.
+static long ResidentKb() {
+    std::ifstream status("/proc/self/status"); 
+    std::string key; 
+    while (status >> key) {
+        if (key == "VmRSS:") {
+            long kb = 0; 
+            status >> kb; 
+            return kb; 
+        }
+        status.ignore(4096, '\n'); 
+    }
+    return 0; 
+}
+
+int main(int argc, char** argv) {
+    const std::size_t carCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000; 
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 10.0; 
+    const unsigned workers = argc > 3 ? std::atoi(argv[3]) : 0; 
+
+    Logger::getInstance().setEnabled(false); 
+    const long baseKb = ResidentKb(); 
+    CarPool pool(carCount); 
+    pool.emplaceMany(carCount, "rio", "kia"); 
+    std::vector<Car*> cars; 
+    for (std::size_t i = 0; i < pool.size(); i++) {
+        cars.push_back(&pool[i]); 
+    }
+    const long carsKb = ResidentKb(); 
+
+    Executor executor(workers, ClockMode::VIRTUAL); 
+    const std::size_t tasks = SpawnFleetTasks(executor, cars, ConcurrentRunnerConfig::Defaults()); 
+    const long tasksKb = ResidentKb(); 
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now(); 
+    executor.RunFor(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds))); 
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); 
+
+    std::printf("cars=%zu sensors=%zu tasks=%zu workers=%u\n", 
+                carCount, carCount * MAX_SENSOR_NUMBER, tasks, executor.getWorkerCount()); 
+    std::printf("task frames: %llu bytes total, %.0f bytes/task\n", 
+                (unsigned long long)Task::getLiveFrameBytes(), 
+                tasks ? (double)Task::getLiveFrameBytes() / tasks : 0.0); 
+    std::printf("rss: cars=%ld kB, tasks+subscriptions=%ld kB\n", carsKb - baseKb, tasksKb - carsKb); 
+    std::printf("simulated %.1f s in %.2f s wall (%.1fx real time)\n", seconds, wall, wall > 0 ? seconds / wall : 0.0); 
+    std::printf("resumes=%llu (%.0f/s)\n", (unsigned long long)executor.getResumeCount(), 
+                wall > 0 ? executor.getResumeCount() / wall : 0.0); 
+    return 0; 
+}
@@ -0,0 +1,192 @@
+// Drives a fleet through the discrete-event engine with the default rates
+// (speed 100 Hz, radar 20 Hz, temperature and battery 1 Hz, ECUs 50 Hz),
+// reports events per second, compares the event schedule alone with one
+// 4-ary heap and with std::priority_queue holding every event, and shows
+// that a sparse fleet crosses idle simulated time at no cost. Finally two
+// fleets with the same seed are run, one on a single engine and one split
+// over two, and must raise exactly the same alerts.
+// Usage: event_engine_bench [cars] [simulated seconds]
+#include "../car/CarPool.hpp"
+#include "../logger/CarLogger.hpp"
+#include "../metrics/CarMetrics.hpp"
+#include "../sim/EventEngine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Sum of event times, so the compiler cannot drop any of the queue loops
+static std::int64_t RunSchedule(EventSchedule& schedule, std::size_t events) {
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < events; i++) {
+        sum += schedule.Next().time;
+        schedule.Advance();
+    }
+    return sum;
+}
+
+static std::int64_t RunQueue(EventQueue& q, const std::int64_t* period, std::size_t events) {
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < events; i++) {
+        SimEvent e = q.Top();
+        sum += e.time;
+        e.time += period[e.kind];
+        q.ReplaceTop(e);
+    }
+    return sum;
+}
+
+struct Later {
+    bool operator()(const SimEvent& a, const SimEvent& b) const { return b < a; }
+};
+
+static std::int64_t RunPriorityQueue(std::priority_queue<SimEvent, std::vector<SimEvent>, Later>& q,
+                                     const std::int64_t* period, std::size_t events) {
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < events; i++) {
+        SimEvent e = q.top();
+        q.pop();
+        sum += e.time;
+        e.time += period[e.kind];
+        q.push(e);
+    }
+    return sum;
+}
+
+// Builds a seeded fleet, runs it on the given number of engines and collects the alerts it raised
+static void RunSeeded(std::size_t carCount, std::size_t engineCount, std::chrono::nanoseconds duration, std::uint64_t* alerts) {
+    std::uint64_t before[CAR_ALERT_COUNT];
+    for (int i = 0; i < CAR_ALERT_COUNT; i++) {
+        before[i] = CarMetrics::get().alerts[i]->value();
+    }
+    Sensor::SetSeedBase(7);
+    CarPool pool(carCount);
+    pool.emplaceMany(carCount, "rio", "kia");
+    std::vector<std::unique_ptr<EventEngine>> engines;
+    for (std::size_t e = 0; e < engineCount; e++) {
+        std::vector<Car*> slice;
+        const std::size_t first = e * carCount / engineCount;
+        for (std::size_t i = first; i < (e + 1) * carCount / engineCount; i++) {
+            pool[i].EnableSensorFusion();
+            slice.push_back(&pool[i]);
+        }
+        engines.push_back(std::make_unique<EventEngine>(slice, ConcurrentRunnerConfig::Defaults(), first, carCount));
+    }
+    for (std::unique_ptr<EventEngine>& engine : engines) {
+        engine->RunFor(duration);
+    }
+    for (std::size_t i = 0; i < pool.size(); i++) {
+        pool[i].DisplayStatus();
+    }
+    for (int i = 0; i < CAR_ALERT_COUNT; i++) {
+        alerts[i] = CarMetrics::get().alerts[i]->value() - before[i];
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t carCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 10.0;
+    const ConcurrentRunnerConfig config = ConcurrentRunnerConfig::Defaults();
+
+    // Scheduling alone, with one recurring event per sensor and car
+    std::int64_t period[EVENT_KIND_COUNT];
+    for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+        period[type] = std::chrono::nanoseconds(config.samplePeriod[type]).count();
+    }
+    period[EVENT_KIND_ECU] = std::chrono::nanoseconds(config.consumePeriod).count();
+    EventSchedule schedule(period, EVENT_KIND_COUNT, (std::uint32_t)carCount);
+    EventQueue fourAry(carCount * EVENT_KIND_COUNT);
+    std::priority_queue<SimEvent, std::vector<SimEvent>, Later> binary;
+    for (std::uint32_t car = 0; car < carCount; car++) {
+        for (std::uint32_t kind = 0; kind < EVENT_KIND_COUNT; kind++) {
+            const SimEvent e{(std::int64_t)(period[kind] * car / carCount), car, kind};
+            fourAry.Push(e);
+            binary.push(e);
+        }
+    }
+    const std::size_t queueEvents = 20 * carCount * EVENT_KIND_COUNT;
+    Clock::time_point start = Clock::now();
+    const std::int64_t scheduleSum = RunSchedule(schedule, queueEvents);
+    const double scheduleNs = SecondsSince(start) * 1e9 / queueEvents;
+    start = Clock::now();
+    const std::int64_t fourArySum = RunQueue(fourAry, period, queueEvents);
+    const double fourAryNs = SecondsSince(start) * 1e9 / queueEvents;
+    start = Clock::now();
+    const std::int64_t binarySum = RunPriorityQueue(binary, period, queueEvents);
+    const double binaryNs = SecondsSince(start) * 1e9 / queueEvents;
+    std::printf("scheduling %zu recurring events: lanes %.1f ns/event (%.1fM events/s), "
+                "one 4-ary heap %.1f ns/event, std::priority_queue %.1f ns/event\n",
+                schedule.size(), scheduleNs, 1e3 / scheduleNs, fourAryNs, binaryNs);
+
+    // The whole fleet
+    Logger::getInstance().setEnabled(false);
+    CarPool pool(carCount);
+    pool.emplaceMany(carCount, "rio", "kia");
+    std::vector<Car*> cars;
+    for (std::size_t i = 0; i < pool.size(); i++) {
+        cars.push_back(&pool[i]);
+    }
+    EventEngine engine(cars, config);
+    engine.RunFor(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds)));
+    const EventEngineStats& stats = engine.getStats();
+    std::printf("cars=%zu recurring events=%zu simulated %.1f s in %.2f s wall (%.1fx real time)\n",
+                carCount, engine.getPendingCount(), seconds, stats.wallSeconds, seconds / stats.wallSeconds);
+    std::printf("events=%llu (%.0f/s): speed=%llu temperature=%llu radar=%llu battery=%llu ecu=%llu\n",
+                (unsigned long long)stats.events, stats.eventsPerSecond,
+                (unsigned long long)stats.perKind[(int)SensorTypes::SPEED_SENSOR],
+                (unsigned long long)stats.perKind[(int)SensorTypes::TEMPERATURE_SENSOR],
+                (unsigned long long)stats.perKind[(int)SensorTypes::RADAR_SENSOR],
+                (unsigned long long)stats.perKind[(int)SensorTypes::BATTERY_LEVEL_SENSOR],
+                (unsigned long long)stats.perKind[EVENT_KIND_ECU]);
+
+    // One car sampled once a minute: a day of simulated time is mostly idle and should take no time
+    ConcurrentRunnerConfig sparse = config;
+    for (auto& p : sparse.samplePeriod) {
+        p = std::chrono::minutes(1);
+    }
+    sparse.consumePeriod = std::chrono::minutes(1);
+    std::vector<Car*> one(1, &pool[0]);
+    EventEngine idle(one, sparse);
+    idle.RunFor(std::chrono::hours(24));
+    std::printf("sparse: 1 car, 1 event/min per kind, 24 h simulated in %.3f ms wall, %llu events\n",
+                idle.getStats().wallSeconds * 1e3, (unsigned long long)idle.getStats().events);
+
+    // The same seed must raise the same alerts however fast the machine is and however the fleet is split
+    const std::size_t seededCars = std::min<std::size_t>(carCount, 2000);
+    std::uint64_t oneEngine[CAR_ALERT_COUNT];
+    std::uint64_t twoEngines[CAR_ALERT_COUNT];
+    RunSeeded(seededCars, 1, std::chrono::seconds(2), oneEngine);
+    RunSeeded(seededCars, 2, std::chrono::seconds(2), twoEngines);
+    bool sameAlerts = true;
+    std::uint64_t alertCount = 0;
+    for (int i = 0; i < CAR_ALERT_COUNT; i++) {
+        sameAlerts = sameAlerts && oneEngine[i] == twoEngines[i];
+        alertCount += oneEngine[i];
+    }
+    std::printf("seeded: %zu cars, 2 s simulated twice, %llu alerts on one engine, %llu on two\n", seededCars,
+                (unsigned long long)alertCount, (unsigned long long)std::accumulate(twoEngines, twoEngines + CAR_ALERT_COUNT, std::uint64_t(0)));
+    if (!sameAlerts) {
+        std::printf("MISMATCH: two runs with the same seed raised different alerts\n");
+        return 1;
+    }
+
+    // Each kind must have fired once per period and car, give or take the stagger
+    const std::uint64_t expectedSpeed = (std::uint64_t)(seconds * 1e9 / period[(int)SensorTypes::SPEED_SENSOR]) * carCount;
+    if (scheduleSum != binarySum || fourArySum != binarySum || stats.perKind[(int)SensorTypes::SPEED_SENSOR] + carCount < expectedSpeed ||
+        stats.perKind[(int)SensorTypes::SPEED_SENSOR] > expectedSpeed + carCount) {
+        std::printf("MISMATCH: queues disagree or event counts are off\n");
+        return 1;
+    }
+    return 0;
+}
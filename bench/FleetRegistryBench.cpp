@@ -0,0 +1,161 @@
+// Registers a large fleet, then measures lock-free lookups alone and while a
+// churn thread keeps removing and re-registering cars, compares them with a
+// std::unordered_map behind a std::shared_mutex, and scans the fleet with
+// partitions handed out to worker threads.
+// Usage: fleet_registry_bench [cars] [lookups per reader] [readers]
+#include "../car/CarPool.hpp"
+#include "../car/FleetRegistry.hpp"
+#include "../logger/CarLogger.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#define BENCH_DISTINCT_CARS 256 ///< Real cars behind the registered keys; the registry only stores pointers
+
+typedef std::chrono::steady_clock Clock;
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// The usual alternative: one map, readers share a lock, writers take it exclusively
+struct LockedMap {
+    std::unordered_map<std::uint64_t, Car*> map;
+    mutable std::shared_mutex lock;
+
+    Car* Find(std::uint64_t id) const {
+        std::shared_lock<std::shared_mutex> guard(lock);
+        auto it = map.find(id);
+        return it == map.end() ? nullptr : it->second;
+    }
+    void Insert(std::uint64_t id, Car* car) {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        map.emplace(id, car);
+    }
+    void Remove(std::uint64_t id) {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        map.erase(id);
+    }
+};
+
+// Runs lookups of random registered IDs on several threads, optionally with one churn thread
+template <typename FindFn, typename ChurnFn>
+static void RunLookups(const char* name, std::size_t cars, std::size_t lookups, int readers, bool churn,
+                       FindFn find, ChurnFn churnOne) {
+    std::atomic<bool> done(false);
+    std::atomic<std::size_t> misses(0), churned(0);
+    std::thread churner;
+    if (churn) {
+        churner = std::thread([&] {
+            std::default_random_engine engine(99);
+            std::uniform_int_distribution<std::uint64_t> pick(0, cars - 1);
+            std::size_t n = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                churnOne(pick(engine));
+                n++;
+            }
+            churned.store(n);
+        });
+    }
+    // Wall time over all lookups, so the figure holds however many cores share the threads
+    const Clock::time_point start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r] {
+            std::default_random_engine engine(r + 1);
+            std::uniform_int_distribution<std::uint64_t> pick(0, cars - 1);
+            std::size_t missed = 0;
+            for (std::size_t i = 0; i < lookups; i++) {
+                missed += find(pick(engine)) == nullptr;
+            }
+            misses += missed;
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    const double seconds = SecondsSince(start);
+    done = true;
+    if (churner.joinable()) {
+        churner.join();
+    }
+    std::printf("%-40s %7.1f ns/lookup  %zu misses", name, seconds * 1e9 / (lookups * readers), misses.load());
+    if (churn) {
+        std::printf(", %zu remove+insert cycles", churned.load());
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char** argv) {
+    const std::size_t cars = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::size_t lookups = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000000;
+    const int readers = argc > 3 ? std::atoi(argv[3]) : 2;
+
+    Logger::getInstance().setEnabled(false);
+    CarPool pool(BENCH_DISTINCT_CARS);
+    pool.emplaceMany(BENCH_DISTINCT_CARS, "rio", "kia");
+
+    FleetRegistry registry(cars);
+    Clock::time_point start = Clock::now();
+    for (std::size_t i = 0; i < cars; i++) {
+        registry.Insert(FleetKey::Id(i), &pool[i % BENCH_DISTINCT_CARS]);
+    }
+    std::printf("registered %zu cars in %.1f ms\n", registry.size(), SecondsSince(start) * 1e3);
+
+    LockedMap locked;
+    locked.map.reserve(cars);
+    for (std::size_t i = 0; i < cars; i++) {
+        locked.map.emplace(i, &pool[i % BENCH_DISTINCT_CARS]);
+    }
+
+    auto registryFind = [&](std::uint64_t id) { return registry.Find(FleetKey::Id(id)); };
+    auto registryChurn = [&](std::uint64_t id) {
+        registry.Remove(FleetKey::Id(id));
+        registry.Insert(FleetKey::Id(id), &pool[id % BENCH_DISTINCT_CARS]);
+    };
+    auto lockedFind = [&](std::uint64_t id) { return locked.Find(id); };
+    auto lockedChurn = [&](std::uint64_t id) {
+        locked.Remove(id);
+        locked.Insert(id, &pool[id % BENCH_DISTINCT_CARS]);
+    };
+    RunLookups("registry, 1 reader", cars, lookups, 1, false, registryFind, registryChurn);
+    RunLookups("registry, readers", cars, lookups, readers, false, registryFind, registryChurn);
+    RunLookups("registry, readers + churn", cars, lookups, readers, true, registryFind, registryChurn);
+    RunLookups("unordered_map + shared_mutex, readers", cars, lookups, readers, false, lockedFind, lockedChurn);
+    RunLookups("unordered_map + shared_mutex, + churn", cars, lookups, readers, true, lockedFind, lockedChurn);
+
+    // Every car is visited exactly once however the partitions fall to the workers
+    FleetScan scan(registry);
+    std::atomic<std::size_t> visited(0);
+    std::vector<std::thread> workers;
+    start = Clock::now();
+    for (int w = 0; w < readers; w++) {
+        workers.emplace_back([&] {
+            std::vector<FleetEntry> entries;
+            std::size_t n = 0;
+            while (scan.Next(entries)) {
+                n += entries.size();
+            }
+            visited += n;
+        });
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    std::printf("partitioned scan: %zu cars on %d workers in %.1f ms\n", visited.load(), readers, SecondsSince(start) * 1e3);
+
+    const FleetKey vin = FleetKey::Vin("1HGCM82633A004352");
+    registry.Insert(vin, &pool[0]);
+    if (visited.load() != cars || registry.Find(vin) != &pool[0] || registry.Find(FleetKey::Id(cars)) != nullptr) {
+        std::printf("MISMATCH: registry contents are wrong\n");
+        return 1;
+    }
+    return 0;
+}
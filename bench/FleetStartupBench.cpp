@@ -0,0 +1,47 @@
+// Measures how long it takes to build and destroy a fleet of cars,
+// comparing individual make_shared construction against the CarPool path.
+#include "../car/Car.hpp"
+#include "../car/CarPool.hpp"
+#include "../logger/CarLogger.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock; 
+
+static double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); 
+}
+
+int main(int argc, char** argv) {
+    const std::size_t cars = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000; 
+
+    // Heap path: one make_shared per car plus six per sensor/ECU
+    Logger::getInstance().setEnabled(false); 
+    Clock::time_point start = Clock::now(); 
+    {
+        std::vector<std::shared_ptr<Car>> fleet; 
+        fleet.reserve(cars); 
+        for (std::size_t i = 0; i < cars; i++) {
+            fleet.push_back(std::make_shared<Car>("rio", "kia")); 
+        }
+        std::printf("heap   build   %zu cars: %8.2f ms\n", cars, MillisecondsSince(start)); 
+        start = Clock::now(); 
+    }
+    std::printf("heap   destroy %zu cars: %8.2f ms\n", cars, MillisecondsSince(start)); 
+    Logger::getInstance().setEnabled(true); 
+
+    // Pooled path: contiguous cars, sensors and ECUs from one arena
+    start = Clock::now(); 
+    {
+        CarPool pool(cars); 
+        pool.emplaceMany(cars, "rio", "kia"); 
+        std::printf("pooled build   %zu cars: %8.2f ms (%zu arena bytes)\n", 
+                    cars, MillisecondsSince(start), pool.arenaBytes()); 
+        start = Clock::now(); 
+    }
+    std::printf("pooled destroy %zu cars: %8.2f ms\n", cars, MillisecondsSince(start)); 
+    return 0; 
+}
@@ -0,0 +1,118 @@
+// Builds cars on several threads at once and checks that every sensor and
+// ECU got a distinct ID below the registries' ID limit, then destroys and
+// rebuilds half of them to show the IDs are reused and stale handles stop
+// resolving. Finally measures ID lookups against a std::unordered_map
+// behind a std::mutex.
+// Usage: object_registry_bench [cars per thread] [threads] [lookups]
+#include "../car/Car.hpp"
+#include "../logger/CarLogger.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Checks that the live sensors and ECUs hold distinct IDs that resolve back to them
+static bool CheckIds(const std::vector<std::unique_ptr<Car>>& cars) {
+    std::vector<char> sensorSeen(Sensor::Registry().getIdLimit(), 0), ecuSeen(ECU::Registry().getIdLimit(), 0);
+    for (const auto& car : cars) {
+        for (const auto& s : car->getSensors()) {
+            const RegistryHandle h = s->getHandle();
+            if (h.id >= sensorSeen.size() || sensorSeen[h.id]++ != 0 || Sensor::Registry().Find(h) != s.get()) {
+                return false;
+            }
+        }
+        for (const auto& e : car->getECUs()) {
+            const RegistryHandle h = e->getHandle();
+            if (h.id >= ecuSeen.size() || ecuSeen[h.id]++ != 0 || ECU::Registry().Find(h) != e.get()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t perThread = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    const int threads = argc > 2 ? std::atoi(argv[2]) : 4;
+    const std::size_t lookups = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10000000;
+
+    Logger::getInstance().setEnabled(false);
+    std::vector<std::unique_ptr<Car>> cars(perThread * threads);
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> builders;
+    for (int t = 0; t < threads; t++) {
+        builders.emplace_back([&, t] {
+            for (std::size_t i = t * perThread; i < (t + 1) * perThread; i++) {
+                cars[i] = std::make_unique<Car>("rio", "kia");
+            }
+        });
+    }
+    for (std::thread& b : builders) {
+        b.join();
+    }
+    std::printf("built %zu cars on %d threads in %.1f ms: %zu sensors below ID %u, %zu ECUs below ID %u\n",
+                cars.size(), threads, SecondsSince(start) * 1e3, Sensor::Registry().size(), Sensor::Registry().getIdLimit(),
+                ECU::Registry().size(), ECU::Registry().getIdLimit());
+    bool ok = CheckIds(cars);
+
+    // Replace every other car; the new sensors take the released IDs, so the limit stays put
+    const std::uint32_t limit = Sensor::Registry().getIdLimit();
+    const RegistryHandle stale = cars[0]->getSensors()[0]->getHandle();
+    for (std::size_t i = 0; i < cars.size(); i += 2) {
+        cars[i].reset();
+    }
+    for (std::size_t i = 0; i < cars.size(); i += 2) {
+        cars[i] = std::make_unique<Car>("rio", "kia");
+    }
+    std::printf("rebuilt %zu cars: sensor ID limit %u -> %u, stale handle %s\n", (cars.size() + 1) / 2, limit,
+                Sensor::Registry().getIdLimit(), Sensor::Registry().Find(stale) == nullptr ? "rejected" : "RESOLVED");
+    ok = ok && CheckIds(cars) && Sensor::Registry().getIdLimit() == limit && Sensor::Registry().Find(stale) == nullptr;
+
+    // The usual alternative: a map from ID to sensor behind a lock
+    std::unordered_map<int, Sensor*> map;
+    std::mutex mapLock;
+    std::vector<RegistryHandle> handles;
+    for (const auto& car : cars) {
+        for (const auto& s : car->getSensors()) {
+            map.emplace(s->getSensorID(), s.get());
+            handles.push_back(s->getHandle());
+        }
+    }
+    std::default_random_engine engine(3);
+    std::uniform_int_distribution<std::size_t> pick(0, handles.size() - 1);
+    std::vector<std::size_t> order(lookups);
+    for (std::size_t& o : order) {
+        o = pick(engine);
+    }
+    std::size_t found = 0;
+    start = Clock::now();
+    for (std::size_t o : order) {
+        found += Sensor::Registry().Find(handles[o]) != nullptr;
+    }
+    const double registrySeconds = SecondsSince(start);
+    start = Clock::now();
+    for (std::size_t o : order) {
+        std::lock_guard<std::mutex> guard(mapLock);
+        found += map.find((int)handles[o].id) != map.end();
+    }
+    const double mapSeconds = SecondsSince(start);
+    std::printf("lookup by handle: registry %.2f ns, unordered_map + mutex %.2f ns\n",
+                registrySeconds * 1e9 / lookups, mapSeconds * 1e9 / lookups);
+
+    if (!ok || found != 2 * lookups) {
+        std::printf("MISMATCH: IDs are duplicated or do not resolve\n");
+        return 1;
+    }
+    return 0;
+}
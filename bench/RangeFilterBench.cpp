@@ -0,0 +1,142 @@
+// Runs the radar/speed range filter for a fleet at a fixed rate against
+// simulated traffic with noisy radar and occasional outlier readings. Reports
+// the cost per car update for the lane-packed fleet filter and for one
+// double-precision filter per car, the achieved rate against the target, and
+// how much the fused range improves on the raw radar. Then starts a fleet
+// of cars with sensor fusion on and checks that their first status pass
+// raises no more collision alerts than their raw radar readings would.
+// Usage: range_filter_bench [cars] [seconds of traffic] [rate Hz] [outlier fraction]
+#include "../fusion/RangeFilter.hpp"
+#include "../car/CarPool.hpp"
+#include "../car/VehicleProfile.hpp"
+#include "../logger/CarLogger.hpp"
+#include "../metrics/CarMetrics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Starts cars with fusion on and shows their status once; returns the collision alerts raised and counts the raw radar ones
+static std::uint64_t FirstStatusCollisions(std::size_t cars, std::size_t& rawCollisions) {
+    Logger::getInstance().setEnabled(false);
+    CarPool pool(cars);
+    pool.emplaceMany(cars, "rio", "kia");
+    const std::uint64_t before = CarMetrics::get().alerts[(int)CarAlert::COLLISION]->value();
+    rawCollisions = 0;
+    for (std::size_t i = 0; i < pool.size(); i++) {
+        Car& c = pool[i];
+        c.EnableSensorFusion();
+        c.StartDiagonisticTool();
+        c.DisplayStatus();
+        rawCollisions += c.getSensorValue(SensorTypes::RADAR_SENSOR) < c.getLimits().safeRadarDistance;
+    }
+    return CarMetrics::get().alerts[(int)CarAlert::COLLISION]->value() - before;
+}
+
+// Ground truth of one car and the vehicle it follows
+struct Traffic {
+    double range; // m
+    double leadSpeed; // m/s
+    double egoSpeed; // m/s
+};
+
+int main(int argc, char** argv) {
+    const std::size_t cars = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+    const double rate = argc > 3 ? std::atof(argv[3]) : 100.0;
+    const double outliers = argc > 4 ? std::atof(argv[4]) : 0.01;
+    const double dt = 1.0 / rate;
+    const std::size_t steps = (std::size_t)(seconds * rate);
+    const double safe = DefaultVehicleProfile::safeRadarDistance;
+    const RangeFilterConfig config = RangeFilterConfig::Defaults();
+
+    std::default_random_engine engine(5);
+    std::uniform_real_distribution<double> range(10.0, 50.0), speed(15.0, 30.0), unit(0.0, 1.0), anywhere(0.0, 50.0);
+    std::normal_distribution<double> noise(0.0, config.radarNoise), accel(0.0, 1.0);
+    std::vector<Traffic> truth(cars);
+    for (Traffic& t : truth) {
+        t = Traffic{range(engine), speed(engine), speed(engine)};
+    }
+
+    FleetRangeFilter fleet(cars, config);
+    std::vector<RangeFilter> single(cars, RangeFilter(config));
+    std::vector<double> radar(cars), egoKmh(cars);
+    double fleetSeconds = 0.0, singleSeconds = 0.0;
+    double rawError = 0.0, fusedError = 0.0;
+    std::size_t rejected = 0, outlierCount = 0, rawFalseAlerts = 0, fusedFalseAlerts = 0, mismatches = 0;
+    for (std::size_t step = 0; step < steps; step++) {
+        for (std::size_t c = 0; c < cars; c++) {
+            Traffic& t = truth[c];
+            // The lead car drifts; the driver behind eases toward a 25 m gap, so gaps open and close smoothly
+            t.leadSpeed = std::max(0.0, t.leadSpeed + accel(engine) * dt);
+            const double follow = 0.04 * (t.range - 25.0) + 0.2 * (t.leadSpeed - t.egoSpeed);
+            t.egoSpeed = std::max(0.0, t.egoSpeed + (follow + 0.5 * accel(engine)) * dt);
+            t.range = std::max(0.5, t.range + (t.leadSpeed - t.egoSpeed) * dt);
+            const bool outlier = unit(engine) < outliers;
+            outlierCount += outlier;
+            radar[c] = outlier ? anywhere(engine) : std::max(0.0, t.range + noise(engine));
+            egoKmh[c] = t.egoSpeed / KMH_TO_MS;
+        }
+
+        Clock::time_point start = Clock::now();
+        rejected += fleet.Step(dt, radar.data(), egoKmh.data());
+        fleetSeconds += SecondsSince(start);
+
+        const TimestampNs now = (TimestampNs)(step * dt * 1e9);
+        start = Clock::now();
+        for (std::size_t c = 0; c < cars; c++) {
+            single[c].OnSpeed(egoKmh[c]);
+            single[c].OnRadar(radar[c], now);
+        }
+        singleSeconds += SecondsSince(start);
+
+        // Skip the first second while the rate estimates settle
+        if (step < rate) {
+            continue;
+        }
+        for (std::size_t c = 0; c < cars; c++) {
+            const double fused = fleet.getRange(c);
+            rawError += (radar[c] - truth[c].range) * (radar[c] - truth[c].range);
+            fusedError += (fused - truth[c].range) * (fused - truth[c].range);
+            // A false collision alert: the reading says the gap is unsafe while it is clearly not
+            const bool clear = truth[c].range > safe + 2.0;
+            rawFalseAlerts += clear && radar[c] < safe;
+            fusedFalseAlerts += clear && fused < safe;
+            mismatches += std::fabs(fused - single[c].getRange()) > 1e-6;
+        }
+    }
+
+    const double updates = (double)cars * steps;
+    const double checked = (double)cars * (steps - std::min<std::size_t>(steps, (std::size_t)rate));
+    std::printf("%zu cars at %.0f Hz for %.1f s of traffic, %.1f%% outliers\n", cars, rate, seconds, 100.0 * outliers);
+    std::printf("fleet filter (%d lanes): %6.2f ns/update, %.2f s per second of traffic (%.1fx real time)\n",
+                FUSION_LANES, fleetSeconds * 1e9 / updates, fleetSeconds / seconds, seconds / fleetSeconds);
+    std::printf("one filter per car:      %6.2f ns/update, %.2f s per second of traffic\n",
+                singleSeconds * 1e9 / updates, singleSeconds / seconds);
+    std::printf("range RMS error: radar %.2f m, fused %.2f m\n", std::sqrt(rawError / checked), std::sqrt(fusedError / checked));
+    std::printf("false collision alerts: radar %zu, fused %zu; %zu readings gated out, %zu outliers injected\n",
+                rawFalseAlerts, fusedFalseAlerts, rejected, outlierCount);
+    if (mismatches != 0) {
+        std::printf("MISMATCH: %zu fleet and single-car estimates differ\n", mismatches);
+        return 1;
+    }
+
+    std::size_t rawStartup = 0;
+    const std::uint64_t fusedStartup = FirstStatusCollisions(std::min<std::size_t>(cars, 10000), rawStartup);
+    std::printf("first status pass of %zu cars: collision alerts radar %zu, fused %llu\n",
+                std::min<std::size_t>(cars, 10000), rawStartup, (unsigned long long)fusedStartup);
+    if (fusedStartup > rawStartup) {
+        std::printf("MISMATCH: fusion raised more collision alerts on the first status pass than the raw radar\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,210 @@
+// Compares the two places a car can keep its built-in sensors: one heap
+// object per sensor (SensorStorage::HEAP) and inside the Car object
+// (SensorStorage::INLINE). Each layout is built twice, as individually
+// allocated cars on a heap scattered by other allocations and as a
+// CarPool, then the fleet is swept in random order three times: reaching
+// every sensor without computing anything, sampling every sensor, and one
+// ECU cycle per car. Reports ns per car and, where the kernel allows
+// perf_event_open, cache misses per car. Both layouts are seeded
+// alike and must end with the same readings.
+// Usage: sensor_layout_bench [cars] [passes]
+#include "../car/CarPool.hpp"
+#include "../logger/CarLogger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <memory>
+#include <random>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Hardware cache-miss counter of the calling thread, or -1 where perf events are not allowed
+static int OpenCacheMissCounter() {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static std::uint64_t ReadCounter(int fd) {
+    std::uint64_t value = 0;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) {
+        return 0;
+    }
+    return value;
+}
+
+struct SweepResult {
+    double walkNs; ///< Per car, reading the registry handle of each sensor
+    double sampleNs; ///< Per car, four SampleSensor calls
+    double ecuNs; ///< Per car, one ConsumeSensorData
+    double walkMisses; ///< Per car, or -1 without a counter
+    double sampleMisses; ///< Per car, or -1 without a counter
+    double ecuMisses; ///< Per car, or -1 without a counter
+    double checksum; ///< Sum of the final readings
+};
+
+// Sweeps the fleet in the given order: walking the sensors, sampling them, then running the ECUs
+static SweepResult Sweep(const std::vector<Car*>& cars, const std::vector<std::size_t>& order, int passes, int counter) {
+    SweepResult r{0, 0, 0, -1, -1, -1, 0};
+    std::uint64_t walkMisses = 0, sampleMisses = 0, ecuMisses = 0;
+    double walkSeconds = 0, sampleSeconds = 0, ecuSeconds = 0;
+    std::uint64_t ids = 0;
+    for (int pass = 0; pass < passes; pass++) {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+        Clock::time_point start = Clock::now();
+        for (std::size_t i : order) {
+            for (const auto& s : cars[i]->getSensors()) {
+                ids += s->getHandle().id;
+            }
+        }
+        walkSeconds += SecondsSince(start);
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        walkMisses += ReadCounter(counter);
+
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+        start = Clock::now();
+        for (std::size_t i : order) {
+            for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+                cars[i]->SampleSensor(SensorTypes(type));
+            }
+        }
+        sampleSeconds += SecondsSince(start);
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        sampleMisses += ReadCounter(counter);
+
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+        start = Clock::now();
+        for (std::size_t i : order) {
+            cars[i]->ConsumeSensorData();
+        }
+        ecuSeconds += SecondsSince(start);
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        ecuMisses += ReadCounter(counter);
+    }
+    const double visits = (double)cars.size() * passes;
+    r.walkNs = walkSeconds * 1e9 / visits;
+    r.sampleNs = sampleSeconds * 1e9 / visits;
+    r.ecuNs = ecuSeconds * 1e9 / visits;
+    if (counter >= 0) {
+        r.walkMisses = walkMisses / visits;
+        r.sampleMisses = sampleMisses / visits;
+        r.ecuMisses = ecuMisses / visits;
+    }
+    for (Car* c : cars) {
+        for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+            r.checksum += c->getSensorValue(SensorTypes(type));
+        }
+    }
+    if (ids == 0) {
+        r.checksum = -1; // Keeps the walk loop; only an empty fleet has no IDs
+    }
+    return r;
+}
+
+static void Print(const char* name, SensorStorage storage, const SweepResult& r) {
+    std::printf("%-9s %-6s walk %6.1f ns/car", name, storage == SensorStorage::INLINE ? "inline" : "heap", r.walkNs);
+    if (r.walkMisses >= 0) {
+        std::printf(" %5.2f misses/car", r.walkMisses);
+    }
+    std::printf("   sample %6.1f ns/car", r.sampleNs);
+    if (r.sampleMisses >= 0) {
+        std::printf(" %5.2f misses/car", r.sampleMisses);
+    }
+    std::printf("   ecu cycle %6.1f ns/car", r.ecuNs);
+    if (r.ecuMisses >= 0) {
+        std::printf(" %5.2f misses/car", r.ecuMisses);
+    }
+    std::printf("\n");
+}
+
+// Cars allocated one by one, with unrelated allocations of random size in between
+static SweepResult RunScattered(std::size_t carCount, int passes, SensorStorage storage, int counter,
+                                const std::vector<std::size_t>& order) {
+    Sensor::SetSeedBase(42);
+    std::default_random_engine engine(7);
+    std::uniform_int_distribution<std::size_t> fillerSize(32, 512);
+    std::vector<std::unique_ptr<Car>> owned;
+    std::vector<std::unique_ptr<char[]>> fillers;
+    std::vector<Car*> cars;
+    for (std::size_t i = 0; i < carCount; i++) {
+        owned.push_back(std::make_unique<Car>("rio", "kia", storage));
+        cars.push_back(owned.back().get());
+        fillers.emplace_back(new char[fillerSize(engine)]);
+    }
+    for (Car* c : cars) {
+        c->StartDiagonisticTool();
+    }
+    return Sweep(cars, order, passes, counter);
+}
+
+// Cars side by side in a CarPool, heap sensors taken from its arena
+static SweepResult RunPooled(std::size_t carCount, int passes, SensorStorage storage, int counter,
+                             const std::vector<std::size_t>& order) {
+    Sensor::SetSeedBase(42);
+    CarPool pool(carCount, true, storage);
+    pool.emplaceMany(carCount, "rio", "kia");
+    std::vector<Car*> cars;
+    for (std::size_t i = 0; i < pool.size(); i++) {
+        cars.push_back(&pool[i]);
+        cars.back()->StartDiagonisticTool();
+    }
+    std::printf("pooled    %-6s %zu bytes per car slot + %zu arena bytes per car\n",
+                storage == SensorStorage::INLINE ? "inline" : "heap", sizeof(Car), pool.arenaBytes() / carCount);
+    return Sweep(cars, order, passes, counter);
+}
+
+int main(int argc, char** argv) {
+    const std::size_t carCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    const int passes = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    Logger::getInstance().setEnabled(false);
+    const int counter = OpenCacheMissCounter();
+    if (counter < 0) {
+        std::printf("perf_event_open unavailable; reporting time only\n");
+    }
+    std::vector<std::size_t> order(carCount);
+    for (std::size_t i = 0; i < carCount; i++) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::default_random_engine(11));
+
+    std::printf("cars=%zu passes=%d sizeof(Car)=%zu sizeof(BuiltInSensors)=%zu\n",
+                carCount, passes, sizeof(Car), sizeof(BuiltInSensors));
+    const SweepResult scatteredHeap = RunScattered(carCount, passes, SensorStorage::HEAP, counter, order);
+    const SweepResult scatteredInline = RunScattered(carCount, passes, SensorStorage::INLINE, counter, order);
+    Print("scattered", SensorStorage::HEAP, scatteredHeap);
+    Print("scattered", SensorStorage::INLINE, scatteredInline);
+    const SweepResult pooledHeap = RunPooled(carCount, passes, SensorStorage::HEAP, counter, order);
+    const SweepResult pooledInline = RunPooled(carCount, passes, SensorStorage::INLINE, counter, order);
+    Print("pooled", SensorStorage::HEAP, pooledHeap);
+    Print("pooled", SensorStorage::INLINE, pooledInline);
+    if (counter >= 0) {
+        close(counter);
+    }
+
+    if (scatteredHeap.checksum != scatteredInline.checksum || pooledHeap.checksum != pooledInline.checksum) {
+        std::printf("MISMATCH: the layouts read different values from the same seed\n");
+        return 1;
+    }
+    return 0;
+}
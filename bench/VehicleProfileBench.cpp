@@ -0,0 +1,93 @@
+// Measures the status check against vehicle limits: compiled for one profile
+// versus limits read from memory, called inline and through Car for fleets
+// with one profile, mixed profiles, and run-time limits.
+// Usage: vehicle_profile_bench [cars] [passes]
+#include "../car/CarPool.hpp"
+#include "../car/VehicleProfile.hpp"
+#include "../logger/CarLogger.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void Report(const char* name, double seconds, std::size_t checks, std::uint64_t alerts) {
+    std::printf("%-36s %6.2f ns/check  (%llu alerts)\n", name, seconds * 1e9 / checks, (unsigned long long)alerts);
+}
+
+int main(int argc, char** argv) {
+    const std::size_t carCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    const std::size_t passes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+    const std::size_t checks = carCount * passes;
+
+    // Signals spread around the limits so every branch is taken
+    std::default_random_engine engine(7);
+    std::uniform_real_distribution<double> speed(0, 100), temperature(0, 60), radar(0, 20), battery(0, 100);
+    std::vector<CarSnapshot> snapshots(carCount);
+    for (CarSnapshot& s : snapshots) {
+        s.values[(int)SensorTypes::SPEED_SENSOR] = speed(engine);
+        s.values[(int)SensorTypes::TEMPERATURE_SENSOR] = temperature(engine);
+        s.values[(int)SensorTypes::RADAR_SENSOR] = radar(engine);
+        s.values[(int)SensorTypes::BATTERY_LEVEL_SENSOR] = battery(engine);
+        s.version = 0;
+    }
+
+    Logger::getInstance().setEnabled(false);
+    CarPool pool(carCount);
+    pool.emplaceMany(carCount, "rio", "kia");
+
+    // Limits the compiler cannot see, as if loaded from a configuration file
+    VehicleLimits runtime = VehicleLimits::Of<PassengerCarProfile>();
+    runtime.maxSpeed = argc > 3 ? std::atof(argv[3]) : runtime.maxSpeed;
+    runtime.name = "runtime";
+
+    std::uint64_t alerts = 0;
+    Clock::time_point start = Clock::now();
+    for (std::size_t p = 0; p < passes; p++) {
+        for (const CarSnapshot& s : snapshots) {
+            alerts += EvaluateVehicleStatus<PassengerCarProfile>(s.values.data());
+        }
+    }
+    Report("inline, compile-time profile", SecondsSince(start), checks, alerts);
+
+    alerts = 0;
+    start = Clock::now();
+    for (std::size_t p = 0; p < passes; p++) {
+        for (const CarSnapshot& s : snapshots) {
+            alerts += EvaluateVehicleStatus(runtime, s.values.data());
+        }
+    }
+    Report("inline, run-time limits", SecondsSince(start), checks, alerts);
+
+    const char* fleets[] = {"Car, one compiled profile", "Car, mixed compiled profiles", "Car, run-time limits"};
+    for (int fleet = 0; fleet < 3; fleet++) {
+        for (std::size_t i = 0; i < carCount; i++) {
+            if (fleet == 0) {
+                pool[i].SetProfile<PassengerCarProfile>();
+            } else if (fleet == 1) {
+                switch (i % 3) {
+                    case 0: pool[i].SetProfile<PassengerCarProfile>(); break;
+                    case 1: pool[i].SetProfile<TruckProfile>(); break;
+                    default: pool[i].SetProfile<SportsCarProfile>(); break;
+                }
+            } else {
+                pool[i].SetProfile(runtime);
+            }
+        }
+        alerts = 0;
+        start = Clock::now();
+        for (std::size_t p = 0; p < passes; p++) {
+            for (std::size_t i = 0; i < carCount; i++) {
+                alerts += pool[i].EvaluateStatus(snapshots[i]);
+            }
+        }
+        Report(fleets[fleet], SecondsSince(start), checks, alerts);
+    }
+    return 0;
+}
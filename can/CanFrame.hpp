@@ -0,0 +1,70 @@
+#ifndef CAN_FRAME_H
+#define CAN_FRAME_H
+
+#include <array>
+#include <cstdint>
+
+#define CAN_MAX_DLEN 8 ///< Payload bytes of a classic CAN frame
+#define CANFD_MAX_DLEN 64 ///< Payload bytes of a CAN-FD frame
+
+/**
+ * @brief One CAN 2.0 or CAN-FD data frame.
+ *
+ * @details Payload storage is always 64 bytes so classic and FD frames share
+ * one type; only the first length bytes are meaningful. Remote frames are
+ * not modelled.
+ */
+struct CanFrame {
+    std::uint32_t id = 0; ///< 11-bit standard or 29-bit extended identifier
+    bool extended = false; ///< Identifier is 29 bits
+    bool fd = false; ///< CAN-FD frame
+    bool bitRateSwitch = false; ///< FD data phase uses the data bit rate
+    std::uint8_t length = 0; ///< Payload bytes; a valid DLC length for the frame kind
+    std::array<std::uint8_t, CANFD_MAX_DLEN> data{}; ///< Payload
+};
+
+/**
+ * @brief Converts a data length code to a payload length.
+ *
+ * @param dlc The 4-bit DLC.
+ * @param fd Whether the frame is CAN-FD; classic frames cap at 8 bytes.
+ * @return std::uint8_t The payload length in bytes.
+ */
+constexpr std::uint8_t CanDlcToLength(std::uint8_t dlc, bool fd) {
+    constexpr std::uint8_t fdLengths[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+    return fd ? fdLengths[dlc & 0x0F] : (dlc > 8 ? 8 : dlc);
+}
+
+/**
+ * @brief Converts a payload length to the smallest data length code that holds it.
+ *
+ * @param length The payload length in bytes.
+ * @return std::uint8_t The DLC; payloads above 8 bytes need an FD frame.
+ */
+constexpr std::uint8_t CanLengthToDlc(std::uint8_t length) {
+    if (length <= 8) return length;
+    if (length <= 12) return 9;
+    if (length <= 16) return 10;
+    if (length <= 20) return 11;
+    if (length <= 24) return 12;
+    if (length <= 32) return 13;
+    if (length <= 48) return 14;
+    return 15;
+}
+
+/**
+ * @brief Checks that a frame's identifier and length are valid for its kind.
+ *
+ * @param frame The frame.
+ * @return true if the frame can be put on a bus.
+ */
+constexpr bool CanFrameValid(const CanFrame& frame) {
+    const std::uint32_t idLimit = frame.extended ? (1u << 29) : (1u << 11);
+    if (frame.id >= idLimit || (frame.bitRateSwitch && !frame.fd)) {
+        return false;
+    }
+    return frame.fd ? CanDlcToLength(CanLengthToDlc(frame.length), true) == frame.length
+                    : frame.length <= CAN_MAX_DLEN;
+}
+
+#endif // !CAN_FRAME_H
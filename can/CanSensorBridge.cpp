@@ -0,0 +1,199 @@
+#include "CanSensorBridge.hpp"
+#include "VehicleMessages.hpp"
+
+/**
+ * @brief Encodes a sensor reading into the frame of its message.
+ * 
+ * @param type The sensor type.
+ * @param value The physical value.
+ * @param counter The alive counter.
+ * @param fd Send as a CAN-FD frame with bit rate switching.
+ * @return CanFrame The frame.
+ */
+CanFrame EncodeSensorFrame(SensorTypes type, double value, std::uint8_t counter, bool fd) {
+    using namespace VehicleMessages; 
+    CanFrame frame; 
+    frame.fd = fd; 
+    frame.bitRateSwitch = fd; 
+    std::uint8_t* data = frame.data.data(); 
+    switch (type) {
+    case SensorTypes::RADAR_SENSOR: 
+        frame.id = Radar::id; 
+        frame.length = Radar::length; 
+        Radar::Distance::Pack(data, value); 
+        Radar::Counter::Insert(data, counter); 
+        break; 
+    case SensorTypes::SPEED_SENSOR: 
+        frame.id = Speed::id; 
+        frame.length = Speed::length; 
+        Speed::VehicleSpeed::Pack(data, value); 
+        Speed::Counter::Insert(data, counter); 
+        break; 
+    case SensorTypes::BATTERY_LEVEL_SENSOR: 
+        frame.id = Battery::id; 
+        frame.length = Battery::length; 
+        Battery::StateOfCharge::Pack(data, value); 
+        Battery::Counter::Insert(data, counter); 
+        break; 
+    case SensorTypes::TEMPERATURE_SENSOR: 
+        frame.id = Temperature::id; 
+        frame.length = Temperature::length; 
+        Temperature::Coolant::Pack(data, value); 
+        Temperature::Counter::Insert(data, counter); 
+        break; 
+    }
+    return frame; 
+}
+
+/**
+ * @brief Decodes a sensor frame.
+ * 
+ * @param frame The frame.
+ * @param type Receives the sensor type.
+ * @param value Receives the physical value.
+ * @param counter Receives the alive counter.
+ * @return true if the frame is one of the sensor messages.
+ */
+bool DecodeSensorFrame(const CanFrame& frame, SensorTypes& type, double& value, std::uint8_t& counter) {
+    using namespace VehicleMessages; 
+    if (frame.extended || frame.length < 8) {
+        return false; 
+    }
+    const std::uint8_t* data = frame.data.data(); 
+    switch (frame.id) {
+    case Radar::id: 
+        type = SensorTypes::RADAR_SENSOR; 
+        value = Radar::Distance::Unpack(data); 
+        counter = (std::uint8_t)Radar::Counter::Extract(data); 
+        return true; 
+    case Speed::id: 
+        type = SensorTypes::SPEED_SENSOR; 
+        value = Speed::VehicleSpeed::Unpack(data); 
+        counter = (std::uint8_t)Speed::Counter::Extract(data); 
+        return true; 
+    case Battery::id: 
+        type = SensorTypes::BATTERY_LEVEL_SENSOR; 
+        value = Battery::StateOfCharge::Unpack(data); 
+        counter = (std::uint8_t)Battery::Counter::Extract(data); 
+        return true; 
+    case Temperature::id: 
+        type = SensorTypes::TEMPERATURE_SENSOR; 
+        value = Temperature::Coolant::Unpack(data); 
+        counter = (std::uint8_t)Temperature::Counter::Extract(data); 
+        return true; 
+    default: 
+        return false; 
+    }
+}
+
+/**
+ * @brief Gets the CAN identifier of a sensor type's message.
+ * 
+ * @param type The sensor type.
+ * @return std::uint32_t The identifier.
+ */
+std::uint32_t SensorMessageId(SensorTypes type) {
+    switch (type) {
+    case SensorTypes::RADAR_SENSOR: return VehicleMessages::Radar::id; 
+    case SensorTypes::SPEED_SENSOR: return VehicleMessages::Speed::id; 
+    case SensorTypes::BATTERY_LEVEL_SENSOR: return VehicleMessages::Battery::id; 
+    case SensorTypes::TEMPERATURE_SENSOR: return VehicleMessages::Temperature::id; 
+    }
+    return 0; 
+}
+
+/**
+ * @brief Adds a node for the sensor to the bus.
+ * 
+ * @param bus The bus.
+ * @param sensor The sensor to sample.
+ * @param type The sensor type.
+ * @param fd Send CAN-FD frames with bit rate switching.
+ */
+CanSensorNode::CanSensorNode(VirtualCanBus& bus, std::shared_ptr<Sensor> sensor, SensorTypes type, bool fd)
+    : bus(bus), sensor(sensor), type(type), fd(fd), 
+      node(bus.AddNode(std::string(sensor->getType()) + " " + std::to_string(sensor->getSensorID()))), counter(0) {}
+
+/**
+ * @brief Samples the sensor and queues its frame.
+ * 
+ * @param now The bus time of the sample.
+ * @return true if the frame was queued.
+ */
+bool CanSensorNode::Publish(TimestampNs now) {
+    const CanFrame frame = EncodeSensorFrame(type, sensor->GetSensorData(), counter, fd); 
+    counter = (counter + 1) & 0x0F; // The counter advances even if the frame is dropped, as on a real ECU
+    return bus.Transmit(node, frame, now); 
+}
+
+/**
+ * @brief Gets the bus node of the sensor.
+ * 
+ * @return VirtualCanBus::NodeId The node.
+ */
+VirtualCanBus::NodeId CanSensorNode::getNode() const {
+    return node; 
+}
+
+/**
+ * @brief Adds a node for the ECU to the bus.
+ * 
+ * @param bus The bus.
+ * @param ecu The ECU that receives the readings.
+ */
+CanEcuNode::CanEcuNode(VirtualCanBus& bus, std::shared_ptr<ECU> ecu)
+    : ecu(ecu), bus(bus), node(bus.AddNode(std::string(ecu->getName()))), received(0), lost(0) {
+    lastCounter.fill(-1); 
+}
+
+/**
+ * @brief Subscribes to a sensor type's message.
+ * 
+ * @param type The sensor type.
+ * @param sensorID ID the readings are recorded under.
+ */
+void CanEcuNode::Listen(SensorTypes type, int sensorID) {
+    bus.Subscribe(node, SensorMessageId(type), 0x7FF, [this, sensorID](const CanFrame& frame, TimestampNs) {
+        Receive(frame, sensorID); 
+    }); 
+}
+
+/**
+ * @brief Decodes a received frame and records it.
+ * 
+ * @param frame The frame.
+ * @param sensorID ID the reading is recorded under.
+ */
+void CanEcuNode::Receive(const CanFrame& frame, int sensorID) {
+    SensorTypes type; 
+    double value; 
+    std::uint8_t counter; 
+    if (!DecodeSensorFrame(frame, type, value, counter)) {
+        return; 
+    }
+    int& last = lastCounter[(int)type]; 
+    if (last >= 0) {
+        lost += (counter - last - 1) & 0x0F; 
+    }
+    last = counter; 
+    received++; 
+    ecu->RecordSample((int)type, sensorID, value); 
+}
+
+/**
+ * @brief Gets the number of frames decoded.
+ * 
+ * @return std::uint64_t The number of frames.
+ */
+std::uint64_t CanEcuNode::getReceivedCount() const {
+    return received; 
+}
+
+/**
+ * @brief Gets the number of frames missing according to the alive counters.
+ * 
+ * @return std::uint64_t The number of frames.
+ */
+std::uint64_t CanEcuNode::getLostCount() const {
+    return lost; 
+}
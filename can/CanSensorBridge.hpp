@@ -0,0 +1,142 @@
+#ifndef CAN_SENSOR_BRIDGE_H
+#define CAN_SENSOR_BRIDGE_H
+
+#include "CanFrame.hpp"
+#include "VirtualCanBus.hpp"
+#include "../ECU/ECU.hpp"
+#include "../Sensors/Sensor.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Encodes a sensor reading into the frame of its message.
+ * 
+ * @param type The sensor type; selects the message in VehicleMessages.
+ * @param value The physical value; saturates at the signal range.
+ * @param counter The alive counter, modulo 16.
+ * @param fd Send as a CAN-FD frame with bit rate switching.
+ * @return CanFrame The frame.
+ */
+CanFrame EncodeSensorFrame(SensorTypes type, double value, std::uint8_t counter, bool fd = false);
+
+/**
+ * @brief Decodes a sensor frame.
+ * 
+ * @param frame The frame.
+ * @param type Receives the sensor type.
+ * @param value Receives the physical value.
+ * @param counter Receives the alive counter.
+ * @return true if the frame is one of the sensor messages and long enough.
+ */
+bool DecodeSensorFrame(const CanFrame& frame, SensorTypes& type, double& value, std::uint8_t& counter);
+
+/**
+ * @brief Gets the CAN identifier of a sensor type's message.
+ * 
+ * @param type The sensor type.
+ * @return std::uint32_t The identifier.
+ */
+std::uint32_t SensorMessageId(SensorTypes type);
+
+/**
+ * @brief Puts a sensor on a virtual bus as a transmitting node.
+ */
+class CanSensorNode {
+public:
+    /**
+     * @brief Adds a node for the sensor to the bus.
+     * 
+     * @param bus The bus; must outlive the node.
+     * @param sensor The sensor to sample.
+     * @param type The sensor type, which selects the message.
+     * @param fd Send CAN-FD frames with bit rate switching.
+     */
+    CanSensorNode(VirtualCanBus& bus, std::shared_ptr<Sensor> sensor, SensorTypes type, bool fd = false);
+
+    /**
+     * @brief Samples the sensor and queues its frame.
+     * 
+     * @param now The bus time of the sample.
+     * @return true if the frame was queued, false if the node's queue was full.
+     */
+    bool Publish(TimestampNs now);
+
+    /**
+     * @brief Gets the bus node of the sensor.
+     * 
+     * @return VirtualCanBus::NodeId The node.
+     */
+    VirtualCanBus::NodeId getNode() const;
+
+private:
+    VirtualCanBus& bus; ///< The bus
+    std::shared_ptr<Sensor> sensor; ///< The sampled sensor
+    SensorTypes type; ///< Selects the message
+    bool fd; ///< Send CAN-FD frames
+    VirtualCanBus::NodeId node; ///< Node on the bus
+    std::uint8_t counter; ///< Next alive counter
+};
+
+/**
+ * @brief Puts an ECU on a virtual bus as a receiving node.
+ * 
+ * @details Decoded readings are stored with ECU::RecordSample, just as if
+ * the sensor had notified the ECU directly, so histories, rollups and
+ * diagnostics see bus traffic. Gaps in the alive counter are counted as
+ * lost frames.
+ */
+class CanEcuNode {
+public:
+    /**
+     * @brief Adds a node for the ECU to the bus.
+     * 
+     * @param bus The bus; must outlive the node.
+     * @param ecu The ECU that receives the readings.
+     */
+    CanEcuNode(VirtualCanBus& bus, std::shared_ptr<ECU> ecu);
+
+    // Deleted copy constructor and assignment operator; the bus keeps a pointer to the node
+    CanEcuNode(const CanEcuNode&) = delete; 
+    CanEcuNode& operator=(const CanEcuNode&) = delete;
+
+    /**
+     * @brief Subscribes to a sensor type's message.
+     * 
+     * @param type The sensor type.
+     * @param sensorID ID the readings are recorded under.
+     */
+    void Listen(SensorTypes type, int sensorID);
+
+    /**
+     * @brief Gets the number of frames decoded.
+     * 
+     * @return std::uint64_t The number of frames.
+     */
+    std::uint64_t getReceivedCount() const;
+
+    /**
+     * @brief Gets the number of frames missing according to the alive counters.
+     * 
+     * @return std::uint64_t The number of frames.
+     */
+    std::uint64_t getLostCount() const;
+
+private:
+    /**
+     * @brief Decodes a received frame and records it.
+     * 
+     * @param frame The frame.
+     * @param sensorID ID the reading is recorded under.
+     */
+    void Receive(const CanFrame& frame, int sensorID);
+
+    std::shared_ptr<ECU> ecu; ///< The receiving ECU
+    VirtualCanBus& bus; ///< The bus
+    VirtualCanBus::NodeId node; ///< Node on the bus
+    std::array<int, Sensor_Types_Count> lastCounter; ///< Last alive counter per sensor type, -1 before the first frame
+    std::uint64_t received; ///< Frames decoded
+    std::uint64_t lost; ///< Frames missing
+};
+
+#endif // !CAN_SENSOR_BRIDGE_H
@@ -0,0 +1,204 @@
+#ifndef CAN_SIGNAL_H
+#define CAN_SIGNAL_H
+
+#include <cstdint>
+
+/**
+ * @brief Bit layout of a signal inside a frame, as in a DBC file.
+ */
+enum class ByteOrder {
+    INTEL,   /**< Little endian; the start bit is the least significant bit */
+    MOTOROLA /**< Big endian; the start bit is the most significant bit (DBC sawtooth numbering) */
+};
+
+/**
+ * @brief A DBC-style signal whose layout and scaling are fixed at compile time.
+ *
+ * @details physical = raw * Factor + Offset. Bit positions count from bit 0
+ * of byte 0, so bit 8 is bit 0 of byte 1. Because every parameter is a
+ * template argument, the byte loops in Insert and Extract unroll into a few
+ * shifts and masks per signal. Everything is constexpr, so layouts can be
+ * checked with static_assert.
+ *
+ * Encode rounds to the nearest raw step and saturates at the raw range
+ * instead of wrapping.
+ *
+ * @tparam StartBit First bit: the LSB for Intel, the MSB for Motorola.
+ * @tparam Length Signal width in bits, 1 to 64.
+ * @tparam Order Byte order.
+ * @tparam Signed Whether the raw value is two's complement.
+ * @tparam Factor Physical units per raw step.
+ * @tparam Offset Physical value of raw zero.
+ */
+template <unsigned StartBit, unsigned Length, ByteOrder Order, bool Signed, double Factor, double Offset>
+struct CanSignal {
+    static_assert(Length >= 1 && Length <= 64, "CAN signals are 1 to 64 bits wide");
+    static_assert(Factor != 0.0, "A zero factor cannot be decoded");
+
+    static constexpr std::uint64_t Mask = Length == 64 ? ~0ull : ((1ull << Length) - 1); ///< Raw value bits
+    static constexpr std::int64_t RawMin = Signed ? -(std::int64_t)(Mask >> 1) - 1 : 0; ///< Smallest raw value
+    static constexpr std::int64_t RawMax = Signed ? (std::int64_t)(Mask >> 1) : (std::int64_t)(Length == 64 ? Mask >> 1 : Mask); ///< Largest raw value
+    static constexpr double Min = (Factor > 0 ? RawMin : RawMax) * Factor + Offset; ///< Smallest physical value
+    static constexpr double Max = (Factor > 0 ? RawMax : RawMin) * Factor + Offset; ///< Largest physical value
+
+    /**
+     * @brief Gets the index of the last payload byte the signal touches.
+     *
+     * @return unsigned The byte index.
+     */
+    static constexpr unsigned LastByte() {
+        if (Order == ByteOrder::INTEL) {
+            return (StartBit + Length - 1) / 8;
+        }
+        const unsigned inFirstByte = StartBit % 8 + 1;
+        return StartBit / 8 + (Length > inFirstByte ? (Length - inFirstByte + 7) / 8 : 0);
+    }
+
+    /**
+     * @brief Scales a physical value to raw bits, rounding and saturating.
+     *
+     * @param physical The physical value.
+     * @return std::uint64_t The raw bits, masked to Length.
+     */
+    static constexpr std::uint64_t Encode(double physical) {
+        const double scaled = (physical - Offset) / Factor;
+        std::int64_t raw;
+        if (!(scaled > (double)RawMin)) { // Also catches NaN
+            raw = RawMin;
+        } else if (scaled >= (double)RawMax) {
+            raw = RawMax;
+        } else {
+            raw = scaled >= 0 ? (std::int64_t)(scaled + 0.5) : -(std::int64_t)(-scaled + 0.5);
+        }
+        return (std::uint64_t)raw & Mask;
+    }
+
+    /**
+     * @brief Scales raw bits back to a physical value.
+     *
+     * @param raw The raw bits.
+     * @return double The physical value.
+     */
+    static constexpr double Decode(std::uint64_t raw) {
+        raw &= Mask;
+        if (Signed && Length < 64 && (raw >> (Length - 1)) != 0) {
+            return (double)(std::int64_t)(raw | ~Mask) * Factor + Offset;
+        }
+        return (Signed ? (double)(std::int64_t)raw : (double)raw) * Factor + Offset;
+    }
+
+    /**
+     * @brief Writes raw bits into a payload, leaving other signals' bits alone.
+     *
+     * @param data The payload; must hold at least LastByte() + 1 bytes.
+     * @param raw The raw bits.
+     */
+    static constexpr void Insert(std::uint8_t* data, std::uint64_t raw) {
+        raw &= Mask;
+        unsigned remaining = Length;
+        if (Order == ByteOrder::INTEL) {
+            unsigned bit = StartBit;
+            while (remaining > 0) {
+                const unsigned shift = bit % 8;
+                const unsigned n = remaining < 8 - shift ? remaining : 8 - shift;
+                const std::uint8_t mask = (std::uint8_t)(((1u << n) - 1) << shift);
+                data[bit / 8] = (std::uint8_t)((data[bit / 8] & ~mask) | ((raw << shift) & mask));
+                raw >>= n;
+                bit += n;
+                remaining -= n;
+            }
+        } else {
+            unsigned byte = StartBit / 8;
+            unsigned top = StartBit % 8;
+            while (remaining > 0) {
+                const unsigned n = remaining < top + 1 ? remaining : top + 1;
+                const unsigned shift = top + 1 - n;
+                const std::uint8_t mask = (std::uint8_t)(((1u << n) - 1) << shift);
+                const std::uint64_t chunk = (raw >> (remaining - n)) & ((1u << n) - 1);
+                data[byte] = (std::uint8_t)((data[byte] & ~mask) | (chunk << shift));
+                remaining -= n;
+                byte++;
+                top = 7;
+            }
+        }
+    }
+
+    /**
+     * @brief Reads raw bits from a payload.
+     *
+     * @param data The payload; must hold at least LastByte() + 1 bytes.
+     * @return std::uint64_t The raw bits.
+     */
+    static constexpr std::uint64_t Extract(const std::uint8_t* data) {
+        std::uint64_t raw = 0;
+        unsigned remaining = Length;
+        if (Order == ByteOrder::INTEL) {
+            unsigned bit = StartBit;
+            unsigned filled = 0;
+            while (remaining > 0) {
+                const unsigned shift = bit % 8;
+                const unsigned n = remaining < 8 - shift ? remaining : 8 - shift;
+                raw |= (std::uint64_t)((data[bit / 8] >> shift) & ((1u << n) - 1)) << filled;
+                filled += n;
+                bit += n;
+                remaining -= n;
+            }
+        } else {
+            unsigned byte = StartBit / 8;
+            unsigned top = StartBit % 8;
+            while (remaining > 0) {
+                const unsigned n = remaining < top + 1 ? remaining : top + 1;
+                const unsigned shift = top + 1 - n;
+                raw = (raw << n) | ((data[byte] >> shift) & ((1u << n) - 1));
+                remaining -= n;
+                byte++;
+                top = 7;
+            }
+        }
+        return raw;
+    }
+
+    /**
+     * @brief Encodes a physical value into a payload.
+     *
+     * @param data The payload.
+     * @param physical The physical value.
+     */
+    static constexpr void Pack(std::uint8_t* data, double physical) { Insert(data, Encode(physical)); }
+
+    /**
+     * @brief Decodes a physical value from a payload.
+     *
+     * @param data The payload.
+     * @return double The physical value.
+     */
+    static constexpr double Unpack(const std::uint8_t* data) { return Decode(Extract(data)); }
+};
+
+/**
+ * @brief Identifier and payload size of a DBC-style message.
+ *
+ * @tparam Id The CAN identifier; lower wins arbitration.
+ * @tparam Length Payload bytes.
+ * @tparam Extended Whether Id is a 29-bit identifier.
+ */
+template <std::uint32_t Id, std::uint8_t Length, bool Extended = false>
+struct CanMessage {
+    static_assert(Id < (Extended ? (1u << 29) : (1u << 11)), "Identifier does not fit the frame format");
+    static_assert(Length <= 64, "CAN-FD payloads are at most 64 bytes");
+
+    static constexpr std::uint32_t id = Id; ///< CAN identifier
+    static constexpr std::uint8_t length = Length; ///< Payload bytes
+    static constexpr bool extended = Extended; ///< 29-bit identifier
+
+    /**
+     * @brief Checks at compile time that a signal fits in the payload.
+     *
+     * @tparam Signal The signal.
+     * @return true if it fits.
+     */
+    template <typename Signal>
+    static constexpr bool Fits() { return Signal::LastByte() < Length; }
+};
+
+#endif // !CAN_SIGNAL_H
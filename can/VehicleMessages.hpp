@@ -0,0 +1,59 @@
+#ifndef VEHICLE_MESSAGES_H
+#define VEHICLE_MESSAGES_H
+
+#include "CanSignal.hpp"
+
+/**
+ * @brief Message definitions for the built-in sensors, in the spirit of a DBC file.
+ *
+ * @details Identifiers follow priority: the radar, which feeds collision
+ * avoidance, wins arbitration over speed, and both win over the slow
+ * battery and temperature messages. Every message carries a 4-bit alive
+ * counter in its last byte so that receivers can detect lost frames.
+ * Physical ranges cover the ranges the sensors produce.
+ */
+namespace VehicleMessages {
+
+/**
+ * @brief RADAR_OBJECT (0x0A0): distance to the nearest object.
+ */
+struct Radar : CanMessage<0x0A0, 8> {
+    using Distance = CanSignal<0, 16, ByteOrder::INTEL, false, 0.001, 0.0>; ///< m, 0 to 65.535
+    using Counter = CanSignal<56, 4, ByteOrder::INTEL, false, 1.0, 0.0>; ///< Alive counter
+};
+
+/**
+ * @brief VEHICLE_SPEED (0x0B0): vehicle speed.
+ */
+struct Speed : CanMessage<0x0B0, 8> {
+    using VehicleSpeed = CanSignal<0, 16, ByteOrder::INTEL, false, 0.01, 0.0>; ///< km/h, 0 to 655.35
+    using Counter = CanSignal<56, 4, ByteOrder::INTEL, false, 1.0, 0.0>; ///< Alive counter
+};
+
+/**
+ * @brief BATTERY_STATUS (0x3A0): state of charge.
+ */
+struct Battery : CanMessage<0x3A0, 8> {
+    using StateOfCharge = CanSignal<0, 10, ByteOrder::INTEL, false, 0.1, 0.0>; ///< %, 0 to 102.3
+    using Counter = CanSignal<56, 4, ByteOrder::INTEL, false, 1.0, 0.0>; ///< Alive counter
+};
+
+/**
+ * @brief ENGINE_TEMPERATURE (0x3B0): coolant temperature, big endian as many powertrain ECUs send it.
+ */
+struct Temperature : CanMessage<0x3B0, 8> {
+    using Coolant = CanSignal<7, 16, ByteOrder::MOTOROLA, false, 0.01, -40.0>; ///< degC, -40 to 615.35
+    using Counter = CanSignal<56, 4, ByteOrder::INTEL, false, 1.0, 0.0>; ///< Alive counter
+};
+
+static_assert(Radar::Fits<Radar::Distance>() && Radar::Fits<Radar::Counter>(), "RADAR_OBJECT layout");
+static_assert(Speed::Fits<Speed::VehicleSpeed>() && Speed::Fits<Speed::Counter>(), "VEHICLE_SPEED layout");
+static_assert(Battery::Fits<Battery::StateOfCharge>() && Battery::Fits<Battery::Counter>(), "BATTERY_STATUS layout");
+static_assert(Temperature::Fits<Temperature::Coolant>() && Temperature::Fits<Temperature::Counter>(), "ENGINE_TEMPERATURE layout");
+static_assert(Speed::VehicleSpeed::Max >= 320.0 && Temperature::Coolant::Max >= 320.0 &&
+              Radar::Distance::Max >= 50.0 && Battery::StateOfCharge::Max >= 100.0,
+              "Signal ranges must cover the sensor ranges");
+
+} // namespace VehicleMessages
+
+#endif // !VEHICLE_MESSAGES_H
@@ -0,0 +1,256 @@
+#include "VirtualCanBus.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Creates an idle bus at time 0.
+ *
+ * @param config Bit rates and queue depth.
+ */
+VirtualCanBus::VirtualCanBus(const CanBusConfig& config)
+    : config(config), busTime(0), statsStart(0), busy(false), currentNode(0), currentEnd(0) {
+    if (config.nominalBitrate == 0 || config.dataBitrate == 0) {
+        throw std::invalid_argument("CAN bit rates must be positive");
+    }
+}
+
+/**
+ * @brief Adds a node.
+ *
+ * @param name Name used in reports.
+ * @return NodeId The node handle.
+ */
+VirtualCanBus::NodeId VirtualCanBus::AddNode(const std::string& name) {
+    nodes.push_back(Node{name, {}});
+    nodes.back().queue.reserve(config.txQueueDepth);
+    return nodes.size() - 1;
+}
+
+/**
+ * @brief Delivers frames whose identifier matches under a mask to a node.
+ *
+ * @param node The receiving node.
+ * @param id Identifier to match.
+ * @param mask Bits of the identifier that must match.
+ * @param handler Called for every accepted frame.
+ */
+void VirtualCanBus::Subscribe(NodeId node, std::uint32_t id, std::uint32_t mask, ReceiveHandler handler) {
+    filters.push_back(Filter{node, id, mask, std::move(handler)});
+}
+
+/**
+ * @brief Queues a frame for transmission.
+ *
+ * @param node The sending node.
+ * @param frame The frame.
+ * @param now When the frame becomes ready.
+ * @return true if queued.
+ */
+bool VirtualCanBus::Transmit(NodeId node, const CanFrame& frame, TimestampNs now) {
+    if (!CanFrameValid(frame)) {
+        stats.rejected++;
+        return false;
+    }
+    std::vector<Pending>& queue = nodes.at(node).queue;
+    if (queue.size() >= config.txQueueDepth) {
+        stats.dropped++;
+        return false;
+    }
+    queue.push_back(Pending{frame, std::max(now, busTime), ArbitrationKey(frame)});
+    return true;
+}
+
+/**
+ * @brief Simulates the bus up to a time.
+ *
+ * Each time the bus goes idle, the frames ready at that moment arbitrate;
+ * if none is ready, the bus stays idle until the next frame becomes ready.
+ *
+ * @param time The time to run to.
+ */
+void VirtualCanBus::RunUntil(TimestampNs time) {
+    for (;;) {
+        if (busy) {
+            if (currentEnd > time) {
+                break;
+            }
+            Complete();
+            continue;
+        }
+
+        // Arbitration among the frames ready now; each node offers its lowest identifier
+        NodeId winner = 0;
+        std::size_t winnerIndex = 0;
+        std::size_t contenders = 0;
+        TimestampNs nextReady = -1;
+        for (NodeId n = 0; n < nodes.size(); n++) {
+            const std::vector<Pending>& queue = nodes[n].queue;
+            std::size_t best = queue.size();
+            for (std::size_t i = 0; i < queue.size(); i++) {
+                if (queue[i].ready > busTime) {
+                    if (nextReady < 0 || queue[i].ready < nextReady) {
+                        nextReady = queue[i].ready;
+                    }
+                } else if (best == queue.size() || queue[i].key < queue[best].key) {
+                    best = i;
+                }
+            }
+            if (best == queue.size()) {
+                continue;
+            }
+            if (contenders == 0 || queue[best].key < nodes[winner].queue[winnerIndex].key) {
+                winner = n;
+                winnerIndex = best;
+            }
+            contenders++;
+        }
+
+        if (contenders == 0) {
+            if (nextReady < 0 || nextReady > time) {
+                break; // Idle until the target time
+            }
+            busTime = nextReady;
+            continue;
+        }
+
+        stats.arbitrationLosses += contenders - 1;
+        std::vector<Pending>& queue = nodes[winner].queue;
+        current = queue[winnerIndex];
+        queue.erase(queue.begin() + winnerIndex);
+        currentNode = winner;
+        currentEnd = busTime + FrameDuration(current.frame);
+        busy = true;
+    }
+    busTime = std::max(busTime, time);
+    stats.elapsedNs = busTime - statsStart;
+}
+
+/**
+ * @brief Finishes the frame on the bus and delivers it.
+ */
+void VirtualCanBus::Complete() {
+    const TimestampNs start = currentEnd - FrameDuration(current.frame);
+    std::uint32_t nominalBits = 0;
+    std::uint32_t dataBits = 0;
+    FrameBits(current.frame, nominalBits, dataBits);
+
+    busy = false;
+    busTime = currentEnd;
+    stats.frames++;
+    stats.bits += nominalBits + dataBits;
+    stats.busyNs += currentEnd - std::max(start, statsStart);
+    CanIdStats& id = stats.perId[current.frame.id];
+    const TimestampNs latency = currentEnd - current.ready;
+    id.frames++;
+    id.totalLatency += latency;
+    id.maxLatency = std::max(id.maxLatency, latency);
+
+    for (const Filter& f : filters) {
+        if (f.node != currentNode && (current.frame.id & f.mask) == (f.id & f.mask)) {
+            f.handler(current.frame, currentEnd);
+        }
+    }
+}
+
+/**
+ * @brief Gets the simulated bus time.
+ *
+ * @return TimestampNs The time.
+ */
+TimestampNs VirtualCanBus::now() const {
+    return busTime;
+}
+
+/**
+ * @brief Gets the traffic counters.
+ *
+ * @return const CanBusStats& The counters.
+ */
+const CanBusStats& VirtualCanBus::getStats() const {
+    return stats;
+}
+
+/**
+ * @brief Clears the traffic counters.
+ */
+void VirtualCanBus::ResetStats() {
+    stats = CanBusStats();
+    statsStart = busTime;
+}
+
+/**
+ * @brief Gets the name of a node.
+ *
+ * @param node The node.
+ * @return const std::string& The name.
+ */
+const std::string& VirtualCanBus::getNodeName(NodeId node) const {
+    return nodes.at(node).name;
+}
+
+/**
+ * @brief Counts the bits of a frame on the wire at worst-case bit stuffing.
+ *
+ * Classic frames use the usual bounds (47 + 8n + (34 + 8n - 1) / 4 bits for
+ * standard frames, 67 + 8n + (54 + 8n - 1) / 4 for extended ones, both
+ * including the 3-bit interframe space). FD frames add the stuff count,
+ * the longer CRC and its fixed stuff bits, and split the bits between the
+ * arbitration and data phases.
+ *
+ * @param frame The frame.
+ * @param nominalBits Receives the bits sent at the nominal bit rate.
+ * @param dataBits Receives the bits sent at the data bit rate.
+ */
+void VirtualCanBus::FrameBits(const CanFrame& frame, std::uint32_t& nominalBits, std::uint32_t& dataBits) {
+    const std::uint32_t payload = 8u * frame.length;
+    if (!frame.fd) {
+        nominalBits = frame.extended ? 67 + payload + (54 + payload - 1) / 4
+                                     : 47 + payload + (34 + payload - 1) / 4;
+        dataBits = 0;
+        return;
+    }
+    const std::uint32_t header = frame.extended ? 36 : 17; // SOF up to and including BRS
+    const std::uint32_t trailer = 13; // CRC delimiter, ACK, ACK delimiter, EOF, interframe space
+    const std::uint32_t crc = frame.length > 16 ? 21 : 17;
+    const std::uint32_t control = 5 + payload; // ESI, DLC, data
+    const std::uint32_t fixedStuff = (4 + crc + 3) / 4; // One per four bits from the stuff count on
+    const std::uint32_t dataPhase = control + (control - 1) / 4 + 4 + crc + fixedStuff;
+    nominalBits = header + (header - 1) / 4 + trailer;
+    dataBits = dataPhase;
+    if (!frame.bitRateSwitch) {
+        nominalBits += dataPhase;
+        dataBits = 0;
+    }
+}
+
+/**
+ * @brief Computes how long a frame occupies this bus.
+ *
+ * @param frame The frame.
+ * @return TimestampNs The duration.
+ */
+TimestampNs VirtualCanBus::FrameDuration(const CanFrame& frame) const {
+    std::uint32_t nominalBits = 0;
+    std::uint32_t dataBits = 0;
+    FrameBits(frame, nominalBits, dataBits);
+    return ((TimestampNs)nominalBits * 1000000000 + config.nominalBitrate - 1) / config.nominalBitrate +
+           ((TimestampNs)dataBits * 1000000000 + config.dataBitrate - 1) / config.dataBitrate;
+}
+
+/**
+ * @brief Computes the arbitration key of a frame.
+ *
+ * The key follows the bits in the order they are sent: the 11-bit base
+ * identifier, then RTR/SRR and IDE (dominant for standard frames), then
+ * the 18 extension bits. A lower key is more dominant.
+ *
+ * @param frame The frame.
+ * @return std::uint64_t The key.
+ */
+std::uint64_t VirtualCanBus::ArbitrationKey(const CanFrame& frame) {
+    if (frame.extended) {
+        const std::uint64_t base = frame.id >> 18;
+        return (base << 20) | (1u << 19) | (1u << 18) | (frame.id & 0x3FFFF);
+    }
+    return (std::uint64_t)frame.id << 20;
+}
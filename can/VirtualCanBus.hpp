@@ -0,0 +1,213 @@
+#ifndef VIRTUAL_CAN_BUS_H
+#define VIRTUAL_CAN_BUS_H
+
+#include "CanFrame.hpp"
+#include "../telemetry/SensorHistory.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Timing and controller settings of a virtual bus.
+ */
+struct CanBusConfig {
+    std::uint32_t nominalBitrate = 500000; ///< Arbitration (and classic CAN) bit rate in bit/s
+    std::uint32_t dataBitrate = 2000000; ///< CAN-FD data phase bit rate in bit/s, used when BRS is set
+    std::size_t txQueueDepth = 16; ///< Frames a node can have pending before Transmit fails
+};
+
+/**
+ * @brief Traffic counters of one identifier.
+ */
+struct CanIdStats {
+    std::uint64_t frames = 0; ///< Frames sent
+    TimestampNs totalLatency = 0; ///< Sum of queueing plus transmission time
+    TimestampNs maxLatency = 0; ///< Worst queueing plus transmission time
+};
+
+/**
+ * @brief Traffic counters of a virtual bus since the last ResetStats.
+ */
+struct CanBusStats {
+    std::uint64_t frames = 0; ///< Frames sent
+    std::uint64_t bits = 0; ///< Bits sent, counted at the worst-case stuffing
+    std::uint64_t arbitrationLosses = 0; ///< Times a ready frame lost arbitration to a lower identifier
+    std::uint64_t dropped = 0; ///< Frames rejected because a node's queue was full
+    std::uint64_t rejected = 0; ///< Frames rejected as invalid
+    TimestampNs busyNs = 0; ///< Time the bus carried frames
+    TimestampNs elapsedNs = 0; ///< Time simulated
+    std::map<std::uint32_t, CanIdStats> perId; ///< Counters per identifier
+
+    /**
+     * @brief Gets the bus load.
+     *
+     * @return double Fraction of time the bus was busy, 0 to 1.
+     */
+    double load() const { return elapsedNs > 0 ? (double)busyNs / elapsedNs : 0.0; }
+};
+
+/**
+ * @brief An in-process CAN bus with arbitration, frame timing and load accounting.
+ *
+ * @details Nodes queue frames with Transmit and receive frames that pass one
+ * of their acceptance filters. RunUntil advances simulated time: whenever
+ * the bus is idle, the lowest arbitration key among the frames ready at
+ * that moment wins, exactly as bitwise arbitration would pick it, and
+ * occupies the bus for its frame duration. Then every other node with a
+ * matching filter receives it. Frame durations use the worst-case bit
+ * stuffing counts of the CAN and CAN-FD frame formats rather than stuffing
+ * real bit streams, so loads and latencies are upper bounds.
+ *
+ * Not thread-safe; one thread drives a bus.
+ */
+class VirtualCanBus {
+public:
+    typedef std::size_t NodeId; ///< Handle of a node on the bus
+    typedef std::function<void(const CanFrame&, TimestampNs)> ReceiveHandler; ///< Called with the frame and its end-of-frame time
+
+    /**
+     * @brief Creates an idle bus at time 0.
+     *
+     * @param config Bit rates and queue depth.
+     */
+    explicit VirtualCanBus(const CanBusConfig& config = CanBusConfig());
+
+    /**
+     * @brief Adds a node.
+     *
+     * @param name Name used in reports.
+     * @return NodeId The node handle.
+     */
+    NodeId AddNode(const std::string& name);
+
+    /**
+     * @brief Delivers frames whose identifier matches under a mask to a node.
+     *
+     * A frame is accepted if (frame.id & mask) == (id & mask). A node may
+     * register several filters; a frame is delivered once per matching filter.
+     *
+     * @param node The receiving node.
+     * @param id Identifier to match.
+     * @param mask Bits of the identifier that must match; 0 accepts everything.
+     * @param handler Called for every accepted frame.
+     */
+    void Subscribe(NodeId node, std::uint32_t id, std::uint32_t mask, ReceiveHandler handler);
+
+    /**
+     * @brief Queues a frame for transmission.
+     *
+     * @param node The sending node.
+     * @param frame The frame.
+     * @param now When the frame becomes ready; times before the bus time are moved up to it.
+     * @return true if queued, false if the frame is invalid or the node's queue is full.
+     */
+    bool Transmit(NodeId node, const CanFrame& frame, TimestampNs now);
+
+    /**
+     * @brief Simulates the bus up to a time, delivering every frame that completes by then.
+     *
+     * @param time The time to run to.
+     */
+    void RunUntil(TimestampNs time);
+
+    /**
+     * @brief Gets the simulated bus time.
+     *
+     * @return TimestampNs The time.
+     */
+    TimestampNs now() const;
+
+    /**
+     * @brief Gets the traffic counters.
+     *
+     * @return const CanBusStats& The counters.
+     */
+    const CanBusStats& getStats() const;
+
+    /**
+     * @brief Clears the traffic counters.
+     */
+    void ResetStats();
+
+    /**
+     * @brief Gets the name of a node.
+     *
+     * @param node The node.
+     * @return const std::string& The name.
+     */
+    const std::string& getNodeName(NodeId node) const;
+
+    /**
+     * @brief Counts the bits of a frame on the wire at worst-case bit stuffing.
+     *
+     * @param frame The frame.
+     * @param nominalBits Receives the bits sent at the nominal bit rate.
+     * @param dataBits Receives the bits sent at the data bit rate (FD with BRS only).
+     */
+    static void FrameBits(const CanFrame& frame, std::uint32_t& nominalBits, std::uint32_t& dataBits);
+
+    /**
+     * @brief Computes how long a frame occupies this bus, including the interframe space.
+     *
+     * @param frame The frame.
+     * @return TimestampNs The duration.
+     */
+    TimestampNs FrameDuration(const CanFrame& frame) const;
+
+private:
+    /**
+     * @brief A frame waiting in a node's transmit queue.
+     */
+    struct Pending {
+        CanFrame frame; ///< The frame
+        TimestampNs ready; ///< When it was queued
+        std::uint64_t key; ///< Arbitration key; lower wins
+    };
+
+    /**
+     * @brief An acceptance filter of a node.
+     */
+    struct Filter {
+        NodeId node; ///< Receiving node
+        std::uint32_t id; ///< Identifier to match
+        std::uint32_t mask; ///< Bits that must match
+        ReceiveHandler handler; ///< Receive callback
+    };
+
+    /**
+     * @brief A node on the bus.
+     */
+    struct Node {
+        std::string name; ///< Name used in reports
+        std::vector<Pending> queue; ///< Transmit queue
+    };
+
+    /**
+     * @brief Computes the arbitration key of a frame.
+     *
+     * @param frame The frame.
+     * @return std::uint64_t The key; a standard frame beats an extended frame with the same base identifier.
+     */
+    static std::uint64_t ArbitrationKey(const CanFrame& frame);
+
+    /**
+     * @brief Finishes the frame on the bus and delivers it.
+     */
+    void Complete();
+
+    CanBusConfig config; ///< Bit rates and queue depth
+    std::vector<Node> nodes; ///< Nodes by NodeId
+    std::vector<Filter> filters; ///< Acceptance filters of all nodes
+    CanBusStats stats; ///< Traffic counters
+    TimestampNs busTime; ///< Time the bus has been simulated to
+    TimestampNs statsStart; ///< Bus time of the last ResetStats
+    bool busy; ///< A frame is on the bus
+    Pending current; ///< The frame on the bus
+    NodeId currentNode; ///< Sender of the frame on the bus
+    TimestampNs currentEnd; ///< When the frame on the bus completes
+};
+
+#endif // !VIRTUAL_CAN_BUS_H
@@ -0,0 +1,62 @@
+#ifndef ATOMIC_SIGNAL_H
+#define ATOMIC_SIGNAL_H
+
+#include <atomic>
+
+/**
+ * @brief A double that can be written and read from different threads.
+ * 
+ * @details Wraps std::atomic<double> with relaxed ordering and converts
+ * implicitly to and from double. Like the atomic, a signal is not
+ * copyable; read it into a double to take its value.
+ */
+class AtomicSignal {
+public:
+    /**
+     * @brief Constructs a signal.
+     * 
+     * @param initial The initial value.
+     */
+    AtomicSignal(double initial = 0.0) : value(initial) {}
+
+    // Deleted copy constructor and assignment operator
+    AtomicSignal(const AtomicSignal&) = delete;
+    AtomicSignal& operator=(const AtomicSignal&) = delete;
+
+    /**
+     * @brief Stores a new value.
+     * 
+     * @param v The value.
+     * @return AtomicSignal& This signal.
+     */
+    AtomicSignal& operator=(double v) {
+        store(v);
+        return *this;
+    }
+
+    /**
+     * @brief Reads the current value.
+     * 
+     * @return double The value.
+     */
+    operator double() const { return load(); }
+
+    /**
+     * @brief Reads the current value.
+     * 
+     * @return double The value.
+     */
+    double load() const { return value.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Stores a new value.
+     * 
+     * @param v The value.
+     */
+    void store(double v) { value.store(v, std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> value; ///< The current value
+};
+
+#endif // !ATOMIC_SIGNAL_H
@@ -6,65 +6,171 @@
 #include "../Sensors/Sensor.hpp"
 #include "../Sensors/SpeedSensor.hpp"
 #include "../Sensors/TemperatureSensor.hpp"
+#include "../metrics/CarMetrics.hpp"
+#include "../config/RuntimeConfig.hpp"
 #include <memory>
 #include <algorithm> // For std::find_if
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
 
-Car::Car(const std::string& model, const std::string& make)
+/**
+ * @brief Gets one built-in sensor by type.
+ * 
+ * @param type The sensor type.
+ * @return Sensor& The sensor.
+ */
+Sensor& BuiltInSensors::get(SensorTypes type) {
+    switch (type) {
+    case SensorTypes::SPEED_SENSOR: return speed; 
+    case SensorTypes::TEMPERATURE_SENSOR: return temperature; 
+    case SensorTypes::RADAR_SENSOR: return radar; 
+    default: return battery; 
+    }
+}
+
+Car::Car(const std::string& model, const std::string& make, SensorStorage storage)
     : model(model), make(make), Adaptive_MODE(false), 
-      Car_Speed_Sensor(std::make_shared<SpeedSensor>()),
-      Car_Temperature_Sensor(std::make_shared<TemperatureSensor>()),
-      Car_Battery_Level_Sensor(std::make_shared<BatteryLevelSensor>()),
-      Car_Radar_Sensor(std::make_shared<RadarSensor>()),
       Car_Adaptive_Cruise_Control_ECU(std::make_shared<Adaptive_Cruise_Control_ECU>()),
-      Car_Diagnostic_ECU(std::make_shared<DiagnosticECU>())
+      Car_Diagnostic_ECU(std::make_shared<DiagnosticECU>()),
+      Limits(VehicleLimits::Of<DefaultVehicleProfile>()), Status_Check(&EvaluateVehicleStatus<DefaultVehicleProfile>),
+      Status_Alerts(), Follow_Settings(false), Settings_Version(0)
 {
     Logger::getInstance().log("A new " + make + " " + model + " is created");
+    if (storage == SensorStorage::INLINE) {
+        PlaceInlineSensors(); 
+    } else {
+        Sensors.resize(MAX_SENSOR_NUMBER); 
+        Sensors[(int)SensorTypes::SPEED_SENSOR] = std::make_shared<SpeedSensor>(); 
+        Sensors[(int)SensorTypes::TEMPERATURE_SENSOR] = std::make_shared<TemperatureSensor>(); 
+        Sensors[(int)SensorTypes::BATTERY_LEVEL_SENSOR] = std::make_shared<BatteryLevelSensor>(); 
+        Sensors[(int)SensorTypes::RADAR_SENSOR] = std::make_shared<RadarSensor>(); 
+    }
     // Initialize the car with sensors and ECUs
     CarINIT();
 }
 
-void Car::CarINIT() {
-    Logger::getInstance().log("Starting the Engine of " + make + " " + model + " vom vom vom");
+Car::Car(const std::string& model, const std::string& make, MonotonicArena& arena, SensorStorage storage)
+    : model(model), make(make), Adaptive_MODE(false), 
+      Car_Adaptive_Cruise_Control_ECU(std::allocate_shared<Adaptive_Cruise_Control_ECU>(ArenaAllocator<Adaptive_Cruise_Control_ECU>(arena))),
+      Car_Diagnostic_ECU(std::allocate_shared<DiagnosticECU>(ArenaAllocator<DiagnosticECU>(arena))),
+      Limits(VehicleLimits::Of<DefaultVehicleProfile>()), Status_Check(&EvaluateVehicleStatus<DefaultVehicleProfile>),
+      Status_Alerts(), Follow_Settings(false), Settings_Version(0)
+{
+    if (Logger::getInstance().isEnabled()) {
+        Logger::getInstance().log("A new " + make + " " + model + " is created");
+    }
+    PlaceSensors(arena, storage); 
+    CarINIT();
+}
 
-    // Resize the Sensors vector to hold all default sensor types
+Car::Car(const std::string& model, const std::string& make, const CarState& state, TimestampNs now, MonotonicArena& arena, SensorStorage storage)
+    : model(model), make(make), Adaptive_MODE(false), 
+      Car_Adaptive_Cruise_Control_ECU(std::allocate_shared<Adaptive_Cruise_Control_ECU>(ArenaAllocator<Adaptive_Cruise_Control_ECU>(arena))),
+      Car_Diagnostic_ECU(std::allocate_shared<DiagnosticECU>(ArenaAllocator<DiagnosticECU>(arena))),
+      Limits(VehicleLimits::Of<DefaultVehicleProfile>()), Status_Check(&EvaluateVehicleStatus<DefaultVehicleProfile>),
+      Status_Alerts(), Follow_Settings(false), Settings_Version(0)
+{
+    PlaceSensors(arena, storage); 
+    AttachBuiltinECUs(); 
+    RestoreState(state, now); 
+}
+
+void Car::PlaceSensors(MonotonicArena& arena, SensorStorage storage) {
+    /**
+     * @brief Builds the built-in sensors, inline or each sharing one arena allocation with its control block.
+     * 
+     * @param arena The arena for sensors kept on the heap.
+     * @param storage Where to keep them.
+     */
+    if (storage == SensorStorage::INLINE) {
+        PlaceInlineSensors(); 
+        return; 
+    }
     Sensors.resize(MAX_SENSOR_NUMBER); 
+    Sensors[(int)SensorTypes::SPEED_SENSOR] = std::allocate_shared<SpeedSensor>(ArenaAllocator<SpeedSensor>(arena)); 
+    Sensors[(int)SensorTypes::TEMPERATURE_SENSOR] = std::allocate_shared<TemperatureSensor>(ArenaAllocator<TemperatureSensor>(arena)); 
+    Sensors[(int)SensorTypes::BATTERY_LEVEL_SENSOR] = std::allocate_shared<BatteryLevelSensor>(ArenaAllocator<BatteryLevelSensor>(arena)); 
+    Sensors[(int)SensorTypes::RADAR_SENSOR] = std::allocate_shared<RadarSensor>(ArenaAllocator<RadarSensor>(arena)); 
+}
 
-    // Directly assign sensors to the corresponding indices
-    Sensors[(int)SensorTypes::SPEED_SENSOR] = Car_Speed_Sensor;
-    Sensors[(int)SensorTypes::TEMPERATURE_SENSOR] = Car_Temperature_Sensor;
-    Sensors[(int)SensorTypes::RADAR_SENSOR] = Car_Radar_Sensor;
-    Sensors[(int)SensorTypes::BATTERY_LEVEL_SENSOR] = Car_Battery_Level_Sensor;
+void Car::PlaceInlineSensors() {
+    /**
+     * @brief Builds the built-in sensors inside the car and fills Sensors with non-owning handles to them.
+     * 
+     * Each handle uses the shared_ptr aliasing constructor with an empty
+     * owner, so it carries no control block: the ECUs that copy it do no
+     * reference counting, and nothing is freed when the last copy goes.
+     */
+    Inline_Sensors.emplace(); 
+    Sensors.resize(MAX_SENSOR_NUMBER); 
+    for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+        Sensors[type] = std::shared_ptr<Sensor>(std::shared_ptr<Sensor>(), &Inline_Sensors->get(SensorTypes(type))); 
+    }
+}
 
-    ECUs.push_back(Car_Adaptive_Cruise_Control_ECU); 
-    ECUs.push_back(Car_Diagnostic_ECU); 
+void Car::CarINIT() {
+    const bool verbose = Logger::getInstance().isEnabled(); 
+    if (verbose) {
+        Logger::getInstance().log("Starting the Engine of " + make + " " + model + " vom vom vom");
+    }
+    AttachBuiltinECUs(); 
 
     // Initialize car_info with default values and log them
-    Car_info[SensorTypes::SPEED_SENSOR] = 0; 
-    Logger::getInstance().log("Speed of " + make + " " + model + ": " + std::to_string(Car_info[SensorTypes::SPEED_SENSOR]));
+    Car_info[(int)SensorTypes::SPEED_SENSOR] = 0; 
+    Car_info[(int)SensorTypes::TEMPERATURE_SENSOR] = 25; 
+    Car_info[(int)SensorTypes::RADAR_SENSOR] = 0; 
+    Car_info[(int)SensorTypes::BATTERY_LEVEL_SENSOR] = 100; 
+    PublishSnapshot(); 
+    if (!verbose) {
+        return; 
+    }
+    Logger::getInstance().log("Speed of " + make + " " + model + ": " + std::to_string(Car_info[(int)SensorTypes::SPEED_SENSOR]));
+    Logger::getInstance().log("Temperature of " + make + " " + model + ": " + std::to_string(Car_info[(int)SensorTypes::TEMPERATURE_SENSOR]));
+    Logger::getInstance().log("Radar reading of " + make + " " + model + ": " + std::to_string(Car_info[(int)SensorTypes::RADAR_SENSOR]));
+    Logger::getInstance().log("Battery level of " + make + " " + model + ": 100%");
+}
 
-    Car_info[SensorTypes::TEMPERATURE_SENSOR] = 25; 
-    Logger::getInstance().log("Temperature of " + make + " " + model + ": " + std::to_string(Car_info[SensorTypes::TEMPERATURE_SENSOR]));
+void Car::AttachBuiltinECUs() {
+    /**
+     * @brief Fills the built-in sensor and ECU tables and subscribes adaptive cruise control to speed and radar.
+     */
+    for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+        Builtin_Sensors[type] = Sensors[type].get(); 
+    }
 
-    Car_info[SensorTypes::RADAR_SENSOR] = 0; 
-    Logger::getInstance().log("Radar reading of " + make + " " + model + ": " + std::to_string(Car_info[SensorTypes::RADAR_SENSOR]));
+    ECUs.reserve(2); 
+    ECUs.push_back(Car_Adaptive_Cruise_Control_ECU); 
+    ECUs.push_back(Car_Diagnostic_ECU); 
 
-    Car_info[SensorTypes::BATTERY_LEVEL_SENSOR] = 100; 
-    Logger::getInstance().log("Battery level of " + make + " " + model + ": 100%");
+    // Adaptive cruise control follows the speed and radar readings
+    const std::shared_ptr<Sensor>& speed = Sensors[(int)SensorTypes::SPEED_SENSOR]; 
+    const std::shared_ptr<Sensor>& radar = Sensors[(int)SensorTypes::RADAR_SENSOR]; 
+    Car_Adaptive_Cruise_Control_ECU->AttachSensor(speed); 
+    speed->AttachECU(Car_Adaptive_Cruise_Control_ECU); 
+    Car_Adaptive_Cruise_Control_ECU->AttachSensor(radar); 
+    radar->AttachECU(Car_Adaptive_Cruise_Control_ECU); 
 }
 
 void Car::UpdateSensorsData() {
     // Update sensor data
-    Car_info[SensorTypes::SPEED_SENSOR] = Car_Speed_Sensor->GetSensorData(); 
-    Car_info[SensorTypes::TEMPERATURE_SENSOR] = Car_Temperature_Sensor->GetSensorData(); 
-    Car_info[SensorTypes::RADAR_SENSOR] = Car_Radar_Sensor->GetSensorData(); 
-    Car_info[SensorTypes::BATTERY_LEVEL_SENSOR] = Car_Battery_Level_Sensor->GetSensorData(); 
+    SampleSensor(SensorTypes::SPEED_SENSOR); 
+    SampleSensor(SensorTypes::TEMPERATURE_SENSOR); 
+    SampleSensor(SensorTypes::RADAR_SENSOR); 
+    SampleSensor(SensorTypes::BATTERY_LEVEL_SENSOR); 
+    PublishSnapshot(); 
 
     // Log the updated sensor values
+    if (!Logger::getInstance().isEnabled()) {
+        return; 
+    }
+    const CarSnapshot snapshot = getSnapshot(); 
     Logger::getInstance().log("Updated sensor data for " + make + " " + model + ": " +
-        "Speed: " + std::to_string(Car_info[SensorTypes::SPEED_SENSOR]) + ", " +
-        "Temperature: " + std::to_string(Car_info[SensorTypes::TEMPERATURE_SENSOR]) + ", " +
-        "Radar: " + std::to_string(Car_info[SensorTypes::RADAR_SENSOR]) + ", " +
-        "Battery Level: " + std::to_string(Car_info[SensorTypes::BATTERY_LEVEL_SENSOR]) + "%");
+        "Speed: " + std::to_string(snapshot.get(SensorTypes::SPEED_SENSOR)) + ", " +
+        "Temperature: " + std::to_string(snapshot.get(SensorTypes::TEMPERATURE_SENSOR)) + ", " +
+        "Radar: " + std::to_string(snapshot.get(SensorTypes::RADAR_SENSOR)) + ", " +
+        "Battery Level: " + std::to_string(snapshot.get(SensorTypes::BATTERY_LEVEL_SENSOR)) + "%");
 }
 
 Car::~Car() {
@@ -78,7 +184,7 @@ void Car::ActivateSensor(std::shared_ptr<Sensor> S) {
      * @param S A shared pointer to the sensor to be activated.
      */
     Sensors.push_back(S); 
-    Logger::getInstance().log("New Activated sensor: " + S->getType()); // Log sensor activation
+    Logger::getInstance().log("New Activated sensor: " + std::string(S->getType())); // Log sensor activation
 }
 
 void Car::ActivateECU(std::shared_ptr<ECU> E) {
@@ -88,7 +194,7 @@ void Car::ActivateECU(std::shared_ptr<ECU> E) {
      * @param E A shared pointer to the ECU to be activated.
      */
     ECUs.push_back(E); 
-    Logger::getInstance().log("New Activated ECU: " + E->getName()); // Log ECU activation
+    Logger::getInstance().log("New Activated ECU: " + std::string(E->getName())); // Log ECU activation
 }
 
 void Car::setAdaptiveMode(bool mode) {
@@ -98,10 +204,10 @@ void Car::setAdaptiveMode(bool mode) {
      * @param mode A boolean indicating whether to enable or disable the adaptive mode.
      */
     Adaptive_MODE = mode; // Set adaptive mode first
-    Logger::getInstance().log("Setting adaptive mode to " + std::string(mode ? "enabled" : "disabled")); // Log the new state
+    Logger::getInstance().log(mode ? "Setting adaptive mode to enabled" : "Setting adaptive mode to disabled"); // Log the new state
 
     for (auto& E : ECUs) {
-        if (E->getName() == "Adaptive Cruise Control ECU") {
+        if (E->getKind() == ECUTypes::ADAPTIVE_CRUISE_CONTROL_ECU) {
             E->PerformFunction(*this); 
             Logger::getInstance().log("Performing function for Adaptive Cruise Control ECU"); // Log function execution
         }
@@ -110,39 +216,75 @@ void Car::setAdaptiveMode(bool mode) {
 
 void Car::DisplayStatus() {
     /**
-     * @brief Displays the current status of the car, including speed, temperature, battery level, radar status, and adaptive mode.
+     * @brief Logs the status lines that changed since the last call, and a periodic summary.
+     * 
+     * All checks use one snapshot so they agree on the same tick, and run
+     * through EvaluateStatus, compiled for the car's vehicle profile when
+     * it has one; StatusAlerts only debounces the result. With sensor fusion on,
+     * the collision check uses the fused range. Unchanged lines are only
+     * counted, so a quiet fleet costs a few compares per car instead of
+     * five log lines. A car that follows the runtime settings first picks
+     * up a newly installed version.
      */
-    if(Car_info[SensorTypes::SPEED_SENSOR] > MAX_SPEED) {
-        Logger::getInstance().log("Speed Exceeded please SLOW DOWN"); 
-    } else {
-        Logger::getInstance().log("Speed is within the allowed Range"); 
+    if (Follow_Settings) {
+        FollowSettingsVersion(); 
     }
-
-    if(Car_info[SensorTypes::TEMPERATURE_SENSOR] > MAX_TEMPERATURE) {
-        Logger::getInstance().log("Car is overheating please stop"); 
-    } else {
-        Logger::getInstance().log("Temperature is within the allowed Range"); 
+    CarSnapshot snapshot = getSnapshot(); 
+    if (Car_Sensor_Fusion_ECU && Car_Sensor_Fusion_ECU->hasEstimate()) {
+        snapshot.values[(int)SensorTypes::RADAR_SENSOR] = Car_Sensor_Fusion_ECU->getRange(); 
     }
-
-    if(Car_info[SensorTypes::BATTERY_LEVEL_SENSOR] < LOW_BATTERY) {
-        Logger::getInstance().log("LOW BATTERY PLEASE GO TO THE NEAREST CHARGING STATION"); 
-    } else {
-        Logger::getInstance().log("Battery is Good"); 
+    const std::uint32_t changed = Status_Alerts.Update(EvaluateStatus(snapshot, Status_Alerts.getAlerts()), Adaptive_MODE); 
+    const std::uint32_t alerts = Status_Alerts.getAlerts(); 
+    const CarMetrics& metrics = CarMetrics::get(); 
+    const int lines = std::popcount(changed); 
+    metrics.statusLinesEmitted->Increment(lines); 
+    metrics.statusLinesSuppressed->Increment(STATUS_LINE_COUNT - lines); 
+    for (std::uint32_t rest = changed; rest != 0; rest &= rest - 1) {
+        const int line = std::countr_zero(rest); 
+        const bool raised = line < STATUS_RULE_COUNT && ((alerts >> line) & 1); 
+        if (raised) {
+            // CarAlert lists the status alerts in VEHICLE_ALERT_* bit order
+            metrics.alerts[(int)CarAlert::OVERSPEED + line]->Increment(); 
+        }
+        Logger::getInstance().log(raised ? LogLevel::WARNING : LogLevel::INFO, Status_Alerts.LineText(line)); 
     }
 
-    if(Car_info[SensorTypes::RADAR_SENSOR] < SAFE_RADAR_DISTANCE) {
-        Logger::getInstance().log("Collision is predicted please Slow down"); 
-    } else {
-        Logger::getInstance().log("NO collision Threats"); 
+    if (Status_Alerts.isSummaryDue() && Logger::getInstance().isEnabled()) {
+        char name[64]; 
+        char line[256]; 
+        std::snprintf(name, sizeof(name), "%s %s", make.c_str(), model.c_str()); 
+        Status_Alerts.Summary(name, snapshot.values.data(), line, sizeof(line)); 
+        Logger::getInstance().log(line); 
     }
+}
 
-    if(Adaptive_MODE == true) {
-        Logger::getInstance().log("CRUISE CONTROL IS ON"); 
-    } else {
-        Logger::getInstance().log("CRUISE CONTROL IS OFF"); 
+void Car::FollowSettingsVersion() {
+    /**
+     * @brief Takes the limits of the runtime settings if a new version was installed.
+     * 
+     * New limits switch the status check to them, which forgets every line.
+     */
+    RcuReadGuard guard; 
+    const RuntimeSettings* settings = RuntimeConfig::get().Current(); 
+    if (settings->version != Settings_Version) {
+        Limits = settings->limits; 
+        Status_Check = nullptr; 
+        Status_Alerts.Reset(); 
+        Settings_Version = settings->version; 
     }
 }
 
+void Car::setDiagnosticMode(bool mode) {
+    /**
+     * @brief Turns the diagnostic anomaly checks on or off.
+     * 
+     * The diagnostic ECU keeps relaying samples to the other ECUs either way.
+     * 
+     * @param mode true to check every sample for anomalies.
+     */
+    Car_Diagnostic_ECU->SetON(mode); 
+}
+
 bool Car::getAdaptiveMode() {
     /**
      * @brief Retrieves the current state of the adaptive cruise control mode.
@@ -152,14 +294,328 @@ bool Car::getAdaptiveMode() {
     return Adaptive_MODE; 
 }
 
-void Car::StartDiagonisticTool() const {
+void Car::StartDiagonisticTool() {
     /**
      * @brief Starts the diagnostic tool for the car, attaching all sensors to the diagnostic ECU.
      */
-    for(auto s : Sensors) {
+    AttachDiagnosticSensors(); 
+    Car_Diagnostic_ECU->PerformFunction(*this); 
+}
+
+void Car::AttachDiagnosticSensors() {
+    /**
+     * @brief Subscribes the diagnostic ECU to every sensor of the car; existing subscriptions are kept.
+     */
+    for (const auto& s : Sensors) {
         Car_Diagnostic_ECU->AttachSensor(s); 
         s->AttachECU(Car_Diagnostic_ECU); 
     }
-    
-    Car_Diagnostic_ECU->PerformFunction(*this); 
+}
+
+double Car::getSensorValue(SensorTypes type) const {
+    /**
+     * @brief Retrieves the latest value of one of the built-in sensors.
+     * 
+     * @param type The sensor type.
+     * @return double The value from the last UpdateSensorsData().
+     */
+    return Car_info[(int)type]; 
+}
+
+void Car::SampleSensor(SensorTypes type) {
+    /**
+     * @brief Reads one built-in sensor and publishes the value to the car state.
+     * 
+     * @param type The sensor type to sample.
+     */
+    Car_info[(int)type] = Builtin_Sensors[(int)type]->GetSensorData(); 
+}
+
+void Car::ConsumeSensorData() {
+    /**
+     * @brief Publishes a snapshot, then runs one ECU cycle on the values the sensors currently hold.
+     * 
+     * The cycle time goes to the carecu_ecu_cycle_seconds histogram.
+     */
+    const TimestampNs start = SteadyNowNs(); 
+    PublishSnapshot(); 
+    Car_Diagnostic_ECU->update(); 
+    CarMetrics::get().ecuCycleSeconds->Observe((SteadyNowNs() - start) * 1e-9); 
+}
+
+void Car::PublishSnapshot() {
+    /**
+     * @brief Publishes the current signals as one tick of the car snapshot.
+     */
+    SeqLock<MAX_SENSOR_NUMBER>::Values values; 
+    for (int i = 0; i < MAX_SENSOR_NUMBER; i++) {
+        values[i] = Car_info[i]; 
+    }
+    Status_Snapshot.publish(values); 
+}
+
+CarSnapshot Car::getSnapshot() const {
+    /**
+     * @brief Gets the last published snapshot without taking a lock.
+     * 
+     * @return CarSnapshot The signals of one tick.
+     */
+    CarSnapshot out; 
+    out.version = Status_Snapshot.read(out.values); 
+    return out; 
+}
+
+bool Car::TryGetSnapshot(CarSnapshot& out) const {
+    /**
+     * @brief Makes one attempt to read the last published snapshot.
+     * 
+     * @param out Receives the snapshot if the attempt succeeds.
+     * @return true if the snapshot is consistent.
+     */
+    return Status_Snapshot.tryRead(out.values, out.version); 
+}
+
+std::uint32_t Car::getStatusFlags() const {
+    /**
+     * @brief Gets the on/off state of the built-in ECUs.
+     * 
+     * @return std::uint32_t CAR_STATUS_* bits.
+     */
+    return (Car_Adaptive_Cruise_Control_ECU->IsON() ? CAR_STATUS_ADAPTIVE_ON : 0) | 
+           (Car_Diagnostic_ECU->IsON() ? CAR_STATUS_DIAGNOSTIC_ON : 0); 
+}
+
+void Car::SetProfile(const VehicleLimits& limits) {
+    /**
+     * @brief Gives the car status limits only known at run time.
+     * 
+     * @param limits The limits.
+     */
+    Follow_Settings = false; 
+    Limits = limits; 
+    Status_Check = nullptr; 
+    Status_Alerts.Reset(); 
+}
+
+void Car::FollowRuntimeConfig() {
+    /**
+     * @brief Makes the car take its status limits from the runtime settings.
+     * 
+     * The limits are taken on the next DisplayStatus.
+     */
+    Follow_Settings = true; 
+    Settings_Version = 0; 
+}
+
+const VehicleLimits& Car::getLimits() const {
+    /**
+     * @brief Gets the status limits of the car.
+     * 
+     * @return const VehicleLimits& The limits.
+     */
+    return Limits; 
+}
+
+std::uint32_t Car::EvaluateStatus(const CarSnapshot& snapshot, std::uint32_t raised) const {
+    /**
+     * @brief Checks one snapshot against the car's status limits.
+     * 
+     * @param snapshot The signals to check.
+     * @param raised VEHICLE_ALERT_* bits raised before.
+     * @return std::uint32_t VEHICLE_ALERT_* bits.
+     */
+    if (Status_Check != nullptr) {
+        return Status_Check(snapshot.values.data(), raised); 
+    }
+    return EvaluateVehicleStatus(Limits, snapshot.values.data(), raised); 
+}
+
+const StatusAlerts& Car::getStatusAlerts() const {
+    /**
+     * @brief Gets the state behind DisplayStatus.
+     * 
+     * @return const StatusAlerts& The raised alerts and the emitted and suppressed line counts.
+     */
+    return Status_Alerts; 
+}
+
+void Car::EnableSensorFusion(const RangeFilterConfig& config) {
+    /**
+     * @brief Adds the sensor fusion ECU and subscribes it to the speed and radar sensors.
+     * 
+     * @param config Noise settings of the filter.
+     */
+    if (Car_Sensor_Fusion_ECU) {
+        return; 
+    }
+    Car_Sensor_Fusion_ECU = std::make_shared<SensorFusionECU>(config); 
+    ECUs.push_back(Car_Sensor_Fusion_ECU); 
+    const std::shared_ptr<Sensor>& speed = Sensors[(int)SensorTypes::SPEED_SENSOR]; 
+    const std::shared_ptr<Sensor>& radar = Sensors[(int)SensorTypes::RADAR_SENSOR]; 
+    Car_Sensor_Fusion_ECU->AttachSensor(speed); 
+    speed->AttachECU(Car_Sensor_Fusion_ECU); 
+    Car_Sensor_Fusion_ECU->AttachSensor(radar); 
+    radar->AttachECU(Car_Sensor_Fusion_ECU); 
+}
+
+const SensorFusionECU* Car::getSensorFusion() const {
+    /**
+     * @brief Gets the sensor fusion ECU.
+     * 
+     * @return const SensorFusionECU* The ECU, or nullptr before EnableSensorFusion.
+     */
+    return Car_Sensor_Fusion_ECU.get(); 
+}
+
+const std::vector<std::shared_ptr<Sensor>>& Car::getSensors() const {
+    /**
+     * @brief Gets the car's sensors.
+     * 
+     * @return const std::vector<std::shared_ptr<Sensor>>& The sensors, built-in ones first, indexed by SensorTypes.
+     */
+    return Sensors; 
+}
+
+SensorStorage Car::getSensorStorage() const {
+    /**
+     * @brief Gets where the car keeps its built-in sensors.
+     * 
+     * @return SensorStorage The storage chosen at construction.
+     */
+    return Inline_Sensors ? SensorStorage::INLINE : SensorStorage::HEAP; 
+}
+
+const std::vector<std::shared_ptr<ECU>>& Car::getECUs() const {
+    /**
+     * @brief Gets the car's ECUs.
+     * 
+     * @return const std::vector<std::shared_ptr<ECU>>& The ECUs.
+     */
+    return ECUs; 
+}
+
+const std::string& Car::getModel() const {
+    /**
+     * @brief Gets the model of the car.
+     * 
+     * @return const std::string& The model.
+     */
+    return model; 
+}
+
+const std::string& Car::getMake() const {
+    /**
+     * @brief Gets the make of the car.
+     * 
+     * @return const std::string& The make.
+     */
+    return make; 
+}
+
+// CarState::profile indexes this table
+static const VehicleLimits Builtin_Profiles[] = {
+    VehicleLimits::Of<PassengerCarProfile>(), VehicleLimits::Of<TruckProfile>(), VehicleLimits::Of<SportsCarProfile>()
+};
+
+CarState Car::SaveState(TimestampNs now) const {
+    /**
+     * @brief Gets everything the car carries from one event to the next.
+     * 
+     * The limits' name is kept as an index into the built-in profiles, the
+     * only names a status check can be compiled for.
+     * 
+     * @param now The current time, which the ages of past deliveries are taken from.
+     * @return CarState The state.
+     */
+    CarState state{}; 
+    state.flags = getStatusFlags(); 
+    state.flags |= Adaptive_MODE ? CAR_STATE_ADAPTIVE_MODE : 0; 
+    state.flags |= Follow_Settings ? CAR_STATE_FOLLOW_SETTINGS : 0; 
+    state.flags |= Status_Check != nullptr ? CAR_STATE_COMPILED_CHECK : 0; 
+    state.profile = -1; 
+    for (int i = 0; i < (int)std::size(Builtin_Profiles); i++) {
+        if (std::strcmp(Limits.name, Builtin_Profiles[i].name) == 0) {
+            state.profile = i; 
+        }
+    }
+    state.maxSpeed = Limits.maxSpeed; 
+    state.maxTemperature = Limits.maxTemperature; 
+    state.lowBattery = Limits.lowBattery; 
+    state.safeRadarDistance = Limits.safeRadarDistance; 
+    state.alerts = Status_Alerts.getState(); 
+    if (Car_Sensor_Fusion_ECU) {
+        state.flags |= CAR_STATE_FUSION; 
+        state.fusion = Car_Sensor_Fusion_ECU->getFilterState(now); 
+    }
+    for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+        state.values[type] = Car_info[type]; 
+        state.sensors[type] = Builtin_Sensors[type]->SaveState(now); 
+        const SensorDiagnostics* d = Car_Diagnostic_ECU->GetSensorSummary(type, Builtin_Sensors[type]->getSensorID()); 
+        if (d != nullptr) {
+            state.diagnosed |= 1u << type; 
+            state.diagnostics[type] = *d; 
+        }
+    }
+    if ((state.sensors[(int)SensorTypes::SPEED_SENSOR].subscribers >> (int)ECUTypes::DIAGNOSTIC_ECU) & 1) {
+        state.flags |= CAR_STATE_DIAGNOSTIC_TOOL; 
+    }
+    return state; 
+}
+
+void Car::CreateSampleHistories() {
+    /**
+     * @brief Creates the sample history of every subscription that has delivered, in every ECU.
+     */
+    for (const auto& e : ECUs) {
+        e->CreateSampleHistories(); 
+    }
+}
+
+void Car::RestoreState(const CarState& state, TimestampNs now) {
+    /**
+     * @brief Takes up a saved state without logging, sampling or notifying.
+     * 
+     * The limits come first, since setting them forgets the status lines.
+     * A car that follows the runtime settings takes the current version
+     * right away, so a restore can run against other thresholds than the
+     * saved run without losing its lines. Subscriptions are made before the
+     * sensors are restored, so their notification filters find their ECUs.
+     * 
+     * @param state The state.
+     * @param now The current time, which the ages of past deliveries are counted back from.
+     */
+    if (state.flags & CAR_STATE_FOLLOW_SETTINGS) {
+        FollowRuntimeConfig(); 
+        FollowSettingsVersion(); 
+    } else if ((state.flags & CAR_STATE_COMPILED_CHECK) && state.profile == 1) {
+        SetProfile<TruckProfile>(); 
+    } else if ((state.flags & CAR_STATE_COMPILED_CHECK) && state.profile == 2) {
+        SetProfile<SportsCarProfile>(); 
+    } else if (state.flags & CAR_STATE_COMPILED_CHECK) {
+        SetProfile<PassengerCarProfile>(); 
+    } else {
+        const char* name = state.profile >= 0 && state.profile < (int)std::size(Builtin_Profiles) ? Builtin_Profiles[state.profile].name : "custom"; 
+        SetProfile(VehicleLimits{name, state.maxSpeed, state.maxTemperature, state.lowBattery, state.safeRadarDistance}); 
+    }
+    Status_Alerts.setState(state.alerts); 
+
+    if (state.flags & CAR_STATE_FUSION) {
+        EnableSensorFusion(state.fusion.config); 
+        Car_Sensor_Fusion_ECU->RestoreFilterState(state.fusion, now); 
+    }
+    if (state.flags & CAR_STATE_DIAGNOSTIC_TOOL) {
+        AttachDiagnosticSensors(); 
+    }
+    Adaptive_MODE = (state.flags & CAR_STATE_ADAPTIVE_MODE) != 0; 
+    Car_Adaptive_Cruise_Control_ECU->SetON((state.flags & CAR_STATUS_ADAPTIVE_ON) != 0); 
+    Car_Diagnostic_ECU->SetON((state.flags & CAR_STATUS_DIAGNOSTIC_ON) != 0); 
+
+    for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+        Car_info[type] = state.values[type]; 
+        Builtin_Sensors[type]->RestoreState(state.sensors[type], now); 
+        if ((state.diagnosed >> type) & 1) {
+            Car_Diagnostic_ECU->RestoreSensorSummary(type, Builtin_Sensors[type]->getSensorID(), state.diagnostics[type]); 
+        }
+    }
+    PublishSnapshot(); 
 }
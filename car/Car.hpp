@@ -5,19 +5,98 @@
 #include "../Sensors/BatteryLevelSensor.hpp"
 #include "../logger/CarLogger.hpp" 
 #include "../ECU/DiagnosticsECU.hpp"
+#include "../ECU/SensorFusionECU.hpp"
 #include "../Sensors/RadarSensor.hpp"
 #include "../Sensors/Sensor.hpp" 
 #include "../ECU/ECU.hpp"
 #include "../Sensors/SpeedSensor.hpp"
 #include "../Sensors/TemperatureSensor.hpp"
+#include "../memory/Arena.hpp"
+#include "AtomicSignal.hpp"
+#include "SeqLock.hpp"
+#include "VehicleProfile.hpp"
+#include "../alerts/StatusAlerts.hpp"
+#include <array>
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
+#include <optional>
 
 #define MAX_SENSOR_NUMBER 4 ///< Maximum number of sensors
-#define MAX_SPEED 50 ///< Maximum speed limit
-#define MAX_TEMPERATURE 30 ///< Maximum temperature limit
-#define LOW_BATTERY 20 ///< Battery level threshold for low battery warning
-#define SAFE_RADAR_DISTANCE 5 ///< Minimum safe distance for radar detection
+#define CAR_STATUS_ADAPTIVE_ON 0x1 ///< Status flag: adaptive cruise control ECU is on
+#define CAR_STATUS_DIAGNOSTIC_ON 0x2 ///< Status flag: diagnostic ECU is on
+#define CAR_STATE_ADAPTIVE_MODE 0x4 ///< Saved state flag: adaptive mode is set on the car
+#define CAR_STATE_DIAGNOSTIC_TOOL 0x8 ///< Saved state flag: the sensors are subscribed to the diagnostic ECU
+#define CAR_STATE_FUSION 0x10 ///< Saved state flag: the sensor fusion ECU is attached
+#define CAR_STATE_FOLLOW_SETTINGS 0x20 ///< Saved state flag: the limits follow the runtime settings
+#define CAR_STATE_COMPILED_CHECK 0x40 ///< Saved state flag: the status check is compiled for the named profile
+
+/**
+ * @brief A consistent copy of the car's signals, all taken from the same tick.
+ */
+struct CarSnapshot {
+    std::array<double, MAX_SENSOR_NUMBER> values; ///< Signal values indexed by SensorTypes
+    std::uint64_t version; ///< Number of ticks published before this one was read
+
+    /**
+     * @brief Gets one signal of the snapshot.
+     * 
+     * @param type The sensor type.
+     * @return double The value.
+     */
+    double get(SensorTypes type) const { return values[(int)type]; }
+};
+
+/**
+ * @brief Everything a car carries from one event to the next, as kept in a checkpoint.
+ * 
+ * @details Plain data of a fixed size. Sensors and the diagnostic
+ * statistics are kept for the built-in sensors; ECU sample histories are
+ * telemetry, not state, and refill from the next samples. Anomaly limits
+ * come from the runtime settings of the process that restores.
+ */
+struct CarState {
+    double values[MAX_SENSOR_NUMBER]; ///< Latest sensor data indexed by SensorTypes
+    std::uint32_t flags; ///< CAR_STATUS_* and CAR_STATE_* bits
+    std::int32_t profile; ///< Index of the limits' name among the built-in profiles, or -1
+    double maxSpeed; ///< VehicleLimits::maxSpeed
+    double maxTemperature; ///< VehicleLimits::maxTemperature
+    double lowBattery; ///< VehicleLimits::lowBattery
+    double safeRadarDistance; ///< VehicleLimits::safeRadarDistance
+    StatusAlertsState alerts; ///< Lines shown by DisplayStatus
+    RangeFilterState fusion; ///< Sensor fusion filter; meaningful with CAR_STATE_FUSION
+    SensorState sensors[MAX_SENSOR_NUMBER]; ///< Built-in sensors indexed by SensorTypes
+    std::uint32_t diagnosed; ///< Bit t set if diagnostics[t] holds the statistics of sensor type t
+    SensorDiagnostics diagnostics[MAX_SENSOR_NUMBER]; ///< Diagnostic ECU statistics of the built-in sensors
+};
+
+/**
+ * @brief Where a car keeps its built-in sensors.
+ */
+enum class SensorStorage {
+    HEAP = 0,  /**< One shared_ptr allocation per sensor, from the heap or the car's arena */
+    INLINE = 1 /**< Inside the Car object; the car hands out non-owning handles */
+};
+
+/**
+ * @brief The built-in sensors of a car, stored by value in a fixed layout.
+ * 
+ * @details Declared in the order the heap layout creates them, so a seeded
+ * run reads the same values with either storage.
+ */
+struct BuiltInSensors {
+    SpeedSensor speed; ///< Speed sensor
+    TemperatureSensor temperature; ///< Temperature sensor
+    BatteryLevelSensor battery; ///< Battery level sensor
+    RadarSensor radar; ///< Radar sensor
+
+    /**
+     * @brief Gets one sensor by type.
+     * 
+     * @param type The sensor type.
+     * @return Sensor& The sensor.
+     */
+    Sensor& get(SensorTypes type);
+};
 
 /**
  * @brief Represents a car with various sensors and ECUs (Electronic Control Units).
@@ -33,8 +112,47 @@ public:
      * 
      * @param model The model of the car.
      * @param make The make of the car.
+     * @param storage Where to keep the built-in sensors.
+     */
+    Car(const std::string& model, const std::string& make, SensorStorage storage = SensorStorage::HEAP);
+
+    /**
+     * @brief Constructs a Car whose sensors and ECUs are placed in an arena.
+     * 
+     * Each sensor and ECU shares one arena allocation with its shared_ptr
+     * control block, so a fleet of cars is built from a few large chunks
+     * instead of many small heap allocations. With SensorStorage::INLINE
+     * only the ECUs come from the arena.
+     * 
+     * @param model The model of the car.
+     * @param make The make of the car.
+     * @param arena The arena to allocate from; must outlive the car and every
+     *              shared_ptr handed out for its sensors and ECUs.
+     * @param storage Where to keep the built-in sensors.
+     */
+    Car(const std::string& model, const std::string& make, MonotonicArena& arena, SensorStorage storage = SensorStorage::HEAP);
+
+    /**
+     * @brief Constructs a Car in a saved state, as a checkpoint restore does.
+     * 
+     * Nothing CarINIT does is replayed: no default signals are published
+     * and nothing is logged. The sensors and ECUs are subscribed once,
+     * straight to the saved set, and then take up their saved state as
+     * RestoreState describes.
+     * 
+     * @param model The model of the car.
+     * @param make The make of the car.
+     * @param state The saved state.
+     * @param now The current time, which the ages of past deliveries are counted back from.
+     * @param arena The arena to allocate from; must outlive the car.
+     * @param storage Where to keep the built-in sensors.
      */
-    Car(const std::string& model, const std::string& make);
+    Car(const std::string& model, const std::string& make, const CarState& state, TimestampNs now, MonotonicArena& arena,
+        SensorStorage storage = SensorStorage::HEAP);
+
+    // Deleted copy constructor and assignment operator
+    Car(const Car&) = delete; 
+    Car& operator=(const Car&) = delete;
     
     /**
      * @brief Destroys the Car object and releases resources.
@@ -58,7 +176,7 @@ public:
     /**
      * @brief Starts the diagnostic tool for the car.
      */
-    void StartDiagonisticTool() const;
+    void StartDiagonisticTool();
 
     /**
      * @brief Initializes the car systems.
@@ -72,6 +190,16 @@ public:
      */
     void setAdaptiveMode(bool mode);
 
+    /**
+     * @brief Turns the diagnostic anomaly checks on or off.
+     * 
+     * StartDiagonisticTool turns them on; the diagnostic ECU keeps
+     * relaying samples to the other ECUs either way.
+     * 
+     * @param mode true to check every sample for anomalies.
+     */
+    void setDiagnosticMode(bool mode);
+
     /**
      * @brief Retrieves the current state of the adaptive cruise control mode.
      * 
@@ -85,23 +213,268 @@ public:
     void UpdateSensorsData();
 
     /**
-     * @brief Displays the current status of the car, including sensor data.
+     * @brief Logs the status lines that changed since the last call, and a periodic summary.
+     * 
+     * The first call logs every line. After that a line is only logged
+     * when its state changes; see StatusAlerts for the hysteresis and
+     * debounce rules.
      */
     void DisplayStatus();
 
+    /**
+     * @brief Retrieves the latest value of one of the built-in sensors.
+     * 
+     * @param type The sensor type.
+     * @return double The value from the last UpdateSensorsData().
+     */
+    double getSensorValue(SensorTypes type) const;
+
+    /**
+     * @brief Reads one built-in sensor and publishes the value to the car state.
+     * 
+     * Safe to call from a producer thread while other threads read the car
+     * state or run ECUs, as long as each sensor has a single producer.
+     * 
+     * @param type The sensor type to sample.
+     */
+    void SampleSensor(SensorTypes type);
+
+    /**
+     * @brief Publishes a snapshot, then runs one ECU cycle on the values the sensors currently hold.
+     * 
+     * Sensors notify their subscribed ECUs without being re-sampled, so this
+     * can run on a consumer thread while producers keep sampling. The
+     * diagnostic tool must have been started once beforehand.
+     */
+    void ConsumeSensorData();
+
+    /**
+     * @brief Publishes the current signals as one tick of the car snapshot.
+     * 
+     * Only one thread may publish for a given car at a time: the thread
+     * running UpdateSensorsData, or the consumer running ConsumeSensorData.
+     */
+    void PublishSnapshot();
+
+    /**
+     * @brief Gets the last published snapshot without taking a lock.
+     * 
+     * Any number of threads may read while the car publishes; a reader
+     * that overlaps a publish retries.
+     * 
+     * @return CarSnapshot The signals of one tick.
+     */
+    CarSnapshot getSnapshot() const;
+
+    /**
+     * @brief Makes one attempt to read the last published snapshot.
+     * 
+     * @param out Receives the snapshot if the attempt succeeds.
+     * @return true if the snapshot is consistent, false if a publish overlapped it.
+     */
+    bool TryGetSnapshot(CarSnapshot& out) const;
+
+    /**
+     * @brief Gives the car the status limits of a vehicle class.
+     * 
+     * The status check is instantiated for the profile, so its limits are
+     * compiled in as immediates; cars of different classes still share the
+     * Car type and can be mixed in one fleet.
+     * 
+     * @tparam P The profile.
+     */
+    template<VehicleProfile P>
+    void SetProfile() {
+        Follow_Settings = false; 
+        Limits = VehicleLimits::Of<P>(); 
+        Status_Check = &EvaluateVehicleStatus<P>; 
+        Status_Alerts.Reset(); 
+    }
+
+    /**
+     * @brief Gives the car status limits only known at run time.
+     * 
+     * The status check then reads the limits from the car.
+     * 
+     * @param limits The limits.
+     */
+    void SetProfile(const VehicleLimits& limits);
+
+    /**
+     * @brief Makes the car take its status limits from the runtime settings.
+     * 
+     * DisplayStatus compares the settings version on every call and
+     * switches the status check to it when a new version was installed, so
+     * thresholds change without a rebuild. SetProfile stops following.
+     */
+    void FollowRuntimeConfig();
+
+    /**
+     * @brief Gets the status limits of the car.
+     * 
+     * @return const VehicleLimits& The limits.
+     */
+    const VehicleLimits& getLimits() const;
+
+    /**
+     * @brief Checks one snapshot against the car's status limits.
+     * 
+     * Runs the check compiled for the car's profile when it has one.
+     * 
+     * @param snapshot The signals to check.
+     * @param raised VEHICLE_ALERT_* bits raised before, held until their signal clears the hysteresis band; 0 for none.
+     * @return std::uint32_t VEHICLE_ALERT_* bits.
+     */
+    std::uint32_t EvaluateStatus(const CarSnapshot& snapshot, std::uint32_t raised = 0) const;
+
+    /**
+     * @brief Adds the sensor fusion ECU and subscribes it to the speed and radar sensors.
+     * 
+     * From then on DisplayStatus checks the fused range instead of the raw
+     * radar sample, so a single noisy reading no longer raises a collision
+     * alert. Calling it again keeps the existing ECU.
+     * 
+     * @param config Noise settings of the filter.
+     */
+    void EnableSensorFusion(const RangeFilterConfig& config = RangeFilterConfig::Defaults());
+
+    /**
+     * @brief Gets the sensor fusion ECU.
+     * 
+     * @return const SensorFusionECU* The ECU, or nullptr before EnableSensorFusion.
+     */
+    const SensorFusionECU* getSensorFusion() const;
+
+    /**
+     * @brief Gets the car's sensors.
+     * 
+     * With SensorStorage::INLINE the built-in entries are non-owning: they
+     * share no control block, copying them touches no reference count, and
+     * they are only valid while the car lives.
+     * 
+     * @return const std::vector<std::shared_ptr<Sensor>>& The sensors, built-in ones first, indexed by SensorTypes.
+     */
+    const std::vector<std::shared_ptr<Sensor>>& getSensors() const;
+
+    /**
+     * @brief Gets where the car keeps its built-in sensors.
+     * 
+     * @return SensorStorage The storage chosen at construction.
+     */
+    SensorStorage getSensorStorage() const;
+
+    /**
+     * @brief Gets the car's ECUs.
+     * 
+     * @return const std::vector<std::shared_ptr<ECU>>& The ECUs.
+     */
+    const std::vector<std::shared_ptr<ECU>>& getECUs() const;
+
+    /**
+     * @brief Gets the state behind DisplayStatus.
+     * 
+     * @return const StatusAlerts& The raised alerts and the emitted and suppressed line counts.
+     */
+    const StatusAlerts& getStatusAlerts() const;
+
+    /**
+     * @brief Gets the on/off state of the built-in ECUs.
+     * 
+     * @return std::uint32_t CAR_STATUS_* bits.
+     */
+    std::uint32_t getStatusFlags() const;
+
+    /**
+     * @brief Gets the model of the car.
+     * 
+     * @return const std::string& The model.
+     */
+    const std::string& getModel() const;
+
+    /**
+     * @brief Gets the make of the car.
+     * 
+     * @return const std::string& The make.
+     */
+    const std::string& getMake() const;
+
+    /**
+     * @brief Gets everything the car carries from one event to the next.
+     * 
+     * Must not overlap with sampling or an ECU cycle of this car.
+     * 
+     * @param now The current time, which the ages of past deliveries are taken from.
+     * @return CarState The state.
+     */
+    CarState SaveState(TimestampNs now) const;
+
+    /**
+     * @brief Takes up a saved state without logging, sampling or notifying.
+     * 
+     * Meant for a car just built: attaches the ECUs the saved car had,
+     * including the diagnostic subscriptions that StartDiagonisticTool
+     * makes, but without its first sample. The sensors and ECUs keep their
+     * own IDs.
+     * 
+     * @param state The state.
+     * @param now The current time, which the ages of past deliveries are counted back from.
+     */
+    void RestoreState(const CarState& state, TimestampNs now);
+
+    /**
+     * @brief Creates the sample history of every subscription that has delivered, in every ECU.
+     * 
+     * A restored car creates them as samples arrive; this does it at once,
+     * for runs where no later tick may allocate.
+     */
+    void CreateSampleHistories();
+
 private: 
+    /**
+     * @brief Subscribes the diagnostic ECU to every sensor of the car.
+     */
+    void AttachDiagnosticSensors();
+
+    /**
+     * @brief Takes the limits of the runtime settings if a new version was installed.
+     */
+    void FollowSettingsVersion();
+
+    /**
+     * @brief Builds the built-in sensors inside the car and fills Sensors with non-owning handles to them.
+     */
+    void PlaceInlineSensors();
+
+    /**
+     * @brief Builds the built-in sensors, inline or in an arena.
+     * 
+     * @param arena The arena for sensors kept on the heap.
+     * @param storage Where to keep them.
+     */
+    void PlaceSensors(MonotonicArena& arena, SensorStorage storage);
+
+    /**
+     * @brief Fills the built-in sensor and ECU tables and subscribes adaptive cruise control.
+     */
+    void AttachBuiltinECUs();
+
     std::string model; ///< The model of the car
     std::string make; ///< The make of the car
     std::vector<std::shared_ptr<ECU>> ECUs; ///< List of ECUs in the car
-    std::vector<std::shared_ptr<Sensor>> Sensors; ///< List of sensors in the car
-    std::unordered_map<SensorTypes, double> Car_info; ///< Map to store sensor data
-    std::shared_ptr<SpeedSensor> Car_Speed_Sensor; ///< Speed sensor of the car
-    std::shared_ptr<TemperatureSensor> Car_Temperature_Sensor; ///< Temperature sensor of the car
-    std::shared_ptr<BatteryLevelSensor> Car_Battery_Level_Sensor; ///< Battery level sensor of the car
-    std::shared_ptr<RadarSensor> Car_Radar_Sensor; ///< Radar sensor of the car
+    std::optional<BuiltInSensors> Inline_Sensors; ///< The built-in sensors with SensorStorage::INLINE, otherwise empty
+    std::vector<std::shared_ptr<Sensor>> Sensors; ///< List of sensors in the car, indexed by SensorTypes for the built-in ones
+    std::array<Sensor*, MAX_SENSOR_NUMBER> Builtin_Sensors; ///< The built-in sensors indexed by SensorTypes, read without going through Sensors
+    std::array<AtomicSignal, MAX_SENSOR_NUMBER> Car_info; ///< Latest sensor data indexed by SensorTypes
+    SeqLock<MAX_SENSOR_NUMBER> Status_Snapshot; ///< Car_info as of the last published tick
     std::shared_ptr<Adaptive_Cruise_Control_ECU> Car_Adaptive_Cruise_Control_ECU; ///< Adaptive cruise control ECU
     std::shared_ptr<DiagnosticECU> Car_Diagnostic_ECU; ///< Diagnostic ECU
+    std::shared_ptr<SensorFusionECU> Car_Sensor_Fusion_ECU; ///< Radar and speed fusion, or null until EnableSensorFusion
     bool Adaptive_MODE; ///< Indicates whether adaptive mode is active
+    VehicleLimits Limits; ///< Status limits of the car's vehicle class
+    VehicleStatusCheck Status_Check; ///< Check compiled for the profile, or nullptr to read Limits
+    StatusAlerts Status_Alerts; ///< Lines shown by DisplayStatus, fed by EvaluateStatus
+    bool Follow_Settings; ///< Whether Limits tracks the runtime settings
+    std::uint64_t Settings_Version; ///< Version of the runtime settings Limits was taken from, 0 for none
 };
 
 #endif // CAR_H
@@ -0,0 +1,147 @@
+#include "CarPool.hpp"
+#include "../logger/CarLogger.hpp"
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+/**
+ * @brief Constructs an empty pool and reserves contiguous storage for the cars.
+ * 
+ * @param capacity Maximum number of cars the pool can hold.
+ * @param quietConstruction If true, logging is suppressed while cars are built or destroyed.
+ * @param storage Where the cars keep their built-in sensors.
+ */
+CarPool::CarPool(std::size_t capacity, bool quietConstruction, SensorStorage storage)
+    : slots(new Slot[capacity]), slotCount(capacity), used(0), quiet(quietConstruction), sensorStorage(storage) {
+}
+
+/**
+ * @brief Destroys every car and releases the arena.
+ */
+CarPool::~CarPool() {
+    clear(); 
+}
+
+/**
+ * @brief Builds one car in the next free slot.
+ * 
+ * @param model The model of the car.
+ * @param make The make of the car.
+ * @return Car& Reference to the new car.
+ */
+Car& CarPool::emplace(const std::string& model, const std::string& make) {
+    if (used == slotCount) {
+        throw std::length_error("CarPool is full"); 
+    }
+    LogSilencer silencer(quiet); 
+    Car* car = new (&slots[used]) Car(model, make, arena, sensorStorage); 
+    used++; 
+    return *car; 
+}
+
+/**
+ * @brief Builds several identical cars.
+ * 
+ * @param count Number of cars to build.
+ * @param model The model of the cars.
+ * @param make The make of the cars.
+ */
+void CarPool::emplaceMany(std::size_t count, const std::string& model, const std::string& make) {
+    if (count > slotCount - used) {
+        throw std::length_error("CarPool is full"); 
+    }
+    LogSilencer silencer(quiet); 
+    for (std::size_t i = 0; i < count; i++) {
+        new (&slots[used]) Car(model, make, arena, sensorStorage); 
+        used++; 
+    }
+}
+
+/**
+ * @brief Builds one car in a saved state in the next free slot.
+ * 
+ * @param model The model of the car.
+ * @param make The make of the car.
+ * @param state The saved state.
+ * @param now The current time.
+ * @return Car& Reference to the new car.
+ */
+Car& CarPool::emplaceRestored(const std::string& model, const std::string& make, const CarState& state, TimestampNs now) {
+    if (used == slotCount) {
+        throw std::length_error("CarPool is full"); 
+    }
+    LogSilencer silencer(quiet); 
+    Car* car = new (&slots[used]) Car(model, make, state, now, arena, sensorStorage); 
+    used++; 
+    return *car; 
+}
+
+/**
+ * @brief Destroys every car in reverse order and returns the arena memory.
+ */
+void CarPool::clear() {
+    LogSilencer silencer(quiet); 
+    while (used > 0) {
+        used--; 
+        reinterpret_cast<Car*>(&slots[used])->~Car(); 
+    }
+    arena.release(); 
+}
+
+/**
+ * @brief Copies the latest sensor values of every car into a fleet store.
+ * 
+ * Values are gathered into a small stack buffer and encoded in batches.
+ * 
+ * @param store Destination; must have at least size() slots.
+ */
+void CarPool::CaptureSamples(FleetSampleStore& store) {
+    const std::size_t Batch = 256; 
+    double buffer[Batch]; 
+    for (int type = 0; type < Sensor_Types_Count; type++) {
+        for (std::size_t first = 0; first < used; first += Batch) {
+            const std::size_t n = std::min(Batch, used - first); 
+            for (std::size_t i = 0; i < n; i++) {
+                buffer[i] = (*this)[first + i].getSensorValue(SensorTypes(type)); 
+            }
+            store.storeColumn(type, first, buffer, n); 
+        }
+    }
+}
+
+/**
+ * @brief Gets a car by its slot.
+ * 
+ * @param i Slot index, below size().
+ * @return Car& Reference to the car.
+ */
+Car& CarPool::operator[](std::size_t i) {
+    return *reinterpret_cast<Car*>(&slots[i]); 
+}
+
+/**
+ * @brief Gets the number of cars in the pool.
+ * 
+ * @return std::size_t The car count.
+ */
+std::size_t CarPool::size() const {
+    return used; 
+}
+
+/**
+ * @brief Gets the maximum number of cars the pool can hold.
+ * 
+ * @return std::size_t The capacity.
+ */
+std::size_t CarPool::capacity() const {
+    return slotCount; 
+}
+
+/**
+ * @brief Gets the bytes taken from the arena by sensors and ECUs.
+ * 
+ * @return std::size_t Arena bytes in use.
+ */
+std::size_t CarPool::arenaBytes() const {
+    return arena.bytesUsed(); 
+}
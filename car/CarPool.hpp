@@ -0,0 +1,127 @@
+#ifndef CAR_POOL_H
+#define CAR_POOL_H
+
+#include "Car.hpp"
+#include "../memory/Arena.hpp"
+#include "../telemetry/FleetSampleStore.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+/**
+ * @brief Contiguous pool for building and tearing down fleets of cars.
+ * 
+ * @details The Car objects themselves live in one contiguous block sized at
+ * construction, and their sensors and ECUs are allocated from a shared
+ * MonotonicArena. Destruction happens in bulk and returns the arena chunks
+ * at once. The building thread's logging can be suppressed while cars are
+ * built and destroyed, which is where most of the per-car startup time
+ * goes; other threads keep logging.
+ */
+class CarPool {
+public:
+    /**
+     * @brief Constructs an empty pool.
+     * 
+     * @param capacity Maximum number of cars the pool can hold.
+     * @param quietConstruction If true, the calling thread logs nothing while cars are built or destroyed.
+     * @param storage Where the cars keep their built-in sensors; with
+     *                SensorStorage::INLINE they sit in the contiguous car block.
+     */
+    explicit CarPool(std::size_t capacity, bool quietConstruction = true, SensorStorage storage = SensorStorage::HEAP);
+
+    /**
+     * @brief Destroys every car and releases the arena.
+     */
+    ~CarPool();
+
+    // Deleted copy constructor and assignment operator
+    CarPool(const CarPool&) = delete; 
+    CarPool& operator=(const CarPool&) = delete;
+
+    /**
+     * @brief Builds one car in the next free slot.
+     * 
+     * @param model The model of the car.
+     * @param make The make of the car.
+     * @return Car& Reference to the new car; stays valid until clear().
+     */
+    Car& emplace(const std::string& model, const std::string& make);
+
+    /**
+     * @brief Builds several identical cars.
+     * 
+     * @param count Number of cars to build.
+     * @param model The model of the cars.
+     * @param make The make of the cars.
+     */
+    void emplaceMany(std::size_t count, const std::string& model, const std::string& make);
+
+    /**
+     * @brief Builds one car in a saved state in the next free slot.
+     * 
+     * @param model The model of the car.
+     * @param make The make of the car.
+     * @param state The saved state.
+     * @param now The current time, which the ages of past deliveries are counted back from.
+     * @return Car& Reference to the new car; stays valid until clear().
+     */
+    Car& emplaceRestored(const std::string& model, const std::string& make, const CarState& state, TimestampNs now);
+
+    /**
+     * @brief Destroys every car and returns the arena memory.
+     */
+    void clear();
+
+    /**
+     * @brief Copies the latest sensor values of every car into a fleet store.
+     * 
+     * Car slot i of the pool is written to slot i of the store, one column
+     * at a time through the batch encoder.
+     * 
+     * @param store Destination; must have at least size() slots.
+     */
+    void CaptureSamples(FleetSampleStore& store);
+
+    /**
+     * @brief Gets a car by its slot.
+     * 
+     * @param i Slot index, below size().
+     * @return Car& Reference to the car.
+     */
+    Car& operator[](std::size_t i);
+
+    /**
+     * @brief Gets the number of cars in the pool.
+     * 
+     * @return std::size_t The car count.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Gets the maximum number of cars the pool can hold.
+     * 
+     * @return std::size_t The capacity.
+     */
+    std::size_t capacity() const;
+
+    /**
+     * @brief Gets the bytes taken from the arena by sensors and ECUs; inline sensors take none.
+     * 
+     * @return std::size_t Arena bytes in use.
+     */
+    std::size_t arenaBytes() const;
+
+private:
+    typedef std::aligned_storage<sizeof(Car), alignof(Car)>::type Slot; 
+
+    MonotonicArena arena; ///< Sensors, ECUs and their control blocks
+    std::unique_ptr<Slot[]> slots; ///< Contiguous storage for the Car objects
+    std::size_t slotCount; ///< Capacity in cars
+    std::size_t used; ///< Number of constructed cars
+    bool quiet; ///< Silence the calling thread while building and destroying
+    SensorStorage sensorStorage; ///< Where the cars keep their built-in sensors
+};
+
+#endif // !CAR_POOL_H
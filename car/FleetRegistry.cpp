@@ -0,0 +1,303 @@
+#include "FleetRegistry.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#define FLEET_SHARD_BITS 6 ///< log2(FLEET_REGISTRY_SHARDS)
+
+static_assert(FLEET_REGISTRY_SHARDS == 1 << FLEET_SHARD_BITS, "FLEET_SHARD_BITS must match FLEET_REGISTRY_SHARDS");
+
+/**
+ * @brief Makes the key of a VIN.
+ *
+ * @param vin 17 characters, digits or letters; lower case is folded to upper case.
+ * @return FleetKey The key.
+ */
+FleetKey FleetKey::Vin(std::string_view vin) {
+    if (vin.size() != FLEET_VIN_LENGTH) {
+        throw std::invalid_argument("a VIN has " + std::to_string(FLEET_VIN_LENGTH) + " characters: '" + std::string(vin) + "'");
+    }
+    FleetKey key{0, 0};
+    for (std::size_t i = 0; i < vin.size(); i++) {
+        const char c = vin[i];
+        std::uint64_t code;
+        if (c >= '0' && c <= '9') {
+            code = 1 + (c - '0');
+        } else if (c >= 'A' && c <= 'Z') {
+            code = 11 + (c - 'A');
+        } else if (c >= 'a' && c <= 'z') {
+            code = 11 + (c - 'a');
+        } else {
+            throw std::invalid_argument("bad character in VIN '" + std::string(vin) + "'");
+        }
+        // Codes start at 1, so the first seven characters always leave high non-zero
+        std::uint64_t& word = i < 7 ? key.high : key.low;
+        word = (word << 6) | code;
+    }
+    return key;
+}
+
+/**
+ * @brief Hashes a key; the top bits pick the shard, the low bits the slot.
+ *
+ * @param key The key.
+ * @return std::uint64_t The hash.
+ */
+static inline std::uint64_t HashKey(const FleetKey& key) {
+    std::uint64_t x = key.low ^ (key.high * 0x9E3779B97F4A7C15ull);
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief Allocates an empty table.
+ *
+ * @param slots Number of slots, a power of two.
+ * @return std::unique_ptr<Table> The table.
+ */
+std::unique_ptr<FleetRegistry::Table> FleetRegistry::MakeTable(std::size_t slots) {
+    std::unique_ptr<Table> table(new Table{slots - 1, std::unique_ptr<Slot[]>(new Slot[slots])});
+    for (std::size_t i = 0; i < slots; i++) {
+        table->slots[i].high.store(0, std::memory_order_relaxed);
+        table->slots[i].low.store(0, std::memory_order_relaxed);
+        table->slots[i].car.store(0, std::memory_order_relaxed);
+    }
+    return table;
+}
+
+/**
+ * @brief Constructs an empty registry.
+ *
+ * @param expectedCars Cars to size the tables for up front.
+ */
+FleetRegistry::FleetRegistry(std::size_t expectedCars) : shards(new Shard[FLEET_REGISTRY_SHARDS]) {
+    // Room for the expected share of every shard at two thirds load, plus slack for uneven spread
+    const std::size_t perShard = expectedCars / FLEET_REGISTRY_SHARDS * 3 / 2 + expectedCars / FLEET_REGISTRY_SHARDS / 8;
+    const std::size_t slots = std::bit_ceil(std::max<std::size_t>(FLEET_REGISTRY_MIN_SLOTS, perShard));
+    for (std::size_t i = 0; i < FLEET_REGISTRY_SHARDS; i++) {
+        Shard& s = shards[i];
+        s.sequence.store(0, std::memory_order_relaxed);
+        s.count = 0;
+        s.published.store(0, std::memory_order_relaxed);
+        s.tables.push_back(MakeTable(slots));
+        s.table.store(s.tables.back().get(), std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Destroys every table; the cars are untouched.
+ */
+FleetRegistry::~FleetRegistry() = default;
+
+/**
+ * @brief Doubles a shard's table; the caller holds the shard lock.
+ *
+ * The new table is filled before it is published, and the old one is left
+ * as it was, so readers probing either see a complete table.
+ *
+ * @param shard The shard.
+ */
+void FleetRegistry::Grow(Shard& shard) {
+    const Table* old = shard.table.load(std::memory_order_relaxed);
+    std::unique_ptr<Table> bigger = MakeTable(2 * (old->mask + 1));
+    for (std::size_t i = 0; i <= old->mask; i++) {
+        const Slot& from = old->slots[i];
+        const std::uintptr_t car = from.car.load(std::memory_order_relaxed);
+        if (car == 0) {
+            continue;
+        }
+        const FleetKey key{from.high.load(std::memory_order_relaxed), from.low.load(std::memory_order_relaxed)};
+        std::size_t j = HashKey(key) & bigger->mask;
+        while (bigger->slots[j].car.load(std::memory_order_relaxed) != 0) {
+            j = (j + 1) & bigger->mask;
+        }
+        bigger->slots[j].high.store(key.high, std::memory_order_relaxed);
+        bigger->slots[j].low.store(key.low, std::memory_order_relaxed);
+        bigger->slots[j].car.store(car, std::memory_order_relaxed);
+    }
+    shard.table.store(bigger.get(), std::memory_order_release);
+    shard.tables.push_back(std::move(bigger));
+}
+
+/**
+ * @brief Registers a car.
+ *
+ * @param key The car's key.
+ * @param car The car; not null.
+ * @return true if registered, false if the key was already taken.
+ */
+bool FleetRegistry::Insert(const FleetKey& key, Car* car) {
+    if (car == nullptr) {
+        throw std::invalid_argument("cannot register a null car");
+    }
+    const std::uint64_t hash = HashKey(key);
+    Shard& s = shards[hash >> (64 - FLEET_SHARD_BITS)];
+    std::lock_guard<std::mutex> guard(s.lock);
+    Table* t = s.table.load(std::memory_order_relaxed);
+    if ((s.count + 1) * 3 > (t->mask + 1) * 2) {
+        Grow(s);
+        t = s.table.load(std::memory_order_relaxed);
+    }
+
+    std::size_t i = hash & t->mask;
+    for (;; i = (i + 1) & t->mask) {
+        const Slot& slot = t->slots[i];
+        if (slot.car.load(std::memory_order_relaxed) == 0) {
+            break;
+        }
+        if (slot.low.load(std::memory_order_relaxed) == key.low && slot.high.load(std::memory_order_relaxed) == key.high) {
+            return false;
+        }
+    }
+
+    const std::uint64_t seq = s.sequence.load(std::memory_order_relaxed);
+    s.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    t->slots[i].high.store(key.high, std::memory_order_relaxed);
+    t->slots[i].low.store(key.low, std::memory_order_relaxed);
+    t->slots[i].car.store((std::uintptr_t)car, std::memory_order_relaxed);
+    s.sequence.store(seq + 2, std::memory_order_release);
+
+    s.count++;
+    s.published.store(s.count, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Unregisters a car.
+ *
+ * The entries after it in the probe run are shifted back into the gap, so
+ * no tombstone is left behind and later lookups stay as short as before.
+ *
+ * @param key The car's key.
+ * @return true if the key was registered.
+ */
+bool FleetRegistry::Remove(const FleetKey& key) {
+    const std::uint64_t hash = HashKey(key);
+    Shard& s = shards[hash >> (64 - FLEET_SHARD_BITS)];
+    std::lock_guard<std::mutex> guard(s.lock);
+    Table* t = s.table.load(std::memory_order_relaxed);
+
+    std::size_t gap = hash & t->mask;
+    for (;; gap = (gap + 1) & t->mask) {
+        const Slot& slot = t->slots[gap];
+        if (slot.car.load(std::memory_order_relaxed) == 0) {
+            return false;
+        }
+        if (slot.low.load(std::memory_order_relaxed) == key.low && slot.high.load(std::memory_order_relaxed) == key.high) {
+            break;
+        }
+    }
+
+    const std::uint64_t seq = s.sequence.load(std::memory_order_relaxed);
+    s.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t j = (gap + 1) & t->mask;; j = (j + 1) & t->mask) {
+        Slot& next = t->slots[j];
+        const std::uintptr_t car = next.car.load(std::memory_order_relaxed);
+        if (car == 0) {
+            break;
+        }
+        const FleetKey moved{next.high.load(std::memory_order_relaxed), next.low.load(std::memory_order_relaxed)};
+        // The entry may fill the gap only if its home slot is not between the gap and itself
+        const std::size_t home = HashKey(moved) & t->mask;
+        if (((j - home) & t->mask) >= ((j - gap) & t->mask)) {
+            t->slots[gap].high.store(moved.high, std::memory_order_relaxed);
+            t->slots[gap].low.store(moved.low, std::memory_order_relaxed);
+            t->slots[gap].car.store(car, std::memory_order_relaxed);
+            gap = j;
+        }
+    }
+    t->slots[gap].car.store(0, std::memory_order_relaxed);
+    s.sequence.store(seq + 2, std::memory_order_release);
+
+    s.count--;
+    s.published.store(s.count, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Looks a car up without taking a lock.
+ *
+ * @param key The car's key.
+ * @return Car* The car, or nullptr if the key is not registered.
+ */
+Car* FleetRegistry::Find(const FleetKey& key) const {
+    const std::uint64_t hash = HashKey(key);
+    const Shard& s = shards[hash >> (64 - FLEET_SHARD_BITS)];
+    for (;;) {
+        const std::uint64_t before = s.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield(); // A writer is inside this shard; let it finish
+            continue;
+        }
+        const Table* t = s.table.load(std::memory_order_acquire);
+        std::uintptr_t found = 0;
+        // Bounded so that a probe racing a writer cannot spin forever; the sequence check catches it
+        std::size_t i = hash & t->mask;
+        for (std::size_t n = 0; n <= t->mask; n++, i = (i + 1) & t->mask) {
+            const Slot& slot = t->slots[i];
+            const std::uintptr_t car = slot.car.load(std::memory_order_relaxed);
+            if (car == 0) {
+                break;
+            }
+            if (slot.low.load(std::memory_order_relaxed) == key.low && slot.high.load(std::memory_order_relaxed) == key.high) {
+                found = car;
+                break;
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.sequence.load(std::memory_order_relaxed) == before) {
+            return (Car*)found;
+        }
+    }
+}
+
+/**
+ * @brief Gets the number of registered cars.
+ *
+ * @return std::size_t The count; approximate while writers are active.
+ */
+std::size_t FleetRegistry::size() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < FLEET_REGISTRY_SHARDS; i++) {
+        total += shards[i].published.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Gets the number of partitions iteration is split into.
+ *
+ * @return std::size_t FLEET_REGISTRY_SHARDS.
+ */
+std::size_t FleetRegistry::getPartitionCount() const {
+    return FLEET_REGISTRY_SHARDS;
+}
+
+/**
+ * @brief Copies the entries of one partition.
+ *
+ * @param partition Partition index, below getPartitionCount().
+ * @param out Receives the entries; cleared first.
+ */
+void FleetRegistry::CollectPartition(std::size_t partition, std::vector<FleetEntry>& out) const {
+    out.clear();
+    const Shard& s = shards[partition];
+    std::lock_guard<std::mutex> guard(s.lock);
+    const Table* t = s.table.load(std::memory_order_relaxed);
+    out.reserve(s.count);
+    for (std::size_t i = 0; i <= t->mask; i++) {
+        const Slot& slot = t->slots[i];
+        const std::uintptr_t car = slot.car.load(std::memory_order_relaxed);
+        if (car != 0) {
+            out.push_back(FleetEntry{{slot.high.load(std::memory_order_relaxed), slot.low.load(std::memory_order_relaxed)}, (Car*)car});
+        }
+    }
+}
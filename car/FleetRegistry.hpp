@@ -0,0 +1,245 @@
+#ifndef FLEET_REGISTRY_H
+#define FLEET_REGISTRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+class Car;
+
+#define FLEET_REGISTRY_SHARDS 64 ///< Independent tables; also the number of iteration partitions
+#define FLEET_REGISTRY_MIN_SLOTS 16 ///< Slots of an empty shard table
+#define FLEET_VIN_LENGTH 17 ///< Characters in a vehicle identification number
+
+/**
+ * @brief Key of a car in the fleet registry: a numeric car ID or a VIN.
+ *
+ * @details A VIN is packed six bits per character into both words, so it
+ * fits exactly and high is never 0; a numeric ID has high == 0. Both kinds
+ * can live in one registry without colliding.
+ */
+struct FleetKey {
+    std::uint64_t high; ///< 0 for a car ID; upper VIN characters otherwise
+    std::uint64_t low; ///< The car ID, or the lower VIN characters
+
+    /**
+     * @brief Makes the key of a numeric car ID.
+     *
+     * @param id The car ID.
+     * @return FleetKey The key.
+     */
+    static FleetKey Id(std::uint64_t id) { return FleetKey{0, id}; }
+
+    /**
+     * @brief Makes the key of a VIN.
+     *
+     * @param vin 17 characters, digits or letters; lower case is folded to upper case.
+     * @return FleetKey The key.
+     * @throws std::invalid_argument If the VIN has the wrong length or characters.
+     */
+    static FleetKey Vin(std::string_view vin);
+
+    bool operator==(const FleetKey& other) const { return high == other.high && low == other.low; }
+};
+
+/**
+ * @brief A registered car, as handed out by partition iteration.
+ */
+struct FleetEntry {
+    FleetKey key; ///< Key of the car
+    Car* car; ///< The car
+};
+
+/**
+ * @brief Concurrent map from car ID or VIN to the car, for ingest, alerting and query threads.
+ *
+ * @details Keys are spread over FLEET_REGISTRY_SHARDS open-addressing
+ * tables with linear probing. Writers lock only their shard. Readers take
+ * no lock: each shard is guarded by a sequence counter like SeqLock, so a
+ * lookup probes without writing shared memory and retries only if a writer
+ * changed the same shard meanwhile. Removal shifts the following entries
+ * back instead of leaving tombstones, so probe lengths stay short under
+ * churn. A shard that grows builds the bigger table aside and publishes it
+ * with one pointer store; the old table is kept until the registry is
+ * destroyed so that a reader still probing it stays safe. Their total is
+ * less than the live table, since each table doubles.
+ *
+ * The registry does not own the cars. A car must stay alive while it is
+ * registered and while a reader may still hold the pointer it got from
+ * Find, which is naturally the case for cars in a CarPool.
+ */
+class FleetRegistry {
+public:
+    /**
+     * @brief Constructs an empty registry.
+     *
+     * @param expectedCars Cars to size the tables for up front, to avoid growing them during ingest.
+     */
+    explicit FleetRegistry(std::size_t expectedCars = 0);
+
+    /**
+     * @brief Destroys every table; the cars are untouched.
+     */
+    ~FleetRegistry();
+
+    // Deleted copy constructor and assignment operator
+    FleetRegistry(const FleetRegistry&) = delete;
+    FleetRegistry& operator=(const FleetRegistry&) = delete;
+
+    /**
+     * @brief Registers a car.
+     *
+     * @param key The car's key.
+     * @param car The car; not null.
+     * @return true if registered, false if the key was already taken.
+     */
+    bool Insert(const FleetKey& key, Car* car);
+
+    /**
+     * @brief Unregisters a car.
+     *
+     * @param key The car's key.
+     * @return true if the key was registered.
+     */
+    bool Remove(const FleetKey& key);
+
+    /**
+     * @brief Looks a car up without taking a lock.
+     *
+     * @param key The car's key.
+     * @return Car* The car, or nullptr if the key is not registered.
+     */
+    Car* Find(const FleetKey& key) const;
+
+    /**
+     * @brief Gets the number of registered cars.
+     *
+     * @return std::size_t The count; approximate while writers are active.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Gets the number of partitions iteration is split into.
+     *
+     * @return std::size_t FLEET_REGISTRY_SHARDS.
+     */
+    std::size_t getPartitionCount() const;
+
+    /**
+     * @brief Copies the entries of one partition.
+     *
+     * The shard is locked only for the copy, so writers to it wait for a
+     * memcpy-sized pause at most, and the caller works on the copy freely.
+     *
+     * @param partition Partition index, below getPartitionCount().
+     * @param out Receives the entries; cleared first.
+     */
+    void CollectPartition(std::size_t partition, std::vector<FleetEntry>& out) const;
+
+    /**
+     * @brief Calls a function for every car of one partition.
+     *
+     * @param partition Partition index, below getPartitionCount().
+     * @param entries Scratch buffer, reused across calls to avoid allocating.
+     * @param fn Called with each FleetEntry.
+     */
+    template <typename F>
+    void ForEachInPartition(std::size_t partition, std::vector<FleetEntry>& entries, F&& fn) const {
+        CollectPartition(partition, entries);
+        for (const FleetEntry& e : entries) {
+            fn(e);
+        }
+    }
+
+private:
+    /**
+     * @brief One slot; empty while car is 0.
+     *
+     * Fields are relaxed atomics so that lock-free readers racing a writer
+     * are not data races; the shard sequence tells them to retry.
+     */
+    struct Slot {
+        std::atomic<std::uint64_t> high; ///< FleetKey::high
+        std::atomic<std::uint64_t> low; ///< FleetKey::low
+        std::atomic<std::uintptr_t> car; ///< The car, or 0 if empty
+    };
+
+    /**
+     * @brief An open-addressing table of a power-of-two number of slots.
+     */
+    struct Table {
+        std::size_t mask; ///< Slots - 1
+        std::unique_ptr<Slot[]> slots; ///< The slots
+    };
+
+    /**
+     * @brief One shard, on its own cache lines.
+     */
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> sequence; ///< Odd while a writer changes the table
+        std::atomic<Table*> table; ///< The live table
+        std::size_t count; ///< Entries in the table; written under lock
+        std::atomic<std::size_t> published; ///< count, readable without the lock
+        mutable std::mutex lock; ///< Serializes writers and partition copies
+        std::vector<std::unique_ptr<Table>> tables; ///< Every table this shard has used, the live one last
+    };
+
+    /**
+     * @brief Allocates an empty table.
+     *
+     * @param slots Number of slots, a power of two.
+     * @return std::unique_ptr<Table> The table.
+     */
+    static std::unique_ptr<Table> MakeTable(std::size_t slots);
+
+    /**
+     * @brief Doubles a shard's table; the caller holds the shard lock.
+     *
+     * @param shard The shard.
+     */
+    void Grow(Shard& shard);
+
+    std::unique_ptr<Shard[]> shards; ///< FLEET_REGISTRY_SHARDS shards
+};
+
+/**
+ * @brief Hands the partitions of a registry out to worker threads, each partition once.
+ *
+ * @details Workers share one scan and call Next until it returns false;
+ * a worker that finishes its partition early simply claims another, so
+ * uneven partitions balance out.
+ */
+class FleetScan {
+public:
+    /**
+     * @brief Starts a scan over every partition.
+     *
+     * @param registry The registry; must outlive the scan.
+     */
+    explicit FleetScan(const FleetRegistry& registry) : registry(registry), next(0) {}
+
+    /**
+     * @brief Claims the next partition and copies its entries.
+     *
+     * @param entries Receives the entries of the claimed partition.
+     * @return true if a partition was claimed, false once all have been handed out.
+     */
+    bool Next(std::vector<FleetEntry>& entries) {
+        const std::size_t partition = next.fetch_add(1, std::memory_order_relaxed);
+        if (partition >= registry.getPartitionCount()) {
+            return false;
+        }
+        registry.CollectPartition(partition, entries);
+        return true;
+    }
+
+private:
+    const FleetRegistry& registry; ///< The registry scanned
+    std::atomic<std::size_t> next; ///< Next partition to hand out
+};
+
+#endif // !FLEET_REGISTRY_H
@@ -0,0 +1,214 @@
+#ifndef OBJECT_REGISTRY_H
+#define OBJECT_REGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#define OBJECT_REGISTRY_CHUNK_BITS 10 ///< log2 of the slots per chunk
+#define OBJECT_REGISTRY_CHUNK_SIZE (1u << OBJECT_REGISTRY_CHUNK_BITS) ///< Slots per chunk
+#define OBJECT_REGISTRY_MAX_CHUNKS 4096 ///< Chunks per registry; IDs stay below 4M
+
+/**
+ * @brief A registered object's ID together with the generation it was issued in.
+ *
+ * @details IDs are reused once their object is unregistered; the
+ * generation tells a stale handle from the object now holding the ID.
+ */
+struct RegistryHandle {
+    std::uint32_t id; ///< Dense ID, an index into arrays sized by getIdLimit()
+    std::uint32_t generation; ///< Times the ID had been released before this object got it
+
+    bool operator==(const RegistryHandle& other) const { return id == other.id && generation == other.generation; }
+};
+
+/**
+ * @brief Hands out dense, recyclable IDs and maps them back to their objects in O(1).
+ *
+ * @details IDs are slot indices. A released ID goes on a free list and is
+ * handed out again before any new one, so the IDs in use stay packed at
+ * the bottom of the range and per-ID arrays stay small. Every release
+ * bumps the slot's generation, so a handle kept past its object's
+ * lifetime stops resolving instead of finding the object that reused it.
+ *
+ * Slots live in fixed-size chunks that are allocated on demand and never
+ * moved or freed, so lookups take no lock even while other threads
+ * register objects. Register and Unregister take one mutex; they run once
+ * per object lifetime, not per sample.
+ *
+ * The registry does not own the objects. A pointer returned by a lookup is
+ * only safe while the caller otherwise knows the object is alive, for
+ * example by holding a shared_ptr to it or to its car.
+ *
+ * @tparam T The registered type.
+ */
+template <typename T>
+class ObjectRegistry {
+public:
+    /**
+     * @brief Constructs an empty registry.
+     */
+    ObjectRegistry() : idLimit(0), live(0) {
+        for (auto& c : chunks) {
+            c.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Frees every chunk; the objects are untouched.
+     */
+    ~ObjectRegistry() {
+        for (auto& c : chunks) {
+            delete[] c.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Deleted copy constructor and assignment operator
+    ObjectRegistry(const ObjectRegistry&) = delete;
+    ObjectRegistry& operator=(const ObjectRegistry&) = delete;
+
+    /**
+     * @brief Registers an object under the most recently released ID, or a new one.
+     *
+     * @param object The object; not null.
+     * @return RegistryHandle Its ID and generation.
+     * @throws std::length_error If every ID is in use.
+     */
+    RegistryHandle Register(T* object) {
+        std::lock_guard<std::mutex> guard(lock);
+        std::uint32_t id;
+        if (!freeIds.empty()) {
+            id = freeIds.back();
+            freeIds.pop_back();
+        } else {
+            id = idLimit.load(std::memory_order_relaxed);
+            if (id >= OBJECT_REGISTRY_MAX_CHUNKS * OBJECT_REGISTRY_CHUNK_SIZE) {
+                throw std::length_error("object registry is full");
+            }
+            std::atomic<Slot*>& chunk = chunks[id >> OBJECT_REGISTRY_CHUNK_BITS];
+            if (chunk.load(std::memory_order_relaxed) == nullptr) {
+                Slot* fresh = new Slot[OBJECT_REGISTRY_CHUNK_SIZE];
+                for (std::uint32_t i = 0; i < OBJECT_REGISTRY_CHUNK_SIZE; i++) {
+                    fresh[i].object.store(nullptr, std::memory_order_relaxed);
+                    fresh[i].generation.store(0, std::memory_order_relaxed);
+                }
+                chunk.store(fresh, std::memory_order_release);
+            }
+            idLimit.store(id + 1, std::memory_order_release);
+        }
+        Slot& s = SlotOf(id);
+        s.object.store(object, std::memory_order_release);
+        live.fetch_add(1, std::memory_order_relaxed);
+        return RegistryHandle{id, s.generation.load(std::memory_order_relaxed)};
+    }
+
+    /**
+     * @brief Releases an object's ID for reuse.
+     *
+     * @param handle The handle Register returned.
+     * @return true if the handle was current; false if it was already released.
+     */
+    bool Unregister(const RegistryHandle& handle) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (handle.id >= idLimit.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        Slot& s = SlotOf(handle.id);
+        if (s.generation.load(std::memory_order_relaxed) != handle.generation ||
+            s.object.load(std::memory_order_relaxed) == nullptr) {
+            return false;
+        }
+        s.object.store(nullptr, std::memory_order_release);
+        s.generation.store(handle.generation + 1, std::memory_order_release);
+        freeIds.push_back(handle.id);
+        live.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Looks an object up by handle without taking a lock.
+     *
+     * @param handle The handle.
+     * @return T* The object, or nullptr if the handle was released.
+     */
+    T* Find(const RegistryHandle& handle) const {
+        if (handle.id >= idLimit.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        const Slot& s = SlotOf(handle.id);
+        // The generation read after the object catches a release and reuse in between
+        if (s.generation.load(std::memory_order_acquire) != handle.generation) {
+            return nullptr;
+        }
+        T* object = s.object.load(std::memory_order_acquire);
+        return s.generation.load(std::memory_order_acquire) == handle.generation ? object : nullptr;
+    }
+
+    /**
+     * @brief Looks the current holder of an ID up without taking a lock.
+     *
+     * @param id The ID.
+     * @return T* The object, or nullptr if the ID is free.
+     */
+    T* Find(std::uint32_t id) const {
+        if (id >= idLimit.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return SlotOf(id).object.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Gets the number of registered objects.
+     *
+     * @return std::size_t The count; approximate while other threads register.
+     */
+    std::size_t size() const {
+        return live.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets one past the highest ID ever handed out.
+     *
+     * Arrays indexed by ID need this many entries. It never shrinks, and
+     * since released IDs are reused first it only grows with the peak
+     * number of live objects.
+     *
+     * @return std::uint32_t The ID limit.
+     */
+    std::uint32_t getIdLimit() const {
+        return idLimit.load(std::memory_order_acquire);
+    }
+
+private:
+    /**
+     * @brief One ID's slot; fields are atomics so that lock-free lookups are not data races.
+     */
+    struct Slot {
+        std::atomic<T*> object; ///< The holder of the ID, or null while it is free
+        std::atomic<std::uint32_t> generation; ///< Bumped each time the ID is released
+    };
+
+    /**
+     * @brief Gets the slot of an ID below idLimit.
+     *
+     * @param id The ID.
+     * @return Slot& The slot.
+     */
+    Slot& SlotOf(std::uint32_t id) const {
+        Slot* chunk = chunks[id >> OBJECT_REGISTRY_CHUNK_BITS].load(std::memory_order_acquire);
+        return chunk[id & (OBJECT_REGISTRY_CHUNK_SIZE - 1)];
+    }
+
+    std::array<std::atomic<Slot*>, OBJECT_REGISTRY_MAX_CHUNKS> chunks; ///< Slot chunks, allocated on demand and kept until destruction
+    std::atomic<std::uint32_t> idLimit; ///< One past the highest ID handed out
+    std::atomic<std::size_t> live; ///< Registered objects
+    std::mutex lock; ///< Serializes Register and Unregister
+    std::vector<std::uint32_t> freeIds; ///< Released IDs, reused last-in first-out
+};
+
+#endif // !OBJECT_REGISTRY_H
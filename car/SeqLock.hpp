@@ -0,0 +1,104 @@
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A fixed vector of doubles published as one unit by a single writer.
+ *
+ * @details Sequence lock: the writer makes the sequence odd, stores the
+ * values, then makes it even again. A reader copies the values between two
+ * loads of the sequence and keeps the copy only if both loads are equal and
+ * even, so it never sees half of one write and half of another. Readers take
+ * no lock and never block the writer; they retry instead. The values are
+ * relaxed atomics, so concurrent copies are not data races.
+ *
+ * Only one thread may call publish at a time.
+ *
+ * @tparam N Number of values.
+ */
+template <std::size_t N>
+class SeqLock {
+public:
+    typedef std::array<double, N> Values; ///< One published vector
+
+    /**
+     * @brief Constructs a lock holding zeros at version 0.
+     */
+    SeqLock() : sequence(0) {
+        for (auto& v : values) {
+            v.store(0.0, std::memory_order_relaxed);
+        }
+    }
+
+    // Deleted copy constructor and assignment operator
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief Publishes a new vector and bumps the version.
+     *
+     * @param v The values to publish.
+     */
+    void publish(const Values& v) {
+        const std::uint64_t s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < N; i++) {
+            values[i].store(v[i], std::memory_order_relaxed);
+        }
+        sequence.store(s + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Makes one attempt to copy the last published vector.
+     *
+     * @param out Receives the values; unspecified if the attempt fails.
+     * @param version Receives the number of publishes the copy reflects.
+     * @return true if the copy is consistent, false if a publish overlapped it.
+     */
+    bool tryRead(Values& out, std::uint64_t& version) const {
+        const std::uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false; // Publish in progress
+        }
+        for (std::size_t i = 0; i < N; i++) {
+            out[i] = values[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        version = before / 2;
+        return true;
+    }
+
+    /**
+     * @brief Copies the last published vector, retrying until it is consistent.
+     *
+     * @param out Receives the values.
+     * @return std::uint64_t Number of publishes the copy reflects.
+     */
+    std::uint64_t read(Values& out) const {
+        std::uint64_t version = 0;
+        while (!tryRead(out, version)) {
+        }
+        return version;
+    }
+
+    /**
+     * @brief Gets the number of completed publishes.
+     *
+     * @return std::uint64_t The version.
+     */
+    std::uint64_t getVersion() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    std::atomic<std::uint64_t> sequence; ///< Twice the version, odd while a publish is in progress
+    std::array<std::atomic<double>, N> values; ///< The published values
+};
+
+#endif // !SEQ_LOCK_H
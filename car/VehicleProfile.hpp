@@ -0,0 +1,131 @@
+#ifndef VEHICLE_PROFILE_H
+#define VEHICLE_PROFILE_H
+
+#include "../Sensors/Sensor.hpp"
+#include <concepts>
+#include <cstdint>
+
+#define VEHICLE_ALERT_OVERSPEED 0x1 ///< Status check: speed above maxSpeed
+#define VEHICLE_ALERT_OVERHEAT 0x2 ///< Status check: temperature above maxTemperature
+#define VEHICLE_ALERT_BATTERY_LOW 0x4 ///< Status check: battery level below lowBattery
+#define VEHICLE_ALERT_COLLISION 0x8 ///< Status check: radar distance below safeRadarDistance
+
+#define VEHICLE_BAND_SPEED 2.0 ///< Hysteresis of the overspeed check: a raised alert holds until the speed is this far below maxSpeed
+#define VEHICLE_BAND_TEMPERATURE 1.0 ///< Hysteresis of the overheat check
+#define VEHICLE_BAND_BATTERY 2.0 ///< Hysteresis of the low battery check
+#define VEHICLE_BAND_RADAR 0.5 ///< Hysteresis of the collision check
+
+/**
+ * @brief A set of status limits as compile-time constants.
+ *
+ * @details A profile is a type with static constexpr members, so checks
+ * instantiated for it compare against immediates instead of loading the
+ * limits from memory.
+ */
+template<class P>
+concept VehicleProfile = requires {
+    { P::name } -> std::convertible_to<const char*>;
+    { P::maxSpeed } -> std::convertible_to<double>;
+    { P::maxTemperature } -> std::convertible_to<double>;
+    { P::lowBattery } -> std::convertible_to<double>;
+    { P::safeRadarDistance } -> std::convertible_to<double>;
+};
+
+/**
+ * @brief Passenger car; the limits every car used before profiles existed.
+ */
+struct PassengerCarProfile {
+    static constexpr const char* name = "passenger"; ///< Name used in reports
+    static constexpr double maxSpeed = 50; ///< Maximum speed limit
+    static constexpr double maxTemperature = 30; ///< Maximum temperature limit
+    static constexpr double lowBattery = 20; ///< Battery level threshold for low battery warning
+    static constexpr double safeRadarDistance = 5; ///< Minimum safe distance for radar detection
+};
+
+/**
+ * @brief Heavy truck: slower, runs hotter, needs a longer gap.
+ */
+struct TruckProfile {
+    static constexpr const char* name = "truck"; ///< Name used in reports
+    static constexpr double maxSpeed = 40; ///< Maximum speed limit
+    static constexpr double maxTemperature = 35; ///< Maximum temperature limit
+    static constexpr double lowBattery = 25; ///< Battery level threshold for low battery warning
+    static constexpr double safeRadarDistance = 12; ///< Minimum safe distance for radar detection
+};
+
+/**
+ * @brief Sports car: faster, brakes harder.
+ */
+struct SportsCarProfile {
+    static constexpr const char* name = "sports"; ///< Name used in reports
+    static constexpr double maxSpeed = 80; ///< Maximum speed limit
+    static constexpr double maxTemperature = 30; ///< Maximum temperature limit
+    static constexpr double lowBattery = 15; ///< Battery level threshold for low battery warning
+    static constexpr double safeRadarDistance = 4; ///< Minimum safe distance for radar detection
+};
+
+typedef PassengerCarProfile DefaultVehicleProfile; ///< Profile of cars that are not given one
+
+static_assert(VehicleProfile<PassengerCarProfile> && VehicleProfile<TruckProfile> && VehicleProfile<SportsCarProfile>,
+              "Built-in profiles must satisfy VehicleProfile");
+
+/**
+ * @brief Status limits held in memory, for profiles only known at run time.
+ */
+struct VehicleLimits {
+    const char* name; ///< Name used in reports
+    double maxSpeed; ///< Maximum speed limit
+    double maxTemperature; ///< Maximum temperature limit
+    double lowBattery; ///< Battery level threshold for low battery warning
+    double safeRadarDistance; ///< Minimum safe distance for radar detection
+
+    /**
+     * @brief Copies the limits of a compile-time profile.
+     *
+     * @tparam P The profile.
+     * @return VehicleLimits The limits.
+     */
+    template<VehicleProfile P>
+    static constexpr VehicleLimits Of() {
+        return VehicleLimits{P::name, P::maxSpeed, P::maxTemperature, P::lowBattery, P::safeRadarDistance};
+    }
+};
+
+/**
+ * @brief Checks signals against a compile-time profile.
+ *
+ * A check that is already raised stays raised until its signal is back
+ * inside the limit by the check's VEHICLE_BAND_*, so a signal hovering at
+ * a limit does not flap.
+ *
+ * @tparam P The profile; its limits and bands are folded in as immediates.
+ * @param values Signal values indexed by SensorTypes.
+ * @param raised VEHICLE_ALERT_* bits raised before this check; 0 for none.
+ * @return std::uint32_t VEHICLE_ALERT_* bits.
+ */
+template<VehicleProfile P>
+inline std::uint32_t EvaluateVehicleStatus(const double* values, std::uint32_t raised = 0) {
+    return (values[(int)SensorTypes::SPEED_SENSOR] > P::maxSpeed - ((raised & VEHICLE_ALERT_OVERSPEED) ? VEHICLE_BAND_SPEED : 0.0) ? VEHICLE_ALERT_OVERSPEED : 0) |
+           (values[(int)SensorTypes::TEMPERATURE_SENSOR] > P::maxTemperature - ((raised & VEHICLE_ALERT_OVERHEAT) ? VEHICLE_BAND_TEMPERATURE : 0.0) ? VEHICLE_ALERT_OVERHEAT : 0) |
+           (values[(int)SensorTypes::BATTERY_LEVEL_SENSOR] < P::lowBattery + ((raised & VEHICLE_ALERT_BATTERY_LOW) ? VEHICLE_BAND_BATTERY : 0.0) ? VEHICLE_ALERT_BATTERY_LOW : 0) |
+           (values[(int)SensorTypes::RADAR_SENSOR] < P::safeRadarDistance + ((raised & VEHICLE_ALERT_COLLISION) ? VEHICLE_BAND_RADAR : 0.0) ? VEHICLE_ALERT_COLLISION : 0);
+}
+
+/**
+ * @brief Checks signals against limits held in memory.
+ *
+ * @param limits The limits.
+ * @param values Signal values indexed by SensorTypes.
+ * @param raised VEHICLE_ALERT_* bits raised before this check; 0 for none.
+ * @return std::uint32_t VEHICLE_ALERT_* bits.
+ */
+inline std::uint32_t EvaluateVehicleStatus(const VehicleLimits& limits, const double* values, std::uint32_t raised = 0) {
+    return (values[(int)SensorTypes::SPEED_SENSOR] > limits.maxSpeed - ((raised & VEHICLE_ALERT_OVERSPEED) ? VEHICLE_BAND_SPEED : 0.0) ? VEHICLE_ALERT_OVERSPEED : 0) |
+           (values[(int)SensorTypes::TEMPERATURE_SENSOR] > limits.maxTemperature - ((raised & VEHICLE_ALERT_OVERHEAT) ? VEHICLE_BAND_TEMPERATURE : 0.0) ? VEHICLE_ALERT_OVERHEAT : 0) |
+           (values[(int)SensorTypes::BATTERY_LEVEL_SENSOR] < limits.lowBattery + ((raised & VEHICLE_ALERT_BATTERY_LOW) ? VEHICLE_BAND_BATTERY : 0.0) ? VEHICLE_ALERT_BATTERY_LOW : 0) |
+           (values[(int)SensorTypes::RADAR_SENSOR] < limits.safeRadarDistance + ((raised & VEHICLE_ALERT_COLLISION) ? VEHICLE_BAND_RADAR : 0.0) ? VEHICLE_ALERT_COLLISION : 0);
+}
+
+typedef std::uint32_t (*VehicleStatusCheck)(const double* values, std::uint32_t raised); ///< A check specialized for one profile
+
+#endif // !VEHICLE_PROFILE_H
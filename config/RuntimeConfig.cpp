@@ -0,0 +1,294 @@
+#include "RuntimeConfig.hpp"
+#include "../logger/CarLogger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+#include <utility>
+#include <vector>
+
+// Physical ranges follow the sensor generators; indexed by SensorTypes
+static const AnomalyLimits Default_Anomaly_Limits[Sensor_Types_Count] = {
+    {0.0, 320.0, 4.0, 30, 10}, // Speed
+    {0.0, 320.0, 4.0, 30, 10}, // Temperature
+    {0.0, 50.0, 4.0, 30, 10},  // Radar
+    {0.0, 100.0, 4.0, 30, 10}  // Battery level
+};
+
+static const char* const Settings_Sensor_Names[Sensor_Types_Count] = {
+    "speed", "temperature", "radar", "battery"
+}; ///< Key prefix of each SensorTypes value
+
+/**
+ * @brief Strips leading and trailing blanks.
+ *
+ * @param text The text.
+ * @return std::string The trimmed text.
+ */
+static std::string Trim(const std::string& text) {
+    const std::size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+/**
+ * @brief Reads a whole string as a number.
+ *
+ * @param text The text.
+ * @param value Receives the number.
+ * @return true if the text is a finite number.
+ */
+static bool ParseNumber(const std::string& text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end != text.c_str() && *end == '\0' && value == value && value - value == 0.0;
+}
+
+/**
+ * @brief Gets the settings the simulator starts with.
+ *
+ * @return RuntimeSettings The default profile's limits and the sensor generators' ranges.
+ */
+RuntimeSettings RuntimeSettings::Defaults() {
+    RuntimeSettings settings;
+    settings.version = 1;
+    settings.limits = VehicleLimits::Of<DefaultVehicleProfile>();
+    std::copy(Default_Anomaly_Limits, Default_Anomaly_Limits + Sensor_Types_Count, settings.anomaly.begin());
+    return settings;
+}
+
+/**
+ * @brief Reads "key = value" lines on top of the defaults.
+ *
+ * A profile line resets the status limits to that profile, so it is
+ * applied first whatever line it is on.
+ *
+ * @param in The text.
+ * @param settings Receives the settings; left unchanged on error.
+ * @param error Receives a description of the first bad line.
+ * @return true if every line was understood.
+ */
+bool RuntimeSettings::Parse(std::istream& in, RuntimeSettings& settings, std::string& error) {
+    RuntimeSettings parsed = Defaults();
+    std::vector<std::pair<std::string, std::string>> entries;
+    std::string line;
+    for (int number = 1; std::getline(in, line); number++) {
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+        const std::size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            error = "line " + std::to_string(number) + ": expected key = value";
+            return false;
+        }
+        const std::string key = Trim(line.substr(0, equals));
+        const std::string value = Trim(line.substr(equals + 1));
+        if (key != "profile") {
+            entries.emplace_back(key, value);
+            continue;
+        }
+        if (value == "passenger") {
+            parsed.limits = VehicleLimits::Of<PassengerCarProfile>();
+        } else if (value == "truck") {
+            parsed.limits = VehicleLimits::Of<TruckProfile>();
+        } else if (value == "sports") {
+            parsed.limits = VehicleLimits::Of<SportsCarProfile>();
+        } else {
+            error = "line " + std::to_string(number) + ": unknown profile " + value;
+            return false;
+        }
+    }
+
+    for (const auto& entry : entries) {
+        const std::string& key = entry.first;
+        double number = 0.0;
+        if (!ParseNumber(entry.second, number)) {
+            error = key + ": not a number: " + entry.second;
+            return false;
+        }
+        if (key == "max_speed") {
+            parsed.limits.maxSpeed = number;
+        } else if (key == "max_temperature") {
+            parsed.limits.maxTemperature = number;
+        } else if (key == "low_battery") {
+            parsed.limits.lowBattery = number;
+        } else if (key == "safe_radar_distance") {
+            parsed.limits.safeRadarDistance = number;
+        } else {
+            const std::size_t dot = key.find('.');
+            int type = 0;
+            while (type < Sensor_Types_Count && key.compare(0, dot, Settings_Sensor_Names[type]) != 0) {
+                type++;
+            }
+            if (dot == std::string::npos || type == Sensor_Types_Count) {
+                error = "unknown key " + key;
+                return false;
+            }
+            AnomalyLimits& limits = parsed.anomaly[type];
+            const std::string field = key.substr(dot + 1);
+            if (field == "min") {
+                limits.minValue = number;
+            } else if (field == "max") {
+                limits.maxValue = number;
+            } else if (field == "z_threshold") {
+                limits.zThreshold = number;
+            } else if ((field == "warmup" || field == "stuck_run") && number >= 0) {
+                (field == "warmup" ? limits.warmup : limits.stuckRun) = (std::uint64_t)number;
+            } else {
+                error = "unknown or negative key " + key;
+                return false;
+            }
+        }
+    }
+    settings = parsed;
+    return true;
+}
+
+/**
+ * @brief Gets the process-wide runtime settings.
+ *
+ * @return RuntimeConfig& The instance, built with the defaults on first use.
+ */
+RuntimeConfig& RuntimeConfig::get() {
+    static RuntimeConfig instance;
+    return instance;
+}
+
+RuntimeConfig::RuntimeConfig()
+    : current(std::make_unique<RuntimeSettings>(RuntimeSettings::Defaults())), lastVersion(1) {
+}
+
+/**
+ * @brief Gets the current version.
+ *
+ * @return const RuntimeSettings* The settings, valid until the calling thread leaves its read section.
+ */
+const RuntimeSettings* RuntimeConfig::Current() const {
+    return current.get();
+}
+
+/**
+ * @brief Publishes new settings; the previous version is retired, not freed.
+ *
+ * @param settings The settings.
+ * @return std::uint64_t The version given to them.
+ */
+std::uint64_t RuntimeConfig::Install(const RuntimeSettings& settings) {
+    std::lock_guard<std::mutex> guard(installLock);
+    std::unique_ptr<RuntimeSettings> next = std::make_unique<RuntimeSettings>(settings);
+    next->version = ++lastVersion;
+    current.Publish(std::move(next));
+    return lastVersion;
+}
+
+/**
+ * @brief Parses a settings file and installs it.
+ *
+ * @param path The file.
+ * @param error Receives the reason when nothing was installed.
+ * @return true if the file was read and installed.
+ */
+bool RuntimeConfig::LoadFile(const std::string& path, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    RuntimeSettings settings;
+    if (!RuntimeSettings::Parse(in, settings, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    Install(settings);
+    return true;
+}
+
+/**
+ * @brief Starts watching a file.
+ *
+ * The file is not installed until it changes; load it with
+ * RuntimeConfig::LoadFile first to start from it.
+ *
+ * @param path The settings file.
+ * @param interval Time between polls.
+ */
+ConfigReloader::ConfigReloader(const std::string& path, std::chrono::milliseconds interval)
+    : path(path), interval(interval), running(true), reloads(0), errors(0) {
+    worker = std::thread(&ConfigReloader::Run, this);
+}
+
+/**
+ * @brief Stops the thread.
+ */
+ConfigReloader::~ConfigReloader() {
+    Stop();
+}
+
+/**
+ * @brief Stops the thread; called by the destructor.
+ */
+void ConfigReloader::Stop() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        running = false;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Gets the counters.
+ *
+ * @return ConfigReloaderStats The counters.
+ */
+ConfigReloaderStats ConfigReloader::getStats() const {
+    return ConfigReloaderStats{reloads.load(std::memory_order_relaxed), errors.load(std::memory_order_relaxed)};
+}
+
+/**
+ * @brief Gets the modification time of a file.
+ *
+ * @param path The file.
+ * @return std::int64_t Nanoseconds since the epoch, or -1 if the file cannot be read.
+ */
+static std::int64_t ModificationTime(const std::string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return -1;
+    }
+    return (std::int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+}
+
+/**
+ * @brief Body of the watcher thread: installs the file when its time stamp moves, then reclaims.
+ */
+void ConfigReloader::Run() {
+    std::int64_t seen = ModificationTime(path);
+    std::unique_lock<std::mutex> guard(lock);
+    while (running) {
+        wake.wait_for(guard, interval);
+        if (!running) {
+            break;
+        }
+        const std::int64_t modified = ModificationTime(path);
+        if (modified != seen && modified >= 0) {
+            seen = modified;
+            std::string error;
+            if (RuntimeConfig::get().LoadFile(path, error)) {
+                reloads.fetch_add(1, std::memory_order_relaxed);
+                Logger::getInstance().log("Runtime settings reloaded from " + path);
+            } else {
+                errors.fetch_add(1, std::memory_order_relaxed);
+                Logger::getInstance().log(LogLevel::ERROR, "Runtime settings not reloaded: " + error);
+            }
+        }
+        Rcu::Reclaim();
+    }
+}
@@ -0,0 +1,169 @@
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include "../car/VehicleProfile.hpp"
+#include "../memory/Rcu.hpp"
+#include "../telemetry/StreamingStats.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Thresholds that can change while the simulation runs.
+ *
+ * @details A version is immutable once installed; a change installs a
+ * whole new one.
+ */
+struct RuntimeSettings {
+    std::uint64_t version; ///< Set by RuntimeConfig::Install; the defaults are version 1
+    VehicleLimits limits; ///< Status limits of the cars that follow the runtime settings
+    std::array<AnomalyLimits, Sensor_Types_Count> anomaly; ///< Diagnostic ECU thresholds indexed by sensor type
+
+    /**
+     * @brief Gets the settings the simulator starts with.
+     *
+     * @return RuntimeSettings The default profile's limits and the sensor generators' ranges.
+     */
+    static RuntimeSettings Defaults();
+
+    /**
+     * @brief Reads "key = value" lines on top of the defaults.
+     *
+     * @details Blank lines and text after '#' are ignored. Keys are
+     * profile (passenger, truck or sports, the base of the status limits),
+     * max_speed, max_temperature, low_battery, safe_radar_distance, and
+     * SENSOR.min, SENSOR.max, SENSOR.z_threshold, SENSOR.warmup and
+     * SENSOR.stuck_run where SENSOR is speed, temperature, radar or battery.
+     *
+     * @param in The text.
+     * @param settings Receives the settings; left unchanged on error.
+     * @param error Receives a description of the first bad line.
+     * @return true if every line was understood.
+     */
+    static bool Parse(std::istream& in, RuntimeSettings& settings, std::string& error);
+};
+
+/**
+ * @brief The process-wide runtime settings, replaced as a whole through RCU.
+ *
+ * @details Simulation threads read the current version inside a read
+ * section without taking a lock, and usually keep a copy of the fields
+ * they need until the version changes. Install publishes a new version
+ * with one pointer swap and retires the old one; it never waits for
+ * readers, and Rcu::Reclaim frees old versions once no reader can hold them.
+ */
+class RuntimeConfig {
+public:
+    /**
+     * @brief Gets the process-wide runtime settings.
+     *
+     * @return RuntimeConfig& The instance.
+     */
+    static RuntimeConfig& get();
+
+    /**
+     * @brief Gets the current version.
+     *
+     * @return const RuntimeSettings* The settings, valid until the calling thread leaves its read section.
+     */
+    const RuntimeSettings* Current() const;
+
+    /**
+     * @brief Publishes new settings.
+     *
+     * @param settings The settings; their version is replaced.
+     * @return std::uint64_t The version given to them.
+     */
+    std::uint64_t Install(const RuntimeSettings& settings);
+
+    /**
+     * @brief Parses a settings file and installs it.
+     *
+     * @param path The file.
+     * @param error Receives the reason when nothing was installed.
+     * @return true if the file was read and installed.
+     */
+    bool LoadFile(const std::string& path, std::string& error);
+
+    // Deleted copy constructor and assignment operator
+    RuntimeConfig(const RuntimeConfig&) = delete;
+    RuntimeConfig& operator=(const RuntimeConfig&) = delete;
+
+private:
+    RuntimeConfig();
+
+    RcuPointer<RuntimeSettings> current; ///< The published version
+    std::mutex installLock; ///< Serializes writers; readers never take it
+    std::uint64_t lastVersion; ///< Version of the last install; written under installLock
+};
+
+/**
+ * @brief Counters of a config reloader.
+ */
+struct ConfigReloaderStats {
+    std::uint64_t reloads; ///< Versions installed from the file
+    std::uint64_t errors; ///< Changes of the file that could not be read or parsed
+};
+
+/**
+ * @brief Watches a settings file from its own thread and installs it whenever it changes.
+ *
+ * @details The thread polls the file's modification time and also reclaims
+ * retired settings after each poll, so grace periods are waited out on
+ * this thread and never on a simulation thread. A file that fails to parse
+ * is logged and the current settings stay.
+ */
+class ConfigReloader {
+public:
+    /**
+     * @brief Starts watching a file.
+     *
+     * @param path The settings file.
+     * @param interval Time between polls.
+     */
+    ConfigReloader(const std::string& path, std::chrono::milliseconds interval);
+
+    /**
+     * @brief Stops the thread.
+     */
+    ~ConfigReloader();
+
+    // Deleted copy constructor and assignment operator
+    ConfigReloader(const ConfigReloader&) = delete;
+    ConfigReloader& operator=(const ConfigReloader&) = delete;
+
+    /**
+     * @brief Stops the thread; called by the destructor.
+     */
+    void Stop();
+
+    /**
+     * @brief Gets the counters.
+     *
+     * @return ConfigReloaderStats The counters.
+     */
+    ConfigReloaderStats getStats() const;
+
+private:
+    /**
+     * @brief Body of the watcher thread.
+     */
+    void Run();
+
+    std::string path; ///< The settings file
+    std::chrono::milliseconds interval; ///< Time between polls
+    std::mutex lock; ///< Guards running for the wake-up
+    std::condition_variable wake; ///< Signalled by Stop
+    bool running; ///< Cleared to stop the thread
+    std::atomic<std::uint64_t> reloads; ///< ConfigReloaderStats::reloads
+    std::atomic<std::uint64_t> errors; ///< ConfigReloaderStats::errors
+    std::thread worker; ///< The watcher thread
+};
+
+#endif // !RUNTIME_CONFIG_H
@@ -0,0 +1,84 @@
+#ifndef KALMAN_FILTER_H
+#define KALMAN_FILTER_H
+
+#include "Lanes.hpp"
+#include "Matrix.hpp"
+
+/**
+ * @brief State estimate and covariance of a linear Kalman filter.
+ *
+ * @tparam T double for one filter, Lanes for several filters stepped together.
+ * @tparam N State size.
+ */
+template <typename T, std::size_t N>
+struct KalmanState {
+    Matrix<T, N, 1> x; ///< State estimate
+    Matrix<T, N, N> P; ///< Estimate covariance
+};
+
+/**
+ * @brief Predicts the state one step ahead: x = F x + u, P = F P F' + Q.
+ *
+ * @param s The filter.
+ * @param F State transition.
+ * @param u Known input added to the state, such as a control term.
+ * @param Q Process noise covariance.
+ */
+template <typename T, std::size_t N>
+FUSION_INLINE void KalmanPredict(KalmanState<T, N>& s, const Matrix<T, N, N>& F, const Matrix<T, N, 1>& u, const Matrix<T, N, N>& Q) {
+    s.x = F * s.x + u;
+    s.P = F * s.P * Transpose(F) + Q;
+}
+
+/**
+ * @brief Corrects the state with a measurement z = H x + noise, unless the measurement is implausible.
+ *
+ * The innovation is gated on its squared Mahalanobis distance: a
+ * measurement further than the gate from the prediction is treated as an
+ * outlier and leaves the filter as it was. Callers force a measurement in
+ * after several rejections in a row, otherwise a filter whose prediction
+ * went wrong would reject the truth forever. The gate is applied by scaling
+ * the gain with a 0/1 mask rather than by branching, so every lane of a
+ * Lanes filter runs the same instructions.
+ *
+ * The innovation covariance is inverted in closed form, so M is 1 or 2.
+ *
+ * @param s The filter.
+ * @param z The measurement.
+ * @param H Measurement model.
+ * @param R Measurement noise covariance.
+ * @param gate Largest accepted squared distance, e.g. 9 for three standard deviations of a scalar.
+ * @param force 1 where the measurement must be used whatever the gate says, 0 elsewhere.
+ * @return T 1 where the measurement was used, 0 where it was rejected.
+ */
+template <typename T, std::size_t N, std::size_t M>
+FUSION_INLINE T KalmanUpdate(KalmanState<T, N>& s, const Matrix<T, M, 1>& z, const Matrix<T, M, N>& H, const Matrix<T, M, M>& R, double gate,
+               const T& force = T(0.0)) {
+    static_assert(M == 1 || M == 2, "the innovation covariance is inverted in closed form for 1 or 2 measurements");
+    const Matrix<T, M, 1> y = z - H * s.x;
+    const Matrix<T, N, M> PHt = s.P * Transpose(H);
+    const Matrix<T, M, M> S = H * PHt + R;
+    Matrix<T, M, M> inverse;
+    if constexpr (M == 1) {
+        inverse(0, 0) = T(1.0) / S(0, 0);
+    } else {
+        const T det = T(1.0) / (S(0, 0) * S(1, 1) - S(0, 1) * S(1, 0));
+        inverse(0, 0) = S(1, 1) * det;
+        inverse(0, 1) = T(0.0) - S(0, 1) * det;
+        inverse(1, 0) = T(0.0) - S(1, 0) * det;
+        inverse(1, 1) = S(0, 0) * det;
+    }
+
+    const T distance = (Transpose(y) * inverse * y)(0, 0);
+    const T inside = LessEqualMask(distance, T(gate));
+    const T accept = inside + force - inside * force;
+    Matrix<T, N, M> K = PHt * inverse;
+    for (std::size_t r = 0; r < N; r++)
+        for (std::size_t c = 0; c < M; c++) K(r, c) *= accept;
+
+    s.x = s.x + K * y;
+    s.P = s.P - K * Transpose(PHt); // P - K H P, with H P = (P H')' since P is symmetric
+    return accept;
+}
+
+#endif // !KALMAN_FILTER_H
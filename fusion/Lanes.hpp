@@ -0,0 +1,143 @@
+#ifndef LANES_H
+#define LANES_H
+
+#include <cstddef>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define FUSION_LANES 4 ///< Cars filtered together by the fleet filter; two SSE2 registers
+
+// The filter steps are too large for the inliner's default budget, but only
+// once inlined do the Lanes temporaries stay in registers
+#if defined(__GNUC__)
+#define FUSION_INLINE inline __attribute__((always_inline))
+#else
+#define FUSION_INLINE inline
+#endif
+
+/**
+ * @brief A short vector of doubles that behaves like one double, one lane per car.
+ *
+ * @details Code templated on the scalar type, such as KalmanFilter.hpp,
+ * runs unchanged on double for one car and on Lanes for N cars at once.
+ * With SSE2 the lanes are held as N / 2 packed registers and every
+ * operator is N / 2 packed instructions; otherwise they are plain doubles.
+ *
+ * @tparam N Number of lanes; even.
+ */
+template <std::size_t N>
+struct Lanes {
+    static_assert(N % 2 == 0, "lanes are used in pairs");
+#ifdef __SSE2__
+    __m128d r[N / 2]; ///< Two lanes per register
+#else
+    double r[N]; ///< One value per lane
+#endif
+
+    Lanes() = default;
+
+    /**
+     * @brief Broadcasts one value to every lane.
+     *
+     * @param x The value.
+     */
+    Lanes(double x) {
+#ifdef __SSE2__
+        for (std::size_t i = 0; i < N / 2; i++) r[i] = _mm_set1_pd(x);
+#else
+        for (std::size_t i = 0; i < N; i++) r[i] = x;
+#endif
+    }
+
+    /**
+     * @brief Loads N consecutive values.
+     *
+     * @param p The values.
+     * @return Lanes The lanes.
+     */
+    static Lanes Load(const double* p) {
+        Lanes a;
+#ifdef __SSE2__
+        for (std::size_t i = 0; i < N / 2; i++) a.r[i] = _mm_loadu_pd(p + 2 * i);
+#else
+        for (std::size_t i = 0; i < N; i++) a.r[i] = p[i];
+#endif
+        return a;
+    }
+
+    /**
+     * @brief Stores the lanes to N consecutive values.
+     *
+     * @param p Receives the values.
+     */
+    void Store(double* p) const {
+#ifdef __SSE2__
+        for (std::size_t i = 0; i < N / 2; i++) _mm_storeu_pd(p + 2 * i, r[i]);
+#else
+        for (std::size_t i = 0; i < N; i++) p[i] = r[i];
+#endif
+    }
+
+    /**
+     * @brief Gets one lane.
+     *
+     * @param i Lane index.
+     * @return double The value.
+     */
+    double lane(std::size_t i) const {
+        double values[N];
+        Store(values);
+        return values[i];
+    }
+
+#ifdef __SSE2__
+    Lanes& operator+=(const Lanes& o) { for (std::size_t i = 0; i < N / 2; i++) r[i] = _mm_add_pd(r[i], o.r[i]); return *this; }
+    Lanes& operator-=(const Lanes& o) { for (std::size_t i = 0; i < N / 2; i++) r[i] = _mm_sub_pd(r[i], o.r[i]); return *this; }
+    Lanes& operator*=(const Lanes& o) { for (std::size_t i = 0; i < N / 2; i++) r[i] = _mm_mul_pd(r[i], o.r[i]); return *this; }
+    Lanes& operator/=(const Lanes& o) { for (std::size_t i = 0; i < N / 2; i++) r[i] = _mm_div_pd(r[i], o.r[i]); return *this; }
+#else
+    Lanes& operator+=(const Lanes& o) { for (std::size_t i = 0; i < N; i++) r[i] += o.r[i]; return *this; }
+    Lanes& operator-=(const Lanes& o) { for (std::size_t i = 0; i < N; i++) r[i] -= o.r[i]; return *this; }
+    Lanes& operator*=(const Lanes& o) { for (std::size_t i = 0; i < N; i++) r[i] *= o.r[i]; return *this; }
+    Lanes& operator/=(const Lanes& o) { for (std::size_t i = 0; i < N; i++) r[i] /= o.r[i]; return *this; }
+#endif
+};
+
+template <std::size_t N> Lanes<N> operator+(Lanes<N> a, const Lanes<N>& b) { return a += b; }
+template <std::size_t N> Lanes<N> operator-(Lanes<N> a, const Lanes<N>& b) { return a -= b; }
+template <std::size_t N> Lanes<N> operator*(Lanes<N> a, const Lanes<N>& b) { return a *= b; }
+template <std::size_t N> Lanes<N> operator/(Lanes<N> a, const Lanes<N>& b) { return a /= b; }
+
+/**
+ * @brief 1.0 where a <= b, 0.0 elsewhere, for use as a multiplier instead of a branch.
+ *
+ * @param a Left side.
+ * @param b Right side.
+ * @return double The mask.
+ */
+inline double LessEqualMask(double a, double b) {
+    return a <= b ? 1.0 : 0.0;
+}
+
+/**
+ * @brief 1.0 in the lanes where a <= b, 0.0 elsewhere.
+ *
+ * @param a Left side.
+ * @param b Right side.
+ * @return Lanes<N> The mask.
+ */
+template <std::size_t N>
+Lanes<N> LessEqualMask(const Lanes<N>& a, const Lanes<N>& b) {
+    Lanes<N> m;
+#ifdef __SSE2__
+    const __m128d one = _mm_set1_pd(1.0);
+    for (std::size_t i = 0; i < N / 2; i++) m.r[i] = _mm_and_pd(_mm_cmple_pd(a.r[i], b.r[i]), one);
+#else
+    for (std::size_t i = 0; i < N; i++) m.r[i] = a.r[i] <= b.r[i] ? 1.0 : 0.0;
+#endif
+    return m;
+}
+
+#endif // !LANES_H
@@ -0,0 +1,92 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <cstddef>
+
+/**
+ * @brief A matrix whose size is fixed at compile time.
+ *
+ * @details Every loop bound is a template parameter, so the compiler
+ * unrolls the products completely and keeps small matrices in registers;
+ * there is no allocation and no run-time size check. T is double, or Lanes
+ * to work on several independent matrices at once.
+ *
+ * @tparam T Element type.
+ * @tparam R Rows.
+ * @tparam C Columns.
+ */
+template <typename T, std::size_t R, std::size_t C>
+struct Matrix {
+    T m[R][C]; ///< Elements, row-major
+
+    T& operator()(std::size_t r, std::size_t c) { return m[r][c]; }
+    const T& operator()(std::size_t r, std::size_t c) const { return m[r][c]; }
+
+    /**
+     * @brief Makes a matrix with every element set to one value.
+     *
+     * @param value The value.
+     * @return Matrix The matrix.
+     */
+    static Matrix Filled(const T& value) {
+        Matrix a;
+        for (std::size_t r = 0; r < R; r++)
+            for (std::size_t c = 0; c < C; c++) a.m[r][c] = value;
+        return a;
+    }
+
+    /**
+     * @brief Makes the identity matrix.
+     *
+     * @return Matrix The identity.
+     */
+    static Matrix Identity() {
+        static_assert(R == C, "only square matrices have an identity");
+        Matrix a = Filled(T(0.0));
+        for (std::size_t i = 0; i < R; i++) a.m[i][i] = T(1.0);
+        return a;
+    }
+};
+
+template <typename T, std::size_t R, std::size_t K, std::size_t C>
+Matrix<T, R, C> operator*(const Matrix<T, R, K>& a, const Matrix<T, K, C>& b) {
+    Matrix<T, R, C> p;
+    for (std::size_t r = 0; r < R; r++) {
+        for (std::size_t c = 0; c < C; c++) {
+            T sum = a.m[r][0] * b.m[0][c];
+            for (std::size_t k = 1; k < K; k++) sum += a.m[r][k] * b.m[k][c];
+            p.m[r][c] = sum;
+        }
+    }
+    return p;
+}
+
+template <typename T, std::size_t R, std::size_t C>
+Matrix<T, R, C> operator+(Matrix<T, R, C> a, const Matrix<T, R, C>& b) {
+    for (std::size_t r = 0; r < R; r++)
+        for (std::size_t c = 0; c < C; c++) a.m[r][c] += b.m[r][c];
+    return a;
+}
+
+template <typename T, std::size_t R, std::size_t C>
+Matrix<T, R, C> operator-(Matrix<T, R, C> a, const Matrix<T, R, C>& b) {
+    for (std::size_t r = 0; r < R; r++)
+        for (std::size_t c = 0; c < C; c++) a.m[r][c] -= b.m[r][c];
+    return a;
+}
+
+/**
+ * @brief Transposes a matrix.
+ *
+ * @param a The matrix.
+ * @return Matrix<T, C, R> The transpose.
+ */
+template <typename T, std::size_t R, std::size_t C>
+Matrix<T, C, R> Transpose(const Matrix<T, R, C>& a) {
+    Matrix<T, C, R> t;
+    for (std::size_t r = 0; r < R; r++)
+        for (std::size_t c = 0; c < C; c++) t.m[c][r] = a.m[r][c];
+    return t;
+}
+
+#endif // !MATRIX_H
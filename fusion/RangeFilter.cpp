@@ -0,0 +1,233 @@
+#include "RangeFilter.hpp"
+#include <limits>
+
+/**
+ * @brief Makes the covariance of a filter with no estimate.
+ *
+ * @param config Noise settings.
+ * @return Matrix<T, 2, 2> The covariance.
+ */
+template <typename T>
+static Matrix<T, 2, 2> InitialCovariance(const RangeFilterConfig& config) {
+    Matrix<T, 2, 2> P = Matrix<T, 2, 2>::Filled(T(0.0));
+    P(0, 0) = T(config.initialRangeVariance);
+    P(1, 1) = T(config.initialRateVariance);
+    return P;
+}
+
+/**
+ * @brief Constructs a filter with no estimate.
+ *
+ * @param config Noise settings.
+ */
+RangeFilter::RangeFilter(const RangeFilterConfig& config)
+    : config(config), speed(0.0), speedAtRadar(0.0), radarTime(0), started(false), rejections(0.0), readings(0), rejected(0) {
+    state.x = Matrix<double, 2, 1>::Filled(0.0);
+    state.P = InitialCovariance<double>(config);
+}
+
+/**
+ * @brief Takes an ego speed reading.
+ *
+ * @param speed Speed in sensor units (km/h).
+ */
+void RangeFilter::OnSpeed(double speed) {
+    this->speed = speed * KMH_TO_MS;
+}
+
+/**
+ * @brief Takes a radar reading and updates the estimate.
+ *
+ * The first reading corrects the vague initial estimate without a
+ * prediction; later ones are predicted over the time since the previous
+ * reading and gated.
+ *
+ * @param range Range in metres.
+ * @param time When the reading was taken.
+ * @return true if the reading was used.
+ */
+bool RangeFilter::OnRadar(double range, TimestampNs time) {
+    readings++;
+    const double dt = started ? (time - radarTime) * 1e-9 : 0.0;
+    const double change = started ? speed - speedAtRadar : 0.0;
+    const double accepted = RangeFilterStep<double>(state, rejections, range, change, dt, config);
+    started = true;
+    speedAtRadar = speed;
+    radarTime = time;
+    rejected += accepted == 0.0;
+    return accepted != 0.0;
+}
+
+/**
+ * @brief Checks whether a radar reading has been taken.
+ *
+ * @return true once the estimate exists.
+ */
+bool RangeFilter::hasEstimate() const {
+    return started;
+}
+
+/**
+ * @brief Gets the estimated range.
+ *
+ * @return double Metres.
+ */
+double RangeFilter::getRange() const {
+    return state.x(0, 0);
+}
+
+/**
+ * @brief Gets the estimated closing rate.
+ *
+ * @return double Metres per second; positive while the gap shrinks.
+ */
+double RangeFilter::getClosingRate() const {
+    return -state.x(1, 0);
+}
+
+/**
+ * @brief Gets the estimated time until the gap closes.
+ *
+ * @return double Seconds, or infinity if the gap is not shrinking.
+ */
+double RangeFilter::getTimeToCollision() const {
+    const double closing = getClosingRate();
+    return closing > 0.0 ? getRange() / closing : std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief Gets the number of radar readings rejected as outliers.
+ *
+ * @return std::uint64_t Rejected readings.
+ */
+std::uint64_t RangeFilter::getRejected() const {
+    return rejected;
+}
+
+/**
+ * @brief Gets the number of radar readings taken.
+ *
+ * @return std::uint64_t Readings.
+ */
+std::uint64_t RangeFilter::getReadings() const {
+    return readings;
+}
+
+/**
+ * @brief Gets the estimate, the settings and the counters.
+ *
+ * @param now The current time, which the last radar step's age is taken from.
+ * @return RangeFilterState The state.
+ */
+RangeFilterState RangeFilter::getState(TimestampNs now) const {
+    return RangeFilterState{config, state, speed, speedAtRadar, now - radarTime, started, rejections, readings, rejected};
+}
+
+/**
+ * @brief Takes up a saved state, settings included.
+ *
+ * @param saved The state.
+ * @param now The current time, which the last radar step is placed before.
+ */
+void RangeFilter::setState(const RangeFilterState& saved, TimestampNs now) {
+    config = saved.config;
+    state = saved.state;
+    speed = saved.speed;
+    speedAtRadar = saved.speedAtRadar;
+    radarTime = now - saved.radarAge;
+    started = saved.started;
+    rejections = saved.rejections;
+    readings = saved.readings;
+    rejected = saved.rejected;
+}
+
+/**
+ * @brief Constructs filters with no estimate.
+ *
+ * @param cars Number of cars.
+ * @param config Noise settings.
+ */
+FleetRangeFilter::FleetRangeFilter(std::size_t cars, const RangeFilterConfig& config)
+    : config(config), cars(cars), states((cars + FUSION_LANES - 1) / FUSION_LANES),
+      lastSpeed(states.size(), Group(0.0)), rejections(states.size(), Group(0.0)), started(false) {
+    for (KalmanState<Group, 2>& s : states) {
+        s.x = Matrix<Group, 2, 1>::Filled(Group(0.0));
+        s.P = InitialCovariance<Group>(config);
+    }
+}
+
+/**
+ * @brief Steps every car by one radar and speed reading.
+ *
+ * Readings are loaded into lanes a group at a time; the lanes past the
+ * last car of a partial group are fed zeros and never read.
+ *
+ * @param dt Time since the last step, s.
+ * @param radar Range of each car, m.
+ * @param speed Ego speed of each car, sensor units (km/h).
+ * @return std::size_t Radar readings rejected in this step.
+ */
+std::size_t FleetRangeFilter::Step(double dt, const double* radar, const double* speed) {
+    // The first step only corrects the initial estimate, like the first reading of a RangeFilter
+    const Group step(started ? dt : 0.0);
+    Group used(0.0);
+    for (std::size_t g = 0; g < states.size(); g++) {
+        const std::size_t first = g * FUSION_LANES;
+        Group z, v;
+        if (first + FUSION_LANES <= cars) {
+            z = Group::Load(radar + first);
+            v = Group::Load(speed + first) * Group(KMH_TO_MS);
+        } else {
+            double lanes[2][FUSION_LANES] = {};
+            for (std::size_t i = 0; first + i < cars; i++) {
+                lanes[0][i] = radar[first + i];
+                lanes[1][i] = speed[first + i];
+            }
+            z = Group::Load(lanes[0]);
+            v = Group::Load(lanes[1]) * Group(KMH_TO_MS);
+        }
+        const Group change = started ? v - lastSpeed[g] : Group(0.0);
+        const Group accepted = RangeFilterStep<Group>(states[g], rejections[g], z, change, step, config);
+        lastSpeed[g] = v;
+        used += accepted;
+    }
+    started = true;
+    // Padding lanes of a partial group see a constant zero range and are always accepted
+    double lanes[FUSION_LANES];
+    used.Store(lanes);
+    double total = 0.0;
+    for (double n : lanes) {
+        total += n;
+    }
+    const double padding = (double)(states.size() * FUSION_LANES - cars);
+    return cars - (std::size_t)(total - padding + 0.5);
+}
+
+/**
+ * @brief Gets the estimated range of a car.
+ *
+ * @param car Car index.
+ * @return double Metres.
+ */
+double FleetRangeFilter::getRange(std::size_t car) const {
+    return states[car / FUSION_LANES].x(0, 0).lane(car % FUSION_LANES);
+}
+
+/**
+ * @brief Gets the estimated closing rate of a car.
+ *
+ * @param car Car index.
+ * @return double Metres per second; positive while the gap shrinks.
+ */
+double FleetRangeFilter::getClosingRate(std::size_t car) const {
+    return -states[car / FUSION_LANES].x(1, 0).lane(car % FUSION_LANES);
+}
+
+/**
+ * @brief Gets the number of cars.
+ *
+ * @return std::size_t The car count.
+ */
+std::size_t FleetRangeFilter::size() const {
+    return cars;
+}
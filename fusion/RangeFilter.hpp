@@ -0,0 +1,260 @@
+#ifndef RANGE_FILTER_H
+#define RANGE_FILTER_H
+
+#include "KalmanFilter.hpp"
+#include "../telemetry/SensorHistory.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define KMH_TO_MS (1.0 / 3.6) ///< Speed sensor units to metres per second
+
+/**
+ * @brief Noise and gating settings of the range filter.
+ */
+struct RangeFilterConfig {
+    double accelerationNoise; ///< Standard deviation of the lead vehicle's unmodelled acceleration, m/s^2
+    double radarNoise; ///< Standard deviation of a radar range reading, m
+    double gate; ///< Largest accepted squared innovation in standard deviations
+    double initialRangeVariance; ///< Variance of the range before the first reading, m^2
+    double initialRateVariance; ///< Variance of the range rate before the first reading, (m/s)^2
+    double maxRejections; ///< Readings rejected in a row after which the next one is used regardless
+
+    /**
+     * @brief Gets the settings for the simulated sensors.
+     *
+     * @return RangeFilterConfig The defaults.
+     */
+    static RangeFilterConfig Defaults() { return RangeFilterConfig{3.0, 1.0, 16.0, 1e4, 1e2, 3.0}; }
+};
+
+/**
+ * @brief Steps a constant-velocity filter of [range, range rate] by one radar reading.
+ *
+ * @details The lead vehicle is assumed to hold its speed, so the range rate
+ * only changes through noise and through the ego speed: when the car
+ * speeds up by dv the gap closes dv faster. That change enters as a known
+ * input, which is how the speed sensor is fused with the radar.
+ *
+ * @tparam T double for one car, Lanes for several.
+ * @param s The filter.
+ * @param rejections Readings rejected in a row; updated.
+ * @param radar Range reading, m.
+ * @param speedChange Ego speed change since the last step, m/s.
+ * @param dt Time since the last step, s.
+ * @param config Noise settings.
+ * @return T 1 where the reading was used, 0 where it was gated out.
+ */
+template <typename T>
+FUSION_INLINE T RangeFilterStep(KalmanState<T, 2>& s, T& rejections, const T& radar, const T& speedChange, const T& dt,
+                  const RangeFilterConfig& config) {
+    Matrix<T, 2, 2> F = Matrix<T, 2, 2>::Identity();
+    F(0, 1) = dt;
+    Matrix<T, 2, 1> u;
+    u(0, 0) = T(0.0);
+    u(1, 0) = T(0.0) - speedChange;
+    // White-noise acceleration integrated over the step
+    const T q = T(config.accelerationNoise * config.accelerationNoise);
+    const T dt2 = dt * dt;
+    Matrix<T, 2, 2> Q;
+    Q(0, 0) = dt2 * dt2 * q * T(0.25);
+    Q(0, 1) = dt2 * dt * q * T(0.5);
+    Q(1, 0) = Q(0, 1);
+    Q(1, 1) = dt2 * q;
+    KalmanPredict(s, F, u, Q);
+
+    Matrix<T, 1, 1> z;
+    z(0, 0) = radar;
+    Matrix<T, 1, 2> H;
+    H(0, 0) = T(1.0);
+    H(0, 1) = T(0.0);
+    Matrix<T, 1, 1> R;
+    R(0, 0) = T(config.radarNoise * config.radarNoise);
+    const T force = LessEqualMask(T(config.maxRejections), rejections);
+    const T accepted = KalmanUpdate(s, z, H, R, config.gate, force);
+    rejections = (rejections + T(1.0)) * (T(1.0) - accepted);
+    return accepted;
+}
+
+/**
+ * @brief Everything a RangeFilter holds, as kept in a checkpoint.
+ *
+ * The time of the last radar step is kept as its age, since timestamps are
+ * only meaningful within one process.
+ */
+struct RangeFilterState {
+    RangeFilterConfig config; ///< Noise settings
+    KalmanState<double, 2> state; ///< [range, range rate]
+    double speed; ///< Latest ego speed, m/s
+    double speedAtRadar; ///< Ego speed at the last radar step, m/s
+    TimestampNs radarAge; ///< Time between the last radar step and the save
+    bool started; ///< Whether a radar reading has been taken
+    double rejections; ///< Readings rejected in a row
+    std::uint64_t readings; ///< Radar readings taken
+    std::uint64_t rejected; ///< Radar readings gated out
+};
+
+/**
+ * @brief Range and closing rate of the obstacle ahead of one car, from its radar and speed samples.
+ *
+ * Not thread-safe; samples of one car are fed by one thread.
+ */
+class RangeFilter {
+public:
+    /**
+     * @brief Constructs a filter with no estimate.
+     *
+     * @param config Noise settings.
+     */
+    explicit RangeFilter(const RangeFilterConfig& config = RangeFilterConfig::Defaults());
+
+    /**
+     * @brief Takes an ego speed reading.
+     *
+     * @param speed Speed in sensor units (km/h).
+     */
+    void OnSpeed(double speed);
+
+    /**
+     * @brief Takes a radar reading and updates the estimate.
+     *
+     * @param range Range in metres.
+     * @param time When the reading was taken.
+     * @return true if the reading was used, false if it was rejected as an outlier.
+     */
+    bool OnRadar(double range, TimestampNs time);
+
+    /**
+     * @brief Checks whether a radar reading has been taken.
+     *
+     * @return true once the estimate exists.
+     */
+    bool hasEstimate() const;
+
+    /**
+     * @brief Gets the estimated range.
+     *
+     * @return double Metres.
+     */
+    double getRange() const;
+
+    /**
+     * @brief Gets the estimated closing rate.
+     *
+     * @return double Metres per second; positive while the gap shrinks.
+     */
+    double getClosingRate() const;
+
+    /**
+     * @brief Gets the estimated time until the gap closes.
+     *
+     * @return double Seconds, or infinity if the gap is not shrinking.
+     */
+    double getTimeToCollision() const;
+
+    /**
+     * @brief Gets the number of radar readings rejected as outliers.
+     *
+     * @return std::uint64_t Rejected readings.
+     */
+    std::uint64_t getRejected() const;
+
+    /**
+     * @brief Gets the number of radar readings taken.
+     *
+     * @return std::uint64_t Readings.
+     */
+    std::uint64_t getReadings() const;
+
+    /**
+     * @brief Gets the estimate, the settings and the counters.
+     *
+     * @param now The current time, which the last radar step's age is taken from.
+     * @return RangeFilterState The state.
+     */
+    RangeFilterState getState(TimestampNs now) const;
+
+    /**
+     * @brief Takes up a saved state, settings included.
+     *
+     * @param saved The state.
+     * @param now The current time, which the last radar step is placed before.
+     */
+    void setState(const RangeFilterState& saved, TimestampNs now);
+
+private:
+    RangeFilterConfig config; ///< Noise settings
+    KalmanState<double, 2> state; ///< [range, range rate]
+    double speed; ///< Latest ego speed, m/s
+    double speedAtRadar; ///< Ego speed at the last radar step, m/s
+    TimestampNs radarTime; ///< Time of the last radar step
+    bool started; ///< Whether a radar reading has been taken
+    double rejections; ///< Readings rejected in a row
+    std::uint64_t readings; ///< Radar readings taken
+    std::uint64_t rejected; ///< Radar readings gated out
+};
+
+/**
+ * @brief Range filters for a whole fleet, stepped together at a fixed rate.
+ *
+ * @details Filters are stored FUSION_LANES cars to a group, each matrix
+ * element holding the lanes of every car in the group, and each group is
+ * stepped by RangeFilterStep on Lanes. The same template code as the
+ * single-car filter therefore runs on packed SSE2 registers, with the
+ * outlier gate as a mask instead of a branch.
+ */
+class FleetRangeFilter {
+public:
+    /**
+     * @brief Constructs filters with no estimate.
+     *
+     * @param cars Number of cars.
+     * @param config Noise settings.
+     */
+    explicit FleetRangeFilter(std::size_t cars, const RangeFilterConfig& config = RangeFilterConfig::Defaults());
+
+    /**
+     * @brief Steps every car by one radar and speed reading.
+     *
+     * @param dt Time since the last step, s.
+     * @param radar Range of each car, m.
+     * @param speed Ego speed of each car, sensor units (km/h).
+     * @return std::size_t Radar readings rejected as outliers in this step.
+     */
+    std::size_t Step(double dt, const double* radar, const double* speed);
+
+    /**
+     * @brief Gets the estimated range of a car.
+     *
+     * @param car Car index.
+     * @return double Metres.
+     */
+    double getRange(std::size_t car) const;
+
+    /**
+     * @brief Gets the estimated closing rate of a car.
+     *
+     * @param car Car index.
+     * @return double Metres per second; positive while the gap shrinks.
+     */
+    double getClosingRate(std::size_t car) const;
+
+    /**
+     * @brief Gets the number of cars.
+     *
+     * @return std::size_t The car count.
+     */
+    std::size_t size() const;
+
+private:
+    typedef Lanes<FUSION_LANES> Group; ///< One value for each car of a group
+
+    RangeFilterConfig config; ///< Noise settings
+    std::size_t cars; ///< Number of cars
+    std::vector<KalmanState<Group, 2>> states; ///< One filter group per FUSION_LANES cars
+    std::vector<Group> lastSpeed; ///< Ego speed at the last step, m/s
+    std::vector<Group> rejections; ///< Readings rejected in a row
+    bool started; ///< Whether a step has been taken
+};
+
+#endif // !RANGE_FILTER_H
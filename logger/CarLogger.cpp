@@ -1,8 +1,11 @@
 #include "CarLogger.hpp"
+#include "../metrics/CarMetrics.hpp"
 
 // Define the static variable in exactly one place in the implementation file
 int Logger::message_number = 0; ///< Static variable to track the number of log messages
 
+static thread_local bool Thread_Silenced = false; ///< Set by Logger::setThreadSilenced for the calling thread
+
 /**
  * @brief Retrieves the singleton instance of the Logger.
  * 
@@ -18,7 +21,7 @@ Logger& Logger::getInstance() {
 }
 
 // Private constructor
-Logger::Logger() {
+Logger::Logger() : enabled(true), level((int)LogLevel::INFO), console(true), fileOpen(false) {
     // No need to initialize message_number here since it’s initialized above
 }
 
@@ -31,8 +34,146 @@ Logger::Logger() {
  * 
  * @param message The message to log.
  */
-void Logger::log(const std::string& message) {
-    ++message_number; // Increment the log message counter
+void Logger::log(std::string_view message) {
+    log(LogLevel::INFO, message);
+}
+
+/**
+ * @brief Logs a message at a given level to every sink.
+ * 
+ * Messages other than INFO carry their level after the number.
+ * 
+ * @param level The severity of the message.
+ * @param message The message to log.
+ */
+void Logger::log(LogLevel level, std::string_view message) {
+    if (!isEnabled(level)) {
+        return; // Output is suppressed
+    }
+    static const char* const names[] = {" DEBUG", "", " WARNING", " ERROR"};
     std::lock_guard<std::mutex> guard(logMutex); // Locking for thread safety
-    std::cout << "CAR LOGGER (" << message_number << "): " << message << std::endl; // Output the log message
+    ++message_number; // Increment the log message counter under the lock
+    CarMetrics::get().logMessages->Increment(); 
+    if (console.load(std::memory_order_relaxed)) {
+        std::cout << "CAR LOGGER (" << message_number << ")" << names[(int)level] << ": " << message << std::endl; // Output the log message
+    }
+    if (fileOpen.load(std::memory_order_relaxed)) {
+        file << "CAR LOGGER (" << message_number << ")" << names[(int)level] << ": " << message << '\n'; 
+    }
+}
+
+/**
+ * @brief Enables or disables output.
+ * 
+ * @param on true to print messages, false to drop them.
+ */
+void Logger::setEnabled(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Checks the switch set by setEnabled.
+ * 
+ * @return true if output is enabled.
+ */
+bool Logger::getEnabled() const {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Drops the calling thread's messages, or stops doing so.
+ * 
+ * @param on true to drop the calling thread's messages.
+ * @return true if they were dropped before the call.
+ */
+bool Logger::setThreadSilenced(bool on) {
+    const bool previous = Thread_Silenced; 
+    Thread_Silenced = on; 
+    return previous; 
+}
+
+/**
+ * @brief Checks whether INFO messages of the calling thread are written anywhere.
+ * 
+ * @return true if log(message) writes messages.
+ */
+bool Logger::isEnabled() const {
+    return isEnabled(LogLevel::INFO);
+}
+
+/**
+ * @brief Checks whether messages of a level from the calling thread are written anywhere.
+ * 
+ * @param level The severity.
+ * @return true if log(level, message) writes messages.
+ */
+bool Logger::isEnabled(LogLevel level) const {
+    return !Thread_Silenced && enabled.load(std::memory_order_relaxed) && 
+           (int)level >= this->level.load(std::memory_order_relaxed) && level != LogLevel::OFF && 
+           (console.load(std::memory_order_relaxed) || fileOpen.load(std::memory_order_relaxed));
+}
+
+/**
+ * @brief Sets the lowest level that is written.
+ * 
+ * @param level The level.
+ */
+void Logger::setLevel(LogLevel level) {
+    this->level.store((int)level, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the lowest level that is written.
+ * 
+ * @return LogLevel The level.
+ */
+LogLevel Logger::getLevel() const {
+    return (LogLevel)level.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Turns writing to standard output on or off.
+ * 
+ * @param on true to write to standard output.
+ */
+void Logger::setConsoleSink(bool on) {
+    console.store(on, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Appends messages to a file as well, or stops doing so.
+ * 
+ * @param path The file to append to; empty closes the current file.
+ * @return true if the file is open, or was closed on request.
+ */
+bool Logger::setFileSink(const std::string& path) {
+    std::lock_guard<std::mutex> guard(logMutex); 
+    fileOpen.store(false, std::memory_order_relaxed);
+    if (file.is_open()) {
+        file.close(); 
+    }
+    if (path.empty()) {
+        return true; 
+    }
+    file.open(path, std::ios::app); 
+    fileOpen.store(file.is_open(), std::memory_order_relaxed);
+    return file.is_open(); 
+}
+
+/**
+ * @brief Parses a level name.
+ * 
+ * @param name debug, info, warning, error or off.
+ * @param level Receives the level if the name is known.
+ * @return true if the name is known.
+ */
+bool Logger::ParseLevel(const std::string& name, LogLevel& level) {
+    static const char* const names[] = {"debug", "info", "warning", "error", "off"};
+    for (int i = 0; i <= (int)LogLevel::OFF; i++) {
+        if (name == names[i]) {
+            level = (LogLevel)i; 
+            return true; 
+        }
+    }
+    return false; 
 }
@@ -2,8 +2,22 @@
 #define LOGGER_HPP
 
 #include <iostream>
+#include <fstream>
 #include <mutex>
+#include <atomic>
 #include <string>
+#include <string_view>
+
+/**
+ * @brief Severity of a log message; messages below the logger's level are dropped.
+ */
+enum class LogLevel {
+    DEBUG = 0,   /**< Detail for tracing a single car */
+    INFO = 1,    /**< Normal activity; the level of log(message) */
+    WARNING = 2, /**< Alerts and anomalies */
+    ERROR = 3,   /**< Failures */
+    OFF = 4      /**< As a level: drop every message */
+};
 
 /**
  * @brief Logger class for logging messages in a thread-safe manner.
@@ -31,11 +45,103 @@ public:
     /**
      * @brief Logs a message to the output.
      * 
-     * This method logs the specified message in a thread-safe manner.
+     * This method logs the specified message in a thread-safe manner, at INFO level.
+     * Literals and std::string both convert to the view without allocating.
+     * 
+     * @param message The message to log.
+     */
+    void log(std::string_view message);
+
+    /**
+     * @brief Logs a message at a given level to every sink.
      * 
+     * @param level The severity of the message.
      * @param message The message to log.
      */
-    void log(const std::string& message);
+    void log(LogLevel level, std::string_view message);
+
+    /**
+     * @brief Enables or disables output.
+     * 
+     * While disabled, log() returns immediately. Used to keep bulk
+     * construction of large fleets quiet.
+     * 
+     * @param on true to print messages, false to drop them.
+     */
+    void setEnabled(bool on);
+
+    /**
+     * @brief Checks the switch set by setEnabled, whatever the level and sinks.
+     * 
+     * @return true if output is enabled.
+     */
+    bool getEnabled() const;
+
+    /**
+     * @brief Drops the calling thread's messages, or stops doing so.
+     * 
+     * Other threads keep logging. Used to keep bulk construction of large
+     * fleets quiet without losing what the rest of the process logs.
+     * 
+     * @param on true to drop the calling thread's messages.
+     * @return true if they were dropped before the call.
+     */
+    static bool setThreadSilenced(bool on);
+
+    /**
+     * @brief Checks whether INFO messages of the calling thread are written anywhere.
+     * 
+     * Callers that build expensive messages can test this first.
+     * 
+     * @return true if log(message) writes messages.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Checks whether messages of a level from the calling thread are written anywhere.
+     * 
+     * @param level The severity.
+     * @return true if log(level, message) writes messages.
+     */
+    bool isEnabled(LogLevel level) const;
+
+    /**
+     * @brief Sets the lowest level that is written.
+     * 
+     * @param level The level; OFF drops everything.
+     */
+    void setLevel(LogLevel level);
+
+    /**
+     * @brief Gets the lowest level that is written.
+     * 
+     * @return LogLevel The level.
+     */
+    LogLevel getLevel() const;
+
+    /**
+     * @brief Turns writing to standard output on or off.
+     * 
+     * @param on true to write to standard output; it is on by default.
+     */
+    void setConsoleSink(bool on);
+
+    /**
+     * @brief Appends messages to a file as well, or stops doing so.
+     * 
+     * @param path The file to append to; empty closes the current file.
+     * @return true if the file is open, or was closed on request.
+     */
+    bool setFileSink(const std::string& path);
+
+    /**
+     * @brief Parses a level name: debug, info, warning, error or off.
+     * 
+     * @param name The name, in lower case.
+     * @param level Receives the level if the name is known.
+     * @return true if the name is known.
+     */
+    static bool ParseLevel(const std::string& name, LogLevel& level);
 
 private:
     Logger(); ///< Private constructor to prevent direct instantiation
@@ -43,7 +149,47 @@ private:
     static int message_number; ///< Static variable to track the number of messages
 
     std::mutex logMutex; ///< Mutex for thread-safe logging
+
+    std::atomic<bool> enabled; ///< Whether log() prints messages
+
+    std::atomic<int> level; ///< Lowest LogLevel written
+
+    std::atomic<bool> console; ///< Whether messages go to standard output
+
+    std::atomic<bool> fileOpen; ///< Whether messages go to file
+
+    std::ofstream file; ///< File sink, guarded by logMutex
+};
+
+/**
+ * @brief Drops the constructing thread's messages for the lifetime of the object when asked to.
+ */
+class LogSilencer {
+public:
+    /**
+     * @brief Silences the calling thread if silence is set.
+     * 
+     * @param silence Whether to drop the thread's messages.
+     */
+    explicit LogSilencer(bool silence) : active(silence), previous(silence && Logger::setThreadSilenced(true)) {
+    }
+
+    /**
+     * @brief Puts back the thread's state found at construction.
+     */
+    ~LogSilencer() {
+        if (active) {
+            Logger::setThreadSilenced(previous);
+        }
+    }
+
+    // Deleted copy constructor and assignment operator
+    LogSilencer(const LogSilencer&) = delete;
+    LogSilencer& operator=(const LogSilencer&) = delete;
+
+private:
+    bool active; ///< Whether the constructor silenced the thread
+    bool previous; ///< Whether the thread was silenced before
 };
 
 #endif // LOGGER_HPP
-// add configuration levels 
@@ -0,0 +1,267 @@
+#include "AllocationAudit.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <execinfo.h>
+#include <new>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One allocating stack and what it allocated.
+ */
+struct AuditSite {
+    std::atomic<std::uint64_t> key; ///< Hash of the frames; 0 while the slot is free
+    std::atomic<bool> ready; ///< Set once frames is written
+    void* frames[ALLOCATION_AUDIT_DEPTH]; ///< Return addresses, innermost first
+    int depth; ///< Valid entries of frames
+    std::atomic<std::uint64_t> count; ///< Allocations
+    std::atomic<std::uint64_t> bytes; ///< Bytes requested
+};
+
+static AuditSite Sites[ALLOCATION_AUDIT_SITES]; ///< Open-addressed by key; zero-initialised before any allocation
+static std::atomic<std::uint64_t> Overflow_Count(0); ///< Allocations of sites that found the table full
+static std::atomic<std::uint64_t> Tick_Allocations(0); ///< Allocations counted over all sites
+static std::atomic<bool> Armed(false); ///< Whether ticks are audited
+static thread_local int Tick_Depth = 0; ///< Ticks the calling thread is inside
+
+#ifdef CARECU_ALLOC_AUDIT
+
+static thread_local bool In_Audit = false; ///< Set while recording, so the unwinder's own allocations are not audited
+
+/**
+ * @brief Records the calling stack of an allocation made inside a tick.
+ *
+ * Never inlined, so the frames to skip are always this function and operator new.
+ *
+ * @param size Bytes requested.
+ */
+__attribute__((noinline)) static void RecordAllocation(std::size_t size) {
+    if (Tick_Depth == 0 || In_Audit || !Armed.load(std::memory_order_relaxed)) {
+        return;
+    }
+    In_Audit = true;
+    void* stack[ALLOCATION_AUDIT_DEPTH + 2];
+    const int captured = backtrace(stack, ALLOCATION_AUDIT_DEPTH + 2);
+    const int skip = std::min(captured, 2);
+    std::uint64_t key = 14695981039346656037ull;
+    for (int i = skip; i < captured; i++) {
+        key = (key ^ (std::uint64_t)(std::uintptr_t)stack[i]) * 1099511628211ull;
+    }
+    key |= 1; // 0 marks a free slot
+    Tick_Allocations.fetch_add(1, std::memory_order_relaxed);
+    for (std::size_t probe = 0; probe < ALLOCATION_AUDIT_SITES; probe++) {
+        AuditSite& site = Sites[(key + probe) % ALLOCATION_AUDIT_SITES];
+        std::uint64_t expected = 0;
+        if (site.key.compare_exchange_strong(expected, key, std::memory_order_acq_rel)) {
+            site.depth = captured - skip;
+            std::memcpy(site.frames, stack + skip, sizeof(void*) * site.depth);
+            site.ready.store(true, std::memory_order_release);
+        } else if (expected != key) {
+            continue;
+        }
+        site.count.fetch_add(1, std::memory_order_relaxed);
+        site.bytes.fetch_add(size, std::memory_order_relaxed);
+        In_Audit = false;
+        return;
+    }
+    Overflow_Count.fetch_add(1, std::memory_order_relaxed);
+    In_Audit = false;
+}
+
+static void* AuditedAllocate(std::size_t size) {
+    RecordAllocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+static void* AuditedAllocateAligned(std::size_t size, std::size_t alignment) {
+    RecordAllocation(size);
+    void* p = nullptr;
+    return posix_memalign(&p, std::max(alignment, sizeof(void*)), size == 0 ? 1 : size) == 0 ? p : nullptr;
+}
+
+void* operator new(std::size_t size) {
+    void* p = AuditedAllocate(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    void* p = AuditedAllocate(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return AuditedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return AuditedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* p = AuditedAllocateAligned(size, (std::size_t)alignment);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    void* p = AuditedAllocateAligned(size, (std::size_t)alignment);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AuditedAllocateAligned(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AuditedAllocateAligned(size, (std::size_t)alignment);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif // CARECU_ALLOC_AUDIT
+
+/**
+ * @brief Checks whether the build replaces operator new.
+ *
+ * @return true if built with CARECU_ALLOC_AUDIT.
+ */
+bool AllocationAudit::isCompiledIn() {
+#ifdef CARECU_ALLOC_AUDIT
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Starts or stops counting allocations made inside ticks.
+ *
+ * The first backtrace loads the unwinder, which allocates; it is taken
+ * here, outside any tick.
+ *
+ * @param on true to count.
+ */
+void AllocationAudit::Arm(bool on) {
+    if (on) {
+        void* stack[2];
+        backtrace(stack, 2);
+    }
+    Armed.store(on, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Marks the calling thread as inside a tick.
+ */
+void AllocationAudit::BeginTick() {
+    Tick_Depth++;
+}
+
+/**
+ * @brief Marks the end of the innermost tick of the calling thread.
+ */
+void AllocationAudit::EndTick() {
+    Tick_Depth--;
+}
+
+/**
+ * @brief Gets the number of allocations counted so far.
+ *
+ * @return std::uint64_t Allocations made inside ticks while armed.
+ */
+std::uint64_t AllocationAudit::getTickAllocations() {
+    return Tick_Allocations.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Demangles the function name inside one line of backtrace_symbols.
+ *
+ * @param line A line such as "binary(_ZN3Car13DisplayStatusEv+0x1c) [0x4051fc]".
+ * @return std::string The line with the name demangled, or the line itself.
+ */
+static std::string DemangleFrame(const char* line) {
+    const char* open = std::strchr(line, '(');
+    const char* plus = open ? std::strchr(open, '+') : nullptr;
+    if (open == nullptr || plus == nullptr || plus == open + 1) {
+        return line;
+    }
+    const std::string mangled(open + 1, plus);
+    int status = 0;
+    char* name = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+    if (status != 0 || name == nullptr) {
+        return line;
+    }
+    std::string out = std::string(line, open + 1) + name + plus;
+    std::free(name);
+    return out;
+}
+
+/**
+ * @brief Prints every call site with its count and bytes, most frequent first.
+ *
+ * @param out The stream to print to.
+ */
+void AllocationAudit::Report(std::FILE* out) {
+    std::vector<const AuditSite*> found;
+    for (const AuditSite& site : Sites) {
+        if (site.ready.load(std::memory_order_acquire)) {
+            found.push_back(&site);
+        }
+    }
+    std::sort(found.begin(), found.end(), [](const AuditSite* a, const AuditSite* b) {
+        return a->count.load(std::memory_order_relaxed) > b->count.load(std::memory_order_relaxed);
+    });
+    std::fprintf(out, "allocation audit: %llu allocations inside ticks at %zu call sites\n",
+                 (unsigned long long)getTickAllocations(), found.size());
+    for (const AuditSite* site : found) {
+        std::fprintf(out, "  %llu allocations, %llu bytes:\n", (unsigned long long)site->count.load(std::memory_order_relaxed),
+                     (unsigned long long)site->bytes.load(std::memory_order_relaxed));
+        char** symbols = backtrace_symbols(site->frames, site->depth);
+        for (int i = 0; i < site->depth; i++) {
+            std::fprintf(out, "    %s\n", symbols ? DemangleFrame(symbols[i]).c_str() : "?");
+        }
+        std::free(symbols);
+    }
+    if (Overflow_Count.load(std::memory_order_relaxed) > 0) {
+        std::fprintf(out, "  %llu allocations from call sites beyond the first %d\n",
+                     (unsigned long long)Overflow_Count.load(std::memory_order_relaxed), ALLOCATION_AUDIT_SITES);
+    }
+}
+
+/**
+ * @brief Forgets every count and call site; no thread may be allocating inside a tick.
+ */
+void AllocationAudit::Reset() {
+    for (AuditSite& site : Sites) {
+        site.ready.store(false, std::memory_order_relaxed);
+        site.count.store(0, std::memory_order_relaxed);
+        site.bytes.store(0, std::memory_order_relaxed);
+        site.key.store(0, std::memory_order_release);
+    }
+    Overflow_Count.store(0, std::memory_order_relaxed);
+    Tick_Allocations.store(0, std::memory_order_relaxed);
+}
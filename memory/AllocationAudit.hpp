@@ -0,0 +1,92 @@
+#ifndef ALLOCATION_AUDIT_H
+#define ALLOCATION_AUDIT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#define ALLOCATION_AUDIT_SITES 512 ///< Distinct call sites recorded; later ones are only counted
+#define ALLOCATION_AUDIT_DEPTH 6 ///< Return addresses kept per call site
+
+/**
+ * @brief Counts heap allocations made inside simulation ticks, per call site.
+ *
+ * @details Built with CARECU_ALLOC_AUDIT, the global operator new and
+ * operator delete are replaced by versions that, while the audit is armed
+ * and the calling thread is inside a tick, record the allocating stack in
+ * a fixed table before calling malloc. The steady-state tick is meant to
+ * allocate nothing, so any entry in the table is an offender; arm the audit
+ * after a warm-up that has created every per-sensor entry.
+ *
+ * Without CARECU_ALLOC_AUDIT nothing is replaced, the tick markers compile
+ * to nothing and isCompiledIn() returns false.
+ */
+class AllocationAudit {
+public:
+    /**
+     * @brief Checks whether the build replaces operator new.
+     *
+     * @return true if built with CARECU_ALLOC_AUDIT.
+     */
+    static bool isCompiledIn();
+
+    /**
+     * @brief Starts or stops counting allocations made inside ticks.
+     *
+     * @param on true to count.
+     */
+    static void Arm(bool on);
+
+    /**
+     * @brief Marks the calling thread as inside a tick; ticks may nest.
+     */
+    static void BeginTick();
+
+    /**
+     * @brief Marks the end of the innermost tick of the calling thread.
+     */
+    static void EndTick();
+
+    /**
+     * @brief Gets the number of allocations counted so far.
+     *
+     * @return std::uint64_t Allocations made inside ticks while armed.
+     */
+    static std::uint64_t getTickAllocations();
+
+    /**
+     * @brief Prints every call site with its count and bytes, most frequent first.
+     *
+     * @param out The stream to print to.
+     */
+    static void Report(std::FILE* out);
+
+    /**
+     * @brief Forgets every count and call site.
+     */
+    static void Reset();
+};
+
+/**
+ * @brief Marks a scope as one simulation tick for the allocation audit.
+ */
+class AllocationAuditTick {
+public:
+#ifdef CARECU_ALLOC_AUDIT
+    AllocationAuditTick() {
+        AllocationAudit::BeginTick();
+    }
+
+    ~AllocationAuditTick() {
+        AllocationAudit::EndTick();
+    }
+#else
+    AllocationAuditTick() {}
+#endif
+
+    // Deleted copy constructor and assignment operator
+    AllocationAuditTick(const AllocationAuditTick&) = delete;
+    AllocationAuditTick& operator=(const AllocationAuditTick&) = delete;
+};
+
+#endif // !ALLOCATION_AUDIT_H
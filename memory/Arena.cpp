@@ -0,0 +1,61 @@
+#include "Arena.hpp"
+#include <cstdint>
+
+/**
+ * @brief Constructs an empty arena; no memory is requested until the first allocation.
+ *
+ * @param chunkSize Size in bytes of each chunk requested from the heap.
+ */
+MonotonicArena::MonotonicArena(std::size_t chunkSize)
+    : chunkSize(chunkSize), cursor(nullptr), limit(nullptr), used(0) {
+}
+
+/**
+ * @brief Releases every chunk.
+ */
+MonotonicArena::~MonotonicArena() {
+    release();
+}
+
+/**
+ * @brief Allocates raw memory, starting a new chunk when the current one is too small.
+ *
+ * @param bytes     Number of bytes.
+ * @param alignment Required alignment, a power of two.
+ * @return Pointer to the memory.
+ */
+void* MonotonicArena::allocate(std::size_t bytes, std::size_t alignment) {
+    std::uintptr_t p = (reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+
+    if (cursor == nullptr || p + bytes > reinterpret_cast<std::uintptr_t>(limit)) {
+        // Oversized requests get a chunk of their own
+        const std::size_t size = bytes + alignment > chunkSize ? bytes + alignment : chunkSize;
+        chunks.emplace_back(new unsigned char[size]);
+        cursor = chunks.back().get();
+        limit = cursor + size;
+        p = (reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+    }
+
+    used += p + bytes - reinterpret_cast<std::uintptr_t>(cursor);
+    cursor = reinterpret_cast<unsigned char*>(p + bytes);
+    return reinterpret_cast<void*>(p);
+}
+
+/**
+ * @brief Returns all chunks to the heap.
+ */
+void MonotonicArena::release() {
+    chunks.clear();
+    cursor = nullptr;
+    limit = nullptr;
+    used = 0;
+}
+
+/**
+ * @brief Gets the number of bytes handed out since the last release().
+ *
+ * @return Bytes allocated, including alignment padding.
+ */
+std::size_t MonotonicArena::bytesUsed() const {
+    return used;
+}
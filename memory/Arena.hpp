@@ -0,0 +1,121 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Monotonic bump allocator backed by large contiguous chunks.
+ *
+ * @details Allocation is a pointer bump inside the current chunk; a new
+ * chunk is only requested when the current one is exhausted. Individual
+ * deallocation is a no-op and all memory is returned at once by release()
+ * or the destructor, which makes building and tearing down large fleets a
+ * handful of heap operations instead of several per object.
+ *
+ * Every object placed in the arena must be destroyed before release().
+ */
+class MonotonicArena {
+public:
+    /**
+     * @brief Constructs an empty arena.
+     *
+     * @param chunkSize Size in bytes of each chunk requested from the heap.
+     */
+    explicit MonotonicArena(std::size_t chunkSize = 1 << 20);
+
+    /**
+     * @brief Releases every chunk.
+     */
+    ~MonotonicArena();
+
+    // Deleted copy constructor and assignment operator
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    /**
+     * @brief Allocates raw memory from the current chunk.
+     *
+     * @param bytes     Number of bytes.
+     * @param alignment Required alignment, a power of two.
+     * @return Pointer to the memory; never nullptr.
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment);
+
+    /**
+     * @brief Returns all chunks to the heap.
+     */
+    void release();
+
+    /**
+     * @brief Gets the number of bytes handed out since the last release().
+     *
+     * @return Bytes allocated, including alignment padding.
+     */
+    std::size_t bytesUsed() const;
+
+private:
+    std::size_t chunkSize; ///< Default chunk size
+    std::vector<std::unique_ptr<unsigned char[]>> chunks; ///< Chunks owned by the arena
+    unsigned char* cursor; ///< Next free byte in the current chunk
+    unsigned char* limit; ///< End of the current chunk
+    std::size_t used; ///< Bytes handed out
+};
+
+/**
+ * @brief Standard allocator adaptor that draws from a MonotonicArena.
+ *
+ * @details Suitable for std::allocate_shared, so an object and its
+ * shared_ptr control block end up next to each other in the arena.
+ *
+ * @tparam T The value type.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    /**
+     * @brief Constructs an allocator drawing from the given arena.
+     *
+     * @param arena The arena; must outlive every allocation.
+     */
+    explicit ArenaAllocator(MonotonicArena& arena) : arena(&arena) {}
+
+    /**
+     * @brief Rebinding constructor.
+     *
+     * @param other Allocator of another value type sharing the same arena.
+     */
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    /**
+     * @brief Allocates storage for n objects.
+     *
+     * @param n Number of objects.
+     * @return Pointer to uninitialised storage.
+     */
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief No-op; the arena reclaims memory in bulk.
+     */
+    void deallocate(T*, std::size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+private:
+    template <typename U> friend class ArenaAllocator;
+
+    MonotonicArena* arena; ///< Arena the memory comes from
+};
+
+#endif // !ARENA_H
@@ -0,0 +1,204 @@
+#include "Rcu.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The read-section state of one thread, on its own cache line.
+ */
+struct alignas(64) RcuReaderSlot {
+    std::atomic<bool> owned; ///< Taken by a thread
+    std::atomic<std::uint64_t> epoch; ///< Epoch the thread's outermost section entered at; 0 outside any section
+};
+
+/**
+ * @brief An object waiting for its grace period.
+ */
+struct RcuRetired {
+    void* object; ///< The object
+    void (*destroy)(void*); ///< Destroys it
+    std::uint64_t epoch; ///< Readers that entered at this epoch or later cannot hold it
+};
+
+static RcuReaderSlot Readers[RCU_MAX_READERS]; ///< Zero-initialised before any thread reads
+static std::atomic<std::size_t> Reader_Limit(0); ///< Slots ever taken; scans stop here
+static std::atomic<std::uint64_t> Global_Epoch(1); ///< Advanced by every Retire and Synchronize
+static std::atomic<std::uint64_t> Reclaimed_Count(0); ///< Retired objects destroyed
+static std::mutex Retired_Lock; ///< Guards Retired_Objects
+static std::vector<RcuRetired> Retired_Objects; ///< Objects waiting for their grace period
+
+/**
+ * @brief The calling thread's slot and nesting depth; gives the slot back at thread exit.
+ */
+struct RcuThreadState {
+    RcuReaderSlot* slot = nullptr; ///< Taken on the first ReadLock
+    int depth = 0; ///< Read sections the thread is inside
+
+    ~RcuThreadState() {
+        if (slot != nullptr) {
+            slot->epoch.store(0, std::memory_order_seq_cst);
+            slot->owned.store(false, std::memory_order_release);
+        }
+    }
+};
+
+static thread_local RcuThreadState Thread_State;
+
+/**
+ * @brief Takes the first free reader slot for the calling thread.
+ *
+ * @return RcuReaderSlot* The slot.
+ * @throws std::length_error If every slot is taken.
+ */
+static RcuReaderSlot* ClaimSlot() {
+    for (std::size_t i = 0; i < RCU_MAX_READERS; i++) {
+        bool expected = false;
+        if (!Readers[i].owned.load(std::memory_order_relaxed) &&
+            Readers[i].owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            std::size_t limit = Reader_Limit.load(std::memory_order_seq_cst);
+            while (limit < i + 1 && !Reader_Limit.compare_exchange_weak(limit, i + 1, std::memory_order_seq_cst)) {
+            }
+            return &Readers[i];
+        }
+    }
+    throw std::length_error("Too many RCU reader threads");
+}
+
+/**
+ * @brief Gets the oldest epoch an active reader entered at.
+ *
+ * @return std::uint64_t The epoch, or the largest value if no thread is reading.
+ */
+static std::uint64_t OldestReaderEpoch() {
+    std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+    const std::size_t limit = Reader_Limit.load(std::memory_order_seq_cst);
+    for (std::size_t i = 0; i < limit; i++) {
+        const std::uint64_t epoch = Readers[i].epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0) {
+            oldest = std::min(oldest, epoch);
+        }
+    }
+    return oldest;
+}
+
+/**
+ * @brief Enters a read section; sections nest.
+ *
+ * The epoch store and the pointer loads that follow are sequentially
+ * consistent, so a writer that has swapped a pointer and then finds this
+ * slot empty knows the reader will see the new pointer.
+ */
+void Rcu::ReadLock() {
+    RcuThreadState& state = Thread_State;
+    if (state.depth++ > 0) {
+        return;
+    }
+    if (state.slot == nullptr) {
+        try {
+            state.slot = ClaimSlot();
+        } catch (...) {
+            state.depth--;
+            throw;
+        }
+    }
+    state.slot->epoch.store(Global_Epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+}
+
+/**
+ * @brief Leaves the innermost read section.
+ */
+void Rcu::ReadUnlock() {
+    RcuThreadState& state = Thread_State;
+    if (--state.depth == 0) {
+        state.slot->epoch.store(0, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Tells reclaimers that the calling thread holds no pointer it read so far.
+ */
+void Rcu::Quiescent() {
+    RcuThreadState& state = Thread_State;
+    if (state.depth == 1) {
+        state.slot->epoch.store(Global_Epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+}
+
+/**
+ * @brief Hands over an unpublished object, tagged with a new epoch.
+ *
+ * @param object The object.
+ * @param destroy Destroys the object.
+ */
+void Rcu::Retire(void* object, void (*destroy)(void*)) {
+    const std::uint64_t epoch = Global_Epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    std::lock_guard<std::mutex> lock(Retired_Lock);
+    Retired_Objects.push_back(RcuRetired{object, destroy, epoch});
+}
+
+/**
+ * @brief Destroys the retired objects that no reader can still hold.
+ *
+ * Objects are destroyed after the list lock is released, so a destructor
+ * may itself retire objects.
+ *
+ * @return std::size_t Objects destroyed.
+ */
+std::size_t Rcu::Reclaim() {
+    std::vector<RcuRetired> expired;
+    {
+        std::lock_guard<std::mutex> lock(Retired_Lock);
+        if (Retired_Objects.empty()) {
+            return 0;
+        }
+        const std::uint64_t oldest = OldestReaderEpoch();
+        auto keep = std::partition(Retired_Objects.begin(), Retired_Objects.end(),
+                                   [oldest](const RcuRetired& r) { return r.epoch > oldest; });
+        expired.assign(keep, Retired_Objects.end());
+        Retired_Objects.erase(keep, Retired_Objects.end());
+    }
+    for (const RcuRetired& r : expired) {
+        r.destroy(r.object);
+    }
+    Reclaimed_Count.fetch_add(expired.size(), std::memory_order_relaxed);
+    return expired.size();
+}
+
+/**
+ * @brief Waits until every read section that entered before the call has left, then reclaims.
+ *
+ * Polls every 100 microseconds; readers are never signalled or slowed.
+ */
+void Rcu::Synchronize() {
+    if (Thread_State.depth > 0) {
+        throw std::logic_error("Rcu::Synchronize called inside a read section");
+    }
+    const std::uint64_t target = Global_Epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    while (OldestReaderEpoch() < target) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    Reclaim();
+}
+
+/**
+ * @brief Gets the number of retired objects not destroyed yet.
+ *
+ * @return std::size_t The count.
+ */
+std::size_t Rcu::getRetiredCount() {
+    std::lock_guard<std::mutex> lock(Retired_Lock);
+    return Retired_Objects.size();
+}
+
+/**
+ * @brief Gets the number of retired objects destroyed so far.
+ *
+ * @return std::uint64_t The count.
+ */
+std::uint64_t Rcu::getReclaimedCount() {
+    return Reclaimed_Count.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,164 @@
+#ifndef RCU_H
+#define RCU_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#define RCU_MAX_READERS 1024 ///< Threads that may use read sections at the same time
+
+/**
+ * @brief Epoch-based read-copy-update: lock-free readers, deferred reclamation.
+ *
+ * @details A reader brackets its use of shared objects with ReadLock and
+ * ReadUnlock (or an RcuReadGuard). The outermost ReadLock of a thread
+ * records the current epoch in the thread's slot; nested ones only count.
+ * Readers never wait and never write anything another thread waits on.
+ *
+ * A writer unpublishes an object, typically by swapping an RcuPointer, and
+ * hands it to Retire, which tags it with a new epoch. Reclaim frees every
+ * retired object whose epoch no active reader predates; a reader that
+ * entered later can only have seen the replacement. Writers call Reclaim
+ * (or Synchronize, which waits) from their own thread, so reclamation
+ * costs the simulation threads nothing.
+ *
+ * A thread takes one of RCU_MAX_READERS slots on its first ReadLock and
+ * gives it back when it exits.
+ */
+class Rcu {
+public:
+    /**
+     * @brief Enters a read section; sections nest.
+     *
+     * @throws std::length_error If RCU_MAX_READERS threads already hold a slot.
+     */
+    static void ReadLock();
+
+    /**
+     * @brief Leaves the innermost read section.
+     */
+    static void ReadUnlock();
+
+    /**
+     * @brief Tells reclaimers that the calling thread holds no pointer it read so far.
+     *
+     * Stays inside the read section, so a long-running loop can let old
+     * objects go without leaving and re-entering it. Does nothing inside a
+     * nested section, whose enclosing scopes may still hold pointers.
+     */
+    static void Quiescent();
+
+    /**
+     * @brief Hands over an object no reader can newly reach, to be destroyed after a grace period.
+     *
+     * @param object The object, already unpublished.
+     * @param destroy Destroys the object; called from whichever thread reclaims it.
+     */
+    static void Retire(void* object, void (*destroy)(void*));
+
+    /**
+     * @brief Destroys the retired objects that no reader can still hold; never waits.
+     *
+     * @return std::size_t Objects destroyed.
+     */
+    static std::size_t Reclaim();
+
+    /**
+     * @brief Waits until every read section that entered before the call has left, then reclaims.
+     *
+     * @throws std::logic_error If the calling thread is inside a read section.
+     */
+    static void Synchronize();
+
+    /**
+     * @brief Gets the number of retired objects not destroyed yet.
+     *
+     * @return std::size_t The count.
+     */
+    static std::size_t getRetiredCount();
+
+    /**
+     * @brief Gets the number of retired objects destroyed so far.
+     *
+     * @return std::uint64_t The count.
+     */
+    static std::uint64_t getReclaimedCount();
+};
+
+/**
+ * @brief Holds a read section for the lifetime of the object.
+ */
+class RcuReadGuard {
+public:
+    RcuReadGuard() {
+        Rcu::ReadLock();
+    }
+
+    ~RcuReadGuard() {
+        Rcu::ReadUnlock();
+    }
+
+    // Deleted copy constructor and assignment operator
+    RcuReadGuard(const RcuReadGuard&) = delete;
+    RcuReadGuard& operator=(const RcuReadGuard&) = delete;
+};
+
+/**
+ * @brief A published immutable object that writers replace as a whole.
+ *
+ * @details Readers inside a read section call get() and may use the
+ * object until they leave the section. Publish swaps in a new version and
+ * retires the old one; it never waits for readers.
+ *
+ * @tparam T The object type.
+ */
+template<typename T>
+class RcuPointer {
+public:
+    /**
+     * @brief Publishes the first version.
+     *
+     * @param initial The object; must not be null.
+     */
+    explicit RcuPointer(std::unique_ptr<T> initial) : current(initial.release()) {}
+
+    /**
+     * @brief Destroys the current version; no reader may still be using it.
+     */
+    ~RcuPointer() {
+        delete current.load(std::memory_order_relaxed);
+    }
+
+    // Deleted copy constructor and assignment operator
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    /**
+     * @brief Gets the current version.
+     *
+     * @return const T* The object, valid until the calling thread leaves its read section.
+     */
+    const T* get() const {
+        return current.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Replaces the current version and retires the old one.
+     *
+     * @param next The new object; must not be null.
+     */
+    void Publish(std::unique_ptr<T> next) {
+        T* old = current.exchange(next.release(), std::memory_order_seq_cst);
+        Rcu::Retire(old, &Destroy);
+    }
+
+private:
+    static void Destroy(void* object) {
+        delete static_cast<T*>(object);
+    }
+
+    std::atomic<T*> current; ///< The published version
+};
+
+#endif // !RCU_H
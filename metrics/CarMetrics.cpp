@@ -0,0 +1,52 @@
+#include "CarMetrics.hpp"
+
+static const char* const Sensor_Labels[Sensor_Types_Count] = {
+    "type=\"speed\"", "type=\"temperature\"", "type=\"radar\"", "type=\"battery_level\""
+}; ///< Label of each SensorTypes value
+
+static const char* const Alert_Labels[CAR_ALERT_COUNT] = {
+    "kind=\"out_of_range\"", "kind=\"spike\"", "kind=\"stuck\"", "kind=\"overspeed\"",
+    "kind=\"overheat\"", "kind=\"low_battery\"", "kind=\"collision\""
+}; ///< Label of each CarAlert value
+
+/**
+ * @brief Registers the simulator metrics.
+ *
+ * @return CarMetrics The metrics.
+ */
+static CarMetrics RegisterCarMetrics() {
+    MetricsRegistry& r = MetricsRegistry::getInstance();
+    CarMetrics m;
+    for (int i = 0; i < Sensor_Types_Count; i++) {
+        m.sensorReads[i] = &r.GetCounter("carecu_sensor_reads_total", "Sensor readings taken.", Sensor_Labels[i]);
+    }
+    m.notificationsDelivered = &r.GetCounter("carecu_notifications_total", "Sensor updates offered to subscribed ECUs.", "result=\"delivered\"");
+    m.notificationsSuppressed = &r.GetCounter("carecu_notifications_total", "Sensor updates offered to subscribed ECUs.", "result=\"suppressed\"");
+    m.ecuSamples = &r.GetCounter("carecu_ecu_samples_total", "Samples recorded by ECUs.");
+    m.adaptiveRuns = &r.GetCounter("carecu_ecu_runs_total", "ECU function runs.", "ecu=\"adaptive_cruise_control\"");
+    m.diagnosticRuns = &r.GetCounter("carecu_ecu_runs_total", "ECU function runs.", "ecu=\"diagnostic\"");
+    // 1 us to about 33 ms
+    m.ecuCycleSeconds = &r.GetHistogram("carecu_ecu_cycle_seconds", "Duration of one car ECU cycle.",
+                                        Histogram::ExponentialBounds(1e-6, 2.0, 16));
+    for (int i = 0; i < CAR_ALERT_COUNT; i++) {
+        m.alerts[i] = &r.GetCounter("carecu_alerts_total", "Alerts raised by diagnostics and status checks.", Alert_Labels[i]);
+    }
+    m.logMessages = &r.GetCounter("carecu_log_messages_total", "Messages printed by the logger.");
+    m.statusLinesEmitted = &r.GetCounter("carecu_status_lines_total", "Status lines considered by DisplayStatus.", "result=\"emitted\"");
+    m.statusLinesSuppressed = &r.GetCounter("carecu_status_lines_total", "Status lines considered by DisplayStatus.", "result=\"suppressed\"");
+    m.ruleAlertsRaised = &r.GetCounter("carecu_rule_alerts_total", "Alert rule transitions.", "transition=\"raised\"");
+    m.ruleAlertsCleared = &r.GetCounter("carecu_rule_alerts_total", "Alert rule transitions.", "transition=\"cleared\"");
+    m.sensors = &r.GetGauge("carecu_sensors", "Sensor objects alive.");
+    m.ecus = &r.GetGauge("carecu_ecus", "ECU objects alive.");
+    return m;
+}
+
+/**
+ * @brief Gets the simulator metrics, registering them on the first call.
+ *
+ * @return const CarMetrics& The metrics.
+ */
+const CarMetrics& CarMetrics::get() {
+    static const CarMetrics metrics = RegisterCarMetrics();
+    return metrics;
+}
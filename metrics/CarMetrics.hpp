@@ -0,0 +1,53 @@
+#ifndef CAR_METRICS_H
+#define CAR_METRICS_H
+
+#include "Metrics.hpp"
+#include "../ECU/ECU.hpp"
+
+/**
+ * @brief Alerts counted in carecu_alerts_total, one label value each.
+ */
+enum class CarAlert {
+    OUT_OF_RANGE = 0, /**< Diagnostics: sample outside the physical range */
+    SPIKE = 1,        /**< Diagnostics: sample far from the running mean */
+    STUCK = 2,        /**< Diagnostics: sensor repeats the same value */
+    OVERSPEED = 3,    /**< Status: speed above the profile maxSpeed */
+    OVERHEAT = 4,     /**< Status: temperature above the profile maxTemperature */
+    BATTERY_LOW = 5,  /**< Status: battery below the profile lowBattery */
+    COLLISION = 6     /**< Status: radar closer than the profile safeRadarDistance */
+};
+
+#define CAR_ALERT_COUNT 7 ///< Number of CarAlert values
+
+/**
+ * @brief The metrics the simulator itself updates.
+ *
+ * @details Registered once on first use and looked up by the hot paths
+ * through get(), so instrumented code never touches the registry lock.
+ */
+struct CarMetrics {
+    Counter* sensorReads[Sensor_Types_Count]; ///< carecu_sensor_reads_total by sensor type
+    Counter* notificationsDelivered; ///< carecu_notifications_total{result="delivered"}
+    Counter* notificationsSuppressed; ///< carecu_notifications_total{result="suppressed"}
+    Counter* ecuSamples; ///< carecu_ecu_samples_total
+    Counter* adaptiveRuns; ///< carecu_ecu_runs_total{ecu="adaptive_cruise_control"}
+    Counter* diagnosticRuns; ///< carecu_ecu_runs_total{ecu="diagnostic"}
+    Histogram* ecuCycleSeconds; ///< carecu_ecu_cycle_seconds, one car's ConsumeSensorData
+    Counter* alerts[CAR_ALERT_COUNT]; ///< carecu_alerts_total by CarAlert
+    Counter* logMessages; ///< carecu_log_messages_total
+    Counter* statusLinesEmitted; ///< carecu_status_lines_total{result="emitted"}
+    Counter* statusLinesSuppressed; ///< carecu_status_lines_total{result="suppressed"}, unchanged lines DisplayStatus left out
+    Counter* ruleAlertsRaised; ///< carecu_rule_alerts_total{transition="raised"}, alert rules loaded with --rules
+    Counter* ruleAlertsCleared; ///< carecu_rule_alerts_total{transition="cleared"}
+    Gauge* sensors; ///< carecu_sensors, live sensor objects
+    Gauge* ecus; ///< carecu_ecus, live ECU objects
+
+    /**
+     * @brief Gets the simulator metrics, registering them on the first call.
+     *
+     * @return const CarMetrics& The metrics.
+     */
+    static const CarMetrics& get();
+};
+
+#endif // !CAR_METRICS_H
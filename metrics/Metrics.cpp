@@ -0,0 +1,368 @@
+#include "Metrics.hpp"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+static std::atomic<std::size_t> next_shard{0}; ///< Shard given to the next thread that asks
+
+/**
+ * @brief Hands out shards round-robin.
+ *
+ * @return std::size_t The next shard index, below METRICS_SHARDS.
+ */
+std::size_t NextMetricShard() {
+    return next_shard.fetch_add(1, std::memory_order_relaxed) % METRICS_SHARDS;
+}
+
+/**
+ * @brief Writes a number the way Prometheus parses it.
+ *
+ * @param out The stream.
+ * @param v The number.
+ */
+static void WriteValue(std::ostream& out, double v) {
+    if (std::isinf(v)) {
+        out << (v > 0 ? "+Inf" : "-Inf");
+    } else if (std::isnan(v)) {
+        out << "NaN";
+    } else {
+        char text[32];
+        const std::to_chars_result r = std::to_chars(text, text + sizeof(text), v); // Shortest exact form
+        out.write(text, r.ptr - text);
+    }
+}
+
+/**
+ * @brief Writes the label set of a sample line, adding one extra pair.
+ *
+ * @param out The stream.
+ * @param labels Label pairs without braces; may be empty.
+ * @param extra An extra pair such as le="0.5"; may be empty.
+ */
+static void WriteLabels(std::ostream& out, const std::string& labels, const std::string& extra) {
+    if (labels.empty() && extra.empty()) {
+        return;
+    }
+    out << '{' << labels;
+    if (!labels.empty() && !extra.empty()) {
+        out << ',';
+    }
+    out << extra << '}';
+}
+
+/**
+ * @brief Creates a counter at zero.
+ */
+Counter::Counter() {
+    for (Shard& s : shards) {
+        s.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Gets the count.
+ *
+ * @return std::uint64_t Sum over the shards.
+ */
+std::uint64_t Counter::value() const {
+    std::uint64_t total = 0;
+    for (const Shard& s : shards) {
+        total += s.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Writes the sample line of this counter.
+ *
+ * @param out The stream.
+ * @param name Family name.
+ * @param labels Label pairs without braces.
+ */
+void Counter::Expose(std::ostream& out, const std::string& name, const std::string& labels) const {
+    out << name;
+    WriteLabels(out, labels, "");
+    out << ' ' << value() << '\n';
+}
+
+/**
+ * @brief Creates a gauge at zero.
+ */
+Gauge::Gauge() : current(0.0) {
+}
+
+/**
+ * @brief Writes the sample line of this gauge.
+ *
+ * @param out The stream.
+ * @param name Family name.
+ * @param labels Label pairs without braces.
+ */
+void Gauge::Expose(std::ostream& out, const std::string& name, const std::string& labels) const {
+    out << name;
+    WriteLabels(out, labels, "");
+    out << ' ';
+    WriteValue(out, value());
+    out << '\n';
+}
+
+/**
+ * @brief Creates a histogram with empty buckets.
+ *
+ * @param bounds Upper bounds of the buckets, ascending.
+ */
+Histogram::Histogram(const std::vector<double>& bounds)
+    : bounds(bounds), linesPerShard((bounds.size() + 2 + 7) / 8) {
+    if (!std::is_sorted(bounds.begin(), bounds.end()) ||
+        std::adjacent_find(bounds.begin(), bounds.end()) != bounds.end()) {
+        throw std::invalid_argument("Histogram bounds must be strictly ascending");
+    }
+    lines.reset(new Line[METRICS_SHARDS * linesPerShard]);
+    for (std::size_t s = 0; s < METRICS_SHARDS; s++) {
+        for (std::size_t i = 0; i < linesPerShard * 8; i++) {
+            Cell(s, i).store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Records one observation.
+ *
+ * The sum is kept as the bit pattern of a double and updated with a
+ * compare-and-swap; only threads sharing the shard can make it retry.
+ *
+ * @param v The observed value.
+ */
+void Histogram::Observe(double v) {
+    const std::size_t shard = MetricShardIndex();
+    const std::size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), v) - bounds.begin();
+    Cell(shard, bucket).fetch_add(1, std::memory_order_relaxed);
+
+    std::atomic<std::uint64_t>& sumCell = Cell(shard, bounds.size() + 1);
+    std::uint64_t old = sumCell.load(std::memory_order_relaxed);
+    while (!sumCell.compare_exchange_weak(old, std::bit_cast<std::uint64_t>(std::bit_cast<double>(old) + v),
+                                          std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Gets the number of observations.
+ *
+ * @return std::uint64_t Sum over the buckets and shards.
+ */
+std::uint64_t Histogram::count() const {
+    std::uint64_t total = 0;
+    for (std::size_t s = 0; s < METRICS_SHARDS; s++) {
+        for (std::size_t i = 0; i <= bounds.size(); i++) {
+            total += Cell(s, i).load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Gets the sum of the observations.
+ *
+ * @return double Sum over the shards.
+ */
+double Histogram::sum() const {
+    double total = 0.0;
+    for (std::size_t s = 0; s < METRICS_SHARDS; s++) {
+        total += std::bit_cast<double>(Cell(s, bounds.size() + 1).load(std::memory_order_relaxed));
+    }
+    return total;
+}
+
+/**
+ * @brief Writes the cumulative bucket lines, the sum and the count.
+ *
+ * @param out The stream.
+ * @param name Family name.
+ * @param labels Label pairs without braces.
+ */
+void Histogram::Expose(std::ostream& out, const std::string& name, const std::string& labels) const {
+    std::vector<std::uint64_t> buckets(bounds.size() + 1, 0);
+    double total = 0.0;
+    for (std::size_t s = 0; s < METRICS_SHARDS; s++) {
+        for (std::size_t i = 0; i < buckets.size(); i++) {
+            buckets[i] += Cell(s, i).load(std::memory_order_relaxed);
+        }
+        total += std::bit_cast<double>(Cell(s, bounds.size() + 1).load(std::memory_order_relaxed));
+    }
+
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < buckets.size(); i++) {
+        cumulative += buckets[i];
+        std::ostringstream le;
+        le << "le=\"";
+        WriteValue(le, i < bounds.size() ? bounds[i] : INFINITY);
+        le << '"';
+        out << name << "_bucket";
+        WriteLabels(out, labels, le.str());
+        out << ' ' << cumulative << '\n';
+    }
+    out << name << "_sum";
+    WriteLabels(out, labels, "");
+    out << ' ';
+    WriteValue(out, total);
+    out << '\n' << name << "_count";
+    WriteLabels(out, labels, "");
+    out << ' ' << cumulative << '\n';
+}
+
+/**
+ * @brief Builds bucket bounds that grow by a constant factor.
+ *
+ * @param start First upper bound.
+ * @param factor Ratio between neighbouring bounds.
+ * @param count Number of bounds.
+ * @return std::vector<double> The bounds.
+ */
+std::vector<double> Histogram::ExponentialBounds(double start, double factor, std::size_t count) {
+    if (start <= 0.0 || factor <= 1.0) {
+        throw std::invalid_argument("Exponential bounds need start > 0 and factor > 1");
+    }
+    std::vector<double> result;
+    result.reserve(count);
+    for (double b = start; result.size() < count; b *= factor) {
+        result.push_back(b);
+    }
+    return result;
+}
+
+/**
+ * @brief Gets the registry.
+ *
+ * @return MetricsRegistry& The registry.
+ */
+MetricsRegistry& MetricsRegistry::getInstance() {
+    static MetricsRegistry* instance = new MetricsRegistry(); // Never destroyed; see the header
+    return *instance;
+}
+
+/**
+ * @brief Finds or creates the family of a name.
+ *
+ * @param name Family name.
+ * @param help Description used if the family is created.
+ * @param type Expected kind.
+ * @return Family& The family.
+ */
+MetricsRegistry::Family& MetricsRegistry::FindFamily(const std::string& name, const std::string& help, MetricType type) {
+    auto it = families.find(name);
+    if (it == families.end()) {
+        it = families.emplace(name, Family{help, type, {}}).first;
+    } else if (it->second.type != type) {
+        throw std::invalid_argument("Metric " + name + " is registered with another type");
+    }
+    return it->second;
+}
+
+/**
+ * @brief Gets or creates a counter.
+ *
+ * @param name Family name.
+ * @param help One-line description of the family.
+ * @param labels Label pairs without braces.
+ * @return Counter& The counter.
+ */
+Counter& MetricsRegistry::GetCounter(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> guard(registryMutex);
+    std::unique_ptr<Metric>& m = FindFamily(name, help, MetricType::COUNTER).series[labels];
+    if (!m) {
+        m.reset(new Counter());
+    }
+    return static_cast<Counter&>(*m);
+}
+
+/**
+ * @brief Gets or creates a gauge.
+ *
+ * @param name Family name.
+ * @param help One-line description of the family.
+ * @param labels Label pairs without braces.
+ * @return Gauge& The gauge.
+ */
+Gauge& MetricsRegistry::GetGauge(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> guard(registryMutex);
+    std::unique_ptr<Metric>& m = FindFamily(name, help, MetricType::GAUGE).series[labels];
+    if (!m) {
+        m.reset(new Gauge());
+    }
+    return static_cast<Gauge&>(*m);
+}
+
+/**
+ * @brief Gets or creates a histogram.
+ *
+ * @param name Family name.
+ * @param help One-line description of the family.
+ * @param bounds Bucket upper bounds, used if the series is created.
+ * @param labels Label pairs without braces.
+ * @return Histogram& The histogram.
+ */
+Histogram& MetricsRegistry::GetHistogram(const std::string& name, const std::string& help, const std::vector<double>& bounds, const std::string& labels) {
+    std::lock_guard<std::mutex> guard(registryMutex);
+    std::unique_ptr<Metric>& m = FindFamily(name, help, MetricType::HISTOGRAM).series[labels];
+    if (!m) {
+        m.reset(new Histogram(bounds));
+    }
+    return static_cast<Histogram&>(*m);
+}
+
+/**
+ * @brief Writes every family in the Prometheus text exposition format.
+ *
+ * Takes the registry lock only to walk the families; the values are read
+ * with relaxed loads while the simulation keeps updating them.
+ *
+ * @param out The stream.
+ */
+void MetricsRegistry::Expose(std::ostream& out) const {
+    static const char* const Type_Names[] = {"counter", "gauge", "histogram"};
+    std::lock_guard<std::mutex> guard(registryMutex);
+    for (const auto& family : families) {
+        out << "# HELP " << family.first << ' ' << family.second.help << '\n';
+        out << "# TYPE " << family.first << ' ' << Type_Names[(int)family.second.type] << '\n';
+        for (const auto& series : family.second.series) {
+            series.second->Expose(out, family.first, series.first);
+        }
+    }
+}
+
+/**
+ * @brief Gets the Prometheus text snapshot.
+ *
+ * @return std::string The snapshot.
+ */
+std::string MetricsRegistry::Expose() const {
+    std::ostringstream out;
+    Expose(out);
+    return out.str();
+}
+
+/**
+ * @brief Writes the snapshot to a file through a temporary file and a rename.
+ *
+ * @param path The file.
+ * @return true if the file was written.
+ */
+bool MetricsRegistry::WriteFile(const std::string& path) const {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        Expose(file);
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
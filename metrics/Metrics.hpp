@@ -0,0 +1,325 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#define METRICS_SHARDS 16 ///< Shards per counter and histogram; threads are spread over them
+
+/**
+ * @brief Kinds of metric, named as in the Prometheus text format.
+ */
+enum class MetricType {
+    COUNTER,  /**< Monotonic count */
+    GAUGE,    /**< Value that goes up and down */
+    HISTOGRAM /**< Distribution over fixed buckets */
+};
+
+/**
+ * @brief Hands out shards round-robin.
+ *
+ * @return std::size_t The next shard index, below METRICS_SHARDS.
+ */
+std::size_t NextMetricShard();
+
+/**
+ * @brief Gets the shard of the calling thread.
+ *
+ * Threads are given shards round-robin on their first update, so up to
+ * METRICS_SHARDS threads update without sharing a cache line. Inline so
+ * that an increment is a thread-local load and one atomic add.
+ *
+ * @return std::size_t Shard index, below METRICS_SHARDS.
+ */
+inline std::size_t MetricShardIndex() {
+    thread_local const std::size_t shard = NextMetricShard();
+    return shard;
+}
+
+/**
+ * @brief One series of a metric family.
+ */
+class Metric {
+public:
+    virtual ~Metric() = default;
+
+    /**
+     * @brief Writes the sample lines of this series in the Prometheus text format.
+     *
+     * @param out The stream.
+     * @param name Family name.
+     * @param labels Label pairs without braces, e.g. type="speed"; may be empty.
+     */
+    virtual void Expose(std::ostream& out, const std::string& name, const std::string& labels) const = 0;
+};
+
+/**
+ * @brief A monotonic count.
+ *
+ * @details Each shard sits on its own cache line and a thread only adds to
+ * its own shard, so increments from different threads never contend.
+ * Reading sums the shards.
+ */
+class Counter : public Metric {
+public:
+    Counter();
+
+    /**
+     * @brief Adds to the count.
+     *
+     * @param n Amount to add.
+     */
+    void Increment(std::uint64_t n = 1) {
+        shards[MetricShardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the count.
+     *
+     * @return std::uint64_t Sum over the shards.
+     */
+    std::uint64_t value() const;
+
+    void Expose(std::ostream& out, const std::string& name, const std::string& labels) const override;
+
+private:
+    /**
+     * @brief One thread group's part of the count.
+     */
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> value; ///< Part of the count
+    };
+
+    Shard shards[METRICS_SHARDS]; ///< Per-thread parts
+};
+
+/**
+ * @brief A value that goes up and down, such as the number of live sensors.
+ *
+ * @details A single atomic: gauges change on construction and configuration,
+ * not per sample, so they are not sharded.
+ */
+class Gauge : public Metric {
+public:
+    Gauge();
+
+    /**
+     * @brief Replaces the value.
+     *
+     * @param v The value.
+     */
+    void Set(double v) { current.store(v, std::memory_order_relaxed); }
+
+    /**
+     * @brief Adds to the value.
+     *
+     * @param delta Amount to add; negative to subtract.
+     */
+    void Add(double delta) { current.fetch_add(delta, std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the value.
+     *
+     * @return double The value.
+     */
+    double value() const { return current.load(std::memory_order_relaxed); }
+
+    void Expose(std::ostream& out, const std::string& name, const std::string& labels) const override;
+
+private:
+    std::atomic<double> current; ///< The value
+};
+
+/**
+ * @brief Counts of observations in fixed buckets, plus their sum.
+ *
+ * @details Every shard has its own cache lines holding one cell per bucket
+ * and one for the sum; a thread only writes its own shard. Observing is a
+ * binary search over the bounds and two relaxed atomic updates.
+ */
+class Histogram : public Metric {
+public:
+    /**
+     * @brief Creates a histogram.
+     *
+     * @param bounds Upper bounds of the buckets, ascending; +Inf is implied.
+     * @throws std::invalid_argument If the bounds are not ascending.
+     */
+    explicit Histogram(const std::vector<double>& bounds);
+
+    /**
+     * @brief Records one observation.
+     *
+     * @param v The observed value.
+     */
+    void Observe(double v);
+
+    /**
+     * @brief Gets the number of observations.
+     *
+     * @return std::uint64_t Sum over the buckets and shards.
+     */
+    std::uint64_t count() const;
+
+    /**
+     * @brief Gets the sum of the observations.
+     *
+     * @return double Sum over the shards.
+     */
+    double sum() const;
+
+    void Expose(std::ostream& out, const std::string& name, const std::string& labels) const override;
+
+    /**
+     * @brief Builds bucket bounds that grow by a constant factor.
+     *
+     * @param start First upper bound; positive.
+     * @param factor Ratio between neighbouring bounds; above 1.
+     * @param count Number of bounds.
+     * @return std::vector<double> The bounds.
+     */
+    static std::vector<double> ExponentialBounds(double start, double factor, std::size_t count);
+
+private:
+    /**
+     * @brief Eight cells on one cache line.
+     */
+    struct alignas(64) Line {
+        std::atomic<std::uint64_t> cell[8]; ///< Bucket counts, or the sum as a double bit pattern
+    };
+
+    /**
+     * @brief Gets one cell of one shard.
+     *
+     * @param shard Shard index.
+     * @param index Bucket index; bounds.size() + 1 is the sum.
+     * @return std::atomic<std::uint64_t>& The cell.
+     */
+    std::atomic<std::uint64_t>& Cell(std::size_t shard, std::size_t index) const {
+        return lines[shard * linesPerShard + index / 8].cell[index % 8];
+    }
+
+    std::vector<double> bounds; ///< Upper bounds, ascending, without +Inf
+    std::size_t linesPerShard; ///< Cache lines of one shard
+    std::unique_ptr<Line[]> lines; ///< All shards back to back
+};
+
+/**
+ * @brief Process-wide set of named metrics with a Prometheus text snapshot.
+ *
+ * @details Metrics are grouped in families by name; series of a family differ
+ * by their labels. Looking a metric up takes a lock and may allocate, so
+ * callers look up once and keep the reference, which stays valid for the
+ * life of the process. Updating a metric takes no lock.
+ */
+class MetricsRegistry {
+public:
+    // Deleted copy constructor and assignment operator
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * @brief Gets the registry.
+     *
+     * The registry is never destroyed, so objects destroyed during exit can
+     * still update their metrics.
+     *
+     * @return MetricsRegistry& The registry.
+     */
+    static MetricsRegistry& getInstance();
+
+    /**
+     * @brief Gets or creates a counter.
+     *
+     * @param name Family name, e.g. carecu_sensor_reads_total.
+     * @param help One-line description of the family.
+     * @param labels Label pairs without braces, e.g. type="speed"; may be empty.
+     * @return Counter& The counter.
+     * @throws std::invalid_argument If the family exists with another type.
+     */
+    Counter& GetCounter(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    /**
+     * @brief Gets or creates a gauge.
+     *
+     * @param name Family name.
+     * @param help One-line description of the family.
+     * @param labels Label pairs without braces; may be empty.
+     * @return Gauge& The gauge.
+     * @throws std::invalid_argument If the family exists with another type.
+     */
+    Gauge& GetGauge(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    /**
+     * @brief Gets or creates a histogram.
+     *
+     * @param name Family name.
+     * @param help One-line description of the family.
+     * @param bounds Bucket upper bounds, used if the series is created.
+     * @param labels Label pairs without braces; may be empty.
+     * @return Histogram& The histogram.
+     * @throws std::invalid_argument If the family exists with another type.
+     */
+    Histogram& GetHistogram(const std::string& name, const std::string& help, const std::vector<double>& bounds, const std::string& labels = "");
+
+    /**
+     * @brief Writes every family in the Prometheus text exposition format.
+     *
+     * @param out The stream.
+     */
+    void Expose(std::ostream& out) const;
+
+    /**
+     * @brief Gets the Prometheus text snapshot.
+     *
+     * @return std::string The snapshot.
+     */
+    std::string Expose() const;
+
+    /**
+     * @brief Writes the snapshot to a file.
+     *
+     * Writes a temporary file next to it and renames it over the target, so
+     * a collector reading the file (e.g. a node exporter textfile directory)
+     * never sees a partial snapshot.
+     *
+     * @param path The file.
+     * @return true if the file was written.
+     */
+    bool WriteFile(const std::string& path) const;
+
+private:
+    MetricsRegistry() = default;
+
+    /**
+     * @brief All series sharing a name.
+     */
+    struct Family {
+        std::string help; ///< Description
+        MetricType type; ///< Kind of every series
+        std::map<std::string, std::unique_ptr<Metric>> series; ///< Series by label string
+    };
+
+    /**
+     * @brief Finds or creates the family of a name.
+     *
+     * @param name Family name.
+     * @param help Description used if the family is created.
+     * @param type Expected kind.
+     * @return Family& The family.
+     * @throws std::invalid_argument If the family exists with another type.
+     */
+    Family& FindFamily(const std::string& name, const std::string& help, MetricType type);
+
+    mutable std::mutex registryMutex; ///< Guards families, not the metric values
+    std::map<std::string, Family> families; ///< Families by name, in exposition order
+};
+
+#endif // !METRICS_H
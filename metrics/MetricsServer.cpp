@@ -0,0 +1,149 @@
+#include "MetricsServer.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <system_error>
+#include <unistd.h>
+
+#define METRICS_POLL_MS 100 ///< Longest the server thread waits before checking for Stop
+#define METRICS_REQUEST_BYTES 2048 ///< Request bytes read; only the request line matters
+
+/**
+ * @brief Binds the address and starts the server thread.
+ *
+ * @param port TCP port; 0 picks a free one.
+ * @param address IPv4 address to listen on.
+ * @param registry The registry to serve.
+ */
+MetricsServer::MetricsServer(unsigned short port, const std::string& address, MetricsRegistry& registry)
+    : registry(registry), listenFd(-1), port(port), running(true), scrapes(0) {
+    sockaddr_in in;
+    std::memset(&in, 0, sizeof(in));
+    in.sin_family = AF_INET;
+    in.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &in.sin_addr) != 1) {
+        throw std::system_error(EINVAL, std::generic_category(), "Metrics address " + address);
+    }
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Metrics socket");
+    }
+    const int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    socklen_t length = sizeof(in);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&in), sizeof(in)) != 0 || listen(listenFd, 8) != 0 ||
+        getsockname(listenFd, reinterpret_cast<sockaddr*>(&in), &length) != 0) {
+        const int error = errno;
+        close(listenFd);
+        throw std::system_error(error, std::generic_category(), "Metrics bind " + address);
+    }
+    this->port = ntohs(in.sin_port);
+    worker = std::thread(&MetricsServer::Run, this);
+}
+
+/**
+ * @brief Stops the thread and closes the socket.
+ */
+MetricsServer::~MetricsServer() {
+    Stop();
+}
+
+/**
+ * @brief Stops answering scrapes.
+ */
+void MetricsServer::Stop() {
+    running.store(false, std::memory_order_relaxed);
+    if (worker.joinable()) {
+        worker.join();
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+        listenFd = -1;
+    }
+}
+
+/**
+ * @brief Gets the port the server listens on.
+ *
+ * @return unsigned short The port.
+ */
+unsigned short MetricsServer::getPort() const {
+    return port;
+}
+
+/**
+ * @brief Gets the number of snapshots served.
+ *
+ * @return std::uint64_t Successful GET /metrics requests.
+ */
+std::uint64_t MetricsServer::getScrapeCount() const {
+    return scrapes.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Body of the server thread: waits for connections with a timeout so Stop is noticed.
+ */
+void MetricsServer::Run() {
+    while (running.load(std::memory_order_relaxed)) {
+        pollfd p{listenFd, POLLIN, 0};
+        if (poll(&p, 1, METRICS_POLL_MS) <= 0) {
+            continue;
+        }
+        const int client = accept(listenFd, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+        Serve(client);
+        close(client);
+    }
+}
+
+/**
+ * @brief Reads one request and writes the response.
+ *
+ * @param client The connected socket.
+ */
+void MetricsServer::Serve(int client) {
+    char request[METRICS_REQUEST_BYTES];
+    std::size_t got = 0;
+    // Read until the end of the request line; a scraper sends it in one segment
+    while (got < sizeof(request) - 1) {
+        pollfd p{client, POLLIN, 0};
+        if (poll(&p, 1, METRICS_POLL_MS * 10) <= 0) {
+            return;
+        }
+        const ssize_t n = recv(client, request + got, sizeof(request) - 1 - got, 0);
+        if (n <= 0) {
+            return;
+        }
+        got += n;
+        request[got] = '\0';
+        if (std::strstr(request, "\r\n") != nullptr || std::strchr(request, '\n') != nullptr) {
+            break;
+        }
+    }
+    request[got] = '\0';
+
+    std::string status = "404 Not Found";
+    std::string body = "Not found; metrics are at /metrics\n";
+    if (std::strncmp(request, "GET /metrics ", 13) == 0 || std::strncmp(request, "GET /metrics?", 13) == 0) {
+        status = "200 OK";
+        body = registry.Expose();
+        scrapes.fetch_add(1, std::memory_order_relaxed);
+    }
+    const std::string response = "HTTP/1.0 " + status + "\r\n"
+        "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "Connection: close\r\n\r\n" + body;
+    std::size_t sent = 0;
+    while (sent < response.size()) {
+        const ssize_t n = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return;
+        }
+        sent += n;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include "Metrics.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Serves the registry snapshot over HTTP for a Prometheus scraper.
+ *
+ * @details A single background thread accepts one connection at a time on a
+ * loopback address and answers GET /metrics with the text exposition;
+ * other paths get 404. Scrapes render the snapshot on this thread, so the
+ * simulation threads only pay for their own relaxed counter updates.
+ */
+class MetricsServer {
+public:
+    /**
+     * @brief Binds the address and starts the server thread.
+     *
+     * @param port TCP port; 0 picks a free one (see getPort).
+     * @param address IPv4 address to listen on.
+     * @param registry The registry to serve.
+     * @throws std::system_error If the socket cannot be bound.
+     */
+    explicit MetricsServer(unsigned short port, const std::string& address = "127.0.0.1",
+                           MetricsRegistry& registry = MetricsRegistry::getInstance());
+
+    /**
+     * @brief Stops the thread and closes the socket.
+     */
+    ~MetricsServer();
+
+    // Deleted copy constructor and assignment operator
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * @brief Stops answering scrapes. Called by the destructor.
+     */
+    void Stop();
+
+    /**
+     * @brief Gets the port the server listens on.
+     *
+     * @return unsigned short The port.
+     */
+    unsigned short getPort() const;
+
+    /**
+     * @brief Gets the number of snapshots served.
+     *
+     * @return std::uint64_t Successful GET /metrics requests.
+     */
+    std::uint64_t getScrapeCount() const;
+
+private:
+    /**
+     * @brief Body of the server thread.
+     */
+    void Run();
+
+    /**
+     * @brief Reads one request and writes the response.
+     *
+     * @param client The connected socket.
+     */
+    void Serve(int client);
+
+    MetricsRegistry& registry; ///< The registry to serve
+    int listenFd; ///< Listening socket
+    unsigned short port; ///< Bound port
+    std::atomic<bool> running; ///< Cleared to stop the thread
+    std::atomic<std::uint64_t> scrapes; ///< Snapshots served
+    std::thread worker; ///< The server thread
+};
+
+#endif // !METRICS_SERVER_H
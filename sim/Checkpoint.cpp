@@ -0,0 +1,483 @@
+#include "Checkpoint.hpp"
+#include "../logger/CarLogger.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+
+#define CHECKPOINT_ALIGN 8 ///< Every section starts at a multiple of this
+#define CHECKPOINT_WRITE_BATCH 4096 ///< Car records gathered per write
+
+/**
+ * @brief First bytes of a checkpoint file.
+ */
+struct CheckpointHeader {
+    char magic[8]; ///< CHECKPOINT_MAGIC
+    std::uint32_t format; ///< CHECKPOINT_FORMAT
+    std::uint32_t carBytes; ///< sizeof(CheckpointCar) of the build that wrote the file
+    std::uint64_t cars; ///< Car records
+    std::uint32_t names; ///< Entries of the name table
+    std::uint32_t engines; ///< Engine sections
+    std::uint64_t seedBase; ///< Sensor::getSeedBase
+    std::uint64_t seedSequence; ///< Sensor::getSeedSequence
+    std::uint64_t namesOffset; ///< Name table: per entry a model length, a make length, then both strings
+    std::uint64_t enginesOffset; ///< Engine sections, one after the other
+    std::uint64_t carsOffset; ///< Car records
+    std::uint64_t fileBytes; ///< Size of the whole file
+};
+
+/**
+ * @brief Start of an engine section; followed by the car slots, padded, then the heads and the events.
+ */
+struct CheckpointEngine {
+    std::int64_t clock; ///< EventEngineState::clock
+    std::int64_t periods[EVENT_KIND_COUNT]; ///< EventEngineState::periods
+    std::uint64_t cars; ///< Cars the engine drives; a uint32 slot index each
+};
+
+/**
+ * @brief One car of the checkpoint.
+ */
+struct CheckpointCar {
+    std::uint32_t name; ///< Index into the name table
+    std::uint32_t reserved; ///< Zero
+    CarState state; ///< Everything else
+};
+
+static_assert(std::is_trivially_copyable<CarState>::value, "car state is written as raw bytes");
+static_assert(std::is_trivially_copyable<SimEvent>::value, "events are written as raw bytes");
+
+/**
+ * @brief Rounds a size up to CHECKPOINT_ALIGN.
+ *
+ * @param n The size.
+ * @return std::uint64_t The padded size.
+ */
+static std::uint64_t Padded(std::uint64_t n) {
+    return (n + CHECKPOINT_ALIGN - 1) & ~(std::uint64_t)(CHECKPOINT_ALIGN - 1);
+}
+
+/**
+ * @brief Gets the size of an engine section.
+ *
+ * @param cars Cars of the engine.
+ * @return std::uint64_t Bytes, padded.
+ */
+static std::uint64_t EngineSectionBytes(std::uint64_t cars) {
+    return sizeof(CheckpointEngine) + Padded(cars * sizeof(std::uint32_t)) + (EVENT_KIND_COUNT + EVENT_KIND_COUNT * cars) * sizeof(SimEvent);
+}
+
+/**
+ * @brief Buffered writer that remembers the first failure.
+ */
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(std::FILE* file) : file(file), offset(0), failed(false) {
+    }
+
+    // Appends bytes; after a failure only the offset moves
+    void Write(const void* bytes, std::size_t n) {
+        if (!failed && n > 0 && std::fwrite(bytes, 1, n, file) != n) {
+            failed = true;
+        }
+        offset += n;
+    }
+
+    // Appends zeros up to the next CHECKPOINT_ALIGN boundary
+    void Pad() {
+        static const char zeros[CHECKPOINT_ALIGN] = {};
+        Write(zeros, Padded(offset) - offset);
+    }
+
+    std::uint64_t getOffset() const {
+        return offset;
+    }
+
+    bool hasFailed() const {
+        return failed;
+    }
+
+private:
+    std::FILE* file; ///< Destination
+    std::uint64_t offset; ///< Bytes written so far
+    bool failed; ///< A write failed
+};
+
+/**
+ * @brief Writes the cars of a pool and the engines that drive them.
+ *
+ * @param path The file.
+ * @param pool The cars.
+ * @param engines The engines.
+ * @param error Receives the reason when nothing was written.
+ * @return true if the checkpoint was written.
+ */
+bool Checkpoint::Save(const std::string& path, CarPool& pool, const std::vector<const EventEngine*>& engines, std::string& error) {
+    const std::size_t cars = pool.size();
+    std::unordered_map<const Car*, std::uint32_t> slotOf;
+    slotOf.reserve(cars);
+    std::vector<std::pair<std::string, std::string>> names;
+    std::vector<std::uint32_t> nameOf(cars);
+    for (std::size_t i = 0; i < cars; i++) {
+        const Car& car = pool[i];
+        slotOf.emplace(&car, (std::uint32_t)i);
+        // Fleets are built in runs of one model, so comparing with the last name is enough
+        if (names.empty() || names.back().first != car.getModel() || names.back().second != car.getMake()) {
+            names.emplace_back(car.getModel(), car.getMake());
+        }
+        nameOf[i] = (std::uint32_t)(names.size() - 1);
+    }
+    for (const EventEngine* engine : engines) {
+        for (const Car* car : engine->getCars()) {
+            if (slotOf.find(car) == slotOf.end()) {
+                error = "an engine drives a car that is not in the pool";
+                return false;
+            }
+        }
+    }
+
+    CheckpointHeader header{};
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.format = CHECKPOINT_FORMAT;
+    header.carBytes = sizeof(CheckpointCar);
+    header.cars = cars;
+    header.names = (std::uint32_t)names.size();
+    header.engines = (std::uint32_t)engines.size();
+    header.seedBase = Sensor::getSeedBase();
+    header.seedSequence = Sensor::getSeedSequence();
+    header.namesOffset = Padded(sizeof(CheckpointHeader));
+    std::uint64_t namesBytes = 0;
+    for (const auto& name : names) {
+        namesBytes += 2 * sizeof(std::uint32_t) + name.first.size() + name.second.size();
+    }
+    header.enginesOffset = header.namesOffset + Padded(namesBytes);
+    header.carsOffset = header.enginesOffset;
+    for (const EventEngine* engine : engines) {
+        header.carsOffset += EngineSectionBytes(engine->getCars().size());
+    }
+    header.fileBytes = header.carsOffset + cars * sizeof(CheckpointCar);
+
+    const std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr) {
+        error = temporary + ": " + std::strerror(errno);
+        return false;
+    }
+    CheckpointWriter out(file);
+    out.Write(&header, sizeof(header));
+    out.Pad();
+    for (const auto& name : names) {
+        const std::uint32_t lengths[2] = {(std::uint32_t)name.first.size(), (std::uint32_t)name.second.size()};
+        out.Write(lengths, sizeof(lengths));
+        out.Write(name.first.data(), name.first.size());
+        out.Write(name.second.data(), name.second.size());
+    }
+    out.Pad();
+
+    std::vector<std::uint32_t> slots;
+    std::vector<SimEvent> events;
+    for (const EventEngine* engine : engines) {
+        const std::vector<Car*>& engineCars = engine->getCars();
+        CheckpointEngine section{};
+        section.cars = engineCars.size();
+        SimEvent heads[EVENT_KIND_COUNT] = {};
+        events.resize(engine->getPendingCount());
+        EventEngineState state;
+        engine->Save(state, events.data(), heads);
+        section.clock = state.clock;
+        std::memcpy(section.periods, state.periods, sizeof(section.periods));
+        slots.resize(engineCars.size());
+        for (std::size_t i = 0; i < engineCars.size(); i++) {
+            slots[i] = slotOf[engineCars[i]];
+        }
+        out.Write(&section, sizeof(section));
+        out.Write(slots.data(), slots.size() * sizeof(std::uint32_t));
+        out.Pad();
+        out.Write(heads, sizeof(heads));
+        out.Write(events.data(), events.size() * sizeof(SimEvent));
+    }
+
+    // Ages are taken on the clock each car's samples are stamped with
+    std::vector<TimestampNs> now(cars, SampleNowNs());
+    for (const EventEngine* engine : engines) {
+        for (const Car* car : engine->getCars()) {
+            now[slotOf[car]] = engine->now().count();
+        }
+    }
+    std::vector<CheckpointCar> batch;
+    batch.reserve(CHECKPOINT_WRITE_BATCH);
+    for (std::size_t i = 0; i < cars; i++) {
+        CheckpointCar record{};
+        record.name = nameOf[i];
+        record.state = pool[i].SaveState(now[i]);
+        batch.push_back(record);
+        if (batch.size() == CHECKPOINT_WRITE_BATCH || i + 1 == cars) {
+            out.Write(batch.data(), batch.size() * sizeof(CheckpointCar));
+            batch.clear();
+        }
+    }
+
+    bool written = !out.hasFailed() && out.getOffset() == header.fileBytes;
+    if (std::fclose(file) != 0) {
+        written = false;
+    }
+    if (!written) {
+        error = temporary + ": write failed: " + std::strerror(errno);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        error = path + ": " + std::strerror(errno);
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Constructs a checkpoint with no file open.
+ */
+Checkpoint::Checkpoint() : data(nullptr), bytes(0) {
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+Checkpoint::~Checkpoint() {
+    Close();
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+void Checkpoint::Close() {
+    if (data != nullptr) {
+        munmap((void*)data, bytes);
+    }
+    data = nullptr;
+    bytes = 0;
+    engineOffsets.clear();
+}
+
+/**
+ * @brief Maps a checkpoint file and checks its layout.
+ *
+ * Every offset and count is checked against the file size here, so
+ * Restore only reads inside the mapping.
+ *
+ * @param path The file.
+ * @param error Receives the reason when the file cannot be used.
+ * @return true if the file is open and well formed.
+ */
+bool Checkpoint::Open(const std::string& path, std::string& error) {
+    Close();
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (std::size_t)info.st_size < sizeof(CheckpointHeader)) {
+        error = path + ": not a checkpoint";
+        close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, (std::size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int mapError = errno;
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        error = path + ": " + std::strerror(mapError);
+        return false;
+    }
+    // Restore reads the file front to back once
+    madvise(mapping, (std::size_t)info.st_size, MADV_SEQUENTIAL);
+    madvise(mapping, (std::size_t)info.st_size, MADV_WILLNEED);
+    data = (const unsigned char*)mapping;
+    bytes = (std::size_t)info.st_size;
+
+    CheckpointHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0) {
+        error = path + ": not a checkpoint";
+    } else if (header.format != CHECKPOINT_FORMAT || header.carBytes != sizeof(CheckpointCar)) {
+        error = path + ": written by another version of the simulator";
+    } else if (header.fileBytes != bytes || header.namesOffset > header.enginesOffset || header.enginesOffset > header.carsOffset ||
+               header.carsOffset > bytes || (bytes - header.carsOffset) / sizeof(CheckpointCar) != header.cars ||
+               (bytes - header.carsOffset) % sizeof(CheckpointCar) != 0) {
+        error = path + ": truncated or corrupt";
+    } else {
+        std::uint64_t at = header.namesOffset;
+        for (std::uint32_t n = 0; n < header.names && error.empty(); n++) {
+            std::uint32_t lengths[2];
+            if (header.enginesOffset - at < sizeof(lengths)) {
+                error = path + ": corrupt name table";
+                break;
+            }
+            std::memcpy(lengths, data + at, sizeof(lengths));
+            at += sizeof(lengths);
+            if (header.enginesOffset - at < (std::uint64_t)lengths[0] + lengths[1]) {
+                error = path + ": corrupt name table";
+            }
+            at += (std::uint64_t)lengths[0] + lengths[1];
+        }
+        at = header.enginesOffset;
+        for (std::uint32_t e = 0; e < header.engines && error.empty(); e++) {
+            CheckpointEngine section;
+            if (header.carsOffset - at < sizeof(section)) {
+                error = path + ": corrupt engine section";
+                break;
+            }
+            std::memcpy(&section, data + at, sizeof(section));
+            if (section.cars > header.cars || header.carsOffset - at < EngineSectionBytes(section.cars)) {
+                error = path + ": corrupt engine section";
+                break;
+            }
+            const unsigned char* slots = data + at + sizeof(section);
+            for (std::uint64_t i = 0; i < section.cars; i++) {
+                std::uint32_t slot;
+                std::memcpy(&slot, slots + i * sizeof(slot), sizeof(slot));
+                if (slot >= header.cars) {
+                    error = path + ": engine drives a car that is not in the file";
+                    break;
+                }
+            }
+            engineOffsets.push_back(at);
+            at += EngineSectionBytes(section.cars);
+        }
+        for (std::uint64_t i = 0; i < header.cars && error.empty(); i++) {
+            std::uint32_t name;
+            std::memcpy(&name, data + header.carsOffset + i * sizeof(CheckpointCar) + offsetof(CheckpointCar, name), sizeof(name));
+            if (name >= header.names) {
+                error = path + ": car with an unknown name";
+            }
+        }
+    }
+    if (!error.empty()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the number of cars saved.
+ *
+ * @return std::size_t The count, or 0 with no file open.
+ */
+std::size_t Checkpoint::getCarCount() const {
+    if (data == nullptr) {
+        return 0;
+    }
+    CheckpointHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    return (std::size_t)header.cars;
+}
+
+/**
+ * @brief Gets the number of engines saved.
+ *
+ * @return std::size_t The count.
+ */
+std::size_t Checkpoint::getEngineCount() const {
+    return engineOffsets.size();
+}
+
+/**
+ * @brief Gets the size of the file.
+ *
+ * @return std::size_t Bytes.
+ */
+std::size_t Checkpoint::getFileBytes() const {
+    return bytes;
+}
+
+/**
+ * @brief Builds the saved cars in a pool and resumes the saved engines over them.
+ *
+ * @param pool Receives the cars.
+ * @param engines Receives the engines.
+ * @param error Receives the reason on failure.
+ * @return true if everything was restored.
+ */
+bool Checkpoint::Restore(CarPool& pool, std::vector<std::unique_ptr<EventEngine>>& engines, std::string& error) const {
+    if (data == nullptr) {
+        error = "no checkpoint open";
+        return false;
+    }
+    CheckpointHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (pool.capacity() - pool.size() < header.cars) {
+        error = "the pool has room for " + std::to_string(pool.capacity() - pool.size()) + " cars, the checkpoint holds " + std::to_string(header.cars);
+        return false;
+    }
+    LogSilencer silencer(true);
+
+    std::vector<std::pair<std::string, std::string>> names;
+    names.reserve(header.names);
+    std::uint64_t at = header.namesOffset;
+    for (std::uint32_t n = 0; n < header.names; n++) {
+        std::uint32_t lengths[2];
+        std::memcpy(lengths, data + at, sizeof(lengths));
+        at += sizeof(lengths);
+        const char* text = (const char*)(data + at);
+        names.emplace_back(std::string(text, lengths[0]), std::string(text + lengths[0], lengths[1]));
+        at += (std::uint64_t)lengths[0] + lengths[1];
+    }
+
+    // A car driven by an engine resumes at the engine's saved time
+    std::vector<TimestampNs> now(header.cars, SampleNowNs());
+    for (std::size_t offset : engineOffsets) {
+        CheckpointEngine section;
+        std::memcpy(&section, data + offset, sizeof(section));
+        for (std::uint64_t i = 0; i < section.cars; i++) {
+            std::uint32_t slot;
+            std::memcpy(&slot, data + offset + sizeof(section) + i * sizeof(slot), sizeof(slot));
+            now[slot] = section.clock;
+        }
+    }
+    // Every car is built straight into its saved state
+    const std::size_t first = pool.size();
+    const unsigned char* records = data + header.carsOffset;
+    std::uint32_t name;
+    CarState state;
+    for (std::uint64_t i = 0; i < header.cars; i++) {
+        std::memcpy(&name, records + i * sizeof(CheckpointCar) + offsetof(CheckpointCar, name), sizeof(name));
+        std::memcpy(&state, records + i * sizeof(CheckpointCar) + offsetof(CheckpointCar, state), sizeof(state));
+        pool.emplaceRestored(names[name].first, names[name].second, state, now[i]);
+    }
+
+    for (std::size_t offset : engineOffsets) {
+        CheckpointEngine section;
+        std::memcpy(&section, data + offset, sizeof(section));
+        const unsigned char* slots = data + offset + sizeof(section);
+        std::vector<Car*> cars(section.cars);
+        for (std::uint64_t i = 0; i < section.cars; i++) {
+            std::uint32_t slot;
+            std::memcpy(&slot, slots + i * sizeof(slot), sizeof(slot));
+            cars[i] = &pool[first + slot];
+        }
+        // Sections start aligned in a page-aligned mapping, so the events can be read in place
+        const SimEvent* heads = (const SimEvent*)(slots + Padded(section.cars * sizeof(std::uint32_t)));
+        EventEngineState saved;
+        saved.clock = section.clock;
+        std::memcpy(saved.periods, section.periods, sizeof(saved.periods));
+        saved.heads = heads;
+        saved.events = heads + EVENT_KIND_COUNT;
+        try {
+            engines.push_back(std::make_unique<EventEngine>(cars, saved));
+        } catch (const std::invalid_argument& e) {
+            error = std::string("corrupt engine section: ") + e.what();
+            return false;
+        }
+    }
+    Sensor::SetSeedBase(header.seedBase, header.seedSequence);
+    return true;
+}
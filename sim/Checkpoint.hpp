@@ -0,0 +1,123 @@
+#ifndef SIM_CHECKPOINT_H
+#define SIM_CHECKPOINT_H
+
+#include "../car/CarPool.hpp"
+#include "EventEngine.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define CHECKPOINT_MAGIC "CARECUCK" ///< First eight bytes of a checkpoint file
+#define CHECKPOINT_FORMAT 1 ///< Layout version; files of another version are refused
+
+/**
+ * @brief Saves a whole simulation to one file and brings it back without replaying how it was built.
+ *
+ * @details A checkpoint holds the seed state of the sensors, a table of car
+ * names, one section per event engine with its clock, its cars and its
+ * schedule, and one fixed-size CarState record per car: signals, limits
+ * and status lines, ECU switches, the fusion filter, the diagnostic
+ * statistics, and each sensor's last reading, random engine and
+ * notification filters. Records are written as they sit in memory, so a
+ * file is only read back by the same build on the same kind of machine;
+ * the header's format number and record size check that.
+ *
+ * Open maps the file read-only. Restore builds every car in a CarPool
+ * straight from its record, with logging off, then resumes every engine on
+ * its saved schedule. Nothing CarINIT or StartDiagonisticTool would log or
+ * sample is replayed, and ECU sample histories are not saved: each is
+ * created by the first sample after the restore, so a restore costs little
+ * more than building the cars. A file can be restored any
+ * number of times to fork what-if runs from one state: with different
+ * runtime settings, or with Sensor::SetSeedBase and Sensor::Reseed for
+ * different sensor readings.
+ */
+class Checkpoint {
+public:
+    /**
+     * @brief Writes the cars of a pool and the engines that drive them.
+     *
+     * The file is written next to path and renamed over it once complete,
+     * so an interrupted save leaves the previous checkpoint intact. No
+     * engine may be running and no car may be sampled meanwhile.
+     *
+     * @param path The file.
+     * @param pool The cars; every car an engine drives must be in it.
+     * @param engines The engines.
+     * @param error Receives the reason when nothing was written.
+     * @return true if the checkpoint was written.
+     */
+    static bool Save(const std::string& path, CarPool& pool, const std::vector<const EventEngine*>& engines, std::string& error);
+
+    /**
+     * @brief Constructs a checkpoint with no file open.
+     */
+    Checkpoint();
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~Checkpoint();
+
+    // Deleted copy constructor and assignment operator
+    Checkpoint(const Checkpoint&) = delete;
+    Checkpoint& operator=(const Checkpoint&) = delete;
+
+    /**
+     * @brief Maps a checkpoint file and checks its layout.
+     *
+     * @param path The file.
+     * @param error Receives the reason when the file cannot be used.
+     * @return true if the file is open and well formed.
+     */
+    bool Open(const std::string& path, std::string& error);
+
+    /**
+     * @brief Unmaps the file; restored cars and engines do not depend on it.
+     */
+    void Close();
+
+    /**
+     * @brief Gets the number of cars saved.
+     *
+     * @return std::size_t The count.
+     */
+    std::size_t getCarCount() const;
+
+    /**
+     * @brief Gets the number of engines saved.
+     *
+     * @return std::size_t The count.
+     */
+    std::size_t getEngineCount() const;
+
+    /**
+     * @brief Gets the size of the file.
+     *
+     * @return std::size_t Bytes.
+     */
+    std::size_t getFileBytes() const;
+
+    /**
+     * @brief Builds the saved cars in a pool and resumes the saved engines over them.
+     *
+     * The cars are appended to the pool in their saved order and the sensor
+     * seed state is set back to the saved one. The cars keep whatever sensor
+     * storage the pool uses.
+     *
+     * @param pool Receives the cars; needs room for getCarCount() more.
+     * @param engines Receives one engine per saved engine, in saved order.
+     * @param error Receives the reason on failure.
+     * @return true if everything was restored; on failure the pool may hold some of the cars.
+     */
+    bool Restore(CarPool& pool, std::vector<std::unique_ptr<EventEngine>>& engines, std::string& error) const;
+
+private:
+    const unsigned char* data; ///< The mapped file, or nullptr
+    std::size_t bytes; ///< Size of the mapping
+    std::vector<std::size_t> engineOffsets; ///< Offset of every engine section, found by Open
+};
+
+#endif // !SIM_CHECKPOINT_H
@@ -0,0 +1,216 @@
+#include "ConcurrentRunner.hpp"
+#include <algorithm>
+
+/**
+ * @brief Builds the default settings.
+ * 
+ * @return ConcurrentRunnerConfig The settings.
+ */
+ConcurrentRunnerConfig ConcurrentRunnerConfig::Defaults() {
+    ConcurrentRunnerConfig c; 
+    c.samplePeriod[(int)SensorTypes::SPEED_SENSOR] = std::chrono::microseconds(10000); 
+    c.samplePeriod[(int)SensorTypes::TEMPERATURE_SENSOR] = std::chrono::microseconds(1000000); 
+    c.samplePeriod[(int)SensorTypes::RADAR_SENSOR] = std::chrono::microseconds(50000); 
+    c.samplePeriod[(int)SensorTypes::BATTERY_LEVEL_SENSOR] = std::chrono::microseconds(1000000); 
+    c.producersPerType = 1; 
+    c.consumers = 1; 
+    c.consumePeriod = std::chrono::microseconds(20000); 
+    c.readers = 0; 
+    c.readPeriod = std::chrono::microseconds(100000); 
+    return c; 
+}
+
+/**
+ * @brief Prepares a run and starts the diagnostic tool on every car.
+ * 
+ * @param cars The cars to drive.
+ * @param config The run settings.
+ */
+ConcurrentRunner::ConcurrentRunner(const std::vector<Car*>& cars, const ConcurrentRunnerConfig& config)
+    : cars(cars), config(config), exporter(nullptr), window(nullptr), running(false) {
+    for (Car* c : this->cars) {
+        c->StartDiagonisticTool(); 
+    }
+}
+
+/**
+ * @brief Stops the threads if still running.
+ */
+ConcurrentRunner::~ConcurrentRunner() {
+    Stop(); 
+}
+
+/**
+ * @brief Starts the producer and consumer threads on disjoint slices of the cars.
+ */
+void ConcurrentRunner::Start() {
+    if (running.exchange(true)) {
+        return; // Already running
+    }
+    for (auto& s : samples) {
+        s.value.store(0, std::memory_order_relaxed); 
+    }
+    cycles.value.store(0, std::memory_order_relaxed); 
+    reads.value.store(0, std::memory_order_relaxed); 
+    retries.value.store(0, std::memory_order_relaxed); 
+    started = std::chrono::steady_clock::now(); 
+
+    const std::size_t n = cars.size(); 
+    const unsigned producers = std::max(1u, config.producersPerType); 
+    for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+        for (unsigned p = 0; p < producers; p++) {
+            TelemetryProducer* telemetry = exporter ? &exporter->CreateProducer() : nullptr; 
+            threads.emplace_back(&ConcurrentRunner::Produce, this, SensorTypes(type), 
+                                 n * p / producers, n * (p + 1) / producers, telemetry); 
+        }
+    }
+    const unsigned consumers = std::max(1u, config.consumers); 
+    for (unsigned c = 0; c < consumers; c++) {
+        threads.emplace_back(&ConcurrentRunner::Consume, this, n * c / consumers, n * (c + 1) / consumers); 
+    }
+    for (unsigned r = 0; r < config.readers; r++) {
+        threads.emplace_back(&ConcurrentRunner::Read, this); 
+    }
+}
+
+/**
+ * @brief Signals the threads to finish and joins them.
+ */
+void ConcurrentRunner::Stop() {
+    {
+        std::lock_guard<std::mutex> guard(stopMutex); 
+        if (!running.exchange(false)) {
+            return; // Not running
+        }
+    }
+    stopSignal.notify_all(); 
+    for (auto& t : threads) {
+        t.join(); 
+    }
+    threads.clear(); 
+    stopped = std::chrono::steady_clock::now(); 
+}
+
+/**
+ * @brief Gets the throughput of the last run.
+ * 
+ * @return ThroughputReport The counters and rates.
+ */
+ThroughputReport ConcurrentRunner::Report() const {
+    ThroughputReport r; 
+    const std::chrono::steady_clock::time_point end = running.load() ? std::chrono::steady_clock::now() : stopped; 
+    r.seconds = std::chrono::duration<double>(end - started).count(); 
+    r.totalSamples = 0; 
+    for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+        r.samples[type] = samples[type].value.load(std::memory_order_relaxed); 
+        r.totalSamples += r.samples[type]; 
+    }
+    r.ecuCycles = cycles.value.load(std::memory_order_relaxed); 
+    r.samplesPerSecond = r.seconds > 0 ? r.totalSamples / r.seconds : 0.0; 
+    r.cyclesPerSecond = r.seconds > 0 ? r.ecuCycles / r.seconds : 0.0; 
+    r.snapshotReads = reads.value.load(std::memory_order_relaxed); 
+    r.snapshotRetries = retries.value.load(std::memory_order_relaxed); 
+    return r; 
+}
+
+/**
+ * @brief Streams every sample the producers take to an exporter.
+ * 
+ * @param exporter The exporter, or null.
+ */
+void ConcurrentRunner::SetExporter(TelemetryExporter* exporter) {
+    this->exporter = exporter; 
+}
+
+/**
+ * @brief Publishes every car to a shared-memory window after each ECU cycle.
+ * 
+ * @param window The window, or null.
+ */
+void ConcurrentRunner::SetTelemetryWindow(SharedTelemetryWindow* window) {
+    this->window = window; 
+}
+
+/**
+ * @brief Samples one sensor type of a slice of cars at the configured rate.
+ * 
+ * Sleeps until an absolute deadline so the rate does not drift with the
+ * time spent sampling. Counts are published once per period.
+ * 
+ * @param type The sensor type to sample.
+ * @param first First car of the slice.
+ * @param last One past the last car of the slice.
+ * @param telemetry Queue to record samples into, or null.
+ */
+void ConcurrentRunner::Produce(SensorTypes type, std::size_t first, std::size_t last, TelemetryProducer* telemetry) {
+    const std::chrono::microseconds period = config.samplePeriod[(int)type]; 
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now(); 
+    do {
+        for (std::size_t i = first; i < last; i++) {
+            cars[i]->SampleSensor(type); 
+        }
+        if (telemetry) {
+            const TimestampNs now = SteadyNowNs(); 
+            for (std::size_t i = first; i < last; i++) {
+                telemetry->Record((std::uint32_t)i, (int)type, cars[i]->getSensorValue(type), now); 
+            }
+        }
+        samples[(int)type].value.fetch_add(last - first, std::memory_order_relaxed); 
+        next += period; 
+    } while (WaitUntil(next)); 
+}
+
+/**
+ * @brief Runs the ECU cycle of a slice of cars at the configured rate.
+ * 
+ * @param first First car of the slice.
+ * @param last One past the last car of the slice.
+ */
+void ConcurrentRunner::Consume(std::size_t first, std::size_t last) {
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now(); 
+    do {
+        for (std::size_t i = first; i < last; i++) {
+            cars[i]->ConsumeSensorData(); 
+        }
+        if (window) {
+            for (std::size_t i = first; i < last; i++) {
+                const CarSnapshot snapshot = cars[i]->getSnapshot(); 
+                window->Publish(i, snapshot.version, snapshot.values.data(), cars[i]->getStatusFlags()); 
+            }
+        }
+        cycles.value.fetch_add(last - first, std::memory_order_relaxed); 
+        next += config.consumePeriod; 
+    } while (WaitUntil(next)); 
+}
+
+/**
+ * @brief Reads the snapshot of every car at the configured rate, as a dashboard would.
+ * 
+ * Counts attempts that overlapped a publish separately from completed reads.
+ */
+void ConcurrentRunner::Read() {
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now(); 
+    CarSnapshot snapshot; 
+    do {
+        std::uint64_t failed = 0; 
+        for (Car* c : cars) {
+            while (!c->TryGetSnapshot(snapshot)) {
+                failed++; 
+            }
+        }
+        reads.value.fetch_add(cars.size(), std::memory_order_relaxed); 
+        retries.value.fetch_add(failed, std::memory_order_relaxed); 
+        next += config.readPeriod; 
+    } while (WaitUntil(next)); 
+}
+
+/**
+ * @brief Sleeps until a deadline or until Stop is called.
+ * 
+ * @param deadline When to wake up.
+ * @return true if the run is still going.
+ */
+bool ConcurrentRunner::WaitUntil(std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(stopMutex); 
+    return !stopSignal.wait_until(lock, deadline, [this] { return !running.load(); }); 
+}
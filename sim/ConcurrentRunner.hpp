@@ -0,0 +1,176 @@
+#ifndef CONCURRENT_RUNNER_H
+#define CONCURRENT_RUNNER_H
+
+#include "../car/Car.hpp"
+#include "../telemetry/SharedTelemetryWindow.hpp"
+#include "../telemetry/TelemetryExporter.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Settings of a concurrent sampling run.
+ */
+struct ConcurrentRunnerConfig {
+    std::chrono::microseconds samplePeriod[MAX_SENSOR_NUMBER]; ///< Sampling period per sensor type
+    unsigned producersPerType; ///< Producer threads per sensor type; cars are split between them
+    unsigned consumers; ///< Consumer threads; cars are split between them
+    std::chrono::microseconds consumePeriod; ///< Period of the ECU cycle on each consumer
+    unsigned readers; ///< Snapshot reader threads (dashboards); each reads every car
+    std::chrono::microseconds readPeriod; ///< Period of a reader's pass over the cars
+
+    /**
+     * @brief Builds the default settings: radar at 20 Hz, speed at 100 Hz,
+     * temperature and battery at 1 Hz, ECUs at 50 Hz, one thread of each kind,
+     * no snapshot readers.
+     * 
+     * @return ConcurrentRunnerConfig The settings.
+     */
+    static ConcurrentRunnerConfig Defaults();
+};
+
+/**
+ * @brief Producer and consumer throughput of a concurrent run.
+ */
+struct ThroughputReport {
+    double seconds; ///< Wall time the threads ran
+    std::uint64_t samples[MAX_SENSOR_NUMBER]; ///< Samples produced per sensor type
+    std::uint64_t totalSamples; ///< Samples produced over all types
+    std::uint64_t ecuCycles; ///< Car ECU cycles run by the consumers
+    double samplesPerSecond; ///< Producer throughput
+    double cyclesPerSecond; ///< Consumer throughput
+    std::uint64_t snapshotReads; ///< Consistent snapshots read by the readers
+    std::uint64_t snapshotRetries; ///< Read attempts that overlapped a publish and were retried
+};
+
+/**
+ * @brief Runs sensors on free-running producer threads while ECUs consume concurrently.
+ * 
+ * @details Each sensor type gets producersPerType threads. Each thread owns a
+ * disjoint slice of the cars, samples that sensor of every car in its slice,
+ * then sleeps until its next period. Consumer threads own disjoint slices of
+ * the cars too and run Car::ConsumeSensorData on them. Every sensor therefore
+ * has exactly one producer, and every ECU has exactly one consumer. The
+ * consumer also publishes each car's snapshot. Reader threads read the
+ * snapshots of every car without locking. The only shared state is the
+ * sensor values, Car_info and the snapshots, all of which are atomic.
+ */
+class ConcurrentRunner {
+public:
+    /**
+     * @brief Prepares a run; the cars must outlive the runner.
+     * 
+     * Starts the diagnostic tool on every car so that the consumers have
+     * subscriptions to notify.
+     * 
+     * @param cars The cars to drive.
+     * @param config The run settings.
+     */
+    ConcurrentRunner(const std::vector<Car*>& cars, const ConcurrentRunnerConfig& config);
+
+    /**
+     * @brief Stops the threads if still running.
+     */
+    ~ConcurrentRunner();
+
+    // Deleted copy constructor and assignment operator
+    ConcurrentRunner(const ConcurrentRunner&) = delete; 
+    ConcurrentRunner& operator=(const ConcurrentRunner&) = delete;
+
+    /**
+     * @brief Starts the producer and consumer threads.
+     */
+    void Start();
+
+    /**
+     * @brief Signals the threads to finish and joins them.
+     */
+    void Stop();
+
+    /**
+     * @brief Gets the throughput of the last run.
+     * 
+     * @return ThroughputReport The counters and rates; rates use the time between Start and Stop.
+     */
+    ThroughputReport Report() const;
+
+    /**
+     * @brief Streams every sample the producers take to an exporter.
+     * 
+     * Each producer thread gets its own exporter queue, so recording stays
+     * wait-free and free of system calls. Call before Start.
+     * 
+     * @param exporter The exporter; must outlive the run. Null stops exporting.
+     */
+    void SetExporter(TelemetryExporter* exporter);
+
+    /**
+     * @brief Publishes every car to a shared-memory window after each ECU cycle.
+     * 
+     * Car i goes to slot i, written only by the consumer that owns the car.
+     * Call before Start.
+     * 
+     * @param window The window; must outlive the run and hold every car. Null stops publishing.
+     */
+    void SetTelemetryWindow(SharedTelemetryWindow* window);
+
+private:
+    /**
+     * @brief Body of a producer thread.
+     * 
+     * @param type The sensor type to sample.
+     * @param first First car of the slice.
+     * @param last One past the last car of the slice.
+     * @param telemetry Queue to record samples into, or null.
+     */
+    void Produce(SensorTypes type, std::size_t first, std::size_t last, TelemetryProducer* telemetry);
+
+    /**
+     * @brief Body of a consumer thread.
+     * 
+     * @param first First car of the slice.
+     * @param last One past the last car of the slice.
+     */
+    void Consume(std::size_t first, std::size_t last);
+
+    /**
+     * @brief Body of a snapshot reader thread.
+     */
+    void Read();
+
+    /**
+     * @brief Sleeps until a deadline or until Stop is called.
+     * 
+     * @param deadline When to wake up.
+     * @return true if the run is still going.
+     */
+    bool WaitUntil(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief A counter on its own cache line so threads never share one.
+     */
+    struct alignas(64) PaddedCounter {
+        std::atomic<std::uint64_t> value{0}; ///< The count
+    };
+
+    std::vector<Car*> cars; ///< Cars driven by the run
+    ConcurrentRunnerConfig config; ///< Run settings
+    TelemetryExporter* exporter; ///< Receives the samples, or null
+    SharedTelemetryWindow* window; ///< Receives the car states, or null
+    std::vector<std::thread> threads; ///< Producer and consumer threads
+    std::atomic<bool> running; ///< Cleared to stop the threads
+    std::mutex stopMutex; ///< Guards the stop notification
+    std::condition_variable stopSignal; ///< Wakes sleeping threads on Stop
+    PaddedCounter samples[MAX_SENSOR_NUMBER]; ///< Samples produced per sensor type
+    PaddedCounter cycles; ///< Car ECU cycles run
+    PaddedCounter reads; ///< Consistent snapshots read
+    PaddedCounter retries; ///< Snapshot reads retried
+    std::chrono::steady_clock::time_point started; ///< When Start was called
+    std::chrono::steady_clock::time_point stopped; ///< When Stop finished
+};
+
+#endif // !CONCURRENT_RUNNER_H
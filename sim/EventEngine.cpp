@@ -0,0 +1,167 @@
+#include "EventEngine.hpp"
+#include "../memory/AllocationAudit.hpp"
+#include "../memory/Rcu.hpp"
+#include <array>
+
+/**
+ * @brief Converts the periods of a config to nanoseconds, indexed by event kind.
+ *
+ * @param config The config.
+ * @return std::array<std::int64_t, EVENT_KIND_COUNT> The periods.
+ */
+static std::array<std::int64_t, EVENT_KIND_COUNT> EventPeriods(const ConcurrentRunnerConfig& config) {
+    std::array<std::int64_t, EVENT_KIND_COUNT> period;
+    for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+        period[type] = std::chrono::nanoseconds(config.samplePeriod[type]).count();
+    }
+    period[EVENT_KIND_ECU] = std::chrono::nanoseconds(config.consumePeriod).count();
+    return period;
+}
+
+/**
+ * @brief Queues the first occurrence of every event and starts the diagnostic tool of every car.
+ *
+ * @param cars The cars.
+ * @param config The sampling and ECU periods.
+ * @param firstCar Position of the first car in the whole fleet.
+ * @param fleetCars Size of the whole fleet; 0 for cars.size().
+ */
+EventEngine::EventEngine(const std::vector<Car*>& cars, const ConcurrentRunnerConfig& config, std::size_t firstCar, std::size_t fleetCars)
+    : cars(cars), schedule(EventPeriods(config).data(), EVENT_KIND_COUNT, (std::uint32_t)cars.size(), (std::uint32_t)firstCar, (std::uint32_t)fleetCars),
+      clock(0), stopping(false), stats{} {
+    SampleClockScope sampleClock(&clock);
+    for (Car* c : this->cars) {
+        c->StartDiagonisticTool();
+    }
+}
+
+/**
+ * @brief Resumes a saved engine over cars whose state has been restored.
+ * @param cars The cars, in the order the saved engine had them.
+ * @param state The clock and schedule of the saved engine.
+ */
+EventEngine::EventEngine(const std::vector<Car*>& cars, const EventEngineState& state)
+    : cars(cars), schedule(state.periods, EVENT_KIND_COUNT, (std::uint32_t)cars.size(), state.events, state.heads),
+      clock(state.clock), stopping(false), stats{} {
+}
+
+/**
+ * @brief Copies out the clock and the schedule; the engine must not be running.
+ * @param state Receives the clock and periods, and points at events and heads.
+ * @param events Receives getPendingCount() events.
+ * @param heads Receives EVENT_KIND_COUNT events.
+ */
+void EventEngine::Save(EventEngineState& state, SimEvent* events, SimEvent* heads) const {
+    state.clock = clock;
+    for (std::uint32_t kind = 0; kind < EVENT_KIND_COUNT; kind++) {
+        state.periods[kind] = schedule.getPeriod(kind);
+    }
+    schedule.Save(events, heads);
+    state.events = events;
+    state.heads = heads;
+}
+
+/**
+ * @brief Gets the cars the engine drives.
+ * @return const std::vector<Car*>& The cars.
+ */
+const std::vector<Car*>& EventEngine::getCars() const {
+    return cars;
+}
+
+/**
+ * @brief Handles every event due in the next stretch of simulated time, or until Stop is called.
+ *
+ * @param duration Simulated time to advance by.
+ */
+void EventEngine::RunFor(std::chrono::nanoseconds duration) {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    AllocationAuditTick tick;
+    RcuReadGuard section;
+    SampleClockScope sampleClock(&clock);
+    std::uint32_t sinceQuiescent = 0;
+    const std::int64_t end = clock + duration.count();
+    stopping.store(false, std::memory_order_relaxed);
+    std::uint64_t handled[EVENT_KIND_COUNT] = {};
+    std::int64_t timedNs[EVENT_KIND_COUNT] = {};
+    while (!schedule.empty() && !stopping.load(std::memory_order_relaxed)) {
+        const SimEvent& e = schedule.Next();
+        if (e.time > end) {
+            break;
+        }
+        clock = e.time;
+        // Reading the clock around every event would cost about as much as a sample
+        const bool timed = (handled[e.kind] & (EVENT_TIMING_STRIDE - 1)) == 0;
+        const TimestampNs before = timed ? SteadyNowNs() : 0;
+        Car& car = *cars[e.car];
+        if (e.kind == EVENT_KIND_ECU) {
+            car.ConsumeSensorData();
+        } else {
+            car.SampleSensor(SensorTypes(e.kind));
+        }
+        if (timed) {
+            timedNs[e.kind] += SteadyNowNs() - before;
+        }
+        handled[e.kind]++;
+        schedule.Advance();
+        if (++sinceQuiescent == EVENT_QUIESCENT_STRIDE) {
+            sinceQuiescent = 0;
+            Rcu::Quiescent(); // Nothing read from the runtime settings is held between events
+        }
+    }
+    if (!stopping.load(std::memory_order_relaxed)) {
+        clock = end;
+    }
+
+    for (int kind = 0; kind < EVENT_KIND_COUNT; kind++) {
+        stats.perKind[kind] += handled[kind];
+        const std::uint64_t timedCount = (handled[kind] + EVENT_TIMING_STRIDE - 1) / EVENT_TIMING_STRIDE;
+        if (timedCount > 0) {
+            stats.perKindSeconds[kind] += timedNs[kind] * 1e-9 * handled[kind] / timedCount;
+        }
+        stats.events += handled[kind];
+    }
+    stats.wallSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.eventsPerSecond = stats.wallSeconds > 0 ? stats.events / stats.wallSeconds : 0.0;
+}
+
+/**
+ * @brief Makes a RunFor in progress return after the current event.
+ */
+void EventEngine::Stop() {
+    stopping.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the simulated time.
+ *
+ * @return std::chrono::nanoseconds The time since the engine was created.
+ */
+std::chrono::nanoseconds EventEngine::now() const {
+    return std::chrono::nanoseconds(clock);
+}
+
+/**
+ * @brief Gets the number of queued events.
+ *
+ * @return std::size_t The count.
+ */
+std::size_t EventEngine::getPendingCount() const {
+    return schedule.size();
+}
+
+/**
+ * @brief Gets the counters.
+ *
+ * @return const EventEngineStats& The counters.
+ */
+const EventEngineStats& EventEngine::getStats() const {
+    return stats;
+}
+
+/**
+ * @brief Zeroes the counters.
+ */
+void EventEngine::ResetStats() {
+    stats = EventEngineStats{};
+}
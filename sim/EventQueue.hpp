@@ -0,0 +1,218 @@
+#ifndef SIM_EVENT_QUEUE_H
+#define SIM_EVENT_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define EVENT_HEAP_ARITY 4 ///< Children per heap node; four 16-byte events fill one cache line
+#define EVENT_HEAP_OFFSET (EVENT_HEAP_ARITY - 1) ///< Array slot of the root, so every group of siblings starts a cache line
+
+/**
+ * @brief A timestamped event of the discrete-event engine.
+ */
+struct SimEvent {
+    std::int64_t time; ///< Simulated time in nanoseconds
+    std::uint32_t car; ///< Index of the car
+    std::uint32_t kind; ///< A SensorTypes value to sample that sensor, or EVENT_KIND_ECU to run the ECUs
+
+    /**
+     * @brief Orders events by time, then by kind.
+     *
+     * Events of one car due at the same instant, such as a speed sample
+     * and an ECU cycle, therefore always come out in the same order, not in
+     * whatever order the other cars in the heap happen to leave them; a
+     * seeded run then gives the same results however the fleet is split
+     * over engines. Ties between cars are left to the heap: cars do not
+     * affect each other.
+     *
+     * @param other The event to compare with.
+     * @return true if this event is due first.
+     */
+    bool operator<(const SimEvent& other) const {
+        return time < other.time || (time == other.time && kind < other.kind);
+    }
+};
+
+/**
+ * @brief Min-heap of events with four children per node.
+ *
+ * @details A 4-ary heap is half as deep as a binary one. The four children
+ * of a node are compared together, and the root sits at array slot
+ * EVENT_HEAP_OFFSET, so those four always share one 64-byte cache line and
+ * each level costs at most one miss. Recurring events are never popped:
+ * the earliest is replaced with its next occurrence. That is usually due
+ * later than most of the heap, so the replacement first walks the hole at
+ * the root down to a leaf along the earliest children and only then moves
+ * the event up from there, which saves a compare per level.
+ *
+ * EventSchedule keeps one event per lane here; the heap also serves
+ * one-off events.
+ */
+class EventQueue {
+public:
+    /**
+     * @brief Constructs an empty queue.
+     *
+     * @param capacity Events to reserve room for.
+     */
+    explicit EventQueue(std::size_t capacity = 0) : count(0) {
+        lines.reserve((capacity + EVENT_HEAP_OFFSET + EVENT_HEAP_ARITY - 1) / EVENT_HEAP_ARITY);
+    }
+
+    /**
+     * @brief Adds an event.
+     *
+     * @param e The event.
+     */
+    void Push(const SimEvent& e) {
+        if ((count + EVENT_HEAP_OFFSET) / EVENT_HEAP_ARITY >= lines.size()) {
+            lines.emplace_back();
+        }
+        std::size_t i = count++;
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / EVENT_HEAP_ARITY;
+            if (!(e < At(parent))) {
+                break;
+            }
+            At(i) = At(parent);
+            i = parent;
+        }
+        At(i) = e;
+    }
+
+    /**
+     * @brief Gets the earliest event; the queue must not be empty.
+     *
+     * @return const SimEvent& The event.
+     */
+    const SimEvent& Top() const {
+        return At(0);
+    }
+
+    /**
+     * @brief Removes the earliest event; the queue must not be empty.
+     */
+    void Pop() {
+        count--;
+        if (count > 0) {
+            SiftDown(At(count));
+        }
+    }
+
+    /**
+     * @brief Replaces the earliest event with another, as one sift-down.
+     *
+     * @param e The event taking its place, usually its next occurrence.
+     */
+    void ReplaceTop(const SimEvent& e) {
+        SiftDown(e);
+    }
+
+    /**
+     * @brief Gets the number of queued events.
+     *
+     * @return std::size_t The count.
+     */
+    std::size_t size() const {
+        return count;
+    }
+
+    /**
+     * @brief Checks whether the queue is empty.
+     *
+     * @return true if no event is queued.
+     */
+    bool empty() const {
+        return count == 0;
+    }
+
+    /**
+     * @brief Gets a queued event by its place in the heap array.
+     *
+     * Pushing a queue's events into an empty queue in this order rebuilds
+     * the same array, since every event is already no earlier than its
+     * parent, so the copy breaks ties between equal times the same way.
+     *
+     * @param i Heap index, below size(); 0 is the earliest event.
+     * @return const SimEvent& The event.
+     */
+    const SimEvent& Get(std::size_t i) const {
+        return At(i);
+    }
+
+private:
+    /**
+     * @brief One cache line of the heap array.
+     */
+    struct alignas(64) Line {
+        SimEvent events[EVENT_HEAP_ARITY]; ///< Consecutive heap slots
+    };
+
+    /**
+     * @brief Gets a heap node.
+     *
+     * @param i Heap index; the root is 0.
+     * @return SimEvent& The node.
+     */
+    SimEvent& At(std::size_t i) {
+        const std::size_t slot = i + EVENT_HEAP_OFFSET;
+        return lines[slot / EVENT_HEAP_ARITY].events[slot % EVENT_HEAP_ARITY];
+    }
+
+    const SimEvent& At(std::size_t i) const {
+        const std::size_t slot = i + EVENT_HEAP_OFFSET;
+        return lines[slot / EVENT_HEAP_ARITY].events[slot % EVENT_HEAP_ARITY];
+    }
+
+    /**
+     * @brief Gets the earliest of the four children starting at a heap index.
+     *
+     * @param first Heap index of the first child; all four must exist.
+     * @return std::size_t Heap index of the earliest.
+     */
+    std::size_t EarliestOfFour(std::size_t first) const {
+        const std::size_t a = At(first + 1) < At(first) ? first + 1 : first;
+        const std::size_t b = At(first + 3) < At(first + 2) ? first + 3 : first + 2;
+        return At(b) < At(a) ? b : a;
+    }
+
+    /**
+     * @brief Places an event at the root and moves it to where it belongs.
+     *
+     * @param e The event; copied first, since it may live in the heap.
+     */
+    void SiftDown(SimEvent e) {
+        std::size_t i = 0;
+        for (;;) {
+            const std::size_t first = i * EVENT_HEAP_ARITY + 1;
+            std::size_t best;
+            if (first + EVENT_HEAP_ARITY <= count) {
+                best = EarliestOfFour(first);
+            } else if (first < count) {
+                best = first;
+                for (std::size_t c = first + 1; c < count; c++) {
+                    best = At(c) < At(best) ? c : best;
+                }
+            } else {
+                break;
+            }
+            At(i) = At(best);
+            i = best;
+        }
+        while (i > 0) {
+            const std::size_t parent = (i - 1) / EVENT_HEAP_ARITY;
+            if (!(e < At(parent))) {
+                break;
+            }
+            At(i) = At(parent);
+            i = parent;
+        }
+        At(i) = e;
+    }
+
+    std::vector<Line> lines; ///< The heap array, in cache lines
+    std::size_t count; ///< Queued events
+};
+
+#endif // !SIM_EVENT_QUEUE_H
@@ -0,0 +1,93 @@
+#include "EventSchedule.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Queues the first occurrence of every event.
+ *
+ * @param periods Period of each kind in nanoseconds.
+ * @param kinds Number of kinds.
+ * @param cars Number of cars.
+ * @param firstCar Position of car 0 in the whole fleet.
+ * @param fleetCars Size of the whole fleet; 0 for cars.
+ */
+EventSchedule::EventSchedule(const std::int64_t* periods, std::uint32_t kinds, std::uint32_t cars, std::uint32_t firstCar, std::uint32_t fleetCars)
+    : lanes(kinds), heads(kinds), count((std::size_t)kinds * cars) {
+    if (fleetCars == 0) {
+        fleetCars = cars;
+    }
+    if ((std::uint64_t)firstCar + cars > fleetCars) {
+        throw std::invalid_argument("the cars of a schedule must fit in its fleet");
+    }
+    for (std::uint32_t kind = 0; kind < kinds; kind++) {
+        if (periods[kind] <= 0) {
+            throw std::invalid_argument("event periods must be positive");
+        }
+        Lane& lane = lanes[kind];
+        lane.period = periods[kind];
+        lane.head = 0;
+        lane.ring.reserve(cars);
+        for (std::uint32_t car = 0; car < cars; car++) {
+            lane.ring.push_back(SimEvent{(std::int64_t)((std::uint64_t)periods[kind] * (firstCar + car) / fleetCars), car, kind});
+        }
+        if (cars > 0) {
+            heads.Push(lane.ring[0]);
+        }
+    }
+}
+
+/**
+ * @brief Rebuilds a schedule written by Save, exactly as it stood.
+ * The heads are pushed in the order they were saved, which restores the
+ * queue's array and with it the order of events due at the same time.
+ * @param periods Period of each kind in nanoseconds.
+ * @param kinds Number of kinds.
+ * @param cars Number of cars.
+ * @param events The events, lane by lane.
+ * @param heads The lane heads in queue order.
+ */
+EventSchedule::EventSchedule(const std::int64_t* periods, std::uint32_t kinds, std::uint32_t cars, const SimEvent* events, const SimEvent* heads)
+    : lanes(kinds), heads(kinds), count((std::size_t)kinds * cars) {
+    for (std::uint32_t kind = 0; kind < kinds; kind++) {
+        if (periods[kind] <= 0) {
+            throw std::invalid_argument("event periods must be positive");
+        }
+        Lane& lane = lanes[kind];
+        lane.period = periods[kind];
+        lane.head = 0;
+        lane.ring.assign(events + (std::size_t)kind * cars, events + (std::size_t)(kind + 1) * cars);
+        for (std::size_t i = 0; i < lane.ring.size(); i++) {
+            const SimEvent& e = lane.ring[i];
+            if (e.kind != kind || e.car >= cars || (i > 0 && e.time < lane.ring[i - 1].time)) {
+                throw std::invalid_argument("saved events do not form a lane in due order");
+            }
+        }
+    }
+    if (cars == 0) {
+        return;
+    }
+    std::vector<bool> pushed(kinds, false);
+    for (std::uint32_t i = 0; i < kinds; i++) {
+        const SimEvent& e = heads[i];
+        if (e.kind >= kinds || pushed[e.kind] || e.time != lanes[e.kind].ring[0].time || e.car != lanes[e.kind].ring[0].car) {
+            throw std::invalid_argument("saved queue does not hold the head of every lane");
+        }
+        pushed[e.kind] = true;
+        this->heads.Push(e);
+    }
+}
+
+/**
+ * @brief Copies out every event and the queue of lane heads.
+ * @param events Receives the events, lane by lane.
+ * @param heads Receives the lane heads in queue order.
+ */
+void EventSchedule::Save(SimEvent* events, SimEvent* heads) const {
+    for (const Lane& lane : lanes) {
+        events = std::copy(lane.ring.begin() + lane.head, lane.ring.end(), events);
+        events = std::copy(lane.ring.begin(), lane.ring.begin() + lane.head, events);
+    }
+    for (std::size_t i = 0; i < this->heads.size(); i++) {
+        heads[i] = this->heads.Get(i);
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef SIM_EVENT_SCHEDULE_H
+#define SIM_EVENT_SCHEDULE_H
+
+#include "EventQueue.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The recurring events of a fleet, in the order they fall due.
+ *
+ * @details Events are grouped into lanes, one per kind, and every event of
+ * a lane recurs with the lane's period. A lane is a ring kept in due order:
+ * its first occurrences all fall within one period, so the earliest event,
+ * once moved one period later, is due after every other event in the lane
+ * and simply becomes the ring's last element. Rescheduling is therefore
+ * one store and a cursor step, and the ring is walked sequentially, which
+ * the prefetcher follows. Only the lane heads compete in an EventQueue,
+ * which holds one event per lane and stays tiny however many cars there
+ * are. Calendar queues and timer wheels exploit the same regularity.
+ */
+class EventSchedule {
+public:
+    /**
+     * @brief Queues the first occurrence of every event.
+     *
+     * Car i fires each kind first at (firstCar + i) / fleetCars of its
+     * period, which spreads the fleet evenly over the period. A fleet split
+     * over several schedules passes each slice's offset and the whole
+     * fleet's size, so every car keeps the phase it would have in one
+     * schedule.
+     *
+     * @param periods Period of each kind in nanoseconds; all positive.
+     * @param kinds Number of kinds.
+     * @param cars Number of cars; each has one event of each kind.
+     * @param firstCar Position of car 0 in the whole fleet.
+     * @param fleetCars Size of the whole fleet; 0 for cars.
+     * @throws std::invalid_argument If a period is not positive, or the cars do not fit in the fleet.
+     */
+    EventSchedule(const std::int64_t* periods, std::uint32_t kinds, std::uint32_t cars, std::uint32_t firstCar = 0, std::uint32_t fleetCars = 0);
+
+    /**
+     * @brief Rebuilds a schedule written by Save, exactly as it stood.
+     * @param periods Period of each kind in nanoseconds; all positive.
+     * @param kinds Number of kinds.
+     * @param cars Number of cars.
+     * @param events kinds x cars events, lane by lane, each lane from its earliest event on.
+     * @param heads The earliest event of every lane in queue order, as Save wrote them; kinds of them if there are cars.
+     * @throws std::invalid_argument If a period is not positive or the events do not form the lanes.
+     */
+    EventSchedule(const std::int64_t* periods, std::uint32_t kinds, std::uint32_t cars, const SimEvent* events, const SimEvent* heads);
+
+    /**
+     * @brief Copies out every event and the queue of lane heads.
+     * @param events Receives size() events, lane by lane, each lane from its earliest event on.
+     * @param heads Receives the earliest event of every lane in queue order; getKindCount() of them if there are cars.
+     */
+    void Save(SimEvent* events, SimEvent* heads) const;
+
+    /**
+     * @brief Gets the number of kinds.
+     * @return std::uint32_t The kinds, one lane each.
+     */
+    std::uint32_t getKindCount() const {
+        return (std::uint32_t)lanes.size();
+    }
+
+    /**
+     * @brief Gets the period of a kind.
+     * @param kind The kind, below getKindCount().
+     * @return std::int64_t Nanoseconds.
+     */
+    std::int64_t getPeriod(std::uint32_t kind) const {
+        return lanes[kind].period;
+    }
+
+    /**
+     * @brief Gets the next event due; the schedule must not be empty.
+     *
+     * @return const SimEvent& The event.
+     */
+    const SimEvent& Next() const {
+        return heads.Top();
+    }
+
+    /**
+     * @brief Moves the next event due one period later.
+     */
+    void Advance() {
+        Lane& lane = lanes[heads.Top().kind];
+        lane.ring[lane.head].time += lane.period;
+        lane.head = lane.head + 1 == lane.ring.size() ? 0 : lane.head + 1;
+        heads.ReplaceTop(lane.ring[lane.head]);
+    }
+
+    /**
+     * @brief Gets the number of recurring events.
+     *
+     * @return std::size_t kinds x cars.
+     */
+    std::size_t size() const {
+        return count;
+    }
+
+    /**
+     * @brief Checks whether there is no event at all.
+     *
+     * @return true if there are no cars or no kinds.
+     */
+    bool empty() const {
+        return count == 0;
+    }
+
+private:
+    /**
+     * @brief The events of one kind.
+     */
+    struct Lane {
+        std::int64_t period; ///< Period of every event in the lane
+        std::vector<SimEvent> ring; ///< Events in due order, starting at head
+        std::size_t head; ///< Index of the earliest event
+    };
+
+    std::vector<Lane> lanes; ///< One lane per kind
+    EventQueue heads; ///< The earliest event of every lane
+    std::size_t count; ///< Events over all lanes
+};
+
+#endif // !SIM_EVENT_SCHEDULE_H
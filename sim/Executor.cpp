@@ -0,0 +1,266 @@
+#include "Executor.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+SimClock sim_clock;
+
+/**
+ * @brief A sleeping task and when it wakes up.
+ */
+struct Timer {
+    std::int64_t due; ///< Simulated wake-up time in nanoseconds
+    std::uint64_t order; ///< Sleep order, breaks ties between equal deadlines
+    std::coroutine_handle<> task; ///< The sleeping task
+
+    /**
+     * @brief Orders timers so that std heap functions keep the earliest on top.
+     *
+     * @param other The timer to compare with.
+     * @return true if this timer wakes up after the other.
+     */
+    bool operator>(const Timer& other) const {
+        return due != other.due ? due > other.due : order > other.order;
+    }
+};
+
+/**
+ * @brief Per-core scheduler state; aligned so workers never share a cache line.
+ */
+struct alignas(64) Executor::Worker {
+    std::vector<Timer> timers; ///< Min-heap of sleeping tasks
+    std::int64_t now = 0; ///< Simulated time in nanoseconds
+    std::uint64_t order = 0; ///< Next sleep order
+    std::atomic<std::uint64_t> resumes{0}; ///< Tasks resumed
+
+    /**
+     * @brief Queues a task to wake up at a simulated time.
+     *
+     * @param due The wake-up time.
+     * @param task The task.
+     */
+    void Schedule(std::int64_t due, std::coroutine_handle<> task) {
+        timers.push_back(Timer{due, order++, task});
+        std::push_heap(timers.begin(), timers.end(), std::greater<Timer>());
+    }
+};
+
+namespace {
+
+thread_local Executor::Worker* current_worker = nullptr; ///< Worker running on this thread
+
+/**
+ * @brief Adds two times without overflowing.
+ */
+std::int64_t SaturatingAdd(std::int64_t a, std::int64_t b) {
+    if (b > 0 && a > std::numeric_limits<std::int64_t>::max() - b) {
+        return std::numeric_limits<std::int64_t>::max();
+    }
+    return a + b;
+}
+
+/**
+ * @brief Pins the calling thread to one core; best effort.
+ *
+ * @param index The worker index.
+ */
+void PinToCore(unsigned index) {
+#ifdef __linux__
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cores, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)index;
+#endif
+}
+
+} // namespace
+
+/**
+ * @brief Queues the task on the current worker's timer heap.
+ *
+ * @param h The suspended task.
+ */
+void SimClock::SleepAwaiter::await_suspend(std::coroutine_handle<> h) const {
+    Executor::Worker* w = current_worker;
+    if (w == nullptr) {
+        throw std::logic_error("sim_clock.sleep awaited outside an Executor");
+    }
+    w->Schedule(SaturatingAdd(w->now, std::max<std::int64_t>(0, duration.count())), h);
+}
+
+/**
+ * @brief Gets the simulated time of the calling task's worker.
+ *
+ * @return std::chrono::nanoseconds The time, zero outside a worker.
+ */
+std::chrono::nanoseconds SimClock::now() const {
+    return std::chrono::nanoseconds(current_worker ? current_worker->now : 0);
+}
+
+/**
+ * @brief Creates the workers.
+ *
+ * @param workers Number of workers; 0 uses one per hardware thread.
+ * @param mode How simulated time advances.
+ */
+Executor::Executor(unsigned workers, ClockMode mode)
+    : mode(mode), nextWorker(0), stopping(false) {
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < workers; i++) {
+        this->workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+/**
+ * @brief Destroys every task still sleeping.
+ */
+Executor::~Executor() {
+    for (auto& w : workers) {
+        for (const Timer& t : w->timers) {
+            t.task.destroy();
+        }
+    }
+}
+
+/**
+ * @brief Hands a task to a worker.
+ *
+ * @param task The task to run.
+ * @param worker The worker index, taken modulo the number of workers.
+ */
+void Executor::Spawn(Task task, unsigned worker) {
+    Worker& w = *workers[worker % workers.size()];
+    w.Schedule(w.now, task.release());
+}
+
+/**
+ * @brief Hands a task to the workers in round-robin order.
+ *
+ * @param task The task to run.
+ */
+void Executor::Spawn(Task task) {
+    Spawn(std::move(task), nextWorker++);
+}
+
+/**
+ * @brief Runs every worker until its clock has advanced by a duration or Stop is called.
+ *
+ * @param duration Simulated time to run for.
+ */
+void Executor::RunFor(std::chrono::nanoseconds duration) {
+    stopping.store(false);
+    if (workers.size() == 1) {
+        RunWorker(*workers[0], 0, duration);
+        return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(workers.size());
+    for (unsigned i = 0; i < workers.size(); i++) {
+        threads.emplace_back(&Executor::RunWorker, this, std::ref(*workers[i]), i, duration);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+/**
+ * @brief Makes a RunFor in progress return early.
+ */
+void Executor::Stop() {
+    {
+        std::lock_guard<std::mutex> guard(stopMutex);
+        stopping.store(true);
+    }
+    stopSignal.notify_all();
+}
+
+/**
+ * @brief Body of one worker for one RunFor call.
+ *
+ * Pops the earliest timer, advances the clock to it (waiting for the wall
+ * clock in real-time mode) and resumes the task, which either sleeps again
+ * or returns.
+ *
+ * @param w The worker.
+ * @param index The worker index, used to pick a core.
+ * @param duration Simulated time to run for.
+ */
+void Executor::RunWorker(Worker& w, unsigned index, std::chrono::nanoseconds duration) {
+    if (workers.size() > 1) {
+        PinToCore(index);
+    }
+    Worker* const previous = current_worker;
+    current_worker = &w;
+    const std::int64_t end = SaturatingAdd(w.now, duration.count());
+    const std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+    const std::int64_t simStart = w.now;
+    std::uint64_t resumed = 0;
+
+    while (!w.timers.empty() && w.timers.front().due <= end && !stopping.load(std::memory_order_relaxed)) {
+        const std::int64_t due = w.timers.front().due;
+        if (mode == ClockMode::REAL_TIME && due > w.now) {
+            const std::chrono::steady_clock::time_point wake = wallStart + std::chrono::nanoseconds(due - simStart);
+            std::unique_lock<std::mutex> lock(stopMutex);
+            if (stopSignal.wait_until(lock, wake, [this] { return stopping.load(); })) {
+                break;
+            }
+        }
+        std::pop_heap(w.timers.begin(), w.timers.end(), std::greater<Timer>());
+        const std::coroutine_handle<> task = w.timers.back().task;
+        w.timers.pop_back();
+        w.now = due;
+        task.resume();
+        resumed++;
+    }
+    if (!stopping.load()) {
+        w.now = end;
+    }
+    w.resumes.fetch_add(resumed, std::memory_order_relaxed);
+    current_worker = previous;
+}
+
+/**
+ * @brief Gets the number of workers.
+ *
+ * @return unsigned The number of workers.
+ */
+unsigned Executor::getWorkerCount() const {
+    return (unsigned)workers.size();
+}
+
+/**
+ * @brief Gets the number of task resumptions over all workers.
+ *
+ * @return std::uint64_t The number of resumptions.
+ */
+std::uint64_t Executor::getResumeCount() const {
+    std::uint64_t total = 0;
+    for (const auto& w : workers) {
+        total += w->resumes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * @brief Gets the number of tasks sleeping on all workers.
+ *
+ * @return std::size_t The number of tasks.
+ */
+std::size_t Executor::getPendingCount() const {
+    std::size_t total = 0;
+    for (const auto& w : workers) {
+        total += w->timers.size();
+    }
+    return total;
+}
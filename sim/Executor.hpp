@@ -0,0 +1,178 @@
+#ifndef SIM_EXECUTOR_H
+#define SIM_EXECUTOR_H
+
+#include "Task.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief How an Executor advances simulated time.
+ */
+enum class ClockMode {
+    REAL_TIME, /**< Workers wait for the wall clock to reach each deadline */
+    VIRTUAL    /**< Workers jump straight to the next deadline */
+};
+
+/**
+ * @brief The simulated clock seen by tasks.
+ *
+ * @details There is one clock object, sim_clock; it reads and schedules on
+ * the executor worker of the calling task. Times are measured from the
+ * moment the worker was created.
+ */
+class SimClock {
+public:
+    /**
+     * @brief Awaiter returned by sleep.
+     */
+    struct SleepAwaiter {
+        std::chrono::nanoseconds duration; ///< How long to sleep
+
+        /**
+         * @brief Never completes synchronously, so a zero sleep still yields.
+         */
+        bool await_ready() const noexcept { return false; }
+
+        /**
+         * @brief Queues the task on the current worker's timer heap.
+         *
+         * @param h The suspended task.
+         */
+        void await_suspend(std::coroutine_handle<> h) const;
+
+        /**
+         * @brief Nothing to return after waking up.
+         */
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Suspends the calling task for a simulated duration.
+     *
+     * Must be awaited from a task running on an Executor.
+     *
+     * @param duration How long to sleep.
+     * @return SleepAwaiter The awaiter to co_await.
+     */
+    SleepAwaiter sleep(std::chrono::nanoseconds duration) const { return SleepAwaiter{duration}; }
+
+    /**
+     * @brief Gets the simulated time of the calling task's worker.
+     *
+     * @return std::chrono::nanoseconds The time since the worker started, zero outside a worker.
+     */
+    std::chrono::nanoseconds now() const;
+};
+
+extern SimClock sim_clock; ///< The clock awaited by tasks
+
+/**
+ * @brief Runs Tasks on a small, fixed set of worker threads, one per core.
+ *
+ * @details Each task is pinned to one worker when it is spawned and is only
+ * ever resumed by that worker, so tasks on the same worker never run
+ * concurrently. Every worker keeps its own heap of sleeping tasks ordered by
+ * deadline and its own simulated time, so workers share nothing while
+ * running. In virtual mode they can therefore advance their clocks
+ * independently. Tasks with the same deadline resume in the order they
+ * went to sleep.
+ *
+ * Spawn must not be called while the executor is running.
+ */
+class Executor {
+public:
+    /**
+     * @brief Creates the workers.
+     *
+     * @param workers Number of workers; 0 uses one per hardware thread.
+     * @param mode How simulated time advances.
+     */
+    explicit Executor(unsigned workers = 0, ClockMode mode = ClockMode::VIRTUAL);
+
+    /**
+     * @brief Destroys every task still sleeping.
+     */
+    ~Executor();
+
+    // Deleted copy constructor and assignment operator
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * @brief Hands a task to a worker; it starts at that worker's current time.
+     *
+     * @param task The task to run.
+     * @param worker The worker index, taken modulo the number of workers.
+     */
+    void Spawn(Task task, unsigned worker);
+
+    /**
+     * @brief Hands a task to the workers in round-robin order.
+     *
+     * @param task The task to run.
+     */
+    void Spawn(Task task);
+
+    /**
+     * @brief Runs every worker until its clock has advanced by a duration or Stop is called.
+     *
+     * Blocks the caller. A single worker runs on the calling thread; more
+     * workers each get a thread pinned to a core.
+     *
+     * @param duration Simulated time to run for.
+     */
+    void RunFor(std::chrono::nanoseconds duration);
+
+    /**
+     * @brief Makes a RunFor in progress return early; safe to call from any thread.
+     */
+    void Stop();
+
+    /**
+     * @brief Gets the number of workers.
+     *
+     * @return unsigned The number of workers.
+     */
+    unsigned getWorkerCount() const;
+
+    /**
+     * @brief Gets the number of task resumptions over all workers.
+     *
+     * @return std::uint64_t The number of resumptions.
+     */
+    std::uint64_t getResumeCount() const;
+
+    /**
+     * @brief Gets the number of tasks sleeping on all workers.
+     *
+     * @return std::size_t The number of tasks.
+     */
+    std::size_t getPendingCount() const;
+
+    struct Worker; ///< Per-core scheduler state, defined in Executor.cpp
+
+private:
+    /**
+     * @brief Body of one worker for one RunFor call.
+     *
+     * @param w The worker.
+     * @param index The worker index, used to pick a core.
+     * @param duration Simulated time to run for.
+     */
+    void RunWorker(Worker& w, unsigned index, std::chrono::nanoseconds duration);
+
+    std::vector<std::unique_ptr<Worker>> workers; ///< The workers
+    ClockMode mode; ///< How simulated time advances
+    unsigned nextWorker; ///< Round-robin position for Spawn
+    std::atomic<bool> stopping; ///< Set by Stop
+    std::mutex stopMutex; ///< Guards the stop notification
+    std::condition_variable stopSignal; ///< Wakes real-time workers on Stop
+};
+
+#endif // !SIM_EXECUTOR_H
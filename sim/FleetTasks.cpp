@@ -0,0 +1,54 @@
+#include "FleetTasks.hpp"
+
+/**
+ * @brief Samples one sensor of a car forever, once per period of simulated time.
+ * 
+ * @param car The car.
+ * @param type The sensor type to sample.
+ * @param period The sampling period.
+ * @return Task The task.
+ */
+Task SensorSamplingTask(Car& car, SensorTypes type, std::chrono::nanoseconds period) {
+    for (;;) {
+        car.SampleSensor(type); 
+        co_await sim_clock.sleep(period); 
+    }
+}
+
+/**
+ * @brief Runs the ECU cycle of a car forever, once per period of simulated time.
+ * 
+ * @param car The car.
+ * @param period The ECU period.
+ * @return Task The task.
+ */
+Task EcuCycleTask(Car& car, std::chrono::nanoseconds period) {
+    for (;;) {
+        car.ConsumeSensorData(); 
+        co_await sim_clock.sleep(period); 
+    }
+}
+
+/**
+ * @brief Spawns the sensor and ECU tasks of every car, one worker per car.
+ * 
+ * @param executor The executor to spawn on.
+ * @param cars The cars.
+ * @param config The periods to use.
+ * @return std::size_t The number of tasks spawned.
+ */
+std::size_t SpawnFleetTasks(Executor& executor, const std::vector<Car*>& cars, const ConcurrentRunnerConfig& config) {
+    std::size_t spawned = 0; 
+    for (std::size_t i = 0; i < cars.size(); i++) {
+        Car& car = *cars[i]; 
+        const unsigned worker = (unsigned)(i % executor.getWorkerCount()); 
+        car.StartDiagonisticTool(); 
+        for (int type = 0; type < MAX_SENSOR_NUMBER; type++) {
+            executor.Spawn(SensorSamplingTask(car, SensorTypes(type), config.samplePeriod[type]), worker); 
+            spawned++; 
+        }
+        executor.Spawn(EcuCycleTask(car, config.consumePeriod), worker); 
+        spawned++; 
+    }
+    return spawned; 
+}
@@ -0,0 +1,48 @@
+#ifndef SIM_FLEET_TASKS_H
+#define SIM_FLEET_TASKS_H
+
+#include "../car/Car.hpp"
+#include "ConcurrentRunner.hpp"
+#include "Executor.hpp"
+#include "Task.hpp"
+#include <chrono>
+#include <vector>
+
+/**
+ * @brief Samples one sensor of a car forever, once per period of simulated time.
+ * 
+ * @param car The car; must outlive the task.
+ * @param type The sensor type to sample.
+ * @param period The sampling period.
+ * @return Task The task, to be spawned on an Executor.
+ */
+Task SensorSamplingTask(Car& car, SensorTypes type, std::chrono::nanoseconds period);
+
+/**
+ * @brief Runs the ECU cycle of a car forever, once per period of simulated time.
+ * 
+ * The diagnostic tool of the car must have been started beforehand.
+ * 
+ * @param car The car; must outlive the task.
+ * @param period The ECU period.
+ * @return Task The task, to be spawned on an Executor.
+ */
+Task EcuCycleTask(Car& car, std::chrono::nanoseconds period);
+
+/**
+ * @brief Spawns the sensor and ECU tasks of every car.
+ * 
+ * @details Starts the diagnostic tool of every car, then spawns one
+ * sampling task per built-in sensor and one ECU task per car, using the
+ * periods of the config. All tasks of a car go to the same worker, so a
+ * car is only ever touched by one thread, just like a car slice of
+ * ConcurrentRunner. The thread counts of the config are not used.
+ * 
+ * @param executor The executor to spawn on.
+ * @param cars The cars; must outlive the executor.
+ * @param config The periods to use.
+ * @return std::size_t The number of tasks spawned.
+ */
+std::size_t SpawnFleetTasks(Executor& executor, const std::vector<Car*>& cars, const ConcurrentRunnerConfig& config);
+
+#endif // !SIM_FLEET_TASKS_H
@@ -0,0 +1,152 @@
+#ifndef SIM_TASK_H
+#define SIM_TASK_H
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <utility>
+
+/**
+ * @brief A fire-and-forget coroutine run by an Executor.
+ *
+ * @details A Task starts suspended and does nothing until it is handed to
+ * Executor::Spawn. From then on the executor owns the coroutine frame: it
+ * resumes the task whenever a sim_clock.sleep the task awaits expires, and
+ * destroys the frame if the executor is destroyed first. A task that
+ * returns frees its own frame.
+ *
+ * Frame allocations are counted so that benchmarks can report the memory
+ * per task.
+ */
+class Task {
+public:
+    /**
+     * @brief Coroutine promise of a Task.
+     */
+    struct promise_type {
+        /**
+         * @brief Creates the Task handed back to the caller.
+         *
+         * @return Task The task owning this coroutine.
+         */
+        Task get_return_object() noexcept {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        /**
+         * @brief Suspends before the first statement so the executor decides when to start.
+         */
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        /**
+         * @brief Lets the frame free itself when the body returns.
+         */
+        std::suspend_never final_suspend() noexcept { return {}; }
+
+        /**
+         * @brief Called when the body returns.
+         */
+        void return_void() noexcept {}
+
+        /**
+         * @brief Tasks have no one to report to, so an escaping exception is fatal.
+         */
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        /**
+         * @brief Allocates a coroutine frame and counts it.
+         *
+         * @param size The frame size chosen by the compiler.
+         * @return void* The frame.
+         */
+        static void* operator new(std::size_t size) {
+            liveFrames().fetch_add(1, std::memory_order_relaxed);
+            liveFrameBytes().fetch_add(size, std::memory_order_relaxed);
+            return ::operator new(size);
+        }
+
+        /**
+         * @brief Frees a coroutine frame.
+         *
+         * @param p The frame.
+         * @param size The frame size.
+         */
+        static void operator delete(void* p, std::size_t size) noexcept {
+            liveFrames().fetch_sub(1, std::memory_order_relaxed);
+            liveFrameBytes().fetch_sub(size, std::memory_order_relaxed);
+            ::operator delete(p);
+        }
+    };
+
+    /**
+     * @brief Moves a task that has not been spawned yet.
+     *
+     * @param other The task to take over.
+     */
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    // Deleted copy constructor and assignment operator
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    /**
+     * @brief Destroys the coroutine if it was never spawned.
+     */
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    /**
+     * @brief Hands the coroutine over to the caller, leaving the task empty.
+     *
+     * @return std::coroutine_handle<> The suspended coroutine.
+     */
+    std::coroutine_handle<> release() noexcept { return std::exchange(handle, nullptr); }
+
+    /**
+     * @brief Gets the number of task frames currently allocated.
+     *
+     * @return std::uint64_t The number of frames.
+     */
+    static std::uint64_t getLiveFrameCount() { return liveFrames().load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the bytes held by task frames currently allocated.
+     *
+     * @return std::uint64_t The number of bytes.
+     */
+    static std::uint64_t getLiveFrameBytes() { return liveFrameBytes().load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief Wraps a freshly created coroutine.
+     *
+     * @param h The coroutine.
+     */
+    explicit Task(std::coroutine_handle<promise_type> h) noexcept : handle(h) {}
+
+    /**
+     * @brief Number of frames allocated and not yet freed.
+     */
+    static std::atomic<std::uint64_t>& liveFrames() {
+        static std::atomic<std::uint64_t> count{0};
+        return count;
+    }
+
+    /**
+     * @brief Bytes of frames allocated and not yet freed.
+     */
+    static std::atomic<std::uint64_t>& liveFrameBytes() {
+        static std::atomic<std::uint64_t> bytes{0};
+        return bytes;
+    }
+
+    std::coroutine_handle<> handle; ///< The coroutine until it is spawned
+};
+
+#endif // !SIM_TASK_H
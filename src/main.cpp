@@ -1,25 +1,580 @@
-#include"../car/Car.hpp" 
-#include "../logger/CarLogger.hpp" 
-#include"../Sensors/Sensor.hpp"
-#include"../ECU/ECU.hpp" 
-#include<thread> 
-#include<chrono> 
-
-
-int main() {
-    std::shared_ptr<Car> c = std::make_shared<Car>("rio", "kia");
-    c->CarINIT();
-    c->setAdaptiveMode(true);
-    c->StartDiagonisticTool();
-    c->DisplayStatus();
-    
-    while (true) {
-        c->UpdateSensorsData();
-        c->StartDiagonisticTool();
-        c->DisplayStatus();
-        std::this_thread::sleep_for(std::chrono::seconds(5));
-    }
-
-    return 0;
-}
-// add a log to file 
+// Load generator for the simulator. Builds a fleet, drives it through the
+// discrete-event engine for a bounded stretch of simulated time, optionally
+// on several threads, and prints a summary: samples and samples per second,
+// time spent per stage, peak RSS and the alerts raised. Built with
+// CARECU_ALLOC_AUDIT it also lists every allocation made inside a tick after
+// the warm-up, per call site, and exits with 3 if there was any. With
+// --config the thresholds come from a settings file that is reloaded
+// whenever it changes, without pausing the simulation threads. --checkpoint
+// saves the whole simulation after the run; --restore resumes one instead
+// of building a fleet, and with --seed forks it into a what-if run whose
+// sensors read differently from the saved one. --rules loads alert rules
+// that are evaluated over every car after each simulated second; only the
+// rules that are raised or cleared are logged and counted.
+// Usage: CarECU [options], see --help
+#include "../alerts/AlertEngine.hpp"
+#include "../car/CarPool.hpp"
+#include "../config/RuntimeConfig.hpp"
+#include "../logger/CarLogger.hpp"
+#include "../memory/AllocationAudit.hpp"
+#include "../metrics/CarMetrics.hpp"
+#include "../Sensors/Sensor.hpp"
+#include "../sim/Checkpoint.hpp"
+#include "../sim/EventEngine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* const Alert_Names[CAR_ALERT_COUNT] = {
+    "out_of_range", "spike", "stuck", "overspeed", "overheat", "low_battery", "collision"
+}; ///< Name of each CarAlert value, as labelled in carecu_alerts_total
+
+static const std::uint64_t Max_Cars = UINT32_MAX; ///< The event schedule numbers cars with 32 bits
+static const double Max_Simulated_Seconds = 1e9; ///< Keeps the run and the warm-up together within int64 nanoseconds
+
+/**
+ * @brief What to run, from the command line.
+ */
+struct RunOptions {
+    std::size_t cars = 1; ///< Cars in the fleet
+    std::uint64_t ticks = 0; ///< ECU cycles per car to run; 0 to use seconds
+    double seconds = 10.0; ///< Simulated seconds to run when ticks is 0
+    double warmup = AllocationAudit::isCompiledIn() ? 1.0 : 0.0; ///< Simulated seconds run before measuring
+    unsigned threads = 1; ///< Threads, each driving its own slice of the fleet
+    bool seeded = false; ///< Whether seed was given
+    std::uint64_t seed = 0; ///< Seed of the sensor random engines
+    LogLevel logLevel = LogLevel::WARNING; ///< Least severe message logged
+    std::vector<std::string> sinks; ///< Log sinks: console, file:PATH or none; the console when empty
+    bool diagnostics = true; ///< Whether the diagnostic ECU checks samples
+    bool acc = false; ///< Whether adaptive cruise control is on
+    bool fusion = true; ///< Whether the sensor fusion ECU is attached
+    SensorStorage sensors = SensorStorage::HEAP; ///< Where the cars keep their built-in sensors
+    std::string configPath; ///< Runtime settings file; empty to keep the built-in thresholds
+    std::uint64_t configPollMs = 500; ///< Time between checks of the settings file
+    std::string checkpointPath; ///< File the simulation is saved to after the run; empty for none
+    std::string restorePath; ///< Checkpoint to resume instead of building a fleet; empty for none
+    std::string rulesPath; ///< Alert rule file evaluated over the fleet; empty for none
+};
+
+static void PrintUsage(const char* program) {
+    std::printf("Usage: %s [options]\n"
+                "  --cars N                cars in the fleet (default 1)\n"
+                "  --ticks N               ECU cycles per car to simulate, one per consume period\n"
+                "  --duration SECONDS      simulated seconds to run when --ticks is not given (default 10)\n"
+                "  --warmup SECONDS        simulated seconds run before measuring (default 0, 1 in audit builds)\n"
+                "  --threads N             threads, each driving a slice of the fleet (default 1)\n"
+                "  --seed N                seed of the sensor random engines (default: random)\n"
+                "  --log-level LEVEL       debug, info, warning, error or off (default warning)\n"
+                "  --log-sink SINK         console, file:PATH or none; may be repeated (default console)\n"
+                "  --diagnostics on|off    diagnostic ECU checks (default on)\n"
+                "  --acc on|off            adaptive cruise control (default off)\n"
+                "  --fusion on|off         radar and speed sensor fusion (default on)\n"
+                "  --sensors heap|inline   where cars keep their built-in sensors (default heap)\n"
+                "  --config PATH           runtime settings file, reloaded when it changes\n"
+                "  --config-poll MS        time between checks of the settings file (default 500)\n"
+                "  --checkpoint PATH       save the whole simulation to PATH after the run\n"
+                "  --restore PATH          resume a checkpoint; its fleet, threads and ECU switches\n"
+                "                          replace --cars, --threads, --diagnostics, --acc and --fusion,\n"
+                "                          and --seed reseeds every sensor to fork a what-if run\n"
+                "  --rules PATH            alert rule file evaluated over every car each simulated second\n"
+                "  --help                  show this help\n",
+                program);
+}
+
+static bool ParseSwitch(const char* text, bool& value) {
+    if (std::strcmp(text, "on") == 0) {
+        value = true;
+        return true;
+    }
+    if (std::strcmp(text, "off") == 0) {
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+static bool ParseCount(const char* text, std::uint64_t& value) {
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoull(text, &end, 10);
+    return end != text && *end == '\0' && text[0] != '-' && errno != ERANGE;
+}
+
+static bool ParseSeconds(const char* text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text, &end);
+    return end != text && *end == '\0' && value >= 0 && value <= Max_Simulated_Seconds;
+}
+
+/**
+ * @brief Fills options from the command line.
+ *
+ * @return int -1 to run, otherwise the exit code to return with.
+ */
+static int ParseOptions(int argc, char** argv, RunOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string name = argv[i];
+        if (name == "--help" || name == "-h") {
+            PrintUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "%s: missing value for %s\n", argv[0], name.c_str());
+            return 2;
+        }
+        const char* value = argv[++i];
+        std::uint64_t count = 0;
+        bool ok = true;
+        if (name == "--cars") {
+            ok = ParseCount(value, count) && count > 0 && count <= Max_Cars;
+            options.cars = (std::size_t)count;
+        } else if (name == "--ticks") {
+            const std::int64_t period = std::chrono::nanoseconds(ConcurrentRunnerConfig::Defaults().consumePeriod).count();
+            ok = ParseCount(value, count) && count > 0 && count <= (std::uint64_t)(Max_Simulated_Seconds * 1e9) / period;
+            options.ticks = count;
+        } else if (name == "--duration") {
+            ok = ParseSeconds(value, options.seconds) && options.seconds > 0;
+        } else if (name == "--warmup") {
+            ok = ParseSeconds(value, options.warmup);
+        } else if (name == "--threads") {
+            ok = ParseCount(value, count) && count > 0 && count <= 1024;
+            options.threads = (unsigned)count;
+        } else if (name == "--seed") {
+            ok = ParseCount(value, options.seed);
+            options.seeded = true;
+        } else if (name == "--log-level") {
+            ok = Logger::ParseLevel(value, options.logLevel);
+        } else if (name == "--log-sink") {
+            const std::string sink = value;
+            ok = sink == "console" || sink == "none" || (sink.compare(0, 5, "file:") == 0 && sink.size() > 5);
+            options.sinks.push_back(sink);
+        } else if (name == "--diagnostics") {
+            ok = ParseSwitch(value, options.diagnostics);
+        } else if (name == "--acc") {
+            ok = ParseSwitch(value, options.acc);
+        } else if (name == "--fusion") {
+            ok = ParseSwitch(value, options.fusion);
+        } else if (name == "--sensors") {
+            ok = std::strcmp(value, "heap") == 0 || std::strcmp(value, "inline") == 0;
+            options.sensors = std::strcmp(value, "inline") == 0 ? SensorStorage::INLINE : SensorStorage::HEAP;
+        } else if (name == "--config") {
+            options.configPath = value;
+        } else if (name == "--config-poll") {
+            ok = ParseCount(value, options.configPollMs) && options.configPollMs > 0;
+        } else if (name == "--checkpoint") {
+            options.checkpointPath = value;
+        } else if (name == "--restore") {
+            options.restorePath = value;
+        } else if (name == "--rules") {
+            options.rulesPath = value;
+        } else {
+            std::fprintf(stderr, "%s: unknown option %s\n", argv[0], name.c_str());
+            PrintUsage(argv[0]);
+            return 2;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "%s: bad value for %s: %s\n", argv[0], name.c_str(), value);
+            return 2;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Points the logger at the sinks of the options.
+ *
+ * @return bool false if a log file could not be opened.
+ */
+static bool ConfigureLogger(const RunOptions& options) {
+    Logger& logger = Logger::getInstance();
+    logger.setLevel(options.logLevel);
+    bool console = options.sinks.empty();
+    std::string path;
+    for (const std::string& sink : options.sinks) {
+        if (sink == "console") {
+            console = true;
+        } else if (sink.compare(0, 5, "file:") == 0) {
+            path = sink.substr(5);
+        }
+    }
+    logger.setConsoleSink(console);
+    if (!path.empty() && !logger.setFileSink(path)) {
+        std::fprintf(stderr, "cannot open log file %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * @brief One thread's share of the fleet.
+ */
+struct Slice {
+    std::vector<Car*> cars; ///< Cars driven by this slice
+    std::unique_ptr<EventEngine> engine; ///< Engine over cars
+    double statusSeconds = 0.0; ///< Time spent in DisplayStatus
+    std::unique_ptr<AlertEngine> alerts; ///< Alert rules over cars, or null without --rules
+    std::vector<double> signals[Sensor_Types_Count]; ///< Signal columns the rules read, one value per car
+    std::vector<AlertTransition> transitions; ///< Transitions of the last evaluation, reused
+    double rulesSeconds = 0.0; ///< Time spent evaluating the alert rules
+};
+
+/**
+ * @brief Alert rules loaded with --rules, shared read-only by every slice.
+ */
+struct LoadedRules {
+    AlertRuleSet set; ///< The rules and their messages
+    std::vector<std::string> texts; ///< Message text of each rule, looked up once
+};
+
+/**
+ * @brief Evaluates the alert rules over a slice's cars and reports the transitions.
+ *
+ * The rules see the signals DisplayStatus checks, the fused range in place
+ * of the radar when fusion has an estimate. Raised rules are logged at
+ * their severity and cleared ones at INFO.
+ */
+static void EvaluateRules(Slice& slice, const LoadedRules& rules) {
+    const double* columns[Sensor_Types_Count];
+    for (int s = 0; s < Sensor_Types_Count; s++) {
+        columns[s] = slice.signals[s].data();
+    }
+    for (std::size_t i = 0; i < slice.cars.size(); i++) {
+        const CarSnapshot snapshot = slice.cars[i]->getSnapshot();
+        const SensorFusionECU* fusion = slice.cars[i]->getSensorFusion();
+        for (int s = 0; s < Sensor_Types_Count; s++) {
+            slice.signals[s][i] = snapshot.values[s];
+        }
+        if (fusion != nullptr && fusion->hasEstimate()) {
+            slice.signals[(int)SensorTypes::RADAR_SENSOR][i] = fusion->getRange();
+        }
+    }
+    slice.transitions.clear();
+    slice.alerts->Evaluate(columns, slice.transitions);
+
+    static const LogLevel Severity_Levels[] = {LogLevel::INFO, LogLevel::WARNING, LogLevel::ERROR}; // Indexed by AlertSeverity
+    const CarMetrics& metrics = CarMetrics::get();
+    Logger& logger = Logger::getInstance();
+    for (const AlertTransition& t : slice.transitions) {
+        (t.raised ? metrics.ruleAlertsRaised : metrics.ruleAlertsCleared)->Increment();
+        const LogLevel level = t.raised ? Severity_Levels[(int)rules.set.rules[t.rule].severity] : LogLevel::INFO;
+        if (logger.isEnabled(level)) {
+            const Car& c = *slice.cars[t.car];
+            char line[256];
+            std::snprintf(line, sizeof(line), "%s %s: %s %s", c.getMake().c_str(), c.getModel().c_str(),
+                          t.raised ? "raised" : "cleared", rules.texts[t.rule].c_str());
+            logger.log(level, line);
+        }
+    }
+}
+
+/**
+ * @brief Runs a slice in chunks of one simulated second, showing every car's status after each.
+ */
+static void RunSlice(Slice& slice, const LoadedRules& rules, std::chrono::nanoseconds duration) {
+    const std::chrono::nanoseconds chunk = std::chrono::seconds(1);
+    for (std::chrono::nanoseconds done(0); done < duration; done += chunk) {
+        slice.engine->RunFor(std::min(chunk, duration - done));
+        Clock::time_point start = Clock::now();
+        AllocationAuditTick tick;
+        for (Car* c : slice.cars) {
+            c->DisplayStatus();
+        }
+        slice.statusSeconds += SecondsSince(start);
+        if (slice.alerts) {
+            start = Clock::now();
+            EvaluateRules(slice, rules);
+            slice.rulesSeconds += SecondsSince(start);
+        }
+    }
+}
+
+/**
+ * @brief Runs every slice for the same stretch of simulated time, one thread each.
+ */
+static void RunSlices(std::vector<Slice>& slices, const LoadedRules& rules, std::chrono::nanoseconds duration) {
+    if (slices.size() == 1) {
+        RunSlice(slices[0], rules, duration);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (Slice& slice : slices) {
+        workers.emplace_back(RunSlice, std::ref(slice), std::cref(rules), duration);
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+}
+
+/**
+ * @brief Builds the fleet in a pool and splits it into slices, one engine each; starting an engine turns diagnostics on.
+ */
+static void BuildSlices(CarPool& pool, const RunOptions& options, const ConcurrentRunnerConfig& config, std::vector<Slice>& slices) {
+    pool.emplaceMany(options.cars, "rio", "kia");
+    slices.resize(std::min<std::size_t>(options.threads, options.cars));
+    for (std::size_t i = 0; i < pool.size(); i++) {
+        Car& c = pool[i];
+        if (options.fusion) {
+            c.EnableSensorFusion();
+        }
+        if (options.acc) {
+            c.setAdaptiveMode(true);
+        }
+        if (!options.configPath.empty()) {
+            c.FollowRuntimeConfig();
+        }
+        slices[i * slices.size() / pool.size()].cars.push_back(&c);
+    }
+    // Each car keeps the sampling phase it would have with one thread, so the split does not change a seeded run
+    std::size_t firstCar = 0;
+    for (Slice& slice : slices) {
+        slice.engine.reset(new EventEngine(slice.cars, config, firstCar, pool.size()));
+        firstCar += slice.cars.size();
+        for (Car* c : slice.cars) {
+            c->setDiagnosticMode(options.diagnostics);
+        }
+    }
+}
+
+/**
+ * @brief Resumes a checkpoint into a pool, one slice per saved engine.
+ *
+ * With a seed every sensor is reseeded from it, which forks the run from
+ * the saved one; without, the run continues as the saved one would have.
+ *
+ * @return bool false if the checkpoint could not be restored.
+ */
+static bool RestoreSlices(const Checkpoint& checkpoint, CarPool& pool, const RunOptions& options, std::vector<Slice>& slices, std::string& error) {
+    std::vector<std::unique_ptr<EventEngine>> engines;
+    if (!checkpoint.Restore(pool, engines, error)) {
+        return false;
+    }
+    if (options.seeded) {
+        Sensor::SetSeedBase(options.seed);
+    }
+    slices.resize(engines.size());
+    for (std::size_t i = 0; i < engines.size(); i++) {
+        slices[i].cars = engines[i]->getCars();
+        slices[i].engine = std::move(engines[i]);
+        for (Car* c : slices[i].cars) {
+            if (!options.configPath.empty()) {
+                c->FollowRuntimeConfig();
+            }
+            if (!options.seeded) {
+                continue;
+            }
+            for (const std::shared_ptr<Sensor>& sensor : c->getSensors()) {
+                sensor->Reseed();
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    RunOptions options;
+    const int exitCode = ParseOptions(argc, argv, options);
+    if (exitCode >= 0) {
+        return exitCode;
+    }
+    if (!ConfigureLogger(options)) {
+        return 1;
+    }
+    if (options.seeded) {
+        Sensor::SetSeedBase(options.seed);
+    }
+    std::string error;
+    if (!options.configPath.empty() && !RuntimeConfig::get().LoadFile(options.configPath, error)) {
+        std::fprintf(stderr, "%s: %s\n", argv[0], error.c_str());
+        return 2;
+    }
+    LoadedRules rules;
+    if (!options.rulesPath.empty()) {
+        try {
+            rules.set = LoadAlertRuleFile(options.rulesPath);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s: %s\n", argv[0], e.what());
+            return 2;
+        }
+        for (const AlertRule& rule : rules.set.rules) {
+            rules.texts.push_back(rules.set.messageText(rule.messageId));
+        }
+    }
+    const ConcurrentRunnerConfig config = ConcurrentRunnerConfig::Defaults();
+    const std::chrono::nanoseconds duration = options.ticks > 0
+        ? std::chrono::nanoseconds(config.consumePeriod) * (std::int64_t)options.ticks
+        : std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(options.seconds));
+
+    // Build the fleet and one engine per slice, or resume them from a checkpoint
+    Clock::time_point start = Clock::now();
+    Checkpoint checkpoint;
+    if (!options.restorePath.empty()) {
+        if (!checkpoint.Open(options.restorePath, error)) {
+            std::fprintf(stderr, "%s: %s\n", argv[0], error.c_str());
+            return 2;
+        }
+        options.cars = checkpoint.getCarCount();
+    }
+    std::unique_ptr<CarPool> fleet;
+    try {
+        fleet = std::make_unique<CarPool>(options.cars, true, options.sensors);
+    } catch (const std::bad_alloc&) {
+        std::fprintf(stderr, "%s: cannot allocate %zu cars\n", argv[0], options.cars);
+        return 2;
+    }
+    CarPool& pool = *fleet;
+    std::vector<Slice> slices;
+    if (options.restorePath.empty()) {
+        BuildSlices(pool, options, config, slices);
+    } else if (!RestoreSlices(checkpoint, pool, options, slices, error)) {
+        std::fprintf(stderr, "%s: %s: %s\n", argv[0], options.restorePath.c_str(), error.c_str());
+        return 2;
+    }
+    const unsigned threads = (unsigned)slices.size();
+    const double buildSeconds = SecondsSince(start);
+    if (!options.restorePath.empty()) {
+        std::printf("restored %zu cars on %u threads from %s (%.1f MB) in %.3f s\n", pool.size(), threads,
+                    options.restorePath.c_str(), checkpoint.getFileBytes() / 1e6, buildSeconds);
+        checkpoint.Close();
+    }
+
+    // One rule engine per slice, so each thread evaluates its own cars
+    if (!rules.set.rules.empty()) {
+        for (Slice& slice : slices) {
+            slice.alerts.reset(new AlertEngine(rules.set.rules, slice.cars.size()));
+            for (std::vector<double>& column : slice.signals) {
+                column.resize(slice.cars.size());
+            }
+            slice.transitions.reserve(slice.cars.size());
+        }
+    }
+
+    // A restored car creates its histories as samples arrive, slow sensors only after many ticks; the audit creates them now
+    if (AllocationAudit::isCompiledIn() && !options.restorePath.empty()) {
+        for (std::size_t i = 0; i < pool.size(); i++) {
+            pool[i].CreateSampleHistories();
+        }
+    }
+
+    // Every sensor has reported and every status line has been shown once after the warm-up
+    if (options.warmup > 0) {
+        RunSlices(slices, rules, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(options.warmup)));
+        for (Slice& slice : slices) {
+            slice.engine->ResetStats();
+            slice.statusSeconds = 0.0;
+            slice.rulesSeconds = 0.0;
+        }
+    }
+    std::uint64_t alertsBefore[CAR_ALERT_COUNT];
+    for (int i = 0; i < CAR_ALERT_COUNT; i++) {
+        alertsBefore[i] = CarMetrics::get().alerts[i]->value();
+    }
+    const std::uint64_t raisedBefore = CarMetrics::get().ruleAlertsRaised->value();
+    const std::uint64_t clearedBefore = CarMetrics::get().ruleAlertsCleared->value();
+    if (AllocationAudit::isCompiledIn()) {
+        AllocationAudit::Arm(true);
+    }
+
+    std::unique_ptr<ConfigReloader> reloader;
+    if (!options.configPath.empty()) {
+        reloader.reset(new ConfigReloader(options.configPath, std::chrono::milliseconds(options.configPollMs)));
+    }
+
+    start = Clock::now();
+    RunSlices(slices, rules, duration);
+    const double runSeconds = SecondsSince(start);
+
+    EventEngineStats total{};
+    double statusSeconds = 0.0;
+    double rulesSeconds = 0.0;
+    for (const Slice& slice : slices) {
+        const EventEngineStats& stats = slice.engine->getStats();
+        total.events += stats.events;
+        for (int kind = 0; kind < EVENT_KIND_COUNT; kind++) {
+            total.perKind[kind] += stats.perKind[kind];
+            total.perKindSeconds[kind] += stats.perKindSeconds[kind];
+        }
+        statusSeconds += slice.statusSeconds;
+        rulesSeconds += slice.rulesSeconds;
+    }
+    std::uint64_t samples = 0;
+    double sampleSeconds = 0.0;
+    for (int kind = 0; kind < MAX_SENSOR_NUMBER; kind++) {
+        samples += total.perKind[kind];
+        sampleSeconds += total.perKindSeconds[kind];
+    }
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    const double simulated = std::chrono::duration<double>(duration).count();
+    std::printf("cars=%zu threads=%u simulated=%.2f s wall=%.3f s (%.1fx real time)\n",
+                options.cars, threads, simulated, runSeconds, simulated / runSeconds);
+    std::printf("samples=%llu (%.0f/s) ecu cycles=%llu events=%llu (%.0f/s)\n",
+                (unsigned long long)samples, samples / runSeconds,
+                (unsigned long long)total.perKind[EVENT_KIND_ECU],
+                (unsigned long long)total.events, total.events / runSeconds);
+    std::printf("stages: build %.3f s, sampling %.3f s, ecu %.3f s, status %.3f s (thread seconds)\n",
+                buildSeconds, sampleSeconds, total.perKindSeconds[EVENT_KIND_ECU], statusSeconds);
+    std::printf("peak rss=%ld kB\n", usage.ru_maxrss);
+    std::printf("alerts:");
+    for (int i = 0; i < CAR_ALERT_COUNT; i++) {
+        std::printf(" %s=%llu", Alert_Names[i], (unsigned long long)(CarMetrics::get().alerts[i]->value() - alertsBefore[i]));
+    }
+    std::printf("\n");
+    if (!rules.set.rules.empty()) {
+        std::printf("rules: %zu from %s, raised=%llu cleared=%llu, %.3f s (thread seconds)\n",
+                    rules.set.rules.size(), options.rulesPath.c_str(),
+                    (unsigned long long)(CarMetrics::get().ruleAlertsRaised->value() - raisedBefore),
+                    (unsigned long long)(CarMetrics::get().ruleAlertsCleared->value() - clearedBefore), rulesSeconds);
+    }
+    if (reloader) {
+        reloader->Stop();
+        const ConfigReloaderStats reloads = reloader->getStats();
+        Rcu::Reclaim();
+        std::uint64_t version = 0;
+        {
+            RcuReadGuard guard;
+            version = RuntimeConfig::get().Current()->version;
+        }
+        std::printf("config: version=%llu reloads=%llu errors=%llu retired=%zu reclaimed=%llu\n",
+                    (unsigned long long)version, (unsigned long long)reloads.reloads, (unsigned long long)reloads.errors,
+                    Rcu::getRetiredCount(), (unsigned long long)Rcu::getReclaimedCount());
+    }
+
+    if (!options.checkpointPath.empty()) {
+        std::vector<const EventEngine*> engines;
+        for (const Slice& slice : slices) {
+            engines.push_back(slice.engine.get());
+        }
+        start = Clock::now();
+        if (!Checkpoint::Save(options.checkpointPath, pool, engines, error)) {
+            std::fprintf(stderr, "%s: %s\n", argv[0], error.c_str());
+            return 1;
+        }
+        std::printf("checkpoint: %zu cars saved to %s in %.3f s\n", pool.size(), options.checkpointPath.c_str(), SecondsSince(start));
+    }
+
+    if (!AllocationAudit::isCompiledIn()) {
+        return 0;
+    }
+    AllocationAudit::Arm(false);
+    AllocationAudit::Report(stdout);
+    return AllocationAudit::getTickAllocations() == 0 ? 0 : 3;
+}
@@ -0,0 +1,92 @@
+#include "CompactSample.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Indexed by SensorTypes; ranges follow the sensor generators with headroom
+static const SampleEncoding Sensor_Encodings[] = {
+    {0.0, 320.0 / 65535.0},    // Speed: 0 to 320 km/h
+    {-40.0, 360.0 / 65535.0},  // Temperature: -40 to 320 degrees
+    {0.0, 50.0 / 65535.0},     // Radar: 0 to 50 m
+    {0.0, 100.0 / 65535.0}     // Battery level: 0 to 100 %
+};
+
+static const SampleEncoding Identity_Encoding = {0.0, 1.0};
+
+/**
+ * @brief Gets the encoding of a sensor type.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @return const SampleEncoding& The encoding.
+ */
+const SampleEncoding& EncodingFor(int sensorType) {
+    const int known = sizeof(Sensor_Encodings) / sizeof(Sensor_Encodings[0]);
+    return sensorType >= 0 && sensorType < known ? Sensor_Encodings[sensorType] : Identity_Encoding;
+}
+
+/**
+ * @brief Encodes a batch of values, four at a time with SSE2.
+ * 
+ * @details Codes are clamped in the double domain, converted with the
+ * default round-to-nearest mode (matching std::nearbyint in the scalar path)
+ * and packed to 16 bits by biasing into the signed range.
+ * 
+ * @param in Values to encode.
+ * @param out Destination codes.
+ * @param count Number of values.
+ * @param enc The encoding.
+ */
+void EncodeSamples(const double* in, CompactSample* out, std::size_t count, const SampleEncoding& enc) {
+    std::size_t i = 0;
+#ifdef __SSE2__
+    const __m128d offset = _mm_set1_pd(enc.offset);
+    const __m128d inverse = _mm_set1_pd(1.0 / enc.scale);
+    const __m128d low = _mm_setzero_pd();
+    const __m128d high = _mm_set1_pd(65535.0);
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+
+    for (; i + 4 <= count; i += 4) {
+        __m128d a = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(in + i), offset), inverse);
+        __m128d b = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(in + i + 2), offset), inverse);
+        a = _mm_min_pd(_mm_max_pd(a, low), high);
+        b = _mm_min_pd(_mm_max_pd(b, low), high);
+        __m128i ia = _mm_sub_epi32(_mm_cvtpd_epi32(a), bias);
+        __m128i ib = _mm_sub_epi32(_mm_cvtpd_epi32(b), bias);
+        __m128i packed = _mm_packs_epi32(_mm_unpacklo_epi64(ia, ib), _mm_setzero_si128());
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(packed, flip));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = EncodeSample(in[i], enc);
+    }
+}
+
+/**
+ * @brief Decodes a batch of codes, four at a time with SSE2.
+ * 
+ * @param in Codes to decode.
+ * @param out Destination values.
+ * @param count Number of codes.
+ * @param enc The encoding.
+ */
+void DecodeSamples(const CompactSample* in, double* out, std::size_t count, const SampleEncoding& enc) {
+    std::size_t i = 0;
+#ifdef __SSE2__
+    const __m128d offset = _mm_set1_pd(enc.offset);
+    const __m128d scale = _mm_set1_pd(enc.scale);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i codes = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)), zero);
+        __m128d a = _mm_cvtepi32_pd(codes);
+        __m128d b = _mm_cvtepi32_pd(_mm_srli_si128(codes, 8));
+        _mm_storeu_pd(out + i, _mm_add_pd(offset, _mm_mul_pd(a, scale)));
+        _mm_storeu_pd(out + i + 2, _mm_add_pd(offset, _mm_mul_pd(b, scale)));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = DecodeSample(in[i], enc);
+    }
+}
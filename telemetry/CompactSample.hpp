@@ -0,0 +1,113 @@
+#ifndef COMPACT_SAMPLE_H
+#define COMPACT_SAMPLE_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/// A sample stored as 16-bit fixed point; see SampleEncoding.
+typedef std::uint16_t CompactSample;
+
+/**
+ * @brief Fixed-point mapping of one sensor type: value = offset + code * scale.
+ * 
+ * @details The range [offset, offset + 65535 * scale] covers the physical
+ * range of the sensor, so the quantisation step is range / 65535 (about
+ * 0.005 km/h for speed, 0.0008 m for radar).
+ */
+struct SampleEncoding {
+    double offset; ///< Value represented by code 0
+    double scale; ///< Value step between consecutive codes
+};
+
+/**
+ * @brief Gets the encoding of a sensor type.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @return const SampleEncoding& The encoding; unknown types get a 0..65535 identity mapping.
+ */
+const SampleEncoding& EncodingFor(int sensorType);
+
+/**
+ * @brief Converts a value to fixed point, rounding to nearest and clamping to the range.
+ * 
+ * @param value The value.
+ * @param enc The encoding.
+ * @return CompactSample The code.
+ */
+inline CompactSample EncodeSample(double value, const SampleEncoding& enc) {
+    double code = std::nearbyint((value - enc.offset) * (1.0 / enc.scale));
+    code = code < 0.0 ? 0.0 : (code > 65535.0 ? 65535.0 : code);
+    return static_cast<CompactSample>(code);
+}
+
+/**
+ * @brief Converts a fixed-point code back to a value.
+ * 
+ * @param code The code.
+ * @param enc The encoding.
+ * @return double The value.
+ */
+inline double DecodeSample(CompactSample code, const SampleEncoding& enc) {
+    return enc.offset + code * enc.scale;
+}
+
+/**
+ * @brief Encodes a batch of values; uses SSE2 when available.
+ * 
+ * @param in Values to encode.
+ * @param out Destination codes; may not overlap in.
+ * @param count Number of values.
+ * @param enc The encoding.
+ */
+void EncodeSamples(const double* in, CompactSample* out, std::size_t count, const SampleEncoding& enc);
+
+/**
+ * @brief Decodes a batch of codes; uses SSE2 when available.
+ * 
+ * @param in Codes to decode.
+ * @param out Destination values; may not overlap in.
+ * @param count Number of codes.
+ * @param enc The encoding.
+ */
+void DecodeSamples(const CompactSample* in, double* out, std::size_t count, const SampleEncoding& enc);
+
+#ifdef CARECU_COMPACT_SAMPLES
+typedef CompactSample StoredSample; ///< Representation used by ECU tables and history
+#else
+typedef double StoredSample; ///< Representation used by ECU tables and history
+#endif
+
+/**
+ * @brief Converts a value to the representation selected at build time.
+ * 
+ * @param value The value.
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @return StoredSample The stored representation.
+ */
+inline StoredSample ToStoredSample(double value, int sensorType) {
+#ifdef CARECU_COMPACT_SAMPLES
+    return EncodeSample(value, EncodingFor(sensorType));
+#else
+    (void)sensorType;
+    return value;
+#endif
+}
+
+/**
+ * @brief Converts a stored sample back to a value.
+ * 
+ * @param stored The stored representation.
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @return double The value.
+ */
+inline double FromStoredSample(StoredSample stored, int sensorType) {
+#ifdef CARECU_COMPACT_SAMPLES
+    return DecodeSample(stored, EncodingFor(sensorType));
+#else
+    (void)sensorType;
+    return stored;
+#endif
+}
+
+#endif // !COMPACT_SAMPLE_H
@@ -0,0 +1,86 @@
+#include "FleetSampleStore.hpp"
+
+/**
+ * @brief Constructs a store with every sample at code 0.
+ * 
+ * @param cars Number of car slots.
+ */
+FleetSampleStore::FleetSampleStore(std::size_t cars) : cars(cars) {
+    for (auto& c : columns) {
+        c.assign(cars, 0);
+    }
+}
+
+/**
+ * @brief Stores one sample.
+ * 
+ * @param car Car slot.
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param value The value to store.
+ */
+void FleetSampleStore::store(std::size_t car, int sensorType, double value) {
+    columns[sensorType][car] = EncodeSample(value, EncodingFor(sensorType));
+}
+
+/**
+ * @brief Loads one sample.
+ * 
+ * @param car Car slot.
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @return double The decoded value.
+ */
+double FleetSampleStore::load(std::size_t car, int sensorType) const {
+    return DecodeSample(columns[sensorType][car], EncodingFor(sensorType));
+}
+
+/**
+ * @brief Stores a run of consecutive car slots of one column.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param first First car slot.
+ * @param values Values for slots first .. first + count - 1.
+ * @param count Number of values.
+ */
+void FleetSampleStore::storeColumn(int sensorType, std::size_t first, const double* values, std::size_t count) {
+    EncodeSamples(values, columns[sensorType].data() + first, count, EncodingFor(sensorType));
+}
+
+/**
+ * @brief Loads a run of consecutive car slots of one column.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @param first First car slot.
+ * @param values Receives the decoded values.
+ * @param count Number of values.
+ */
+void FleetSampleStore::loadColumn(int sensorType, std::size_t first, double* values, std::size_t count) const {
+    DecodeSamples(columns[sensorType].data() + first, values, count, EncodingFor(sensorType));
+}
+
+/**
+ * @brief Gets the raw codes of one column.
+ * 
+ * @param sensorType The sensor type (index of SensorTypes).
+ * @return const CompactSample* Pointer to size() codes.
+ */
+const CompactSample* FleetSampleStore::column(int sensorType) const {
+    return columns[sensorType].data();
+}
+
+/**
+ * @brief Gets the number of car slots.
+ * 
+ * @return std::size_t The slot count.
+ */
+std::size_t FleetSampleStore::size() const {
+    return cars;
+}
+
+/**
+ * @brief Gets the memory used by the sample columns.
+ * 
+ * @return std::size_t Bytes.
+ */
+std::size_t FleetSampleStore::bytes() const {
+    return cars * Sensor_Types_Count * sizeof(CompactSample);
+}
@@ -0,0 +1,93 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief Fixed-capacity ring buffer that never allocates.
+ *
+ * @details Storage is an inline std::array, so a SampleRing can live inside
+ * any object (ECU tables, history buffers) without touching the heap. When
+ * the ring is full, pushing overwrites the oldest element.
+ *
+ * @tparam T        Element type.
+ * @tparam Capacity Number of elements kept; must be a power of two so the
+ *                  index wrap is a mask instead of a division.
+ */
+template <typename T, std::size_t Capacity>
+class SampleRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SampleRing capacity must be a power of two");
+
+public:
+    SampleRing() : head(0), count(0) {}
+
+    /**
+     * @brief Appends an element, overwriting the oldest one when full.
+     *
+     * @param value The element to store.
+     */
+    void push(const T& value) {
+        storage[head] = value;
+        head = (head + 1) & (Capacity - 1);
+        if (count < Capacity) {
+            ++count;
+        }
+    }
+
+    /**
+     * @brief Accesses an element by age.
+     *
+     * @param i 0 is the oldest element kept, size() - 1 the newest.
+     * @return Reference to the element.
+     */
+    const T& operator[](std::size_t i) const {
+        return storage[(head + Capacity - count + i) & (Capacity - 1)];
+    }
+
+    /**
+     * @brief Gets the most recently pushed element.
+     *
+     * @return Reference to the newest element; undefined when empty.
+     */
+    const T& back() const {
+        return storage[(head + Capacity - 1) & (Capacity - 1)];
+    }
+
+    /**
+     * @brief Gets the number of elements currently kept.
+     *
+     * @return Element count, never larger than capacity().
+     */
+    std::size_t size() const { return count; }
+
+    /**
+     * @brief Checks whether the ring holds no elements.
+     *
+     * @return true if nothing was pushed since construction or clear().
+     */
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Gets the fixed capacity of the ring.
+     *
+     * @return The Capacity template argument.
+     */
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    /**
+     * @brief Drops all elements without releasing storage.
+     */
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+private:
+    std::array<T, Capacity> storage; ///< Inline element storage
+    std::size_t head;                ///< Index of the next slot to write
+    std::size_t count;               ///< Number of valid elements
+};
+
+#endif // !SAMPLE_RING_H
@@ -0,0 +1,170 @@
+#include "SensorHistory.hpp"
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @brief Gets the current steady-clock time in nanoseconds.
+ *
+ * @return Nanoseconds since the steady clock epoch.
+ */
+TimestampNs SteadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static thread_local const std::int64_t* Sample_Clock = nullptr; ///< Installed by SampleClockScope on the calling thread
+
+/**
+ * @brief Gets the time the calling thread stamps samples with.
+ *
+ * @return The simulated clock of the innermost SampleClockScope, or SteadyNowNs().
+ */
+TimestampNs SampleNowNs() {
+    return Sample_Clock != nullptr ? *Sample_Clock : SteadyNowNs();
+}
+
+/**
+ * @brief Installs a simulated clock for the calling thread.
+ *
+ * @param clock Simulated time in nanoseconds.
+ */
+SampleClockScope::SampleClockScope(const std::int64_t* clock) : previous(Sample_Clock) {
+    Sample_Clock = clock;
+}
+
+/**
+ * @brief Puts back the clock the thread had before.
+ */
+SampleClockScope::~SampleClockScope() {
+    Sample_Clock = previous;
+}
+
+/**
+ * @brief Constructs a window whose buckets are all marked as unused.
+ *
+ * @param bucketWidth Width of one bucket in nanoseconds.
+ */
+RollupWindow::RollupWindow(TimestampNs bucketWidth) : bucketWidth(bucketWidth) {
+    for (auto& b : buckets) {
+        b.epoch = -1;
+        b.stats = WindowStats{0, 0.0, 0.0, 0.0};
+    }
+}
+
+/**
+ * @brief Adds a sample, recycling its bucket if it still holds an older epoch.
+ *
+ * @param time  Sample timestamp.
+ * @param value Sample value.
+ */
+void RollupWindow::add(TimestampNs time, double value) {
+    const std::int64_t epoch = time / bucketWidth;
+    Bucket& b = buckets[epoch % BucketCount];
+
+    if (b.epoch != epoch) {
+        // The slot belongs to a bucket that already left the window
+        b.epoch = epoch;
+        b.stats = WindowStats{1, value, value, value};
+        return;
+    }
+
+    b.stats.count++;
+    b.stats.min = std::min(b.stats.min, value);
+    b.stats.max = std::max(b.stats.max, value);
+    b.stats.sum += value;
+}
+
+/**
+ * @brief Combines the buckets whose epoch is within the last BucketCount epochs.
+ *
+ * @param now The time the window ends at.
+ * @return Aggregate over the window.
+ */
+WindowStats RollupWindow::query(TimestampNs now) const {
+    const std::int64_t newest = now / bucketWidth;
+    WindowStats result{0, 0.0, 0.0, 0.0};
+
+    for (const auto& b : buckets) {
+        if (b.epoch < 0 || b.epoch > newest || b.epoch <= newest - BucketCount) {
+            continue; // Unused, from the future, or expired
+        }
+        if (result.count == 0) {
+            result = b.stats;
+            continue;
+        }
+        result.count += b.stats.count;
+        result.min = std::min(result.min, b.stats.min);
+        result.max = std::max(result.max, b.stats.max);
+        result.sum += b.stats.sum;
+    }
+    return result;
+}
+
+/**
+ * @brief Constructs the history with 1 s, 10 s and 1 min rollups.
+ *
+ * @param sensorType The sensor type (index of SensorTypes).
+ */
+SensorHistory::SensorHistory(int sensorType)
+    : sensorType(sensorType),
+      rollups{{RollupWindow(100000000LL),    // 1 s as 10 x 100 ms
+               RollupWindow(1000000000LL),   // 10 s as 10 x 1 s
+               RollupWindow(6000000000LL)}}  // 1 min as 10 x 6 s
+{
+}
+
+/**
+ * @brief Records a sample into the raw rings and every rollup.
+ *
+ * Rollups aggregate the exact value; only the raw ring is quantised.
+ *
+ * @param time  Sample timestamp.
+ * @param value Sample value.
+ */
+void SensorHistory::record(TimestampNs time, double value) {
+    times.push(time);
+    values.push(ToStoredSample(value, sensorType));
+    for (auto& r : rollups) {
+        r.add(time, value);
+    }
+}
+
+/**
+ * @brief Gets the rollup of one window.
+ *
+ * @param id  Which window to query.
+ * @param now The time the window ends at.
+ * @return Aggregate of the window.
+ */
+WindowStats SensorHistory::window(RollupWindowId id, TimestampNs now) const {
+    return rollups[int(id)].query(now);
+}
+
+/**
+ * @brief Gets the number of raw samples kept.
+ *
+ * @return Sample count, at most Capacity.
+ */
+std::size_t SensorHistory::size() const {
+    return values.size();
+}
+
+/**
+ * @brief Gets the timestamp of a raw sample.
+ *
+ * @param i 0 is the oldest sample kept.
+ * @return The timestamp.
+ */
+TimestampNs SensorHistory::sampleTime(std::size_t i) const {
+    return times[i];
+}
+
+/**
+ * @brief Gets the value of a raw sample.
+ *
+ * @param i 0 is the oldest sample kept.
+ * @return The value, decoded if stored in fixed point.
+ */
+double SensorHistory::sampleValue(std::size_t i) const {
+    return FromStoredSample(values[i], sensorType);
+}
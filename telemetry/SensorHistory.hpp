@@ -0,0 +1,200 @@
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include "SampleRing.hpp"
+#include "CompactSample.hpp"
+
+/// Timestamps are nanoseconds on a monotonic clock.
+typedef std::int64_t TimestampNs;
+
+/**
+ * @brief Gets the current time on the monotonic clock used for sample timestamps.
+ *
+ * @return Nanoseconds since an arbitrary steady epoch.
+ */
+TimestampNs SteadyNowNs();
+
+/**
+ * @brief Gets the time the calling thread stamps samples with.
+ *
+ * @details Inside a SampleClockScope this is the simulated time of the
+ * event engine driving the thread, so a seeded run stamps the same samples
+ * with the same times however fast the machine is; elsewhere it is
+ * SteadyNowNs().
+ *
+ * @return Nanoseconds on the thread's sample clock.
+ */
+TimestampNs SampleNowNs();
+
+/**
+ * @brief Makes SampleNowNs read a simulated clock on the calling thread while in scope.
+ */
+class SampleClockScope {
+public:
+    /**
+     * @brief Installs the clock.
+     *
+     * @param clock Simulated time in nanoseconds; must outlive the scope.
+     */
+    explicit SampleClockScope(const std::int64_t* clock);
+
+    /**
+     * @brief Puts back the clock the thread had before.
+     */
+    ~SampleClockScope();
+
+    // Deleted copy constructor and assignment operator
+    SampleClockScope(const SampleClockScope&) = delete;
+    SampleClockScope& operator=(const SampleClockScope&) = delete;
+
+private:
+    const std::int64_t* previous; ///< The thread's clock before this scope, or nullptr
+};
+
+/**
+ * @brief Aggregate of the samples that fell into a time window.
+ */
+struct WindowStats {
+    std::size_t count; ///< Number of samples in the window
+    double min;        ///< Smallest sample (0 when count is 0)
+    double max;        ///< Largest sample (0 when count is 0)
+    double sum;        ///< Sum of all samples
+
+    /**
+     * @brief Gets the arithmetic mean of the window.
+     *
+     * @return sum / count, or 0 for an empty window.
+     */
+    double mean() const { return count ? sum / count : 0.0; }
+};
+
+/**
+ * @enum RollupWindowId
+ * @brief The rollup resolutions kept for every sensor.
+ */
+enum class RollupWindowId {
+    ONE_SECOND = 0,  /**< Last second, 100 ms buckets */
+    TEN_SECONDS = 1, /**< Last 10 seconds, 1 s buckets */
+    ONE_MINUTE = 2   /**< Last minute, 6 s buckets */
+};
+
+#define Rollup_Window_Count 3 // Number of RollupWindowId values
+
+/**
+ * @brief Sliding window made of fixed-width time buckets.
+ *
+ * @details Each bucket aggregates count/min/max/sum of the samples whose
+ * timestamp falls into it. Adding a sample touches exactly one bucket and a
+ * query combines BucketCount buckets, so both are O(1) regardless of the
+ * sample rate. The window covers the current (partial) bucket plus the
+ * BucketCount - 1 before it.
+ */
+class RollupWindow {
+public:
+    static const int BucketCount = 10; ///< Buckets per window
+
+    /**
+     * @brief Constructs an empty window.
+     *
+     * @param bucketWidth Width of one bucket in nanoseconds.
+     */
+    explicit RollupWindow(TimestampNs bucketWidth);
+
+    /**
+     * @brief Adds a sample to the bucket its timestamp belongs to.
+     *
+     * @param time  Sample timestamp.
+     * @param value Sample value.
+     */
+    void add(TimestampNs time, double value);
+
+    /**
+     * @brief Combines the buckets that are still inside the window.
+     *
+     * @param now The time the window ends at.
+     * @return Aggregate over the window.
+     */
+    WindowStats query(TimestampNs now) const;
+
+private:
+    struct Bucket {
+        std::int64_t epoch; ///< Bucket number (time / width) the data belongs to
+        WindowStats stats;  ///< Aggregate of the bucket
+    };
+
+    std::array<Bucket, BucketCount> buckets; ///< Buckets indexed by epoch % BucketCount
+    TimestampNs bucketWidth;                 ///< Width of one bucket
+};
+
+/**
+ * @brief Bounded raw history and multi-resolution rollups for one sensor.
+ *
+ * @details Keeps the last Capacity raw samples in ring buffers and feeds
+ * every sample into the 1 s, 10 s and 1 min rollups. Timestamps and values
+ * are kept in separate rings so that, when built with
+ * CARECU_COMPACT_SAMPLES, values shrink to 16-bit fixed point. Nothing is
+ * allocated after construction.
+ */
+class SensorHistory {
+public:
+    static const std::size_t Capacity = 128; ///< Raw samples kept per sensor
+
+    /**
+     * @brief Constructs an empty history.
+     *
+     * @param sensorType The sensor type (index of SensorTypes), which selects
+     *                   the fixed-point encoding of the stored values.
+     */
+    explicit SensorHistory(int sensorType = -1);
+
+    /**
+     * @brief Records a sample into the raw rings and all rollups.
+     *
+     * @param time  Sample timestamp.
+     * @param value Sample value.
+     */
+    void record(TimestampNs time, double value);
+
+    /**
+     * @brief Gets the rollup of one window.
+     *
+     * @param id  Which window to query.
+     * @param now The time the window ends at.
+     * @return Aggregate of the window.
+     */
+    WindowStats window(RollupWindowId id, TimestampNs now) const;
+
+    /**
+     * @brief Gets the number of raw samples kept.
+     *
+     * @return Sample count, at most Capacity.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Gets the timestamp of a raw sample.
+     *
+     * @param i 0 is the oldest sample kept, size() - 1 the newest.
+     * @return The timestamp.
+     */
+    TimestampNs sampleTime(std::size_t i) const;
+
+    /**
+     * @brief Gets the value of a raw sample.
+     *
+     * @param i 0 is the oldest sample kept, size() - 1 the newest.
+     * @return The value, decoded if stored in fixed point.
+     */
+    double sampleValue(std::size_t i) const;
+
+private:
+    int sensorType; ///< Selects the encoding of stored values
+    SampleRing<TimestampNs, Capacity> times; ///< Timestamps of the last Capacity samples
+    SampleRing<StoredSample, Capacity> values; ///< Values of the last Capacity samples
+    std::array<RollupWindow, Rollup_Window_Count> rollups; ///< Indexed by RollupWindowId
+};
+
+#endif // !SENSOR_HISTORY_H
@@ -0,0 +1,266 @@
+#include "SharedTelemetryWindow.hpp"
+#include <bit>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+/**
+ * @brief Unlinks a segment whose creator is no longer running.
+ * 
+ * The segment is judged by its header, so one of another layout, or one
+ * still being initialized, is left alone. The name is only unlinked if it
+ * still refers to the segment examined, not to one another run has just
+ * put in its place.
+ * 
+ * @param name Segment name.
+ * @param reason Receives why the segment was kept.
+ * @return true if the name is free now.
+ */
+static bool UnlinkIfStale(const std::string& name, std::string& reason) {
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0); 
+    if (fd < 0) {
+        const bool gone = errno == ENOENT; 
+        reason = "cannot be inspected"; 
+        return gone; 
+    }
+    struct stat info; 
+    void* mapping = MAP_FAILED; 
+    if (fstat(fd, &info) == 0 && (std::size_t)info.st_size >= sizeof(ShmWindowHeader)) {
+        mapping = mmap(nullptr, sizeof(ShmWindowHeader), PROT_READ, MAP_SHARED, fd, 0); 
+    }
+    close(fd); 
+    if (mapping == MAP_FAILED) {
+        reason = "is not a telemetry window"; 
+        return false; 
+    }
+    const ShmWindowHeader* header = static_cast<const ShmWindowHeader*>(mapping); 
+    const bool known = header->magic.load(std::memory_order_acquire) == SHM_WINDOW_MAGIC && 
+                       header->version == SHM_WINDOW_VERSION && header->headerBytes == sizeof(ShmWindowHeader); 
+    const pid_t creator = header->creatorPid; 
+    munmap(mapping, sizeof(ShmWindowHeader)); 
+    if (!known || creator <= 0) {
+        reason = "has an unknown layout or is still being created; remove it if no simulator uses it"; 
+        return false; 
+    }
+    if (kill(creator, 0) == 0 || errno == EPERM) {
+        reason = "is in use by process " + std::to_string(creator); 
+        return false; 
+    }
+
+    struct stat current; 
+    const int again = shm_open(name.c_str(), O_RDONLY, 0); 
+    const bool same = again >= 0 && fstat(again, &current) == 0 && current.st_dev == info.st_dev && current.st_ino == info.st_ino; 
+    if (again >= 0) {
+        close(again); 
+    }
+    if (same) {
+        shm_unlink(name.c_str()); 
+    }
+    return true; 
+}
+
+/**
+ * @brief Creates a segment for the simulator, replacing one left behind by a run that has ended.
+ * 
+ * The magic number is stored last with release ordering, so a reader that
+ * sees it also sees a fully initialized header.
+ * 
+ * @param name Segment name.
+ * @param carCapacity Slots to reserve.
+ * @return SharedTelemetryWindow The writable window.
+ */
+SharedTelemetryWindow SharedTelemetryWindow::Create(const std::string& name, std::size_t carCapacity) {
+    const std::size_t bytes = sizeof(ShmWindowHeader) + carCapacity * sizeof(ShmCarSlot); 
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644); 
+    if (fd < 0 && errno == EEXIST) {
+        std::string reason; 
+        if (!UnlinkIfStale(name, reason)) {
+            throw std::runtime_error("shared memory segment " + name + " " + reason); 
+        }
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644); 
+    }
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + name); 
+    }
+    if (ftruncate(fd, (off_t)bytes) != 0) {
+        const int error = errno; 
+        close(fd); 
+        shm_unlink(name.c_str()); 
+        throw std::system_error(error, std::generic_category(), "ftruncate " + name); 
+    }
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0); 
+    const int error = errno; 
+    close(fd); 
+    if (mapping == MAP_FAILED) {
+        shm_unlink(name.c_str()); 
+        throw std::system_error(error, std::generic_category(), "mmap " + name); 
+    }
+
+    // ftruncate zero-fills, which is a valid initial state for every slot
+    ShmWindowHeader* header = new (mapping) ShmWindowHeader; 
+    header->version = SHM_WINDOW_VERSION; 
+    header->headerBytes = sizeof(ShmWindowHeader); 
+    header->slotBytes = sizeof(ShmCarSlot); 
+    header->signalCount = SHM_WINDOW_SIGNALS; 
+    header->carCapacity = (std::uint32_t)carCapacity; 
+    header->carCount.store(0, std::memory_order_relaxed); 
+    header->creatorPid = (std::int32_t)getpid(); 
+    header->createdNs = SteadyNowNs(); 
+    header->magic.store(SHM_WINDOW_MAGIC, std::memory_order_release); 
+    return SharedTelemetryWindow(name, mapping, bytes, true); 
+}
+
+/**
+ * @brief Opens an existing segment read-only.
+ * 
+ * @param name Segment name.
+ * @return SharedTelemetryWindow The read-only window.
+ */
+SharedTelemetryWindow SharedTelemetryWindow::Open(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0); 
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + name); 
+    }
+    struct stat info; 
+    if (fstat(fd, &info) != 0 || (std::size_t)info.st_size < sizeof(ShmWindowHeader)) {
+        close(fd); 
+        throw std::runtime_error(name + " is not a telemetry window"); 
+    }
+    void* mapping = mmap(nullptr, (std::size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0); 
+    const int error = errno; 
+    close(fd); 
+    if (mapping == MAP_FAILED) {
+        throw std::system_error(error, std::generic_category(), "mmap " + name); 
+    }
+    SharedTelemetryWindow window(name, mapping, (std::size_t)info.st_size, false); 
+    const ShmWindowHeader* header = window.header; 
+    if (header->magic.load(std::memory_order_acquire) != SHM_WINDOW_MAGIC || 
+        header->version != SHM_WINDOW_VERSION || header->headerBytes != sizeof(ShmWindowHeader) || 
+        header->slotBytes != sizeof(ShmCarSlot) || header->signalCount != SHM_WINDOW_SIGNALS || 
+        sizeof(ShmWindowHeader) + (std::size_t)header->carCapacity * sizeof(ShmCarSlot) > window.bytes) {
+        throw std::runtime_error(name + " has an unknown layout or is not initialized yet"); 
+    }
+    return window; 
+}
+
+/**
+ * @brief Wraps a mapping.
+ */
+SharedTelemetryWindow::SharedTelemetryWindow(const std::string& name, void* mapping, std::size_t bytes, bool owner)
+    : name(name), mapping(mapping), bytes(bytes), owner(owner), 
+      header(static_cast<ShmWindowHeader*>(mapping)), 
+      slots(reinterpret_cast<ShmCarSlot*>(static_cast<char*>(mapping) + sizeof(ShmWindowHeader))) {}
+
+/**
+ * @brief Takes over another window's mapping.
+ * 
+ * @param other The window to move from.
+ */
+SharedTelemetryWindow::SharedTelemetryWindow(SharedTelemetryWindow&& other) noexcept
+    : name(std::move(other.name)), mapping(other.mapping), bytes(other.bytes), owner(other.owner), 
+      header(other.header), slots(other.slots) {
+    other.mapping = nullptr; 
+    other.owner = false; 
+}
+
+/**
+ * @brief Unmaps the segment, and unlinks it if this window created it.
+ */
+SharedTelemetryWindow::~SharedTelemetryWindow() {
+    if (mapping) {
+        munmap(mapping, bytes); 
+    }
+    if (owner) {
+        shm_unlink(name.c_str()); 
+    }
+}
+
+/**
+ * @brief Publishes the state of one car.
+ * 
+ * @param car Slot index.
+ * @param tick Car snapshot version.
+ * @param values Signal values indexed by SensorTypes.
+ * @param flags CAR_STATUS_* bits.
+ */
+void SharedTelemetryWindow::Publish(std::size_t car, std::uint64_t tick, const double* values, std::uint32_t flags) {
+    if (car >= header->carCapacity) {
+        throw std::out_of_range("car index outside the telemetry window"); 
+    }
+    ShmCarSlot& slot = slots[car]; 
+    const std::uint64_t s = slot.sequence.load(std::memory_order_relaxed); 
+    slot.sequence.store(s + 1, std::memory_order_relaxed); 
+    std::atomic_thread_fence(std::memory_order_release); 
+    slot.tick.store(tick, std::memory_order_relaxed); 
+    for (int i = 0; i < SHM_WINDOW_SIGNALS; i++) {
+        slot.values[i].store(std::bit_cast<std::uint64_t>(values[i]), std::memory_order_relaxed); 
+    }
+    slot.flags.store(flags, std::memory_order_relaxed); 
+    slot.updatedNs.store(SteadyNowNs(), std::memory_order_relaxed); 
+    slot.sequence.store(s + 2, std::memory_order_release); 
+
+    // Grow the visible range; several publishers may race, the largest wins
+    std::uint32_t count = header->carCount.load(std::memory_order_relaxed); 
+    while (count <= car && !header->carCount.compare_exchange_weak(count, (std::uint32_t)car + 1, std::memory_order_release)) {
+    }
+}
+
+/**
+ * @brief Makes one attempt to read one car.
+ * 
+ * @param car Slot index.
+ * @param out Receives the state if the attempt succeeds.
+ * @return true if the copy is consistent.
+ */
+bool SharedTelemetryWindow::TryRead(std::size_t car, ShmCarState& out) const {
+    if (car >= header->carCapacity) {
+        return false; 
+    }
+    const ShmCarSlot& slot = slots[car]; 
+    const std::uint64_t before = slot.sequence.load(std::memory_order_acquire); 
+    if (before & 1) {
+        return false; 
+    }
+    out.tick = slot.tick.load(std::memory_order_relaxed); 
+    for (int i = 0; i < SHM_WINDOW_SIGNALS; i++) {
+        out.values[i] = std::bit_cast<double>(slot.values[i].load(std::memory_order_relaxed)); 
+    }
+    out.flags = slot.flags.load(std::memory_order_relaxed); 
+    out.updatedNs = slot.updatedNs.load(std::memory_order_relaxed); 
+    std::atomic_thread_fence(std::memory_order_acquire); 
+    return slot.sequence.load(std::memory_order_relaxed) == before; 
+}
+
+/**
+ * @brief Gets the number of slots in use.
+ * 
+ * @return std::size_t The number of cars published so far.
+ */
+std::size_t SharedTelemetryWindow::getCarCount() const {
+    return header->carCount.load(std::memory_order_acquire); 
+}
+
+/**
+ * @brief Gets the number of slots.
+ * 
+ * @return std::size_t The capacity.
+ */
+std::size_t SharedTelemetryWindow::getCarCapacity() const {
+    return header->carCapacity; 
+}
+
+/**
+ * @brief Gets the size of the mapping.
+ * 
+ * @return std::size_t Bytes mapped.
+ */
+std::size_t SharedTelemetryWindow::getMappedBytes() const {
+    return bytes; 
+}
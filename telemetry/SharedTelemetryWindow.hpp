@@ -0,0 +1,171 @@
+#ifndef SHARED_TELEMETRY_WINDOW_H
+#define SHARED_TELEMETRY_WINDOW_H
+
+#include "SensorHistory.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#define SHM_WINDOW_MAGIC 0x4E49574345524143ull ///< "CARECWIN" in little endian, written last when a segment is ready
+#define SHM_WINDOW_VERSION 2 ///< Layout version; readers refuse other versions
+#define SHM_WINDOW_SIGNALS 4 ///< Signals per car, indexed by SensorTypes
+
+/**
+ * @brief First bytes of the segment.
+ *
+ * @details All fields are fixed-width and the struct is padded to one
+ * cache line, so the layout is the same for every process on the machine.
+ */
+struct alignas(64) ShmWindowHeader {
+    std::atomic<std::uint64_t> magic; ///< SHM_WINDOW_MAGIC once the segment is initialized
+    std::uint32_t version; ///< SHM_WINDOW_VERSION
+    std::uint32_t headerBytes; ///< sizeof(ShmWindowHeader)
+    std::uint32_t slotBytes; ///< sizeof(ShmCarSlot)
+    std::uint32_t signalCount; ///< SHM_WINDOW_SIGNALS
+    std::uint32_t carCapacity; ///< Slots in the segment
+    std::atomic<std::uint32_t> carCount; ///< Slots in use
+    std::int32_t creatorPid; ///< Process that created the segment, which tells a live segment from a stale one
+    std::int64_t createdNs; ///< Steady-clock time the segment was created
+};
+
+/**
+ * @brief State of one car, guarded by its own sequence lock.
+ *
+ * @details Exactly one cache line. Values are stored as the bit patterns of
+ * doubles in 64-bit atomics, so readers in other processes copy them
+ * without locks and without data races.
+ */
+struct alignas(64) ShmCarSlot {
+    std::atomic<std::uint64_t> sequence; ///< Odd while the writer updates the slot
+    std::atomic<std::uint64_t> tick; ///< Car snapshot version of the values
+    std::atomic<std::uint64_t> values[SHM_WINDOW_SIGNALS]; ///< Car_info as double bit patterns
+    std::atomic<std::uint32_t> flags; ///< CAR_STATUS_* bits
+    std::uint32_t reserved; ///< Zero
+    std::atomic<std::int64_t> updatedNs; ///< Steady-clock time of the last publish
+};
+
+static_assert(sizeof(ShmWindowHeader) == 64, "ShmWindowHeader layout");
+static_assert(sizeof(ShmCarSlot) == 64, "ShmCarSlot layout");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared atomics must be lock-free");
+
+/**
+ * @brief A consistent copy of one slot.
+ */
+struct ShmCarState {
+    std::uint64_t tick; ///< Car snapshot version
+    double values[SHM_WINDOW_SIGNALS]; ///< Signal values indexed by SensorTypes
+    std::uint32_t flags; ///< CAR_STATUS_* bits
+    std::int64_t updatedNs; ///< Steady-clock time of the publish
+};
+
+/**
+ * @brief Latest state of every car in a named POSIX shared-memory segment.
+ *
+ * @details The simulator creates the segment and publishes into it; other
+ * processes open it read-only and map it, so reading is a plain memory
+ * copy with no IPC round trip. Each car has its own slot and sequence
+ * lock: one writer per slot, any number of readers, and neither ever
+ * waits for the other. A reader retries a slot it caught mid-update.
+ */
+class SharedTelemetryWindow {
+public:
+    /**
+     * @brief Creates a segment for the simulator.
+     *
+     * A segment already under the name is only replaced when it was left
+     * behind: it has this layout and the process that created it is gone.
+     * A segment whose creator is still running is never taken over, since
+     * its readers would go on polling an orphaned copy.
+     *
+     * @param name Segment name, e.g. "/carecu-window".
+     * @param carCapacity Slots to reserve.
+     * @return SharedTelemetryWindow The writable window; unlinks the name when destroyed.
+     * @throws std::system_error If the segment cannot be created.
+     * @throws std::runtime_error If the name is held by a running simulator or by a segment of unknown layout.
+     */
+    static SharedTelemetryWindow Create(const std::string& name, std::size_t carCapacity);
+
+    /**
+     * @brief Opens an existing segment read-only.
+     *
+     * @param name Segment name.
+     * @return SharedTelemetryWindow The read-only window.
+     * @throws std::system_error If the segment cannot be opened.
+     * @throws std::runtime_error If the segment is not initialized or has another layout version.
+     */
+    static SharedTelemetryWindow Open(const std::string& name);
+
+    /**
+     * @brief Takes over another window's mapping.
+     *
+     * @param other The window to move from.
+     */
+    SharedTelemetryWindow(SharedTelemetryWindow&& other) noexcept;
+
+    /**
+     * @brief Unmaps the segment, and unlinks it if this window created it.
+     */
+    ~SharedTelemetryWindow();
+
+    // Deleted copy constructor and assignment operator
+    SharedTelemetryWindow(const SharedTelemetryWindow&) = delete;
+    SharedTelemetryWindow& operator=(const SharedTelemetryWindow&) = delete;
+
+    /**
+     * @brief Publishes the state of one car.
+     *
+     * Only one thread may publish a given car at a time.
+     *
+     * @param car Slot index; slots up to it become visible to readers.
+     * @param tick Car snapshot version.
+     * @param values Signal values indexed by SensorTypes.
+     * @param flags CAR_STATUS_* bits.
+     */
+    void Publish(std::size_t car, std::uint64_t tick, const double* values, std::uint32_t flags);
+
+    /**
+     * @brief Makes one attempt to read one car.
+     *
+     * @param car Slot index.
+     * @param out Receives the state if the attempt succeeds.
+     * @return true if the copy is consistent, false if a publish overlapped it.
+     */
+    bool TryRead(std::size_t car, ShmCarState& out) const;
+
+    /**
+     * @brief Gets the number of slots in use.
+     *
+     * @return std::size_t The number of cars published so far.
+     */
+    std::size_t getCarCount() const;
+
+    /**
+     * @brief Gets the number of slots.
+     *
+     * @return std::size_t The capacity.
+     */
+    std::size_t getCarCapacity() const;
+
+    /**
+     * @brief Gets the size of the mapping.
+     *
+     * @return std::size_t Bytes mapped.
+     */
+    std::size_t getMappedBytes() const;
+
+private:
+    /**
+     * @brief Wraps a mapping.
+     */
+    SharedTelemetryWindow(const std::string& name, void* mapping, std::size_t bytes, bool owner);
+
+    std::string name; ///< Segment name
+    void* mapping; ///< Start of the mapping
+    std::size_t bytes; ///< Size of the mapping
+    bool owner; ///< Created the segment; unlinks it on destruction
+    ShmWindowHeader* header; ///< Header at the start of the mapping
+    ShmCarSlot* slots; ///< Slots after the header
+};
+
+#endif // !SHARED_TELEMETRY_WINDOW_H
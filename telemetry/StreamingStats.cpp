@@ -0,0 +1,111 @@
+#include "StreamingStats.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructs empty statistics.
+ *
+ * @param ewmaAlpha Weight of the newest sample in the EWMA.
+ */
+StreamingStats::StreamingStats(double ewmaAlpha)
+    : n(0), runningMean(0.0), m2(0.0), runningEwma(0.0), alpha(ewmaAlpha),
+      minimum(0.0), maximum(0.0), lastValue(0.0) {
+}
+
+/**
+ * @brief Adds one sample using Welford's update.
+ *
+ * @param value The sample value.
+ */
+void StreamingStats::add(double value) {
+    n++;
+    if (n == 1) {
+        runningMean = value;
+        runningEwma = value;
+        minimum = value;
+        maximum = value;
+        lastValue = value;
+        return;
+    }
+
+    const double delta = value - runningMean;
+    runningMean += delta / n;
+    m2 += delta * (value - runningMean);
+    runningEwma += alpha * (value - runningEwma);
+    minimum = std::min(minimum, value);
+    maximum = std::max(maximum, value);
+    lastValue = value;
+}
+
+/**
+ * @brief Gets the sample variance.
+ *
+ * @return The unbiased variance, or 0 with fewer than two samples.
+ */
+double StreamingStats::variance() const {
+    return n > 1 ? m2 / (n - 1) : 0.0;
+}
+
+/**
+ * @brief Gets the sample standard deviation.
+ *
+ * @return The square root of variance().
+ */
+double StreamingStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+/**
+ * @brief Constructs diagnostics with no samples and no anomalies.
+ */
+SensorDiagnostics::SensorDiagnostics()
+    : repeatRun(0), flags(ANOMALY_NONE), zScoreCount(0), stuckCount(0), rangeCount(0) {
+}
+
+/**
+ * @brief Classifies a sample and folds it into the statistics.
+ *
+ * @param value  The sample value.
+ * @param limits Thresholds for the sensor type.
+ * @return unsigned Bitwise OR of the AnomalyFlags raised by this sample.
+ */
+unsigned SensorDiagnostics::add(double value, const AnomalyLimits& limits) {
+    unsigned raised = ANOMALY_NONE;
+
+    if (value < limits.minValue || value > limits.maxValue) {
+        raised |= ANOMALY_RANGE;
+        rangeCount++;
+    }
+
+    const double sd = runningStats.stddev();
+    if (runningStats.count() >= limits.warmup && sd > 0.0 &&
+        std::fabs(value - runningStats.mean()) / sd > limits.zThreshold) {
+        raised |= ANOMALY_Z_SCORE;
+        zScoreCount++;
+    }
+
+    repeatRun = (runningStats.count() > 0 && value == runningStats.last()) ? repeatRun + 1 : 1;
+    if (limits.stuckRun > 0 && repeatRun >= limits.stuckRun) {
+        raised |= ANOMALY_STUCK;
+        stuckCount++;
+    }
+
+    runningStats.add(value);
+    flags = raised;
+    return raised;
+}
+
+/**
+ * @brief Gets how many samples raised a given anomaly.
+ *
+ * @param flag One of the AnomalyFlags bits.
+ * @return The number of samples that raised it.
+ */
+std::uint64_t SensorDiagnostics::anomalyCount(AnomalyFlags flag) const {
+    switch (flag) {
+        case ANOMALY_Z_SCORE: return zScoreCount;
+        case ANOMALY_STUCK: return stuckCount;
+        case ANOMALY_RANGE: return rangeCount;
+        default: return 0;
+    }
+}
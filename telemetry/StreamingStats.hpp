@@ -0,0 +1,172 @@
+#ifndef STREAMING_STATS_H
+#define STREAMING_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Incremental statistics over an unbounded stream of samples.
+ *
+ * @details Mean and variance use Welford's update so they stay numerically
+ * stable over long runs. An exponentially weighted moving average tracks
+ * recent behaviour. Every update is O(1) and the object never allocates.
+ */
+class StreamingStats {
+public:
+    /**
+     * @brief Constructs empty statistics.
+     *
+     * @param ewmaAlpha Weight of the newest sample in the EWMA, in (0, 1].
+     */
+    explicit StreamingStats(double ewmaAlpha = 0.1);
+
+    /**
+     * @brief Adds one sample.
+     *
+     * @param value The sample value.
+     */
+    void add(double value);
+
+    /**
+     * @brief Gets the number of samples seen.
+     *
+     * @return The sample count.
+     */
+    std::uint64_t count() const { return n; }
+
+    /**
+     * @brief Gets the running mean.
+     *
+     * @return The mean, or 0 when no sample was seen.
+     */
+    double mean() const { return runningMean; }
+
+    /**
+     * @brief Gets the sample variance.
+     *
+     * @return The unbiased variance, or 0 with fewer than two samples.
+     */
+    double variance() const;
+
+    /**
+     * @brief Gets the sample standard deviation.
+     *
+     * @return The square root of variance().
+     */
+    double stddev() const;
+
+    /**
+     * @brief Gets the exponentially weighted moving average.
+     *
+     * @return The EWMA, seeded with the first sample.
+     */
+    double ewma() const { return runningEwma; }
+
+    /**
+     * @brief Gets the smallest sample seen.
+     *
+     * @return The minimum, or 0 when no sample was seen.
+     */
+    double min() const { return minimum; }
+
+    /**
+     * @brief Gets the largest sample seen.
+     *
+     * @return The maximum, or 0 when no sample was seen.
+     */
+    double max() const { return maximum; }
+
+    /**
+     * @brief Gets the most recent sample.
+     *
+     * @return The last value passed to add().
+     */
+    double last() const { return lastValue; }
+
+private:
+    std::uint64_t n;    ///< Number of samples
+    double runningMean; ///< Welford mean
+    double m2;          ///< Welford sum of squared deviations
+    double runningEwma; ///< Exponentially weighted moving average
+    double alpha;       ///< EWMA weight of the newest sample
+    double minimum;     ///< Smallest sample
+    double maximum;     ///< Largest sample
+    double lastValue;   ///< Most recent sample
+};
+
+/**
+ * @enum AnomalyFlags
+ * @brief Bit flags describing why a sample looks abnormal.
+ */
+enum AnomalyFlags : unsigned {
+    ANOMALY_NONE = 0,          /**< Sample looks normal */
+    ANOMALY_Z_SCORE = 1u << 0, /**< Sample is too many standard deviations from the mean */
+    ANOMALY_STUCK = 1u << 1,   /**< Sensor kept reporting the same value */
+    ANOMALY_RANGE = 1u << 2    /**< Sample is outside the physical range of the sensor */
+};
+
+/**
+ * @brief Thresholds used to classify samples of one sensor type.
+ */
+struct AnomalyLimits {
+    double minValue;        ///< Lowest valid reading
+    double maxValue;        ///< Highest valid reading
+    double zThreshold;      ///< |z| above which a sample is a spike
+    std::uint64_t warmup;   ///< Samples needed before z-scores are trusted
+    std::uint64_t stuckRun; ///< Consecutive identical samples that count as stuck
+};
+
+/**
+ * @brief Streaming statistics plus anomaly detection for one sensor.
+ */
+class SensorDiagnostics {
+public:
+    /**
+     * @brief Constructs diagnostics with no samples.
+     */
+    SensorDiagnostics();
+
+    /**
+     * @brief Classifies a sample and folds it into the statistics.
+     *
+     * @details The z-score is computed against the statistics before the
+     * sample is added, so a spike does not hide itself.
+     *
+     * @param value  The sample value.
+     * @param limits Thresholds for the sensor type.
+     * @return unsigned Bitwise OR of the AnomalyFlags raised by this sample.
+     */
+    unsigned add(double value, const AnomalyLimits& limits);
+
+    /**
+     * @brief Gets the running statistics.
+     *
+     * @return Reference to the statistics.
+     */
+    const StreamingStats& stats() const { return runningStats; }
+
+    /**
+     * @brief Gets the flags raised by the most recent sample.
+     *
+     * @return Bitwise OR of AnomalyFlags.
+     */
+    unsigned lastFlags() const { return flags; }
+
+    /**
+     * @brief Gets how many samples raised a given anomaly.
+     *
+     * @param flag One of the AnomalyFlags bits.
+     * @return The number of samples that raised it.
+     */
+    std::uint64_t anomalyCount(AnomalyFlags flag) const;
+
+private:
+    StreamingStats runningStats; ///< Statistics over all samples
+    std::uint64_t repeatRun;     ///< Length of the current run of identical samples
+    unsigned flags;              ///< Flags raised by the last sample
+    std::uint64_t zScoreCount;   ///< Samples flagged as spikes
+    std::uint64_t stuckCount;    ///< Samples flagged as stuck
+    std::uint64_t rangeCount;    ///< Samples flagged as out of range
+};
+
+#endif // !STREAMING_STATS_H
@@ -0,0 +1,68 @@
+#include "TelemetryEndpoint.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @brief Opens a datagram socket for a telemetry endpoint.
+ * 
+ * @param endpoint The endpoint.
+ * @param bindAddress Bind for receiving instead of sending.
+ * @param address Receives the resolved address.
+ * @param addressLength Receives the address length.
+ * @return int The socket, or -1 with errno set.
+ */
+int OpenTelemetrySocket(const std::string& endpoint, bool bindAddress, sockaddr_storage& address, socklen_t& addressLength) {
+    std::memset(&address, 0, sizeof(address)); 
+    int fd = -1; 
+    if (endpoint.compare(0, 5, "unix:") == 0) {
+        const std::string path = endpoint.substr(5); 
+        sockaddr_un* un = reinterpret_cast<sockaddr_un*>(&address); 
+        if (path.empty() || path.size() >= sizeof(un->sun_path)) {
+            errno = EINVAL; 
+            return -1; 
+        }
+        un->sun_family = AF_UNIX; 
+        std::memcpy(un->sun_path, path.c_str(), path.size() + 1); 
+        addressLength = sizeof(sockaddr_un); 
+        fd = socket(AF_UNIX, SOCK_DGRAM, 0); 
+        if (fd >= 0 && bindAddress) {
+            unlink(path.c_str()); 
+        }
+    } else if (endpoint.compare(0, 4, "udp:") == 0) {
+        const std::string hostPort = endpoint.substr(4); 
+        const std::size_t colon = hostPort.rfind(':'); 
+        sockaddr_in* in = reinterpret_cast<sockaddr_in*>(&address); 
+        in->sin_family = AF_INET; 
+        if (colon == std::string::npos || 
+            inet_pton(AF_INET, hostPort.substr(0, colon).c_str(), &in->sin_addr) != 1) {
+            errno = EINVAL; 
+            return -1; 
+        }
+        in->sin_port = htons((unsigned short)std::atoi(hostPort.c_str() + colon + 1)); 
+        addressLength = sizeof(sockaddr_in); 
+        fd = socket(AF_INET, SOCK_DGRAM, 0); 
+    } else {
+        errno = EINVAL; 
+        return -1; 
+    }
+    if (fd < 0) {
+        return -1; 
+    }
+    if (bindAddress) {
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), addressLength) != 0) {
+            const int error = errno; 
+            close(fd); 
+            errno = error; 
+            return -1; 
+        }
+    } else {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); 
+    }
+    return fd; 
+}
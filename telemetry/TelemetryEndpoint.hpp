@@ -0,0 +1,27 @@
+#ifndef TELEMETRY_ENDPOINT_H
+#define TELEMETRY_ENDPOINT_H
+
+#include <string>
+#include <sys/socket.h>
+
+/**
+ * @brief Opens a datagram socket for a telemetry endpoint.
+ * 
+ * Endpoints are "unix:<path>" for a Unix domain datagram socket or
+ * "udp:<host>:<port>" for UDP, e.g. "udp:127.0.0.1:9500". A receiver binds
+ * the address (replacing a stale Unix socket file); a sender only resolves
+ * it. Sender sockets are non-blocking.
+ * 
+ * Linux queues at most net.unix.max_dgram_qlen datagrams (10 by default)
+ * on a Unix datagram socket regardless of its buffer size, so UDP loopback
+ * copes far better with bursts.
+ * 
+ * @param endpoint The endpoint.
+ * @param bindAddress Bind for receiving instead of sending.
+ * @param address Receives the resolved address.
+ * @param addressLength Receives the address length.
+ * @return int The socket, or -1 with errno set.
+ */
+int OpenTelemetrySocket(const std::string& endpoint, bool bindAddress, sockaddr_storage& address, socklen_t& addressLength);
+
+#endif // !TELEMETRY_ENDPOINT_H
@@ -0,0 +1,242 @@
+#include "TelemetryExporter.hpp"
+#include "TelemetryEndpoint.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <system_error>
+#include <unistd.h>
+
+/**
+ * @brief Queues a sample.
+ * 
+ * @param car Car index.
+ * @param sensorType SensorTypes value.
+ * @param value The reading.
+ * @param time Steady-clock time of the reading.
+ * @return true if queued, false if the ring was full.
+ */
+bool TelemetryProducer::Record(std::uint32_t car, int sensorType, double value, TimestampNs time) {
+    const std::size_t h = head.load(std::memory_order_relaxed); 
+    if (h - tail.load(std::memory_order_acquire) > mask) {
+        dropped.fetch_add(1, std::memory_order_relaxed); 
+        return false; 
+    }
+    ring[h & mask] = Entry{car, (std::uint8_t)sensorType, value, time}; 
+    head.store(h + 1, std::memory_order_release); 
+    return true; 
+}
+
+/**
+ * @brief Creates an empty ring.
+ * 
+ * @param capacity Number of entries; a power of two.
+ */
+TelemetryProducer::TelemetryProducer(std::size_t capacity)
+    : ring(capacity), mask(capacity - 1), head(0), tail(0), dropped(0) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        throw std::invalid_argument("TelemetryProducer capacity must be a power of two"); 
+    }
+}
+
+/**
+ * @brief Opens the socket and starts the exporter thread.
+ * 
+ * @param config The settings.
+ */
+TelemetryExporter::TelemetryExporter(const TelemetryExporterConfig& config)
+    : config(config), socketFd(-1), addressStorage(sizeof(sockaddr_storage)), addressLength(0), 
+      recordsPerDatagram(0), filled(0), sequence(0), batchStart(-1), running(true), 
+      samplesQueued(0), samplesSent(0), datagramsSent(0), datagramsFailed(0), sendCalls(0) {
+    if (config.batchSize == 0 || config.datagramBytes < sizeof(TelemetryDatagramHeader) + sizeof(TelemetryRecord)) {
+        throw std::invalid_argument("TelemetryExporter needs a batch and room for one record per datagram"); 
+    }
+    recordsPerDatagram = std::min<std::size_t>((config.datagramBytes - sizeof(TelemetryDatagramHeader)) / sizeof(TelemetryRecord), 
+                                               std::numeric_limits<std::uint16_t>::max()); 
+    sockaddr_storage address; 
+    socklen_t length = 0; 
+    socketFd = OpenTelemetrySocket(config.endpoint, false, address, length); 
+    if (socketFd < 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot open telemetry endpoint " + config.endpoint); 
+    }
+    std::memcpy(addressStorage.data(), &address, sizeof(address)); 
+    addressLength = length; 
+    buffers.resize(config.batchSize * config.datagramBytes); 
+    worker = std::thread(&TelemetryExporter::Run, this); 
+}
+
+/**
+ * @brief Flushes what is queued, stops the thread and closes the socket.
+ */
+TelemetryExporter::~TelemetryExporter() {
+    Stop(); 
+    close(socketFd); 
+}
+
+/**
+ * @brief Sends everything queued and stops the exporter thread.
+ */
+void TelemetryExporter::Stop() {
+    running.store(false); 
+    if (worker.joinable()) {
+        worker.join(); 
+    }
+}
+
+/**
+ * @brief Creates a queue for one simulation thread.
+ * 
+ * @return TelemetryProducer& The queue.
+ */
+TelemetryProducer& TelemetryExporter::CreateProducer() {
+    std::lock_guard<std::mutex> guard(producersMutex); 
+    producers.emplace_back(new TelemetryProducer(config.producerCapacity)); 
+    return *producers.back(); 
+}
+
+/**
+ * @brief Gets the counters.
+ * 
+ * @return TelemetryExporterStats The counters.
+ */
+TelemetryExporterStats TelemetryExporter::getStats() const {
+    TelemetryExporterStats s; 
+    s.samplesQueued = samplesQueued.load(std::memory_order_relaxed); 
+    s.samplesDropped = 0; 
+    {
+        std::lock_guard<std::mutex> guard(producersMutex); 
+        for (const auto& p : producers) {
+            s.samplesDropped += p->dropped.load(std::memory_order_relaxed); 
+        }
+    }
+    s.samplesSent = samplesSent.load(std::memory_order_relaxed); 
+    s.datagramsSent = datagramsSent.load(std::memory_order_relaxed); 
+    s.datagramsFailed = datagramsFailed.load(std::memory_order_relaxed); 
+    s.sendCalls = sendCalls.load(std::memory_order_relaxed); 
+    return s; 
+}
+
+/**
+ * @brief Body of the exporter thread.
+ * 
+ * Polls the producers instead of waiting on a condition variable, so that
+ * recording a sample never has to wake anyone up.
+ */
+void TelemetryExporter::Run() {
+    const std::chrono::microseconds idle = std::max(std::chrono::microseconds(50), 
+                                                    std::min(config.flushInterval / 4, std::chrono::microseconds(1000))); 
+    while (running.load()) {
+        const std::size_t moved = Drain(); 
+        if (batchStart >= 0 && SteadyNowNs() - batchStart >= (TimestampNs)config.flushInterval.count() * 1000) {
+            Flush(); 
+        }
+        if (moved == 0) {
+            std::this_thread::sleep_for(idle); 
+        }
+    }
+    Drain(); 
+    Flush(); 
+}
+
+/**
+ * @brief Moves queued samples into datagrams, sending every full batch.
+ * 
+ * @return std::size_t Samples moved.
+ */
+std::size_t TelemetryExporter::Drain() {
+    std::lock_guard<std::mutex> guard(producersMutex); 
+    std::size_t moved = 0; 
+    for (auto& p : producers) {
+        const std::size_t t = p->tail.load(std::memory_order_relaxed); 
+        const std::size_t h = p->head.load(std::memory_order_acquire); 
+        for (std::size_t i = t; i != h; i++) {
+            Append(p->ring[i & p->mask]); 
+        }
+        p->tail.store(h, std::memory_order_release); 
+        moved += h - t; 
+    }
+    samplesQueued.fetch_add(moved, std::memory_order_relaxed); 
+    return moved; 
+}
+
+/**
+ * @brief Appends one record, starting a new datagram when the current one is full.
+ * 
+ * A new datagram is also started when the sample is too far from the
+ * current datagram's base time for a 32-bit microsecond offset.
+ * 
+ * @param e The sample.
+ */
+void TelemetryExporter::Append(const TelemetryProducer::Entry& e) {
+    TelemetryDatagramHeader* header = filled ? 
+        reinterpret_cast<TelemetryDatagramHeader*>(&buffers[(filled - 1) * config.datagramBytes]) : nullptr; 
+    const TimestampNs offset = header ? (e.time - header->baseTimeNs) / 1000 : 0; 
+    if (!header || header->count == recordsPerDatagram || 
+        offset > std::numeric_limits<std::int32_t>::max() || offset < std::numeric_limits<std::int32_t>::min()) {
+        if (filled == config.batchSize) {
+            Flush(); 
+        }
+        header = reinterpret_cast<TelemetryDatagramHeader*>(&buffers[filled * config.datagramBytes]); 
+        header->magic = TELEMETRY_MAGIC; 
+        header->version = TELEMETRY_VERSION; 
+        header->count = 0; 
+        header->sequence = 0; // Assigned when sent
+        header->baseTimeNs = e.time; 
+        filled++; 
+        if (batchStart < 0) {
+            batchStart = SteadyNowNs(); 
+        }
+    }
+    TelemetryRecord* records = reinterpret_cast<TelemetryRecord*>(header + 1); 
+    TelemetryRecord& r = records[header->count++]; 
+    r.car = e.car; 
+    r.sensorType = e.sensorType; 
+    r.reserved = 0; 
+    r.value = EncodeSample(e.value, EncodingFor(e.sensorType)); 
+    r.offsetUs = (std::int32_t)((e.time - header->baseTimeNs) / 1000); 
+}
+
+/**
+ * @brief Sends the filled datagrams with sendmmsg and starts a new batch.
+ * 
+ * A datagram the kernel rejects is counted and skipped; the rest of the
+ * batch is still sent.
+ */
+void TelemetryExporter::Flush() {
+    if (filled == 0) {
+        return; 
+    }
+    std::vector<iovec> iov(filled); 
+    std::vector<mmsghdr> messages(filled); 
+    for (std::size_t i = 0; i < filled; i++) {
+        TelemetryDatagramHeader* header = reinterpret_cast<TelemetryDatagramHeader*>(&buffers[i * config.datagramBytes]); 
+        header->sequence = sequence++; 
+        iov[i].iov_base = header; 
+        iov[i].iov_len = sizeof(TelemetryDatagramHeader) + header->count * sizeof(TelemetryRecord); 
+        std::memset(&messages[i], 0, sizeof(mmsghdr)); 
+        messages[i].msg_hdr.msg_name = addressStorage.data(); 
+        messages[i].msg_hdr.msg_namelen = addressLength; 
+        messages[i].msg_hdr.msg_iov = &iov[i]; 
+        messages[i].msg_hdr.msg_iovlen = 1; 
+    }
+    std::size_t next = 0; 
+    while (next < filled) {
+        const int sent = sendmmsg(socketFd, &messages[next], (unsigned)(filled - next), MSG_DONTWAIT); 
+        sendCalls.fetch_add(1, std::memory_order_relaxed); 
+        if (sent <= 0) {
+            datagramsFailed.fetch_add(1, std::memory_order_relaxed); 
+            next++; 
+            continue; 
+        }
+        for (std::size_t i = next; i < next + (std::size_t)sent; i++) {
+            samplesSent.fetch_add(reinterpret_cast<TelemetryDatagramHeader*>(iov[i].iov_base)->count, std::memory_order_relaxed); 
+        }
+        datagramsSent.fetch_add(sent, std::memory_order_relaxed); 
+        next += sent; 
+    }
+    filled = 0; 
+    batchStart = -1; 
+}
@@ -0,0 +1,182 @@
+#ifndef TELEMETRY_EXPORTER_H
+#define TELEMETRY_EXPORTER_H
+
+#include "SensorHistory.hpp"
+#include "TelemetryWire.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Settings of a telemetry exporter.
+ */
+struct TelemetryExporterConfig {
+    std::string endpoint = "udp:127.0.0.1:9500"; ///< Destination, see OpenTelemetrySocket
+    std::size_t batchSize = 32; ///< Datagrams handed to one sendmmsg call
+    std::size_t datagramBytes = 8192; ///< Largest datagram, header included
+    std::chrono::microseconds flushInterval = std::chrono::microseconds(10000); ///< Longest a sample waits before a partial batch is sent
+    std::size_t producerCapacity = 1 << 16; ///< Samples each producer can hold; a power of two
+};
+
+/**
+ * @brief Counters of a telemetry exporter.
+ */
+struct TelemetryExporterStats {
+    std::uint64_t samplesQueued; ///< Samples taken from the producers
+    std::uint64_t samplesDropped; ///< Samples rejected because a producer queue was full
+    std::uint64_t samplesSent; ///< Samples in datagrams the kernel accepted
+    std::uint64_t datagramsSent; ///< Datagrams the kernel accepted
+    std::uint64_t datagramsFailed; ///< Datagrams the kernel rejected (no receiver, buffer full)
+    std::uint64_t sendCalls; ///< sendmmsg calls
+};
+
+/**
+ * @brief Queue of samples from one simulation thread to the exporter thread.
+ *
+ * @details Single-producer, single-consumer ring; Record is wait-free and
+ * makes no system call, and it drops the sample if the ring is full
+ * rather than blocking the simulation.
+ */
+class TelemetryProducer {
+public:
+    /**
+     * @brief Queues a sample.
+     *
+     * @param car Car index.
+     * @param sensorType SensorTypes value.
+     * @param value The reading.
+     * @param time Steady-clock time of the reading.
+     * @return true if queued, false if the ring was full.
+     */
+    bool Record(std::uint32_t car, int sensorType, double value, TimestampNs time);
+
+private:
+    friend class TelemetryExporter;
+
+    /**
+     * @brief One queued sample.
+     */
+    struct Entry {
+        std::uint32_t car; ///< Car index
+        std::uint8_t sensorType; ///< SensorTypes value
+        double value; ///< The reading
+        TimestampNs time; ///< When it was read
+    };
+
+    /**
+     * @brief Creates an empty ring.
+     *
+     * @param capacity Number of entries; a power of two.
+     */
+    explicit TelemetryProducer(std::size_t capacity);
+
+    std::vector<Entry> ring; ///< Entry storage
+    std::size_t mask; ///< capacity - 1
+    alignas(64) std::atomic<std::size_t> head; ///< Next slot to write; written by the producer
+    alignas(64) std::atomic<std::size_t> tail; ///< Next slot to read; written by the exporter
+    alignas(64) std::atomic<std::uint64_t> dropped; ///< Samples rejected because the ring was full
+};
+
+/**
+ * @brief Packs samples from many cars into binary datagrams and sends them in batches.
+ *
+ * @details Simulation threads each get a TelemetryProducer and record into
+ * it. A single exporter thread drains the producers, packs records into
+ * datagrams of up to datagramBytes, and sends a batch with one sendmmsg
+ * call when batchSize datagrams are full or the oldest unsent sample is
+ * flushInterval old. All system calls happen on the exporter thread. The
+ * socket is non-blocking, so a slow or absent receiver costs datagrams,
+ * never simulation time.
+ */
+class TelemetryExporter {
+public:
+    /**
+     * @brief Opens the socket and starts the exporter thread.
+     *
+     * @param config The settings.
+     * @throws std::system_error If the socket cannot be opened.
+     */
+    explicit TelemetryExporter(const TelemetryExporterConfig& config = TelemetryExporterConfig());
+
+    /**
+     * @brief Flushes what is queued, stops the thread and closes the socket.
+     */
+    ~TelemetryExporter();
+
+    // Deleted copy constructor and assignment operator
+    TelemetryExporter(const TelemetryExporter&) = delete;
+    TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+    /**
+     * @brief Creates a queue for one simulation thread.
+     *
+     * @return TelemetryProducer& The queue; lives as long as the exporter.
+     */
+    TelemetryProducer& CreateProducer();
+
+    /**
+     * @brief Sends everything queued and stops the exporter thread.
+     * 
+     * Producers must have stopped recording. Called by the destructor.
+     */
+    void Stop();
+
+    /**
+     * @brief Gets the counters.
+     *
+     * @return TelemetryExporterStats The counters.
+     */
+    TelemetryExporterStats getStats() const;
+
+private:
+    /**
+     * @brief Body of the exporter thread.
+     */
+    void Run();
+
+    /**
+     * @brief Moves queued samples into datagrams, sending every full batch.
+     *
+     * @return std::size_t Samples moved.
+     */
+    std::size_t Drain();
+
+    /**
+     * @brief Appends one record, starting a new datagram when the current one is full.
+     *
+     * @param e The sample.
+     */
+    void Append(const TelemetryProducer::Entry& e);
+
+    /**
+     * @brief Sends the filled datagrams with sendmmsg and starts a new batch.
+     */
+    void Flush();
+
+    TelemetryExporterConfig config; ///< Settings
+    int socketFd; ///< The datagram socket
+    std::vector<unsigned char> addressStorage; ///< Destination address
+    std::uint32_t addressLength; ///< Destination address length
+    std::size_t recordsPerDatagram; ///< Records that fit in one datagram
+    std::vector<unsigned char> buffers; ///< batchSize datagrams back to back
+    std::size_t filled; ///< Datagrams in the batch, counting the one being filled
+    std::uint64_t sequence; ///< Next datagram number
+    TimestampNs batchStart; ///< When the oldest unsent sample was packed, -1 if none
+    mutable std::mutex producersMutex; ///< Guards producers
+    std::vector<std::unique_ptr<TelemetryProducer>> producers; ///< Queues of the simulation threads
+    std::atomic<bool> running; ///< Cleared to stop the thread
+    std::atomic<std::uint64_t> samplesQueued; ///< See TelemetryExporterStats
+    std::atomic<std::uint64_t> samplesSent; ///< See TelemetryExporterStats
+    std::atomic<std::uint64_t> datagramsSent; ///< See TelemetryExporterStats
+    std::atomic<std::uint64_t> datagramsFailed; ///< See TelemetryExporterStats
+    std::atomic<std::uint64_t> sendCalls; ///< See TelemetryExporterStats
+    std::thread worker; ///< The exporter thread
+};
+
+#endif // !TELEMETRY_EXPORTER_H
@@ -0,0 +1,45 @@
+#ifndef TELEMETRY_WIRE_H
+#define TELEMETRY_WIRE_H
+
+#include "CompactSample.hpp"
+#include <cstdint>
+
+/**
+ * @brief Binary format of the telemetry datagrams.
+ * 
+ * @details A datagram is a TelemetryDatagramHeader followed by count
+ * TelemetryRecord entries. Values use the per-type 16-bit fixed-point
+ * encodings of CompactSample, and times are signed microsecond offsets from
+ * the header's base time, so a record is 12 bytes. Fields are in host byte
+ * order because the exporter only talks to local sockets.
+ */
+
+#define TELEMETRY_MAGIC 0x4C455443u ///< "CTEL" in little endian
+#define TELEMETRY_VERSION 1 ///< Wire format version
+
+/**
+ * @brief Leads every datagram.
+ */
+struct TelemetryDatagramHeader {
+    std::uint32_t magic; ///< TELEMETRY_MAGIC
+    std::uint16_t version; ///< TELEMETRY_VERSION
+    std::uint16_t count; ///< Records that follow
+    std::uint64_t sequence; ///< Datagram number; gaps mean lost datagrams
+    std::int64_t baseTimeNs; ///< Steady-clock time the record offsets count from
+};
+
+/**
+ * @brief One sample.
+ */
+struct TelemetryRecord {
+    std::uint32_t car; ///< Car index in the exporting simulation
+    std::uint8_t sensorType; ///< SensorTypes value
+    std::uint8_t reserved; ///< Zero
+    CompactSample value; ///< Value in the encoding of the sensor type
+    std::int32_t offsetUs; ///< Microseconds relative to the header's base time
+};
+
+static_assert(sizeof(TelemetryDatagramHeader) == 24, "TelemetryDatagramHeader layout");
+static_assert(sizeof(TelemetryRecord) == 12, "TelemetryRecord layout");
+
+#endif // !TELEMETRY_WIRE_H
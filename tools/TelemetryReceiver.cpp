@@ -0,0 +1,105 @@
+// Reference receiver for the telemetry exporter. Binds the endpoint,
+// receives datagrams in batches with recvmmsg and prints datagrams,
+// samples per second and loss (from sequence gaps) once per second.
+// Usage: telemetry_receiver [endpoint] [seconds, 0 = forever]
+#include "../telemetry/TelemetryEndpoint.hpp"
+#include "../telemetry/TelemetryWire.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <vector>
+
+int main(int argc, char** argv) {
+    const std::string endpoint = argc > 1 ? argv[1] : "udp:127.0.0.1:9500"; 
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 0.0; 
+
+    sockaddr_storage address; 
+    socklen_t length = 0; 
+    const int fd = OpenTelemetrySocket(endpoint, true, address, length); 
+    if (fd < 0) {
+        std::perror(("cannot bind " + endpoint).c_str()); 
+        return 1; 
+    }
+    int receiveBuffer = 8 << 20; 
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer)); 
+    timeval timeout = {0, 100000}; 
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)); 
+
+    const std::size_t batch = 64; 
+    const std::size_t datagramBytes = 65536; 
+    std::vector<unsigned char> buffers(batch * datagramBytes); 
+    std::vector<iovec> iov(batch); 
+    std::vector<mmsghdr> messages(batch); 
+    for (std::size_t i = 0; i < batch; i++) {
+        iov[i].iov_base = &buffers[i * datagramBytes]; 
+        iov[i].iov_len = datagramBytes; 
+    }
+
+    std::uint64_t datagrams = 0, samples = 0, lost = 0, malformed = 0, restarts = 0; 
+    std::uint64_t intervalDatagrams = 0, intervalSamples = 0; 
+    std::uint64_t expected = 0; 
+    bool first = true; 
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now(); 
+    std::chrono::steady_clock::time_point report = start + std::chrono::seconds(1); 
+    std::printf("listening on %s\n", endpoint.c_str()); 
+    std::fflush(stdout); 
+
+    for (;;) {
+        std::memset(messages.data(), 0, sizeof(mmsghdr) * batch); 
+        for (std::size_t i = 0; i < batch; i++) {
+            messages[i].msg_hdr.msg_iov = &iov[i]; 
+            messages[i].msg_hdr.msg_iovlen = 1; 
+        }
+        const int received = recvmmsg(fd, messages.data(), (unsigned)batch, MSG_WAITFORONE, nullptr); 
+        for (int i = 0; i < received; i++) {
+            const TelemetryDatagramHeader* header = static_cast<const TelemetryDatagramHeader*>(iov[i].iov_base); 
+            if (messages[i].msg_len < sizeof(TelemetryDatagramHeader) || header->magic != TELEMETRY_MAGIC || 
+                header->version != TELEMETRY_VERSION || 
+                messages[i].msg_len != sizeof(TelemetryDatagramHeader) + header->count * sizeof(TelemetryRecord)) {
+                malformed++; 
+                continue; 
+            }
+            if (!first && header->sequence < expected) {
+                restarts++; // Exporter restarted, or reordering
+            } else if (!first) {
+                lost += header->sequence - expected; 
+            }
+            first = false; 
+            expected = header->sequence + 1; 
+            intervalDatagrams++; 
+            intervalSamples += header->count; 
+        }
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now(); 
+        if (now >= report) {
+            datagrams += intervalDatagrams; 
+            samples += intervalSamples; 
+            std::printf("%8.0f datagrams/s %10.0f samples/s  total: datagrams=%llu samples=%llu lost=%llu malformed=%llu restarts=%llu\n", 
+                        (double)intervalDatagrams, (double)intervalSamples, 
+                        (unsigned long long)datagrams, (unsigned long long)samples, (unsigned long long)lost, 
+                        (unsigned long long)malformed, (unsigned long long)restarts); 
+            std::fflush(stdout); 
+            intervalDatagrams = intervalSamples = 0; 
+            report += std::chrono::seconds(1); 
+        }
+        if (seconds > 0 && now - start >= std::chrono::duration<double>(seconds)) {
+            break; 
+        }
+    }
+    datagrams += intervalDatagrams; 
+    samples += intervalSamples; 
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); 
+    std::printf("received %llu datagrams, %llu samples in %.1f s; lost %llu datagrams (%.3f%%)\n", 
+                (unsigned long long)datagrams, (unsigned long long)samples, elapsed, (unsigned long long)lost, 
+                datagrams + lost ? 100.0 * lost / (datagrams + lost) : 0.0); 
+    close(fd); 
+    if (endpoint.compare(0, 5, "unix:") == 0) {
+        unlink(endpoint.c_str() + 5); 
+    }
+    return 0; 
+}
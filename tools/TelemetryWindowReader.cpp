@@ -0,0 +1,73 @@
+// Example reader of the shared-memory telemetry window. Maps the segment
+// read-only and polls every car at a target rate, reporting the achieved
+// poll rate, seqlock retries and a summary of the fleet it saw.
+// Usage: telemetry_window_reader [name] [seconds] [polls per second, 0 = as fast as possible]
+#include "../car/Car.hpp"
+#include "../telemetry/SharedTelemetryWindow.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <thread>
+
+int main(int argc, char** argv) {
+    const std::string name = argc > 1 ? argv[1] : "/carecu-window"; 
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 5.0; 
+    const double rate = argc > 3 ? std::atof(argv[3]) : 1000.0; 
+
+    try {
+        const SharedTelemetryWindow window = SharedTelemetryWindow::Open(name); 
+        std::printf("mapped %s: %zu slots, %zu bytes\n", name.c_str(), window.getCarCapacity(), window.getMappedBytes()); 
+
+        while (window.getCarCount() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Simulator still starting
+        }
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now(); 
+        const std::chrono::steady_clock::time_point end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds)); 
+        const std::chrono::nanoseconds period(rate > 0 ? (long long)(1e9 / rate) : 0); 
+        std::chrono::steady_clock::time_point next = start; 
+        std::uint64_t polls = 0, reads = 0, retries = 0, late = 0; 
+        std::size_t cars = 0, adaptive = 0, diagnostic = 0, speeding = 0; 
+        ShmCarState state; 
+
+        while (std::chrono::steady_clock::now() < end) {
+            cars = window.getCarCount(); 
+            adaptive = diagnostic = speeding = 0; 
+            for (std::size_t i = 0; i < cars; i++) {
+                // A writer preempted mid-update keeps its slot odd; yield instead of spinning through our time slice
+                for (unsigned attempt = 1; !window.TryRead(i, state); attempt++) {
+                    retries++; 
+                    if (attempt % 16 == 0) {
+                        std::this_thread::yield(); 
+                    }
+                }
+                adaptive += (state.flags & CAR_STATUS_ADAPTIVE_ON) != 0; 
+                diagnostic += (state.flags & CAR_STATUS_DIAGNOSTIC_ON) != 0; 
+                speeding += state.values[(int)SensorTypes::SPEED_SENSOR] > DefaultVehicleProfile::maxSpeed; 
+            }
+            reads += cars; 
+            polls++; 
+            if (period.count() > 0) {
+                next += period; 
+                const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now(); 
+                if (next > now) {
+                    std::this_thread::sleep_until(next); 
+                } else {
+                    late++; // This poll overran its period
+                    next = now; 
+                }
+            }
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); 
+        std::printf("%llu polls of %zu cars in %.2f s: %.0f polls/s, %.1f M car reads/s, %llu retries, %llu late polls\n", 
+                    (unsigned long long)polls, cars, elapsed, polls / elapsed, reads / elapsed / 1e6, 
+                    (unsigned long long)retries, (unsigned long long)late); 
+        std::printf("last poll: %zu cars with diagnostics on, %zu with adaptive cruise control on, %zu above %g km/h\n", 
+                    diagnostic, adaptive, speeding, DefaultVehicleProfile::maxSpeed); 
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what()); 
+        return 1; 
+    }
+    return 0; 
+}